@@ -421,6 +421,32 @@ class CINFO3D_VISU
     void createBoardPolygon();
     void createLayers( REPORTER *aStatusTextReporter );
     void destroyLayers();
+    void destroyLayer( PCB_LAYER_ID aLayerId );
+    void destroyHoles();
+
+    /**
+     * @brief layerItemsHash - Hash of the board items drawn on a layer, and of the settings
+     * used to convert them, to know if the layer has to be built again
+     */
+    size_t layerItemsHash( PCB_LAYER_ID aLayerId ) const;
+
+    /**
+     * @brief createCopperLayer - Adds the items of a copper layer to its container and,
+     * if aLayerPoly is not NULL, to its polygon set.  Safe to call for several layers
+     * at the same time.
+     */
+    void createCopperLayer( PCB_LAYER_ID aLayerId,
+                            const std::vector< const TRACK *> &aTrackList,
+                            CBVHCONTAINER2D *aLayerContainer,
+                            SHAPE_POLY_SET *aLayerPoly );
+
+    /**
+     * @brief createTechLayer - Adds the items of a technical layer to its container and
+     * polygon set.  Safe to call for several layers at the same time.
+     */
+    void createTechLayer( PCB_LAYER_ID aLayerId,
+                          CBVHCONTAINER2D *aLayerContainer,
+                          SHAPE_POLY_SET &aLayerPoly );
 
     // Helper functions to create the board
     COBJECT2D *createNewTrack( const TRACK* aTrack , int aClearanceValue ) const;
@@ -583,6 +609,10 @@ class CINFO3D_VISU
     /// It contains the 2d elements of each layer
     MAP_CONTAINER_2D  m_layers_container2D;
 
+    /// Hash of the items each layer of m_layers_container2D (and m_layers_poly) was built
+    /// from, the unchanged layers are kept when the board is reloaded
+    std::map< PCB_LAYER_ID, size_t > m_layers_hash;
+
     /// It contains the holes per each layer
     MAP_CONTAINER_2D  m_layers_holes2D;
 
@@ -58,29 +58,35 @@
 
 // These variables are parameters used in addTextSegmToContainer.
 // But addTextSegmToContainer is a call-back function,
-// so we cannot send them as arguments.
-static int s_textWidth;
-static CGENERICCONTAINER2D *s_dstcontainer = NULL;
-static float s_biuTo3Dunits;
-static const BOARD_ITEM *s_boardItem = NULL;
+// so they are sent through its aData argument.
+struct TSEGM_2_CONTAINER_PRMS
+{
+    int m_textWidth;
+    CGENERICCONTAINER2D *m_dstcontainer;
+    float m_biuTo3Dunits;
+    const BOARD_ITEM *m_boardItem;
+};
 
 // This is a call back function, used by DrawGraphicText to draw the 3D text shape:
-void addTextSegmToContainer( int x0, int y0, int xf, int yf, void* aData )
+static void addTextSegmToContainer( int x0, int y0, int xf, int yf, void* aData )
 {
-    wxASSERT( s_dstcontainer != NULL );
+    const TSEGM_2_CONTAINER_PRMS *prms = static_cast<const TSEGM_2_CONTAINER_PRMS *>( aData );
+
+    wxASSERT( prms->m_dstcontainer != NULL );
 
-    const SFVEC2F start3DU( x0 * s_biuTo3Dunits, -y0 * s_biuTo3Dunits );
-    const SFVEC2F end3DU  ( xf * s_biuTo3Dunits, -yf * s_biuTo3Dunits );
+    const float biuTo3Dunits = prms->m_biuTo3Dunits;
+    const SFVEC2F start3DU( x0 * biuTo3Dunits, -y0 * biuTo3Dunits );
+    const SFVEC2F end3DU  ( xf * biuTo3Dunits, -yf * biuTo3Dunits );
 
     if( Is_segment_a_circle( start3DU, end3DU ) )
-        s_dstcontainer->Add( new CFILLEDCIRCLE2D( start3DU,
-                                                  ( s_textWidth / 2 ) * s_biuTo3Dunits,
-                                                  *s_boardItem) );
+        prms->m_dstcontainer->Add( new CFILLEDCIRCLE2D( start3DU,
+                                                        ( prms->m_textWidth / 2 ) * biuTo3Dunits,
+                                                        *prms->m_boardItem) );
     else
-        s_dstcontainer->Add( new CROUNDSEGMENT2D( start3DU,
-                                                  end3DU,
-                                                  s_textWidth * s_biuTo3Dunits,
-                                                  *s_boardItem ) );
+        prms->m_dstcontainer->Add( new CROUNDSEGMENT2D( start3DU,
+                                                        end3DU,
+                                                        prms->m_textWidth * biuTo3Dunits,
+                                                        *prms->m_boardItem ) );
 }
 
 
@@ -97,10 +103,11 @@ void CINFO3D_VISU::AddShapeWithClearanceToContainer( const TEXTE_PCB* aTextPCB,
     if( aTextPCB->IsMirrored() )
         size.x = -size.x;
 
-    s_boardItem    = (const BOARD_ITEM *)&aTextPCB;
-    s_dstcontainer = aDstContainer;
-    s_textWidth    = aTextPCB->GetThickness() + ( 2 * aClearanceValue );
-    s_biuTo3Dunits = m_biuTo3Dunits;
+    TSEGM_2_CONTAINER_PRMS prms;
+    prms.m_boardItem    = aTextPCB;
+    prms.m_dstcontainer = aDstContainer;
+    prms.m_textWidth    = aTextPCB->GetThickness() + ( 2 * aClearanceValue );
+    prms.m_biuTo3Dunits = m_biuTo3Dunits;
 
     // not actually used, but needed by DrawGraphicText
     const COLOR4D dummy_color = COLOR4D::BLACK;
@@ -122,7 +129,7 @@ void CINFO3D_VISU::AddShapeWithClearanceToContainer( const TEXTE_PCB* aTextPCB,
                              txt, aTextPCB->GetTextAngle(), size,
                              aTextPCB->GetHorizJustify(), aTextPCB->GetVertJustify(),
                              aTextPCB->GetThickness(), aTextPCB->IsItalic(),
-                             true, addTextSegmToContainer );
+                             true, addTextSegmToContainer, &prms );
         }
     }
     else
@@ -131,7 +138,7 @@ void CINFO3D_VISU::AddShapeWithClearanceToContainer( const TEXTE_PCB* aTextPCB,
                          aTextPCB->GetShownText(), aTextPCB->GetTextAngle(), size,
                          aTextPCB->GetHorizJustify(), aTextPCB->GetVertJustify(),
                          aTextPCB->GetThickness(), aTextPCB->IsItalic(),
-                         true, addTextSegmToContainer );
+                         true, addTextSegmToContainer, &prms );
     }
 }
 
@@ -222,14 +229,15 @@ void CINFO3D_VISU::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMod
     if( aModule->Value().GetLayer() == aLayerId && aModule->Value().IsVisible() )
         texts.push_back( &aModule->Value() );
 
-    s_boardItem    = (const BOARD_ITEM *)&aModule->Value();
-    s_dstcontainer = aDstContainer;
-    s_biuTo3Dunits = m_biuTo3Dunits;
+    TSEGM_2_CONTAINER_PRMS prms;
+    prms.m_boardItem    = (const BOARD_ITEM *)&aModule->Value();
+    prms.m_dstcontainer = aDstContainer;
+    prms.m_biuTo3Dunits = m_biuTo3Dunits;
 
     for( unsigned ii = 0; ii < texts.size(); ++ii )
     {
         TEXTE_MODULE *textmod = texts[ii];
-        s_textWidth = textmod->GetThickness() + ( 2 * aInflateValue );
+        prms.m_textWidth = textmod->GetThickness() + ( 2 * aInflateValue );
         wxSize size = textmod->GetTextSize();
 
         if( textmod->IsMirrored() )
@@ -239,7 +247,7 @@ void CINFO3D_VISU::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMod
                          textmod->GetShownText(), textmod->GetDrawRotation(), size,
                          textmod->GetHorizJustify(), textmod->GetVertJustify(),
                          textmod->GetThickness(), textmod->IsItalic(),
-                         true, addTextSegmToContainer );
+                         true, addTextSegmToContainer, &prms );
     }
 }
 
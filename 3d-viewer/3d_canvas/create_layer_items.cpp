@@ -55,9 +55,43 @@
 #include <thread>
 #include <algorithm>
 #include <atomic>
+#include <functional>
+#include <future>
+#include <set>
+#include <string>
 
 #include <profile.h>
 
+// Number of segments to draw a circle using segments (used on countour zones
+// and text copper elements )
+static const int segcountforcircle = 12;
+
+// segments to draw a circle to build texts. Is is used only to build
+// the shape of each segment of the stroke font, therefore no need to have
+// many segments per circle.
+static const int segcountInStrokeFont = 12;
+
+// draw graphic items, on technical layers
+static const PCB_LAYER_ID teckLayerList[] = {
+        B_Adhes,
+        F_Adhes,
+        B_Paste,
+        F_Paste,
+        B_SilkS,
+        F_SilkS,
+        B_Mask,
+        F_Mask,
+
+        // Aux Layers
+        Dwgs_User,
+        Cmts_User,
+        Eco1_User,
+        Eco2_User,
+        Edge_Cuts,
+        Margin
+    };
+
+
 void CINFO3D_VISU::destroyLayers()
 {
     if( !m_layers_poly.empty() )
@@ -73,43 +107,73 @@ void CINFO3D_VISU::destroyLayers()
         m_layers_poly.clear();
     }
 
-    if( !m_layers_inner_holes_poly.empty() )
+    if( !m_layers_container2D.empty() )
     {
-        for( MAP_POLY::iterator ii = m_layers_inner_holes_poly.begin();
-             ii != m_layers_inner_holes_poly.end();
+        for( MAP_CONTAINER_2D::iterator ii = m_layers_container2D.begin();
+             ii != m_layers_container2D.end();
              ++ii )
         {
             delete ii->second;
             ii->second = NULL;
         }
 
-        m_layers_inner_holes_poly.clear();
+        m_layers_container2D.clear();
     }
 
-    if( !m_layers_outer_holes_poly.empty() )
+    m_layers_hash.clear();
+
+    destroyHoles();
+}
+
+
+void CINFO3D_VISU::destroyLayer( PCB_LAYER_ID aLayerId )
+{
+    MAP_CONTAINER_2D::iterator container = m_layers_container2D.find( aLayerId );
+
+    if( container != m_layers_container2D.end() )
     {
-        for( MAP_POLY::iterator ii = m_layers_outer_holes_poly.begin();
-             ii != m_layers_outer_holes_poly.end();
+        delete container->second;
+        m_layers_container2D.erase( container );
+    }
+
+    MAP_POLY::iterator poly = m_layers_poly.find( aLayerId );
+
+    if( poly != m_layers_poly.end() )
+    {
+        delete poly->second;
+        m_layers_poly.erase( poly );
+    }
+
+    m_layers_hash.erase( aLayerId );
+}
+
+
+void CINFO3D_VISU::destroyHoles()
+{
+    if( !m_layers_inner_holes_poly.empty() )
+    {
+        for( MAP_POLY::iterator ii = m_layers_inner_holes_poly.begin();
+             ii != m_layers_inner_holes_poly.end();
              ++ii )
         {
             delete ii->second;
             ii->second = NULL;
         }
 
-        m_layers_outer_holes_poly.clear();
+        m_layers_inner_holes_poly.clear();
     }
 
-    if( !m_layers_container2D.empty() )
+    if( !m_layers_outer_holes_poly.empty() )
     {
-        for( MAP_CONTAINER_2D::iterator ii = m_layers_container2D.begin();
-             ii != m_layers_container2D.end();
+        for( MAP_POLY::iterator ii = m_layers_outer_holes_poly.begin();
+             ii != m_layers_outer_holes_poly.end();
              ++ii )
         {
             delete ii->second;
             ii->second = NULL;
         }
 
-        m_layers_container2D.clear();
+        m_layers_outer_holes_poly.clear();
     }
 
     if( !m_layers_holes2D.empty() )
@@ -138,768 +202,1118 @@ void CINFO3D_VISU::destroyLayers()
 }
 
 
-void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
+static void hashCombine( size_t &aSeed, size_t aValue )
 {
-    // Number of segments to draw a circle using segments (used on countour zones
-    // and text copper elements )
-    const int    segcountforcircle = 12;
-    const double correctionFactor  = GetCircleCorrectionFactor( segcountforcircle );
-
-    // segments to draw a circle to build texts. Is is used only to build
-    // the shape of each segment of the stroke font, therefore no need to have
-    // many segments per circle.
-    const int segcountInStrokeFont  = 12;
-    const double correctionFactorStroke = GetCircleCorrectionFactor( segcountInStrokeFont );
+    aSeed ^= aValue + 0x9e3779b9 + ( aSeed << 6 ) + ( aSeed >> 2 );
+}
 
-    destroyLayers();
 
-    // Build Copper layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
-    // /////////////////////////////////////////////////////////////////////////
+static void hashInt( size_t &aSeed, int aValue )
+{
+    hashCombine( aSeed, std::hash<int>()( aValue ) );
+}
 
-    #ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startCopperLayersTime = GetRunningMicroSecs();
 
-    unsigned start_Time = stats_startCopperLayersTime;
-#endif
+static void hashDouble( size_t &aSeed, double aValue )
+{
+    hashCombine( aSeed, std::hash<double>()( aValue ) );
+}
 
-    PCB_LAYER_ID cu_seq[MAX_CU_LAYERS];
-    LSET     cu_set = LSET::AllCuMask( m_copperLayersCount );
 
-    m_stats_nr_tracks               = 0;
-    m_stats_track_med_width         = 0;
-    m_stats_nr_vias                 = 0;
-    m_stats_via_med_hole_diameter   = 0;
-    m_stats_nr_holes                = 0;
-    m_stats_hole_med_diameter       = 0;
+// The 2D objects keep a reference to the item they were made from, so the identity of the
+// items is part of the hash, as well as their shape
+static void hashItem( size_t &aSeed, const BOARD_ITEM *aItem )
+{
+    hashCombine( aSeed, std::hash<const BOARD_ITEM *>()( aItem ) );
+}
 
-    // Prepare track list, convert in a vector. Calc statistic for the holes
-    // /////////////////////////////////////////////////////////////////////////
-    std::vector< const TRACK *> trackList;
-    trackList.clear();
-    trackList.reserve( m_board->m_Track.GetCount() );
 
-    for( const TRACK* track = m_board->m_Track; track; track = track->Next() )
-    {
-        if( !Is3DLayerEnabled( track->GetLayer() ) ) // Skip non enabled layers
-            continue;
+static void hashPoint( size_t &aSeed, const wxPoint &aPoint )
+{
+    hashInt( aSeed, aPoint.x );
+    hashInt( aSeed, aPoint.y );
+}
 
-        // Note: a TRACK holds normal segment tracks and
-        // also vias circles (that have also drill values)
-        trackList.push_back( track );
 
-        if( track->Type() == PCB_VIA_T )
-        {
-            const VIA *via = static_cast< const VIA*>( track );
-            m_stats_nr_vias++;
-            m_stats_via_med_hole_diameter += via->GetDrillValue() * m_biuTo3Dunits;
-        }
-        else
-        {
-            m_stats_nr_tracks++;
-        }
+static void hashSize( size_t &aSeed, const wxSize &aSize )
+{
+    hashInt( aSeed, aSize.x );
+    hashInt( aSeed, aSize.y );
+}
 
-        m_stats_track_med_width += track->GetWidth() * m_biuTo3Dunits;
-    }
 
-    if( m_stats_nr_tracks )
-        m_stats_track_med_width /= (float)m_stats_nr_tracks;
+static void hashPolySet( size_t &aSeed, const SHAPE_POLY_SET &aPolySet )
+{
+    for( int i = 0; i < aPolySet.OutlineCount(); ++i )
+    {
+        hashInt( aSeed, aPolySet.HoleCount( i ) );
 
-    if( m_stats_nr_vias )
-        m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
+        for( int j = -1; j < aPolySet.HoleCount( i ); ++j )
+        {
+            const SHAPE_LINE_CHAIN &chain = ( j < 0 ) ? aPolySet.COutline( i ) :
+                                                        aPolySet.CHole( i, j );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T01: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+            hashInt( aSeed, chain.PointCount() );
 
-    // Prepare copper layers index and containers
-    // /////////////////////////////////////////////////////////////////////////
-    std::vector< PCB_LAYER_ID > layer_id;
-    layer_id.clear();
-    layer_id.reserve( m_copperLayersCount );
+            for( int k = 0; k < chain.PointCount(); ++k )
+            {
+                hashInt( aSeed, chain.CPoint( k ).x );
+                hashInt( aSeed, chain.CPoint( k ).y );
+            }
+        }
+    }
+}
 
-    for( unsigned i = 0; i < arrayDim( cu_seq ); ++i )
-        cu_seq[i] = ToLAYER_ID( B_Cu - i );
 
-    for( LSEQ cu = cu_set.Seq( cu_seq, arrayDim( cu_seq ) ); cu; ++cu )
-    {
-        const PCB_LAYER_ID curr_layer_id = *cu;
+static void hashText( size_t &aSeed, const EDA_TEXT &aText )
+{
+    hashCombine( aSeed, std::hash<std::wstring>()( aText.GetShownText().ToStdWstring() ) );
+    hashPoint( aSeed, aText.GetTextPos() );
+    hashSize( aSeed, aText.GetTextSize() );
+    hashDouble( aSeed, aText.GetTextAngle() );
+    hashInt( aSeed, aText.GetThickness() );
+    hashInt( aSeed, aText.GetHorizJustify() );
+    hashInt( aSeed, aText.GetVertJustify() );
+    hashInt( aSeed, aText.IsItalic() );
+    hashInt( aSeed, aText.IsBold() );
+    hashInt( aSeed, aText.IsMirrored() );
+    hashInt( aSeed, aText.IsVisible() );
+    hashInt( aSeed, aText.IsMultilineAllowed() );
+}
 
-        if( !Is3DLayerEnabled( curr_layer_id ) ) // Skip non enabled layers
-            continue;
 
-        layer_id.push_back( curr_layer_id );
+static void hashDrawSegment( size_t &aSeed, const DRAWSEGMENT &aSegment )
+{
+    hashInt( aSeed, aSegment.GetShape() );
+    hashPoint( aSeed, aSegment.GetStart() );
+    hashPoint( aSeed, aSegment.GetEnd() );
+    hashDouble( aSeed, aSegment.GetAngle() );
+    hashInt( aSeed, aSegment.GetWidth() );
 
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
+    for( const wxPoint &point : aSegment.GetBezierPoints() )
+        hashPoint( aSeed, point );
 
-        if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-            (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-        {
-            SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-            m_layers_poly[curr_layer_id] = layerPoly;
-        }
-    }
+    hashPolySet( aSeed, aSegment.GetPolyShape() );
+}
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T02: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Create tracks and vias" ) );
+static void hashPad( size_t &aSeed, const D_PAD &aPad, PCB_LAYER_ID aLayerId )
+{
+    hashPoint( aSeed, aPad.GetPosition() );
+    hashDouble( aSeed, aPad.GetOrientation() );
+    hashInt( aSeed, aPad.GetShape() );
+    hashInt( aSeed, aPad.GetAnchorPadShape() );
+    hashSize( aSeed, aPad.GetSize() );
+    hashSize( aSeed, aPad.GetDelta() );
+    hashPoint( aSeed, aPad.GetOffset() );
+    hashSize( aSeed, aPad.GetDrillSize() );
+    hashInt( aSeed, aPad.GetDrillShape() );
+    hashInt( aSeed, aPad.GetAttribute() );
+    hashDouble( aSeed, aPad.GetRoundRectRadiusRatio() );
+    hashCombine( aSeed, std::hash<BASE_SET>()( aPad.GetLayerSet() ) );
+
+    if( aPad.GetShape() == PAD_SHAPE_CUSTOM )
+        hashPolySet( aSeed, aPad.GetCustomShapeAsPolygon() );
+
+    // The margins come from the pad, its footprint and the board settings
+    if( ( aLayerId == F_Mask ) || ( aLayerId == B_Mask ) )
+        hashInt( aSeed, aPad.GetSolderMaskMargin() );
+
+    if( ( aLayerId == F_Paste ) || ( aLayerId == B_Paste ) )
+        hashSize( aSeed, aPad.GetSolderPasteMargin() );
+}
 
-    // Create tracks as objects and add it to container
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
 
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+size_t CINFO3D_VISU::layerItemsHash( PCB_LAYER_ID aLayerId ) const
+{
+    size_t hash = std::hash<int>()( aLayerId );
+
+    // The settings used to convert the items
+    hashDouble( hash, m_biuTo3Dunits );
+    hashInt( hash, GetCopperThicknessBIU() );
+    hashDouble( hash, m_calc_seg_min_factor3DU );
+    hashDouble( hash, m_calc_seg_max_factor3DU );
+    hashInt( hash, m_render_engine );
+    hashInt( hash, GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) );
+    hashInt( hash, GetFlag( FL_ZONE ) );
+    hashInt( hash, g_DrawDefaultLineThickness );
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+    for( const TRACK* track = m_board->m_Track; track; track = track->Next() )
+    {
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
 
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+        hashItem( hash, track );
+        hashInt( hash, track->Type() );
+        hashPoint( hash, track->GetStart() );
+        hashPoint( hash, track->GetEnd() );
+        hashInt( hash, track->GetWidth() );
+        hashCombine( hash, std::hash<BASE_SET>()( track->GetLayerSet() ) );
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+        // Tracks and vias are skipped when their own layer is hidden
+        hashInt( hash, Is3DLayerEnabled( track->GetLayer() ) );
+    }
 
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
+    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        for( const D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+        {
+            if( !pad->IsOnLayer( aLayerId ) )
                 continue;
 
-            // Add object item to layer container
-            layerContainer->Add( createNewTrack( track, 0.0f ) );
+            hashItem( hash, pad );
+            hashPad( hash, *pad, aLayerId );
         }
-    }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+        for( const BOARD_ITEM* item = module->GraphicalItemsList(); item; item = item->Next() )
+        {
+            if( item->GetLayer() != aLayerId )
+                continue;
 
-    // Create VIAS and THTs objects and add it to holes containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+            hashItem( hash, item );
 
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+            if( item->Type() == PCB_MODULE_TEXT_T )
+            {
+                const TEXTE_MODULE *text = static_cast<const TEXTE_MODULE *>( item );
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+                hashText( hash, *text );
+                hashDouble( hash, text->GetDrawRotation() );
+            }
+            else if( item->Type() == PCB_MODULE_EDGE_T )
+            {
+                hashDrawSegment( hash, *static_cast<const EDGE_MODULE *>( item ) );
+            }
+        }
 
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+        const TEXTE_MODULE *texts[] = { &module->Reference(), &module->Value() };
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
+        for( const TEXTE_MODULE *text : texts )
+        {
+            if( text->GetLayer() == aLayerId )
             {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE_T viatype = via->GetViaType();
-                const float holediameter = via->GetDrillValue() * BiuTo3Dunits();
-                const float thickness = GetCopperThickness3DU();
-                const float hole_inner_radius = ( holediameter / 2.0f );
+                hashItem( hash, text );
+                hashText( hash, *text );
+                hashDouble( hash, text->GetDrawRotation() );
+            }
+        }
+    }
 
-                const SFVEC2F via_center(  via->GetStart().x * m_biuTo3Dunits,
-                                          -via->GetStart().y * m_biuTo3Dunits );
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-                if( viatype != VIA_THROUGH )
-                {
+        hashItem( hash, item );
+        hashInt( hash, item->Type() );
 
-                    // Add hole objects
-                    // /////////////////////////////////////////////////////////
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            hashDrawSegment( hash, *static_cast<const DRAWSEGMENT *>( item ) );
+            break;
 
-                    CBVHCONTAINER2D *layerHoleContainer = NULL;
+        case PCB_TEXT_T:
+            hashText( hash, *static_cast<const TEXTE_PCB *>( item ) );
+            break;
 
-                    // Check if the layer is already created
-                    if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
-                    {
-                        // not found, create a new container
-                        layerHoleContainer = new CBVHCONTAINER2D;
-                        m_layers_holes2D[curr_layer_id] = layerHoleContainer;
-                    }
-                    else
-                    {
-                        // found
-                        layerHoleContainer = m_layers_holes2D[curr_layer_id];
-                    }
+        case PCB_DIMENSION_T:
+        {
+            const DIMENSION *dimension = static_cast<const DIMENSION *>( item );
 
-                    // Add a hole for this layer
-                    layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
-                                                                  hole_inner_radius + thickness,
-                                                                  *track ) );
-                }
-                else if( lIdx == 0 ) // it only adds once the THT holes
-                {
-                    // Add through hole object
-                    // /////////////////////////////////////////////////////////
-                    m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius + thickness,
-                                                                    *track ) );
+            hashText( hash, dimension->Text() );
+            hashInt( hash, dimension->GetWidth() );
 
-                    m_through_holes_vias_outer.Add(
-                                new CFILLEDCIRCLE2D( via_center,
-                                                     hole_inner_radius + thickness,
-                                                     *track ) );
+            const wxPoint *points[] = { &dimension->m_crossBarO, &dimension->m_crossBarF,
+                                        &dimension->m_featureLineGO, &dimension->m_featureLineGF,
+                                        &dimension->m_featureLineDO, &dimension->m_featureLineDF,
+                                        &dimension->m_arrowD1F, &dimension->m_arrowD2F,
+                                        &dimension->m_arrowG1F, &dimension->m_arrowG2F };
 
-                    m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius,
-                                                                    *track ) );
+            for( const wxPoint *point : points )
+                hashPoint( hash, *point );
+        }
+            break;
 
-                    //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                    //                                                     hole_inner_radius,
-                    //                                                     *track ) );
-                }
-            }
+        default:
+            break;
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Create VIAS and THTs objects and add it to holes containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+        const ZONE_CONTAINER* zone = m_board->GetArea( ii );
 
-        // ADD TRACKS
-        const unsigned int nTracks = trackList.size();
+        if( !zone->IsOnLayer( aLayerId ) )
+            continue;
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+        hashItem( hash, zone );
+        hashInt( hash, zone->GetMinThickness() );
+        hashPolySet( hash, zone->GetFilledPolysList() );
+    }
 
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+    return hash;
+}
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
-            {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE_T viatype = via->GetViaType();
 
-                if( viatype != VIA_THROUGH )
-                {
+void CINFO3D_VISU::createCopperLayer( PCB_LAYER_ID aLayerId,
+                                      const std::vector< const TRACK *> &aTrackList,
+                                      CBVHCONTAINER2D *aLayerContainer,
+                                      SHAPE_POLY_SET *aLayerPoly )
+{
+    const double correctionFactor = GetCircleCorrectionFactor( segcountforcircle );
 
-                    // Add VIA hole contourns
-                    // /////////////////////////////////////////////////////////
+    // Create tracks as objects and add it to container
+    // /////////////////////////////////////////////////////////////////////////
+    for( const TRACK *track : aTrackList )
+    {
+        // NOTE: Vias can be on multiple layers
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
 
-                    // Add outter holes of VIAs
-                    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
-                    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
+        // Add object item to layer container
+        aLayerContainer->Add( createNewTrack( track, 0.0f ) );
+    }
 
-                    // Check if the layer is already created
-                    if( m_layers_outer_holes_poly.find( curr_layer_id ) ==
-                        m_layers_outer_holes_poly.end() )
-                    {
-                        // not found, create a new container
-                        layerOuterHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_outer_holes_poly[curr_layer_id] = layerOuterHolesPoly;
+    // Creates outline contours of the tracks and add it to the poly of the layer
+    // /////////////////////////////////////////////////////////////////////////
+    if( aLayerPoly )
+    {
+        for( const TRACK *track : aTrackList )
+        {
+            if( !track->IsOnLayer( aLayerId ) )
+                continue;
 
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
-                                  m_layers_inner_holes_poly.end() );
+            // Add the track contour
+            int nrSegments = GetNrSegmentsCircle( track->GetWidth() );
 
-                        layerInnerHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_inner_holes_poly[curr_layer_id] = layerInnerHolesPoly;
-                    }
-                    else
-                    {
-                        // found
-                        layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
+            track->TransformShapeWithClearanceToPolygon(
+                        *aLayerPoly,
+                        0,
+                        nrSegments,
+                        GetCircleCorrectionFactor( nrSegments ) );
+        }
+    }
 
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                                  m_layers_inner_holes_poly.end() );
+    // Add modules PADs objects to containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        AddPadsShapesWithClearanceToContainer( module,
+                                               aLayerContainer,
+                                               aLayerId,
+                                               0,
+                                               true );
+
+        // Micro-wave modules may have items on copper layers
+        AddGraphicsShapesWithClearanceToContainer( module,
+                                                   aLayerContainer,
+                                                   aLayerId,
+                                                   0 );
+    }
 
-                        layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
-                    }
+    // Add modules PADs poly contourns
+    // /////////////////////////////////////////////////////////////////////////
+    if( aLayerPoly )
+    {
+        for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+        {
+            // Note: NPTH pads are not drawn on copper layers when the pad
+            // has same shape as its hole
+            transformPadsShapesWithClearanceToPolygon( module->PadsList(),
+                                                       aLayerId,
+                                                       *aLayerPoly,
+                                                       0,
+                                                       true );
 
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2) + GetCopperThicknessBIU();
+            // Micro-wave modules may have items on copper layers
+            module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId,
+                                                                    *aLayerPoly,
+                                                                    0,
+                                                                    segcountforcircle,
+                                                                    correctionFactor );
 
-                    TransformCircleToPolygon( *layerOuterHolesPoly,
-                                              via->GetStart(),
-                                              hole_outer_radius,
-                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
+            transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *aLayerPoly );
+        }
+    }
 
-                    TransformCircleToPolygon( *layerInnerHolesPoly,
-                                              via->GetStart(),
-                                              holediameter / 2,
-                                              GetNrSegmentsCircle( holediameter ) );
-                }
-                else if( lIdx == 0 ) // it only adds once the THT holes
-                {
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
+    // Add graphic item on copper layers to object containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-                    // Add through hole contourns
-                    // /////////////////////////////////////////////////////////
-                    TransformCircleToPolygon( m_through_outer_holes_poly,
-                                              via->GetStart(),
-                                              hole_outer_radius,
-                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:  // should not exist on copper layers
+        {
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              aLayerContainer,
+                                              aLayerId,
+                                              0 );
+        }
+        break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              aLayerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              aLayerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        default:
+            wxLogTrace( m_logTrace,
+                        wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+        break;
+        }
+    }
 
-                    TransformCircleToPolygon( m_through_inner_holes_poly,
-                                              via->GetStart(),
-                                              holediameter / 2,
-                                              GetNrSegmentsCircle( holediameter ) );
+    // Add graphic item on copper layers to poly contourns
+    // /////////////////////////////////////////////////////////////////////////
+    if( aLayerPoly )
+    {
+        for( auto item : m_board->Drawings() )
+        {
+            if( !item->IsOnLayer( aLayerId ) )
+                continue;
 
-                    // Add samething for vias only
+            switch( item->Type() )
+            {
+            case PCB_LINE_T:
+            {
+                const int nrSegments =
+                        GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
 
-                    TransformCircleToPolygon( m_through_outer_holes_vias_poly,
-                                              via->GetStart(),
-                                              hole_outer_radius,
-                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
+                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
+                            *aLayerPoly,
+                            0,
+                            nrSegments,
+                            GetCircleCorrectionFactor( nrSegments ) );
+            }
+            break;
 
-                    //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
-                    //                          via->GetStart(),
-                    //                          holediameter / 2,
-                    //                          GetNrSegmentsCircle( holediameter ) );
-                }
+            case PCB_TEXT_T:
+                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet(
+                            *aLayerPoly,
+                            0,
+                            segcountforcircle,
+                            correctionFactor );
+            break;
+
+            default:
+                wxLogTrace( m_logTrace,
+                            wxT( "createLayers: item type: %d not implemented" ),
+                            item->Type() );
+            break;
             }
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Creates outline contours of the tracks and add it to the poly of the layer
+    // Add zones objects
     // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
+    if( GetFlag( FL_ZONE ) )
     {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
         {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( zone->GetLayer() != aLayerId )
+                continue;
+
+            AddSolidAreasShapesToContainer( zone, aLayerContainer, aLayerId );
 
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+            if( aLayerPoly )
+                zone->TransformSolidAreasShapesToPolygonSet( *aLayerPoly,
+                                                             segcountforcircle,
+                                                             correctionFactor );
+        }
+    }
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+    // This will make a union of all added contours
+    if( aLayerPoly )
+        aLayerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+}
 
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
 
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
+void CINFO3D_VISU::createTechLayer( PCB_LAYER_ID aLayerId,
+                                    CBVHCONTAINER2D *aLayerContainer,
+                                    SHAPE_POLY_SET &aLayerPoly )
+{
+    const double correctionFactorStroke = GetCircleCorrectionFactor( segcountInStrokeFont );
 
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
+    // Add drawing objects
+    // /////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-                // Add the track contour
-                int nrSegments = GetNrSegmentsCircle( track->GetWidth() );
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              aLayerContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-                track->TransformShapeWithClearanceToPolygon(
-                            *layerPoly,
-                            0,
-                            nrSegments,
-                            GetCircleCorrectionFactor( nrSegments ) );
-            }
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              aLayerContainer,
+                                              aLayerId,
+                                              0 );
+            break;
+
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              aLayerContainer,
+                                              aLayerId,
+                                              0 );
+            break;
+
+        default:
+            break;
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add holes of modules
-    // /////////////////////////////////////////////////////////////////////////
-    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    // Add drawing contours
+    // /////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
     {
-        const D_PAD* pad = module->PadsList();
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-        for( ; pad; pad = pad->Next() )
+        switch( item->Type() )
         {
-            const wxSize padHole = pad->GetDrillSize();
+        case PCB_LINE_T:
+        {
+            const unsigned int nr_segments =
+                    GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
 
-            if( !padHole.x )    // Not drilled pad like SMD pad
-                continue;
+            ((DRAWSEGMENT*) item)->TransformShapeWithClearanceToPolygon( aLayerPoly,
+                                                                         0,
+                                                                         nr_segments,
+                                                                         0.0 );
+        }
+            break;
 
-            // The hole in the body is inflated by copper thickness,
-            // if not plated, no copper
-            const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
-                                GetCopperThicknessBIU() : 0;
+        case PCB_TEXT_T:
+            ((TEXTE_PCB*) item)->TransformShapeWithClearanceToPolygonSet( aLayerPoly,
+                                                                          0,
+                                                                          segcountInStrokeFont,
+                                                                          1.0 );
+            break;
 
-            m_stats_nr_holes++;
-            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
-                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+        default:
+            break;
+        }
+    }
 
-            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
-            m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
+
+    // Add modules tech layers - objects
+    // /////////////////////////////////////////////////////////////////////
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
+        {
+            D_PAD*  pad = module->PadsList();
+            int     linewidth = g_DrawDefaultLineThickness;
+
+            for( ; pad; pad = pad->Next() )
+            {
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
+
+                buildPadShapeThickOutlineAsSegments( pad,
+                                                     aLayerContainer,
+                                                     linewidth );
+            }
+        }
+        else
+        {
+            AddPadsShapesWithClearanceToContainer( module,
+                                                   aLayerContainer,
+                                                   aLayerId,
+                                                   0,
+                                                   false );
         }
+
+        AddGraphicsShapesWithClearanceToContainer( module,
+                                                   aLayerContainer,
+                                                   aLayerId,
+                                                   0 );
     }
-    if( m_stats_nr_holes )
-        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
 
-    // Add contours of the pad holes (pads can be Circle or Segment holes)
-    // /////////////////////////////////////////////////////////////////////////
-    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    // Add modules tech layers - contours
+    // /////////////////////////////////////////////////////////////////////
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
     {
-        const D_PAD* pad = module->PadsList();
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
+        {
+            D_PAD*  pad = module->PadsList();
+            const int linewidth = g_DrawDefaultLineThickness;
 
-        for( ; pad; pad = pad->Next() )
+            for( ; pad; pad = pad->Next() )
+            {
+                if( !pad->IsOnLayer( aLayerId ) )
+                    continue;
+
+                buildPadShapeThickOutlineAsPolygon( pad, aLayerPoly, linewidth );
+            }
+        }
+        else
         {
-            const wxSize padHole = pad->GetDrillSize();
+            transformPadsShapesWithClearanceToPolygon( module->PadsList(),
+                                                       aLayerId,
+                                                       aLayerPoly,
+                                                       0,
+                                                       false );
+        }
 
-            if( !padHole.x ) // Not drilled pad like SMD pad
+        // On tech layers, use a poor circle approximation, only for texts (stroke font)
+        module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId,
+                                                               aLayerPoly,
+                                                               0,
+                                                               segcountInStrokeFont,
+                                                               correctionFactorStroke,
+                                                               segcountInStrokeFont );
+
+        // Add the remaining things with dynamic seg count for circles
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, aLayerPoly );
+    }
+
+
+    // Draw non copper zones
+    // /////////////////////////////////////////////////////////////////////
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( !zone->IsOnLayer( aLayerId ) )
                 continue;
 
-            // The hole in the body is inflated by copper thickness.
-            const int inflate = GetCopperThicknessBIU();
+            AddSolidAreasShapesToContainer( zone,
+                                            aLayerContainer,
+                                            aLayerId );
+        }
 
-            // we use the hole diameter to calculate the seg count.
-            // for round holes, padHole.x == padHole.y
-            // for oblong holes, the diameter is the smaller of (padHole.x, padHole.y)
-            const int diam = std::min( padHole.x, padHole.y );
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            ZONE_CONTAINER* zone = m_board->GetArea( ii );
 
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
 
-            if( pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED )
-            {
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly,
-                                                inflate,
-                                                GetNrSegmentsCircle( diam ) );
+            zone->TransformSolidAreasShapesToPolygonSet( aLayerPoly,
+                                                         // Use the same segcount as stroke font
+                                                         segcountInStrokeFont,
+                                                         correctionFactorStroke );
+        }
+    }
 
-                pad->BuildPadDrillShapePolygon( m_through_inner_holes_poly,
-                                                0,
-                                                GetNrSegmentsCircle( diam ) );
-            }
-            else
-            {
-                // If not plated, no copper.
-                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly_NPTH,
-                                                inflate,
-                                                GetNrSegmentsCircle( diam ) );
-            }
+    // This will make a union of all added contours
+    aLayerPoly.Simplify( SHAPE_POLY_SET::PM_FAST );
+}
+
+
+void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
+{
+    destroyHoles();
+
+    #ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_startLayersTime = GetRunningMicroSecs();
+
+    unsigned start_Time = stats_startLayersTime;
+#endif
+
+    PCB_LAYER_ID cu_seq[MAX_CU_LAYERS];
+    LSET     cu_set = LSET::AllCuMask( m_copperLayersCount );
+
+    m_stats_nr_tracks               = 0;
+    m_stats_track_med_width         = 0;
+    m_stats_nr_vias                 = 0;
+    m_stats_via_med_hole_diameter   = 0;
+    m_stats_nr_holes                = 0;
+    m_stats_hole_med_diameter       = 0;
+
+    // Prepare track list, convert in a vector. Calc statistic for the holes
+    // /////////////////////////////////////////////////////////////////////////
+    std::vector< const TRACK *> trackList;
+    trackList.clear();
+    trackList.reserve( m_board->m_Track.GetCount() );
+
+    for( const TRACK* track = m_board->m_Track; track; track = track->Next() )
+    {
+        if( !Is3DLayerEnabled( track->GetLayer() ) ) // Skip non enabled layers
+            continue;
+
+        // Note: a TRACK holds normal segment tracks and
+        // also vias circles (that have also drill values)
+        trackList.push_back( track );
+
+        if( track->Type() == PCB_VIA_T )
+        {
+            const VIA *via = static_cast< const VIA*>( track );
+            m_stats_nr_vias++;
+            m_stats_via_med_hole_diameter += via->GetDrillValue() * m_biuTo3Dunits;
+        }
+        else
+        {
+            m_stats_nr_tracks++;
         }
+
+        m_stats_track_med_width += track->GetWidth() * m_biuTo3Dunits;
     }
 
+    if( m_stats_nr_tracks )
+        m_stats_track_med_width /= (float)m_stats_nr_tracks;
+
+    if( m_stats_nr_vias )
+        m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T08: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
+    printf( "T01: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add modules PADs objects to containers
+    // Prepare copper layers index
     // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    std::vector< PCB_LAYER_ID > layer_id;
+    layer_id.clear();
+    layer_id.reserve( m_copperLayersCount );
+
+    for( unsigned i = 0; i < arrayDim( cu_seq ); ++i )
+        cu_seq[i] = ToLAYER_ID( B_Cu - i );
+
+    for( LSEQ cu = cu_set.Seq( cu_seq, arrayDim( cu_seq ) ); cu; ++cu )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+        const PCB_LAYER_ID curr_layer_id = *cu;
 
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+        if( !Is3DLayerEnabled( curr_layer_id ) ) // Skip non enabled layers
+            continue;
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        layer_id.push_back( curr_layer_id );
+    }
 
-        // ADD PADS
-        for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
+    // User layers are not drawn here, only technical layers
+    std::vector< PCB_LAYER_ID > tech_layer_id;
 
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
+    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
+         seq;
+         ++seq )
+    {
+        const PCB_LAYER_ID curr_layer_id = *seq;
+
+        if( Is3DLayerEnabled( curr_layer_id ) )
+            tech_layer_id.push_back( curr_layer_id );
+    }
+
+    const bool buildCopperPoly = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
+                                 (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY);
+
+    // Find the layers to (re)build.  A layer is kept from the previous build if the hash of
+    // the items (and settings) it was built from did not change, so after an edit only the
+    // layers touched by it are rebuilt.
+    // /////////////////////////////////////////////////////////////////////////
+    struct LAYER_TO_BUILD
+    {
+        PCB_LAYER_ID     layer;
+        bool             isCopper;
+        CBVHCONTAINER2D *container;
+        SHAPE_POLY_SET  *poly;
+    };
+
+    std::vector< LAYER_TO_BUILD > layersToBuild;
+    std::set< PCB_LAYER_ID > enabledLayers;
+
+    enabledLayers.insert( layer_id.begin(), layer_id.end() );
+    enabledLayers.insert( tech_layer_id.begin(), tech_layer_id.end() );
+
+    // Drop the layers that are not displayed anymore
+    for( MAP_CONTAINER_2D::iterator ii = m_layers_container2D.begin();
+         ii != m_layers_container2D.end(); )
+    {
+        const PCB_LAYER_ID curr_layer_id = (ii++)->first;
+
+        if( enabledLayers.find( curr_layer_id ) == enabledLayers.end() )
+            destroyLayer( curr_layer_id );
+    }
+
+    for( PCB_LAYER_ID curr_layer_id : enabledLayers )
+    {
+        const size_t hash = layerItemsHash( curr_layer_id );
+        const std::map< PCB_LAYER_ID, size_t >::const_iterator oldHash =
+                m_layers_hash.find( curr_layer_id );
+
+        if( ( oldHash != m_layers_hash.end() ) && ( oldHash->second == hash ) )
+            continue;
+
+        destroyLayer( curr_layer_id );
+
+        LAYER_TO_BUILD toBuild;
+        toBuild.layer     = curr_layer_id;
+        toBuild.isCopper  = IsCopperLayer( curr_layer_id );
+        toBuild.container = new CBVHCONTAINER2D;
+        toBuild.poly      = NULL;
+
+        m_layers_container2D[curr_layer_id] = toBuild.container;
+
+        if( !toBuild.isCopper || buildCopperPoly )
+        {
+            toBuild.poly = new SHAPE_POLY_SET;
+            m_layers_poly[curr_layer_id] = toBuild.poly;
         }
+
+        m_layers_hash[curr_layer_id] = hash;
+        layersToBuild.push_back( toBuild );
     }
 
+    // Copper layers usually have the most items, so start them first
+    std::stable_partition( layersToBuild.begin(), layersToBuild.end(),
+                           []( const LAYER_TO_BUILD& aLayer ) { return aLayer.isCopper; } );
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
+    printf( "T02: %.3f ms (%u layers to build)\n",
+            (float)( GetRunningMicroSecs() - start_Time ) / 1e3,
+            (unsigned) layersToBuild.size() );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add modules PADs poly contourns
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Create layers" ) );
+
+    // Build each layer as an independent task.  The holes are created meanwhile on this
+    // thread, they do not use the layer containers.
     // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
+    std::atomic<size_t> nextLayer( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            layersToBuild.size() );
+
+    auto build_lambda = [&]()
     {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+        for( size_t i = nextLayer.fetch_add( 1 );
+                    i < layersToBuild.size();
+                    i = nextLayer.fetch_add( 1 ) )
         {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+            const LAYER_TO_BUILD& toBuild = layersToBuild[i];
+
+            if( toBuild.isCopper )
+                createCopperLayer( toBuild.layer, trackList, toBuild.container, toBuild.poly );
+            else
+                createTechLayer( toBuild.layer, toBuild.container, *toBuild.poly );
+
+            // We only need the Solder mask to initialize the BVH
+            // because..?
+            if( (toBuild.layer == B_Mask) || (toBuild.layer == F_Mask) )
+                toBuild.container->BuildBVH();
+        }
+    };
+
+    std::vector<std::future<void>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, build_lambda );
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Create holes" ) );
+
+    // Create VIAS and THTs objects and add it to holes containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    {
+        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+
+        // ADD TRACKS
+        unsigned int nTracks = trackList.size();
 
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+        {
+            const TRACK *track = trackList[trackIdx];
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+            if( !track->IsOnLayer( curr_layer_id ) )
+                continue;
 
-            // ADD PADS
-            for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+            // ADD VIAS and THT
+            if( track->Type() == PCB_VIA_T )
             {
-                // Construct polys
-                // /////////////////////////////////////////////////////////////
-
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                transformPadsShapesWithClearanceToPolygon( module->PadsList(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           true );
-
-                // Micro-wave modules may have items on copper layers
-                module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
-                                                                        *layerPoly,
-                                                                        0,
-                                                                        segcountforcircle,
-                                                                        correctionFactor );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
+                const VIA *via = static_cast< const VIA*>( track );
+                const VIATYPE_T viatype = via->GetViaType();
+                const float holediameter = via->GetDrillValue() * BiuTo3Dunits();
+                const float thickness = GetCopperThickness3DU();
+                const float hole_inner_radius = ( holediameter / 2.0f );
+
+                const SFVEC2F via_center(  via->GetStart().x * m_biuTo3Dunits,
+                                          -via->GetStart().y * m_biuTo3Dunits );
+
+                if( viatype != VIA_THROUGH )
+                {
+
+                    // Add hole objects
+                    // /////////////////////////////////////////////////////////
+
+                    CBVHCONTAINER2D *layerHoleContainer = NULL;
+
+                    // Check if the layer is already created
+                    if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
+                    {
+                        // not found, create a new container
+                        layerHoleContainer = new CBVHCONTAINER2D;
+                        m_layers_holes2D[curr_layer_id] = layerHoleContainer;
+                    }
+                    else
+                    {
+                        // found
+                        layerHoleContainer = m_layers_holes2D[curr_layer_id];
+                    }
+
+                    // Add a hole for this layer
+                    layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
+                                                                  hole_inner_radius + thickness,
+                                                                  *track ) );
+                }
+                else if( lIdx == 0 ) // it only adds once the THT holes
+                {
+                    // Add through hole object
+                    // /////////////////////////////////////////////////////////
+                    m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                                    hole_inner_radius + thickness,
+                                                                    *track ) );
+
+                    m_through_holes_vias_outer.Add(
+                                new CFILLEDCIRCLE2D( via_center,
+                                                     hole_inner_radius + thickness,
+                                                     *track ) );
+
+                    m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
+                                                                    hole_inner_radius,
+                                                                    *track ) );
+
+                    //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
+                    //                                                     hole_inner_radius,
+                    //                                                     *track ) );
+                }
             }
         }
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T10: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add graphic item on copper layers to object containers
+    // Create VIAS and THTs objects and add it to holes containers
     // /////////////////////////////////////////////////////////////////////////
     for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
     {
         const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
 
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        // ADD TRACKS
+        const unsigned int nTracks = trackList.size();
 
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
+        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
+            const TRACK *track = trackList[trackIdx];
+
+            if( !track->IsOnLayer( curr_layer_id ) )
                 continue;
 
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:  // should not exist on copper layers
+            // ADD VIAS and THT
+            if( track->Type() == PCB_VIA_T )
             {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
+                const VIA *via = static_cast< const VIA*>( track );
+                const VIATYPE_T viatype = via->GetViaType();
+
+                if( viatype != VIA_THROUGH )
+                {
+
+                    // Add VIA hole contourns
+                    // /////////////////////////////////////////////////////////
+
+                    // Add outter holes of VIAs
+                    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
+                    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
+
+                    // Check if the layer is already created
+                    if( m_layers_outer_holes_poly.find( curr_layer_id ) ==
+                        m_layers_outer_holes_poly.end() )
+                    {
+                        // not found, create a new container
+                        layerOuterHolesPoly = new SHAPE_POLY_SET;
+                        m_layers_outer_holes_poly[curr_layer_id] = layerOuterHolesPoly;
+
+                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
+                                  m_layers_inner_holes_poly.end() );
+
+                        layerInnerHolesPoly = new SHAPE_POLY_SET;
+                        m_layers_inner_holes_poly[curr_layer_id] = layerInnerHolesPoly;
+                    }
+                    else
+                    {
+                        // found
+                        layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
+
+                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
+                                  m_layers_inner_holes_poly.end() );
 
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+                        layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
+                    }
 
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+                    const int holediameter = via->GetDrillValue();
+                    const int hole_outer_radius = (holediameter / 2) + GetCopperThicknessBIU();
 
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
-            }
-        }
-    }
+                    TransformCircleToPolygon( *layerOuterHolesPoly,
+                                              via->GetStart(),
+                                              hole_outer_radius,
+                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+                    TransformCircleToPolygon( *layerInnerHolesPoly,
+                                              via->GetStart(),
+                                              holediameter / 2,
+                                              GetNrSegmentsCircle( holediameter ) );
+                }
+                else if( lIdx == 0 ) // it only adds once the THT holes
+                {
+                    const int holediameter = via->GetDrillValue();
+                    const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
 
-    // Add graphic item on copper layers to poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+                    // Add through hole contourns
+                    // /////////////////////////////////////////////////////////
+                    TransformCircleToPolygon( m_through_outer_holes_poly,
+                                              via->GetStart(),
+                                              hole_outer_radius,
+                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
 
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+                    TransformCircleToPolygon( m_through_inner_holes_poly,
+                                              via->GetStart(),
+                                              holediameter / 2,
+                                              GetNrSegmentsCircle( holediameter ) );
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+                    // Add samething for vias only
 
-            // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-            for( auto item : m_board->Drawings() )
-            {
-                if( !item->IsOnLayer( curr_layer_id ) )
-                    continue;
+                    TransformCircleToPolygon( m_through_outer_holes_vias_poly,
+                                              via->GetStart(),
+                                              hole_outer_radius,
+                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
 
-                switch( item->Type() )
-                {
-                case PCB_LINE_T:
-                {
-                    const int nrSegments =
-                            GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
-
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
-                                *layerPoly,
-                                0,
-                                nrSegments,
-                                GetCircleCorrectionFactor( nrSegments ) );
-                }
-                break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet(
-                                *layerPoly,
-                                0,
-                                segcountforcircle,
-                                correctionFactor );
-                break;
-
-                default:
-                    wxLogTrace( m_logTrace,
-                                wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                break;
+                    //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
+                    //                          via->GetStart(),
+                    //                          holediameter / 2,
+                    //                          GetNrSegmentsCircle( holediameter ) );
                 }
             }
         }
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T12: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
+    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    if( GetFlag( FL_ZONE ) )
+    // Add holes of modules
+    // /////////////////////////////////////////////////////////////////////////
+    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
     {
-        if( aStatusTextReporter )
-            aStatusTextReporter->Report( _( "Create zones" ) );
-
-        // Add zones objects
-        // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        const D_PAD* pad = module->PadsList();
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        for( ; pad; pad = pad->Next() )
         {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
-                {
-                    const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
-
-                    if( zone == nullptr )
-                        break;
+            const wxSize padHole = pad->GetDrillSize();
 
-                    auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
+            if( !padHole.x )    // Not drilled pad like SMD pad
+                continue;
 
-                    if( layerContainer != m_layers_container2D.end() )
-                        AddSolidAreasShapesToContainer( zone, layerContainer->second,
-                                                        zone->GetLayer() );
-                }
+            // The hole in the body is inflated by copper thickness,
+            // if not plated, no copper
+            const int inflate = (pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED) ?
+                                GetCopperThicknessBIU() : 0;
 
-                threadsFinished++;
-            } );
+            m_stats_nr_holes++;
+            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
+                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
 
-            t.detach();
+            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
+            m_through_holes_inner.Add( createNewPadDrill( pad,       0 ) );
         }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
     }
+    if( m_stats_nr_holes )
+        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "fill zones T13: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
+    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
-    if( GetFlag( FL_ZONE ) &&
-        GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
+    // Add contours of the pad holes (pads can be Circle or Segment holes)
+    // /////////////////////////////////////////////////////////////////////////
+    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
     {
-        // ADD COPPER ZONES
-        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-        {
-            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-            if( zone == nullptr )
-                break;
-
-            auto layerContainer = m_layers_poly.find( zone->GetLayer() );
+        const D_PAD* pad = module->PadsList();
 
-            if( layerContainer != m_layers_poly.end() )
-                zone->TransformSolidAreasShapesToPolygonSet( *layerContainer->second, segcountforcircle, correctionFactor );
-        }
-    }
+        for( ; pad; pad = pad->Next() )
+        {
+            const wxSize padHole = pad->GetDrillSize();
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T14: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+            if( !padHole.x ) // Not drilled pad like SMD pad
+                continue;
 
-    // Simplify layer polygons
-    // /////////////////////////////////////////////////////////////////////////
+            // The hole in the body is inflated by copper thickness.
+            const int inflate = GetCopperThicknessBIU();
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
+            // we use the hole diameter to calculate the seg count.
+            // for round holes, padHole.x == padHole.y
+            // for oblong holes, the diameter is the smaller of (padHole.x, padHole.y)
+            const int diam = std::min( padHole.x, padHole.y );
 
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
 
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
+            if( pad->GetAttribute () != PAD_ATTRIB_HOLE_NOT_PLATED )
             {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
-                {
-                    auto layerPoly = m_layers_poly.find( layer_id[i] );
-
-                    if( layerPoly != m_layers_poly.end() )
-                        // This will make a union of all added contours
-                        layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                }
-
-                threadsFinished++;
-            } );
+                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly,
+                                                inflate,
+                                                GetNrSegmentsCircle( diam ) );
 
-            t.detach();
+                pad->BuildPadDrillShapePolygon( m_through_inner_holes_poly,
+                                                0,
+                                                GetNrSegmentsCircle( diam ) );
+            }
+            else
+            {
+                // If not plated, no copper.
+                pad->BuildPadDrillShapePolygon( m_through_outer_holes_poly_NPTH,
+                                                inflate,
+                                                GetNrSegmentsCircle( diam ) );
+            }
         }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T15: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
+    printf( "T08: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
     start_Time = GetRunningMicroSecs();
 #endif
 
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
+
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    unsigned stats_endLayersTime = GetRunningMicroSecs();
+    start_Time = stats_endLayersTime;
+#endif
+
     // Simplify holes polygon contours
     // /////////////////////////////////////////////////////////////////////////
     if( aStatusTextReporter )
@@ -927,8 +1341,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
 #endif
-    // End Build Copper layers
-
 
     // This will make a union of all added contourns
     m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
@@ -937,247 +1349,10 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
     //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
-#endif
-
-    // Build Tech layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
-    // /////////////////////////////////////////////////////////////////////////
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startTechLayersTime = GetRunningMicroSecs();
-#endif
-
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build Tech layers" ) );
-
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
-
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
-
-    // User layers are not drawn here, only technical layers
-
-    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
-         seq;
-         ++seq )
-    {
-        const PCB_LAYER_ID curr_layer_id = *seq;
-
-        if( !Is3DLayerEnabled( curr_layer_id ) )
-                    continue;
-
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
-
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
-
-        // Add drawing objects
-        // /////////////////////////////////////////////////////////////////////
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            default:
-                break;
-            }
-        }
-
-
-        // Add drawing contours
-        // /////////////////////////////////////////////////////////////////////
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-            {
-                const unsigned int nr_segments =
-                        GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
-
-                ((DRAWSEGMENT*) item)->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                             0,
-                                                                             nr_segments,
-                                                                             0.0 );
-            }
-                break;
-
-            case PCB_TEXT_T:
-                ((TEXTE_PCB*) item)->TransformShapeWithClearanceToPolygonSet( *layerPoly,
-                                                                              0,
-                                                                              segcountInStrokeFont,
-                                                                              1.0 );
-                break;
-
-            default:
-                break;
-            }
-        }
-
-
-        // Add modules tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                D_PAD*  pad = module->PadsList();
-                int     linewidth = g_DrawDefaultLineThickness;
-
-                for( ; pad; pad = pad->Next() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsSegments( pad,
-                                                         layerContainer,
-                                                         linewidth );
-                }
-            }
-            else
-            {
-                AddPadsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0,
-                                                       false );
-            }
-
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
-
-
-        // Add modules tech layers - contours
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                D_PAD*  pad = module->PadsList();
-                const int linewidth = g_DrawDefaultLineThickness;
-
-                for( ; pad; pad = pad->Next() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                transformPadsShapesWithClearanceToPolygon( module->PadsList(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           false );
-            }
-
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
-                                                                   *layerPoly,
-                                                                   0,
-                                                                   segcountInStrokeFont,
-                                                                   correctionFactorStroke,
-                                                                   segcountInStrokeFont );
-
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-        }
-
-
-        // Draw non copper zones
-        // /////////////////////////////////////////////////////////////////////
-        if( GetFlag( FL_ZONE ) )
-        {
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                AddSolidAreasShapesToContainer( zone,
-                                                layerContainer,
-                                                curr_layer_id );
-            }
-
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly,
-                                                             // Use the same segcount as stroke font
-                                                             segcountInStrokeFont,
-                                                             correctionFactorStroke );
-            }
-        }
-
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-    }
-    // End Build Tech layers
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endTechLayersTime = GetRunningMicroSecs();
-#endif
-
-
-    // Build BVH for holes and vias
-    // /////////////////////////////////////////////////////////////////////////
-
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_startHolesBVHTime = GetRunningMicroSecs();
 #endif
+
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Build BVH for holes and vias" ) );
 
@@ -1194,24 +1369,14 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         }
     }
 
-    // We only need the Solder mask to initialize the BVH
-    // because..?
-    if( (CBVHCONTAINER2D *)m_layers_container2D[B_Mask] )
-        ((CBVHCONTAINER2D *)m_layers_container2D[B_Mask])->BuildBVH();
-
-    if( (CBVHCONTAINER2D *)m_layers_container2D[F_Mask] )
-        ((CBVHCONTAINER2D *)m_layers_container2D[F_Mask])->BuildBVH();
-
 #ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endHolesBVHTime = GetRunningMicroSecs();
 
     printf( "CINFO3D_VISU::createLayers times\n" );
-    printf( "  Copper Layers:          %.3f ms\n",
-            (float)( stats_endCopperLayersTime  - stats_startCopperLayersTime  ) / 1e3 );
+    printf( "  Layers and holes:       %.3f ms\n",
+            (float)( stats_endLayersTime        - stats_startLayersTime        ) / 1e3 );
     printf( "  Holes BVH creation:     %.3f ms\n",
             (float)( stats_endHolesBVHTime      - stats_startHolesBVHTime      ) / 1e3 );
-    printf( "  Tech Layers:            %.3f ms\n",
-            (float)( stats_endTechLayersTime    - stats_startTechLayersTime    ) / 1e3 );
     printf( "Statistics:\n" );
     printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
     printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
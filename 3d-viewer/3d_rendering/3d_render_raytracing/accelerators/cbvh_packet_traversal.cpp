@@ -132,22 +132,45 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                                                     ia,
                                                     aHitInfoPacket );
 
-                for( int j = 0; j < curCell->nPrimitives; ++j )
-                {
-                    const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
+                const int firstBlock = m_nodeTriangleBlock[nodeNum];
 
-                    if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                if( firstBlock >= 0 )
+                {
+                    // Leaf of triangles: test each ray against four triangles at once
+                    for( unsigned int i = ia; i < ie; ++i )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
-                        {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
+                        const bool hitted = intersectTriangles( *curCell,
+                                                                firstBlock,
+                                                                aRayPacket.m_ray[i],
                                                                 aHitInfoPacket[i].m_HitInfo );
 
-                            if( hitted )
+                        if( hitted )
+                        {
+                            anyHitted |= hitted;
+                            aHitInfoPacket[i].m_hitresult |= hitted;
+                            aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                        }
+                    }
+                }
+                else
+                {
+                    for( int j = 0; j < curCell->nPrimitives; ++j )
+                    {
+                        const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
+
+                        if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                        {
+                            for( unsigned int i = ia; i < ie; ++i )
                             {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                                const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
+                                                                    aHitInfoPacket[i].m_HitInfo );
+
+                                if( hitted )
+                                {
+                                    anyHitted |= hitted;
+                                    aHitInfoPacket[i].m_hitresult |= hitted;
+                                    aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
+                                }
                             }
                         }
                     }
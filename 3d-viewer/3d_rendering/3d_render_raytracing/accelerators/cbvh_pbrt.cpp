@@ -304,6 +304,8 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
 
     wxASSERT( offset == (unsigned int)totalNodes );
 
+    buildTriangleBlocks( totalNodes );
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     uint32_t treeBytes = totalNodes * sizeof( LinearBVHNode ) + sizeof( *this ) +
                          m_primitives.size() * sizeof( m_primitives[0] ) +
@@ -1152,16 +1154,29 @@ bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
         {
             if( node->nPrimitives > 0 )
             {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
+                const int firstBlock = m_nodeTriangleBlock[nodeNum];
+
+                if( firstBlock >= 0 )
                 {
-                    if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
-                                                                             aHitInfo ) )
+                    if( intersectTriangles( *node, firstBlock, aRay, aHitInfo ) )
                     {
                         aHitInfo.m_acc_node_info = nodeNum;
                         hit = true;
                     }
                 }
+                else
+                {
+                    // Intersect ray with primitives in leaf BVH node
+                    for( int i = 0; i < node->nPrimitives; ++i )
+                    {
+                        if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
+                                                                                 aHitInfo ) )
+                        {
+                            aHitInfo.m_acc_node_info = nodeNum;
+                            hit = true;
+                        }
+                    }
+                }
             }
             else
             {
@@ -1219,14 +1234,24 @@ bool CBVH_PBRT::Intersect( const RAY &aRay,
         {
             if( node->nPrimitives > 0 )
             {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
+                const int firstBlock = m_nodeTriangleBlock[nodeNum];
+
+                if( firstBlock >= 0 )
                 {
-                    if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
-                                                                             aHitInfo ) )
-                    {
-                        //aHitInfo.m_acc_node_info = nodeNum;
+                    if( intersectTriangles( *node, firstBlock, aRay, aHitInfo ) )
                         hit = true;
+                }
+                else
+                {
+                    // Intersect ray with primitives in leaf BVH node
+                    for( int i = 0; i < node->nPrimitives; ++i )
+                    {
+                        if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
+                                                                                 aHitInfo ) )
+                        {
+                            //aHitInfo.m_acc_node_info = nodeNum;
+                            hit = true;
+                        }
                     }
                 }
             }
@@ -1282,14 +1307,24 @@ bool CBVH_PBRT::IntersectP( const RAY &aRay, float aMaxDistance ) const
         {
             if( node->nPrimitives > 0 )
             {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
+                const int firstBlock = m_nodeTriangleBlock[nodeNum];
+
+                if( firstBlock >= 0 )
                 {
-                    const COBJECT *obj = m_primitives[node->primitivesOffset + i];
+                    if( intersectPTriangles( *node, firstBlock, aRay, aMaxDistance ) )
+                        return true;
+                }
+                else
+                {
+                    // Intersect ray with primitives in leaf BVH node
+                    for( int i = 0; i < node->nPrimitives; ++i )
+                    {
+                        const COBJECT *obj = m_primitives[node->primitivesOffset + i];
 
-                    if( obj->GetMaterial()->GetCastShadows() )
-                        if( obj->IntersectP( aRay, aMaxDistance ) )
-                            return true;
+                        if( obj->GetMaterial()->GetCastShadows() )
+                            if( obj->IntersectP( aRay, aMaxDistance ) )
+                                return true;
+                    }
                 }
             }
             else
@@ -1318,3 +1353,100 @@ bool CBVH_PBRT::IntersectP( const RAY &aRay, float aMaxDistance ) const
 
     return false;
 }
+
+
+void CBVH_PBRT::buildTriangleBlocks( int aTotalNodes )
+{
+    m_triangleBlocks.clear();
+    m_nodeTriangleBlock.assign( aTotalNodes, -1 );
+
+    for( int nodeNum = 0; nodeNum < aTotalNodes; ++nodeNum )
+    {
+        const LinearBVHNode &node = m_nodes[nodeNum];
+
+        if( node.nPrimitives == 0 )
+            continue;
+
+        bool onlyTriangles = true;
+
+        for( int i = 0; (i < node.nPrimitives) && onlyTriangles; ++i )
+        {
+            const COBJECT *obj = m_primitives[node.primitivesOffset + i];
+
+            onlyTriangles = ( obj->GetObjectType() == OBJ3D_TRIANGLE );
+        }
+
+        if( !onlyTriangles )
+            continue;
+
+        m_nodeTriangleBlock[nodeNum] = m_triangleBlocks.size();
+
+        for( int i = 0; i < node.nPrimitives; i += 4 )
+        {
+            CTRIANGLE4 block;
+
+            for( int lane = 0; (lane < 4) && ((i + lane) < node.nPrimitives); ++lane )
+            {
+                const COBJECT *obj = m_primitives[node.primitivesOffset + i + lane];
+
+                block.Set( lane, *static_cast<const CTRIANGLE *>( obj ) );
+            }
+
+            m_triangleBlocks.push_back( block );
+        }
+    }
+}
+
+
+bool CBVH_PBRT::intersectTriangles( const LinearBVHNode &aNode,
+                                    int aFirstBlock,
+                                    const RAY &aRay,
+                                    HITINFO &aHitInfo ) const
+{
+    bool hit = false;
+
+    for( int i = 0; i < aNode.nPrimitives; i += 4 )
+    {
+        const CTRIANGLE4 &block = m_triangleBlocks[aFirstBlock + i / 4];
+
+        // The block only tells which triangles may be hit, they fill the hit info
+        for( unsigned int lanes = block.Intersect( aRay, aHitInfo.m_tHit ), lane = 0;
+             lanes;
+             lanes >>= 1, ++lane )
+        {
+            if( lanes & 1 )
+                if( m_primitives[aNode.primitivesOffset + i + lane]->Intersect( aRay, aHitInfo ) )
+                    hit = true;
+        }
+    }
+
+    return hit;
+}
+
+
+bool CBVH_PBRT::intersectPTriangles( const LinearBVHNode &aNode,
+                                     int aFirstBlock,
+                                     const RAY &aRay,
+                                     float aMaxDistance ) const
+{
+    for( int i = 0; i < aNode.nPrimitives; i += 4 )
+    {
+        const CTRIANGLE4 &block = m_triangleBlocks[aFirstBlock + i / 4];
+
+        for( unsigned int lanes = block.Intersect( aRay, aMaxDistance ), lane = 0;
+             lanes;
+             lanes >>= 1, ++lane )
+        {
+            if( lanes & 1 )
+            {
+                const COBJECT *obj = m_primitives[aNode.primitivesOffset + i + lane];
+
+                if( obj->GetMaterial()->GetCastShadows() )
+                    if( obj->IntersectP( aRay, aMaxDistance ) )
+                        return true;
+            }
+        }
+    }
+
+    return false;
+}
@@ -71,7 +71,9 @@
 #define _CBVH_PBRT_H_
 
 #include "caccelerator.h"
+#include "../shapes3D/ctriangle4.h"
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 // Forward Declarations
@@ -153,6 +155,22 @@ private:
     int flattenBVHTree( BVHBuildNode *node,
                         uint32_t *offset );
 
+    /**
+     * Packs the triangles of the leaves made only of CTRIANGLEs in CTRIANGLE4 blocks.
+     */
+    void buildTriangleBlocks( int aTotalNodes );
+
+    /// Intersects a ray with the triangles of a leaf, using its CTRIANGLE4 blocks
+    bool intersectTriangles( const LinearBVHNode &aNode,
+                             int aFirstBlock,
+                             const RAY &aRay,
+                             HITINFO &aHitInfo ) const;
+
+    bool intersectPTriangles( const LinearBVHNode &aNode,
+                              int aFirstBlock,
+                              const RAY &aRay,
+                              float aMaxDistance ) const;
+
     // BVH Private Data
     const int           m_maxPrimsInNode;
     SPLITMETHOD         m_splitMethod;
@@ -161,6 +179,12 @@ private:
 
     std::list<void *> m_addresses_pointer_to_mm_free;
 
+    /// Triangles of the leaves made only of triangles, four by block
+    std::vector<CTRIANGLE4> m_triangleBlocks;
+
+    /// First block of the triangles of each node, or -1 if it is not a leaf of triangles
+    std::vector<int> m_nodeTriangleBlock;
+
     // Partition traversal
     unsigned int m_I[RAYPACKET_RAYS_PER_PACKET];
 };
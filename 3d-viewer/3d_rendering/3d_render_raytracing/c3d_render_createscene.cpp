@@ -251,6 +251,7 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
     m_reloadRequested = false;
 
     m_model_materials.clear();
+    free_3D_model_meshes();
 
     COBJECT2D_STATS::Instance().ResetStats();
     COBJECT3D_STATS::Instance().ResetStats();
@@ -1243,13 +1244,15 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
                                             SFVEC3F( 0.0f, 0.0f, 1.0f ) );
             }
 
+            // The module matrix is a rigid transformation, so the models placed with it can
+            // share their meshes with the other modules. The scale goes to the model matrix.
             const double modelunit_to_3d_units_factor = m_settings.BiuTo3Dunits() *
                                                         UNITS3D_TO_UNITSPCB;
 
-            moduleMatrix = glm::scale( moduleMatrix,
-                                       SFVEC3F( modelunit_to_3d_units_factor,
-                                                modelunit_to_3d_units_factor,
-                                                modelunit_to_3d_units_factor ) );
+            const glm::mat4 unitsMatrix = glm::scale( glm::mat4( 1.0f ),
+                                                      SFVEC3F( modelunit_to_3d_units_factor,
+                                                               modelunit_to_3d_units_factor,
+                                                               modelunit_to_3d_units_factor ) );
 
 
             // Get the list of model files for this model
@@ -1265,7 +1268,7 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
                 // only add it if the return is not NULL
                 if( modelPtr )
                 {
-                    glm::mat4 modelMatrix = moduleMatrix;
+                    glm::mat4 modelMatrix = unitsMatrix;
 
                     modelMatrix = glm::translate( modelMatrix,
                                                   SFVEC3F( sM->m_Offset.x,
@@ -1292,7 +1295,7 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
                                                        sM->m_Scale.y,
                                                        sM->m_Scale.z ) );
 
-                    add_3D_models( modelPtr, modelMatrix );
+                    add_3D_models( modelPtr, moduleMatrix, modelMatrix );
                 }
 
                 ++sM;
@@ -1303,6 +1306,7 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
 
 
 void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
+                                           const glm::mat4 &aPlacementMatrix,
                                            const glm::mat4 &aModelMatrix )
 {
 
@@ -1449,98 +1453,148 @@ void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
             }
         }
 
-        const glm::mat3 normalMatrix = glm::transpose( glm::inverse( glm::mat3( aModelMatrix ) ) );
+        CMODEL_MESH *modelMesh = get_3D_model_mesh( a3DModel, aModelMatrix, *materialVector );
 
-        for( unsigned int mesh_i = 0;
-             mesh_i < a3DModel->m_MeshesSize;
-             ++mesh_i )
+        if( modelMesh )
+            m_object_container.Add( new CMODEL_INSTANCE( modelMesh, aPlacementMatrix ) );
+    }
+}
+
+
+CMODEL_MESH *C3D_RENDER_RAYTRACING::get_3D_model_mesh( const S3DMODEL *a3DModel,
+                                                       const glm::mat4 &aModelMatrix,
+                                                       const MODEL_MATERIALS &aMaterials )
+{
+    // Look for a mesh already built for this model and matrix
+    MODEL_MESHES &meshes = m_model_meshes[a3DModel];
+
+    for( unsigned int i = 0; i < meshes.size(); ++i )
+    {
+        if( meshes[i].first == aModelMatrix )
+            return meshes[i].second;
+    }
+
+    CMODEL_MESH *modelMesh = new CMODEL_MESH;
+
+    const glm::mat3 normalMatrix = glm::transpose( glm::inverse( glm::mat3( aModelMatrix ) ) );
+
+    for( unsigned int mesh_i = 0;
+         mesh_i < a3DModel->m_MeshesSize;
+         ++mesh_i )
+    {
+        const SMESH &mesh = a3DModel->m_Meshes[mesh_i];
+
+        // Validate the mesh pointers
+        wxASSERT( mesh.m_Positions != NULL );
+        wxASSERT( mesh.m_FaceIdx != NULL );
+        wxASSERT( mesh.m_Normals != NULL );
+        wxASSERT( mesh.m_FaceIdxSize > 0 );
+        wxASSERT( (mesh.m_FaceIdxSize % 3) == 0 );
+
+
+        if( (mesh.m_Positions != NULL) &&
+            (mesh.m_Normals != NULL) &&
+            (mesh.m_FaceIdx != NULL) &&
+            (mesh.m_FaceIdxSize > 0) &&
+            (mesh.m_VertexSize > 0) &&
+            ((mesh.m_FaceIdxSize % 3) == 0) &&
+            (mesh.m_MaterialIdx < a3DModel->m_MaterialsSize) )
         {
-            const SMESH &mesh = a3DModel->m_Meshes[mesh_i];
-
-            // Validate the mesh pointers
-            wxASSERT( mesh.m_Positions != NULL );
-            wxASSERT( mesh.m_FaceIdx != NULL );
-            wxASSERT( mesh.m_Normals != NULL );
-            wxASSERT( mesh.m_FaceIdxSize > 0 );
-            wxASSERT( (mesh.m_FaceIdxSize % 3) == 0 );
-
-
-            if( (mesh.m_Positions != NULL) &&
-                (mesh.m_Normals != NULL) &&
-                (mesh.m_FaceIdx != NULL) &&
-                (mesh.m_FaceIdxSize > 0) &&
-                (mesh.m_VertexSize > 0) &&
-                ((mesh.m_FaceIdxSize % 3) == 0) &&
-                (mesh.m_MaterialIdx < a3DModel->m_MaterialsSize) )
-            {
-                const CBLINN_PHONG_MATERIAL &blinn_material = (*materialVector)[mesh.m_MaterialIdx];
+            const CBLINN_PHONG_MATERIAL &blinn_material = aMaterials[mesh.m_MaterialIdx];
 
-                // Add all face triangles
-                for( unsigned int faceIdx = 0;
-                     faceIdx < mesh.m_FaceIdxSize;
-                     faceIdx += 3 )
-                {
-                    const unsigned int idx0 = mesh.m_FaceIdx[faceIdx + 0];
-                    const unsigned int idx1 = mesh.m_FaceIdx[faceIdx + 1];
-                    const unsigned int idx2 = mesh.m_FaceIdx[faceIdx + 2];
+            // Add all face triangles
+            for( unsigned int faceIdx = 0;
+                 faceIdx < mesh.m_FaceIdxSize;
+                 faceIdx += 3 )
+            {
+                const unsigned int idx0 = mesh.m_FaceIdx[faceIdx + 0];
+                const unsigned int idx1 = mesh.m_FaceIdx[faceIdx + 1];
+                const unsigned int idx2 = mesh.m_FaceIdx[faceIdx + 2];
 
-                    wxASSERT( idx0 < mesh.m_VertexSize );
-                    wxASSERT( idx1 < mesh.m_VertexSize );
-                    wxASSERT( idx2 < mesh.m_VertexSize );
+                wxASSERT( idx0 < mesh.m_VertexSize );
+                wxASSERT( idx1 < mesh.m_VertexSize );
+                wxASSERT( idx2 < mesh.m_VertexSize );
 
-                    if( ( idx0 < mesh.m_VertexSize ) &&
-                        ( idx1 < mesh.m_VertexSize ) &&
-                        ( idx2 < mesh.m_VertexSize ) )
-                    {
-                        const SFVEC3F &v0 = mesh.m_Positions[idx0];
-                        const SFVEC3F &v1 = mesh.m_Positions[idx1];
-                        const SFVEC3F &v2 = mesh.m_Positions[idx2];
+                if( ( idx0 < mesh.m_VertexSize ) &&
+                    ( idx1 < mesh.m_VertexSize ) &&
+                    ( idx2 < mesh.m_VertexSize ) )
+                {
+                    const SFVEC3F &v0 = mesh.m_Positions[idx0];
+                    const SFVEC3F &v1 = mesh.m_Positions[idx1];
+                    const SFVEC3F &v2 = mesh.m_Positions[idx2];
 
-                        const SFVEC3F &n0 = mesh.m_Normals[idx0];
-                        const SFVEC3F &n1 = mesh.m_Normals[idx1];
-                        const SFVEC3F &n2 = mesh.m_Normals[idx2];
+                    const SFVEC3F &n0 = mesh.m_Normals[idx0];
+                    const SFVEC3F &n1 = mesh.m_Normals[idx1];
+                    const SFVEC3F &n2 = mesh.m_Normals[idx2];
 
-                        // Transform vertex with the model matrix
-                        const SFVEC3F vt0 = SFVEC3F( aModelMatrix * glm::vec4( v0, 1.0f) );
-                        const SFVEC3F vt1 = SFVEC3F( aModelMatrix * glm::vec4( v1, 1.0f) );
-                        const SFVEC3F vt2 = SFVEC3F( aModelMatrix * glm::vec4( v2, 1.0f) );
+                    // Transform vertex with the model matrix
+                    const SFVEC3F vt0 = SFVEC3F( aModelMatrix * glm::vec4( v0, 1.0f) );
+                    const SFVEC3F vt1 = SFVEC3F( aModelMatrix * glm::vec4( v1, 1.0f) );
+                    const SFVEC3F vt2 = SFVEC3F( aModelMatrix * glm::vec4( v2, 1.0f) );
 
-                        const SFVEC3F nt0 = glm::normalize( SFVEC3F( normalMatrix * n0 ) );
-                        const SFVEC3F nt1 = glm::normalize( SFVEC3F( normalMatrix * n1 ) );
-                        const SFVEC3F nt2 = glm::normalize( SFVEC3F( normalMatrix * n2 ) );
+                    const SFVEC3F nt0 = glm::normalize( SFVEC3F( normalMatrix * n0 ) );
+                    const SFVEC3F nt1 = glm::normalize( SFVEC3F( normalMatrix * n1 ) );
+                    const SFVEC3F nt2 = glm::normalize( SFVEC3F( normalMatrix * n2 ) );
 
-                        CTRIANGLE *newTriangle = new  CTRIANGLE( vt0, vt2, vt1,
-                                                                 nt0, nt2, nt1 );
+                    CTRIANGLE *newTriangle = new  CTRIANGLE( vt0, vt2, vt1,
+                                                             nt0, nt2, nt1 );
 
 
 
-                        m_object_container.Add( newTriangle );
-                        newTriangle->SetMaterial( (const CMATERIAL *)&blinn_material );
+                    modelMesh->Add( newTriangle );
+                    newTriangle->SetMaterial( (const CMATERIAL *)&blinn_material );
 
-                        if( mesh.m_Color == NULL )
-                        {
-                            const SFVEC3F diffuseColor =
-                                a3DModel->m_Materials[mesh.m_MaterialIdx].m_Diffuse;
+                    if( mesh.m_Color == NULL )
+                    {
+                        const SFVEC3F diffuseColor =
+                            a3DModel->m_Materials[mesh.m_MaterialIdx].m_Diffuse;
 
-                            if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
-                                newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( diffuseColor ) ) );
-                            else
-                                newTriangle->SetColor( ConvertSRGBToLinear( diffuseColor ) );
-                        }
+                        if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
+                            newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( diffuseColor ) ) );
                         else
-                        {
-                            if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
-                                newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx0] ) ),
-                                                       ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx1] ) ),
-                                                       ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx2] ) ) );
-                            else
-                                newTriangle->SetColor( ConvertSRGBToLinear( mesh.m_Color[idx0] ),
-                                                       ConvertSRGBToLinear( mesh.m_Color[idx1] ),
-                                                       ConvertSRGBToLinear( mesh.m_Color[idx2] ) );
-                        }
+                            newTriangle->SetColor( ConvertSRGBToLinear( diffuseColor ) );
+                    }
+                    else
+                    {
+                        if( m_settings.MaterialModeGet() == MATERIAL_MODE_CAD_MODE )
+                            newTriangle->SetColor( ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx0] ) ),
+                                                   ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx1] ) ),
+                                                   ConvertSRGBToLinear( MaterialDiffuseToColorCAD( mesh.m_Color[idx2] ) ) );
+                        else
+                            newTriangle->SetColor( ConvertSRGBToLinear( mesh.m_Color[idx0] ),
+                                                   ConvertSRGBToLinear( mesh.m_Color[idx1] ),
+                                                   ConvertSRGBToLinear( mesh.m_Color[idx2] ) );
                     }
                 }
             }
         }
     }
+
+    if( modelMesh->IsEmpty() )
+    {
+        delete modelMesh;
+        modelMesh = NULL;
+    }
+    else
+    {
+        modelMesh->Build();
+    }
+
+    meshes.push_back( std::make_pair( aModelMatrix, modelMesh ) );
+
+    return modelMesh;
+}
+
+
+void C3D_RENDER_RAYTRACING::free_3D_model_meshes()
+{
+    for( MAP_MODEL_MESHES::iterator it = m_model_meshes.begin();
+         it != m_model_meshes.end();
+         ++it )
+    {
+        for( unsigned int i = 0; i < it->second.size(); ++i )
+            delete it->second[i].second;
+    }
+
+    m_model_meshes.clear();
 }
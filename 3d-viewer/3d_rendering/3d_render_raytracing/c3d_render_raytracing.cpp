@@ -32,6 +32,7 @@
 #include <atomic>
 #include <chrono>
 #include <climits>
+#include <future>
 #include <thread>
 
 #include "c3d_render_raytracing.h"
@@ -82,6 +83,8 @@ C3D_RENDER_RAYTRACING::~C3D_RENDER_RAYTRACING()
     delete m_accelerator;
     m_accelerator = NULL;
 
+    free_3D_model_meshes();
+
     delete m_outlineBoard2dObjects;
     m_outlineBoard2dObjects = NULL;
 
@@ -326,6 +329,14 @@ void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextRepor
 
         m_BgColorTop_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_settings.m_BgColorTop );
         m_BgColorBot_LinearRGB = ConvertSRGBToLinear( (SFVEC3F)m_settings.m_BgColorBot );
+
+        // Show a low resolution image of the new view first (unless there is one already),
+        // the full resolution blocks will be traced over it on the next redraws
+        if( !m_isPreview && ( m_settings.RenderEngineGet() != RENDER_ENGINE_OPENGL_LEGACY ) )
+        {
+            render_preview( ptrPBO );
+            return;
+        }
     }
 
     switch( m_rt_render_state )
@@ -366,45 +377,46 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
     m_isPreview = false;
 
     auto startTime = std::chrono::steady_clock::now();
-    bool breakLoop = false;
+    std::atomic<bool> breakLoop( false );
 
     std::atomic<size_t> numBlocksRendered( 0 );
     std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
     size_t parallelThreadCount = std::min<size_t>(
             std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
             m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+
+    // The blocks are handed out from the centre of the window outwards.  The workers give up
+    // after a time slice, so the progress is displayed and a camera move restarts the frame
+    // without waiting for the remaining blocks.
+    auto trace_lambda = [&]()
     {
-        std::thread t = std::thread( [&]()
+        for( size_t iBlock = currentBlock.fetch_add( 1 );
+                    iBlock < m_blockPositions.size() && !breakLoop;
+                    iBlock = currentBlock.fetch_add( 1 ) )
         {
-            for( size_t iBlock = currentBlock.fetch_add( 1 );
-                        iBlock < m_blockPositions.size() && !breakLoop;
-                        iBlock = currentBlock.fetch_add( 1 ) )
+            if( !m_blockPositionsWasProcessed[iBlock] )
             {
-                if( !m_blockPositionsWasProcessed[iBlock] )
-                {
-                    rt_render_trace_block( ptrPBO, iBlock );
-                    numBlocksRendered++;
-                    m_blockPositionsWasProcessed[iBlock] = 1;
-
-                    // Check if it spend already some time render and request to exit
-                    // to display the progress
-                    if( std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - startTime ).count() > 150 )
-                        breakLoop = true;
-                }
+                rt_render_trace_block( ptrPBO, iBlock );
+                numBlocksRendered++;
+                m_blockPositionsWasProcessed[iBlock] = 1;
+
+                // Check if it spend already some time render and request to exit
+                // to display the progress
+                if( std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startTime ).count() > 150 )
+                    breakLoop = true;
             }
+        }
+    };
 
-            threadsFinished++;
-        } );
+    std::vector<std::future<void>> returns( parallelThreadCount );
 
-        t.detach();
-    }
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, trace_lambda );
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
 
     m_nrBlocksRenderProgress += numBlocksRendered;
 
@@ -532,6 +544,7 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
                                                 const HITINFO_PACKET *aHitPck_X0Y0,
                                                 const HITINFO_PACKET *aHitPck_AA_X1Y1,
                                                 const RAY *aRayPck,
+                                                const bool *aPixelNeedsAA,
                                                 SFVEC3F *aOutHitColor )
 {
     const bool is_testShadow =  m_settings.GetFlag( FL_RENDER_RAYTRACING_SHADOWS );
@@ -540,6 +553,10 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
     {
         for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
+            // Keep the preset color
+            if( !aPixelNeedsAA[i] )
+                continue;
+
             const RAY &rayAA = aRayPck[i];
 
             HITINFO hitAA;
@@ -655,6 +672,27 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
 
 #define DISP_FACTOR 0.075f
 
+// Largest difference (in linear RGB) between two samples that does not need anti aliasing
+#define AA_COLOR_THRESHOLD 0.015f
+
+/**
+ * Returns true if two samples hit different things or got visibly different colors,
+ * so the pixel between them is on an edge and needs anti aliasing.
+ */
+static bool samplesDiffer( const HITINFO_PACKET &aHitA, const SFVEC3F &aColorA,
+                           const HITINFO_PACKET &aHitB, const SFVEC3F &aColorB )
+{
+    if( aHitA.m_hitresult != aHitB.m_hitresult )
+        return true;
+
+    if( aHitA.m_hitresult && ( aHitA.m_HitInfo.pHitObject != aHitB.m_HitInfo.pHitObject ) )
+        return true;
+
+    const SFVEC3F diff = glm::abs( aColorA - aColorB );
+
+    return glm::max( diff.r, glm::max( diff.g, diff.b ) ) > AA_COLOR_THRESHOLD;
+}
+
 void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                                                    signed int iBlock )
 {
@@ -788,6 +826,33 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                               );
         }
 
+        // Only the pixels on an edge get the extra samples, the others keep the average of
+        // the two samples taken so far.  A pixel is compared with its second sample and with
+        // its right and bottom neighbours, as these are the directions the extra samples go.
+        bool pixelNeedsAA[RAYPACKET_RAYS_PER_PACKET];
+        bool blockNeedsAA = false;
+
+        for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+        {
+            for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+            {
+                bool needsAA = samplesDiffer( hitPacket_X0Y0[i], hitColor_X0Y0[i],
+                                              hitPacket_AA_X1Y1[i], hitColor_AA_X1Y1[i] );
+
+                if( !needsAA && ( x < (RAYPACKET_DIM - 1) ) )
+                    needsAA = samplesDiffer( hitPacket_X0Y0[i], hitColor_X0Y0[i],
+                                             hitPacket_X0Y0[i + 1], hitColor_X0Y0[i + 1] );
+
+                if( !needsAA && ( y < (RAYPACKET_DIM - 1) ) )
+                    needsAA = samplesDiffer( hitPacket_X0Y0[i], hitColor_X0Y0[i],
+                                             hitPacket_X0Y0[i + RAYPACKET_DIM],
+                                             hitColor_X0Y0[i + RAYPACKET_DIM] );
+
+                pixelNeedsAA[i] = needsAA;
+                blockNeedsAA |= needsAA;
+            }
+        }
+
         SFVEC3F hitColor_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
         SFVEC3F hitColor_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
         SFVEC3F hitColor_AA_X0Y1_half[RAYPACKET_RAYS_PER_PACKET];
@@ -802,39 +867,45 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
             hitColor_AA_X0Y1_half[i] = color_average;
         }
 
-        RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
-
-        RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
-                                               (SFVEC2F)blockPosI + SFVEC2F(0.5f - DISP_FACTOR, DISP_FACTOR),
-                                               SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
-                                               blockRayPck_AA_X1Y0 );
-
-        RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
-                                               (SFVEC2F)blockPosI + SFVEC2F(DISP_FACTOR, 0.5f - DISP_FACTOR),
-                                               SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
-                                               blockRayPck_AA_X0Y1 );
-
-        RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
-                                               (SFVEC2F)blockPosI + SFVEC2F(0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR),
-                                               SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
-                                               blockRayPck_AA_X1Y1_half );
-
-        rt_trace_AA_packet( bgColor,
-                            hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                            blockRayPck_AA_X1Y0,
-                            hitColor_AA_X1Y0 );
-
-        rt_trace_AA_packet( bgColor,
-                            hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                            blockRayPck_AA_X0Y1,
-                            hitColor_AA_X0Y1 );
-
-        rt_trace_AA_packet( bgColor,
-                            hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                            blockRayPck_AA_X1Y1_half,
-                            hitColor_AA_X0Y1_half );
+        if( blockNeedsAA )
+        {
+            RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
+            RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
+            RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
+
+            RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
+                                                   (SFVEC2F)blockPosI + SFVEC2F(0.5f - DISP_FACTOR, DISP_FACTOR),
+                                                   SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
+                                                   blockRayPck_AA_X1Y0 );
+
+            RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
+                                                   (SFVEC2F)blockPosI + SFVEC2F(DISP_FACTOR, 0.5f - DISP_FACTOR),
+                                                   SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
+                                                   blockRayPck_AA_X0Y1 );
+
+            RAYPACKET_InitRays_with2DDisplacement( m_settings.CameraGet(),
+                                                   (SFVEC2F)blockPosI + SFVEC2F(0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR),
+                                                   SFVEC2F(DISP_FACTOR, DISP_FACTOR), // Displacement random factor
+                                                   blockRayPck_AA_X1Y1_half );
+
+            rt_trace_AA_packet( bgColor,
+                                hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                blockRayPck_AA_X1Y0,
+                                pixelNeedsAA,
+                                hitColor_AA_X1Y0 );
+
+            rt_trace_AA_packet( bgColor,
+                                hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                blockRayPck_AA_X0Y1,
+                                pixelNeedsAA,
+                                hitColor_AA_X0Y1 );
+
+            rt_trace_AA_packet( bgColor,
+                                hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                blockRayPck_AA_X1Y1_half,
+                                pixelNeedsAA,
+                                hitColor_AA_X0Y1_half );
+        }
 
         // Average the result
         for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
@@ -1087,628 +1158,626 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
     m_isPreview = true;
 
     std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
     size_t parallelThreadCount = std::min<size_t>(
             std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
             m_blockPositions.size() );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+
+    auto preview_lambda = [&]()
     {
-        std::thread t = std::thread( [&]()
+        for( size_t iBlock = nextBlock.fetch_add( 1 );
+                    iBlock < m_blockPositionsFast.size();
+                    iBlock = nextBlock.fetch_add( 1 ) )
         {
-            for( size_t iBlock = nextBlock.fetch_add( 1 );
-                        iBlock < m_blockPositionsFast.size();
-                        iBlock = nextBlock.fetch_add( 1 ) )
-            {
-                const SFVEC2UI &windowPosUI = m_blockPositionsFast[ iBlock ];
-                const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
-                                                    windowPosUI.y + m_yoffset );
+            const SFVEC2UI &windowPosUI = m_blockPositionsFast[ iBlock ];
+            const SFVEC2I windowsPos = SFVEC2I( windowPosUI.x + m_xoffset,
+                                                windowPosUI.y + m_yoffset );
 
-                RAYPACKET blockPacket( m_settings.CameraGet(), windowsPos, 4 );
+            RAYPACKET blockPacket( m_settings.CameraGet(), windowsPos, 4 );
 
-                HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
-
-                // Initialize hitPacket with a "not hit" information
-                for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-                {
-                    hitPacket[i].m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
-                    hitPacket[i].m_HitInfo.m_acc_node_info = 0;
-                    hitPacket[i].m_hitresult = false;
-                }
-
-                //  Intersect packet block
-                m_accelerator->Intersect( blockPacket, hitPacket );
+            HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
 
+            // Initialize hitPacket with a "not hit" information
+            for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+            {
+                hitPacket[i].m_HitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                hitPacket[i].m_HitInfo.m_acc_node_info = 0;
+                hitPacket[i].m_hitresult = false;
+            }
 
-                // Calculate background gradient color
-                // /////////////////////////////////////////////////////////////////////
-                SFVEC3F bgColor[RAYPACKET_DIM];
+            //  Intersect packet block
+            m_accelerator->Intersect( blockPacket, hitPacket );
 
-                for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
-                {
-                    const float posYfactor = (float)(windowsPos.y + y * 4.0f) / (float)m_windowSize.y;
 
-                    bgColor[y] = (SFVEC3F)m_settings.m_BgColorTop * SFVEC3F(posYfactor) +
-                                 (SFVEC3F)m_settings.m_BgColorBot * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) );
-                }
+            // Calculate background gradient color
+            // /////////////////////////////////////////////////////////////////////
+            SFVEC3F bgColor[RAYPACKET_DIM];
 
-                CCOLORRGB hitColorShading[RAYPACKET_RAYS_PER_PACKET];
+            for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
+            {
+                const float posYfactor = (float)(windowsPos.y + y * 4.0f) / (float)m_windowSize.y;
 
-                for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-                {
-                    const SFVEC3F bhColorY = bgColor[i / RAYPACKET_DIM];
+                bgColor[y] = (SFVEC3F)m_settings.m_BgColorTop * SFVEC3F(posYfactor) +
+                             (SFVEC3F)m_settings.m_BgColorBot * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) );
+            }
 
-                    if( hitPacket[i].m_hitresult == true )
-                    {
-                        const SFVEC3F hitColor = shadeHit( bhColorY,
-                                                           blockPacket.m_ray[i],
-                                                           hitPacket[i].m_HitInfo,
-                                                           false,
-                                                           0,
-                                                           false );
-
-                        hitColorShading[i] = CCOLORRGB( hitColor );
-                    }
-                    else
-                        hitColorShading[i] = bhColorY;
-                }
+            CCOLORRGB hitColorShading[RAYPACKET_RAYS_PER_PACKET];
 
-                CCOLORRGB cLRB_old[(RAYPACKET_DIM - 1)];
+            for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+            {
+                const SFVEC3F bhColorY = bgColor[i / RAYPACKET_DIM];
 
-                for( unsigned int y = 0; y < (RAYPACKET_DIM - 1); ++y )
+                if( hitPacket[i].m_hitresult == true )
                 {
+                    const SFVEC3F hitColor = shadeHit( bhColorY,
+                                                       blockPacket.m_ray[i],
+                                                       hitPacket[i].m_HitInfo,
+                                                       false,
+                                                       0,
+                                                       false );
+
+                    hitColorShading[i] = CCOLORRGB( hitColor );
+                }
+                else
+                    hitColorShading[i] = bhColorY;
+            }
 
-                    const SFVEC3F     bgColorY = bgColor[y];
-                    const CCOLORRGB   bgColorYRGB = CCOLORRGB( bgColorY );
-
-                    // This stores cRTB from the last block to be reused next time in a cLTB pixel
-                    CCOLORRGB cRTB_old;
-
-                    //RAY       cRTB_ray;
-                    //HITINFO   cRTB_hitInfo;
-
-                    for( unsigned int x = 0; x < (RAYPACKET_DIM - 1); ++x )
-                    {
-                        //      pxl 0  pxl 1  pxl 2  pxl 3  pxl 4
-                        //        x0                          x1  ...
-                        //     .---------------------------.
-                        // y0  | cLT  | cxxx | cLRT | cxxx | cRT  |
-                        //     | cxxx | cLTC | cxxx | cRTC | cxxx |
-                        //     | cLTB | cxxx | cC   | cxxx | cRTB |
-                        //     | cxxx | cLBC | cxxx | cRBC | cxxx |
-                        //     '---------------------------'
-                        // y1  | cLB  | cxxx | cLRB | cxxx | cRB  |
+            CCOLORRGB cLRB_old[(RAYPACKET_DIM - 1)];
 
-                        const unsigned int iLT = ((x + 0) + RAYPACKET_DIM * (y + 0));
-                        const unsigned int iRT = ((x + 1) + RAYPACKET_DIM * (y + 0));
-                        const unsigned int iLB = ((x + 0) + RAYPACKET_DIM * (y + 1));
-                        const unsigned int iRB = ((x + 1) + RAYPACKET_DIM * (y + 1));
+            for( unsigned int y = 0; y < (RAYPACKET_DIM - 1); ++y )
+            {
 
-                        // !TODO: skip when there are no hits
+                const SFVEC3F     bgColorY = bgColor[y];
+                const CCOLORRGB   bgColorYRGB = CCOLORRGB( bgColorY );
 
+                // This stores cRTB from the last block to be reused next time in a cLTB pixel
+                CCOLORRGB cRTB_old;
 
-                        const CCOLORRGB &cLT = hitColorShading[ iLT ];
-                        const CCOLORRGB &cRT = hitColorShading[ iRT ];
-                        const CCOLORRGB &cLB = hitColorShading[ iLB ];
-                        const CCOLORRGB &cRB = hitColorShading[ iRB ];
+                //RAY       cRTB_ray;
+                //HITINFO   cRTB_hitInfo;
 
-                        // Trace and shade cC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cC = bgColorYRGB;
+                for( unsigned int x = 0; x < (RAYPACKET_DIM - 1); ++x )
+                {
+                    //      pxl 0  pxl 1  pxl 2  pxl 3  pxl 4
+                    //        x0                          x1  ...
+                    //     .---------------------------.
+                    // y0  | cLT  | cxxx | cLRT | cxxx | cRT  |
+                    //     | cxxx | cLTC | cxxx | cRTC | cxxx |
+                    //     | cLTB | cxxx | cC   | cxxx | cRTB |
+                    //     | cxxx | cLBC | cxxx | cRBC | cxxx |
+                    //     '---------------------------'
+                    // y1  | cLB  | cxxx | cLRB | cxxx | cRB  |
 
-                        const SFVEC3F &oriLT = blockPacket.m_ray[ iLT ].m_Origin;
-                        const SFVEC3F &oriRB = blockPacket.m_ray[ iRB ].m_Origin;
+                    const unsigned int iLT = ((x + 0) + RAYPACKET_DIM * (y + 0));
+                    const unsigned int iRT = ((x + 1) + RAYPACKET_DIM * (y + 0));
+                    const unsigned int iLB = ((x + 0) + RAYPACKET_DIM * (y + 1));
+                    const unsigned int iRB = ((x + 1) + RAYPACKET_DIM * (y + 1));
 
-                        const SFVEC3F &dirLT = blockPacket.m_ray[ iLT ].m_Dir;
-                        const SFVEC3F &dirRB = blockPacket.m_ray[ iRB ].m_Dir;
+                    // !TODO: skip when there are no hits
 
-                        SFVEC3F oriC;
-                        SFVEC3F dirC;
 
-                        HITINFO centerHitInfo;
-                        centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                    const CCOLORRGB &cLT = hitColorShading[ iLT ];
+                    const CCOLORRGB &cRT = hitColorShading[ iRT ];
+                    const CCOLORRGB &cLB = hitColorShading[ iLB ];
+                    const CCOLORRGB &cRB = hitColorShading[ iRB ];
 
-                        bool hittedC = false;
+                    // Trace and shade cC
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cC = bgColorYRGB;
 
-                        if( (hitPacket[ iLT ].m_hitresult == true) ||
-                            (hitPacket[ iRT ].m_hitresult == true) ||
-                            (hitPacket[ iLB ].m_hitresult == true) ||
-                            (hitPacket[ iRB ].m_hitresult == true) )
-                        {
+                    const SFVEC3F &oriLT = blockPacket.m_ray[ iLT ].m_Origin;
+                    const SFVEC3F &oriRB = blockPacket.m_ray[ iRB ].m_Origin;
 
-                            oriC = ( oriLT + oriRB ) * 0.5f;
-                            dirC = glm::normalize( ( dirLT + dirRB ) * 0.5f );
+                    const SFVEC3F &dirLT = blockPacket.m_ray[ iLT ].m_Dir;
+                    const SFVEC3F &dirRB = blockPacket.m_ray[ iRB ].m_Dir;
 
-                            // Trace the center ray
-                            RAY centerRay;
-                            centerRay.Init( oriC, dirC );
+                    SFVEC3F oriC;
+                    SFVEC3F dirC;
 
-                            const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
-                            const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
-                            const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
-                            const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
+                    HITINFO centerHitInfo;
+                    centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
 
-                            if( nodeLT != 0 )
-                                hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLT );
+                    bool hittedC = false;
 
-                            if( ( nodeRT != 0 ) &&
-                                ( nodeRT != nodeLT ) )
-                                hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRT );
+                    if( (hitPacket[ iLT ].m_hitresult == true) ||
+                        (hitPacket[ iRT ].m_hitresult == true) ||
+                        (hitPacket[ iLB ].m_hitresult == true) ||
+                        (hitPacket[ iRB ].m_hitresult == true) )
+                    {
 
-                            if( ( nodeLB != 0 ) &&
-                                ( nodeLB != nodeLT ) &&
-                                ( nodeLB != nodeRT ) )
-                                    hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLB );
+                        oriC = ( oriLT + oriRB ) * 0.5f;
+                        dirC = glm::normalize( ( dirLT + dirRB ) * 0.5f );
 
-                            if( ( nodeRB != 0 ) &&
-                                ( nodeRB != nodeLB ) &&
-                                ( nodeRB != nodeLT ) &&
-                                ( nodeRB != nodeRT ) )
-                                    hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRB );
+                        // Trace the center ray
+                        RAY centerRay;
+                        centerRay.Init( oriC, dirC );
+
+                        const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
+                        const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
+                        const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
+                        const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
+
+                        if( nodeLT != 0 )
+                            hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLT );
+
+                        if( ( nodeRT != 0 ) &&
+                            ( nodeRT != nodeLT ) )
+                            hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRT );
+
+                        if( ( nodeLB != 0 ) &&
+                            ( nodeLB != nodeLT ) &&
+                            ( nodeLB != nodeRT ) )
+                                hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeLB );
+
+                        if( ( nodeRB != 0 ) &&
+                            ( nodeRB != nodeLB ) &&
+                            ( nodeRB != nodeLT ) &&
+                            ( nodeRB != nodeRT ) )
+                                hittedC |= m_accelerator->Intersect( centerRay, centerHitInfo, nodeRB );
+
+                        if( hittedC )
+                            cC = CCOLORRGB( shadeHit( bgColorY, centerRay, centerHitInfo, false, 0, false ) );
+                        else
+                        {
+                            centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
+                            hittedC = m_accelerator->Intersect( centerRay, centerHitInfo );
 
                             if( hittedC )
-                                cC = CCOLORRGB( shadeHit( bgColorY, centerRay, centerHitInfo, false, 0, false ) );
-                            else
-                            {
-                                centerHitInfo.m_tHit = std::numeric_limits<float>::infinity();
-                                hittedC = m_accelerator->Intersect( centerRay, centerHitInfo );
-
-                                if( hittedC )
-                                    cC = CCOLORRGB( shadeHit( bgColorY,
-                                                              centerRay,
-                                                              centerHitInfo,
-                                                              false,
-                                                              0,
-                                                              false ) );
-                            }
+                                cC = CCOLORRGB( shadeHit( bgColorY,
+                                                          centerRay,
+                                                          centerHitInfo,
+                                                          false,
+                                                          0,
+                                                          false ) );
                         }
+                    }
 
-                        // Trace and shade cLRT
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLRT = bgColorYRGB;
+                    // Trace and shade cLRT
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cLRT = bgColorYRGB;
 
-                        const SFVEC3F &oriRT = blockPacket.m_ray[ iRT ].m_Origin;
-                        const SFVEC3F &dirRT = blockPacket.m_ray[ iRT ].m_Dir;
+                    const SFVEC3F &oriRT = blockPacket.m_ray[ iRT ].m_Origin;
+                    const SFVEC3F &dirRT = blockPacket.m_ray[ iRT ].m_Dir;
 
-                        if( y == 0 )
-                        {
-                            // Trace the center ray
-                            RAY rayLRT;
-                            rayLRT.Init( ( oriLT + oriRT ) * 0.5f,
-                                            glm::normalize( ( dirLT + dirRT ) * 0.5f ) );
+                    if( y == 0 )
+                    {
+                        // Trace the center ray
+                        RAY rayLRT;
+                        rayLRT.Init( ( oriLT + oriRT ) * 0.5f,
+                                        glm::normalize( ( dirLT + dirRT ) * 0.5f ) );
 
-                            HITINFO hitInfoLRT;
-                            hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
+                        HITINFO hitInfoLRT;
+                        hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
 
-                            if( hitPacket[ iLT ].m_hitresult &&
-                                hitPacket[ iRT ].m_hitresult &&
-                                (hitPacket[ iLT ].m_HitInfo.pHitObject == hitPacket[ iRT ].m_HitInfo.pHitObject) )
-                            {
-                                hitInfoLRT.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
-                                hitInfoLRT.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
-                                                      hitPacket[ iRT ].m_HitInfo.m_tHit ) * 0.5f;
-                                hitInfoLRT.m_HitNormal =
-                                        glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
-                                                          hitPacket[ iRT ].m_HitInfo.m_HitNormal ) * 0.5f );
-
-                                cLRT = CCOLORRGB( shadeHit( bgColorY, rayLRT, hitInfoLRT, false, 0, false ) );
-                                cLRT = BlendColor( cLRT, BlendColor( cLT, cRT) );
-                            }
-                            else
+                        if( hitPacket[ iLT ].m_hitresult &&
+                            hitPacket[ iRT ].m_hitresult &&
+                            (hitPacket[ iLT ].m_HitInfo.pHitObject == hitPacket[ iRT ].m_HitInfo.pHitObject) )
+                        {
+                            hitInfoLRT.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
+                            hitInfoLRT.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
+                                                  hitPacket[ iRT ].m_HitInfo.m_tHit ) * 0.5f;
+                            hitInfoLRT.m_HitNormal =
+                                    glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
+                                                      hitPacket[ iRT ].m_HitInfo.m_HitNormal ) * 0.5f );
+
+                            cLRT = CCOLORRGB( shadeHit( bgColorY, rayLRT, hitInfoLRT, false, 0, false ) );
+                            cLRT = BlendColor( cLRT, BlendColor( cLT, cRT) );
+                        }
+                        else
+                        {
+                            if( hitPacket[ iLT ].m_hitresult ||
+                                hitPacket[ iRT ].m_hitresult )                  // If any hits
                             {
-                                if( hitPacket[ iLT ].m_hitresult ||
-                                    hitPacket[ iRT ].m_hitresult )                  // If any hits
-                                {
-                                    const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
-                                    const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
+                                const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
+                                const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
 
-                                    bool hittedLRT = false;
+                                bool hittedLRT = false;
 
-                                    if( nodeLT != 0 )
-                                        hittedLRT |= m_accelerator->Intersect( rayLRT, hitInfoLRT, nodeLT );
+                                if( nodeLT != 0 )
+                                    hittedLRT |= m_accelerator->Intersect( rayLRT, hitInfoLRT, nodeLT );
 
-                                    if( ( nodeRT != 0 ) &&
-                                        ( nodeRT != nodeLT ) )
-                                        hittedLRT |= m_accelerator->Intersect( rayLRT,
-                                                                               hitInfoLRT,
-                                                                               nodeRT );
+                                if( ( nodeRT != 0 ) &&
+                                    ( nodeRT != nodeLT ) )
+                                    hittedLRT |= m_accelerator->Intersect( rayLRT,
+                                                                           hitInfoLRT,
+                                                                           nodeRT );
 
-                                    if( hittedLRT )
+                                if( hittedLRT )
+                                    cLRT = CCOLORRGB( shadeHit( bgColorY,
+                                                                rayLRT,
+                                                                hitInfoLRT,
+                                                                false,
+                                                                0,
+                                                                false ) );
+                                else
+                                {
+                                    hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
+
+                                    if( m_accelerator->Intersect( rayLRT,hitInfoLRT ) )
                                         cLRT = CCOLORRGB( shadeHit( bgColorY,
                                                                     rayLRT,
                                                                     hitInfoLRT,
                                                                     false,
                                                                     0,
                                                                     false ) );
-                                    else
-                                    {
-                                        hitInfoLRT.m_tHit = std::numeric_limits<float>::infinity();
-
-                                        if( m_accelerator->Intersect( rayLRT,hitInfoLRT ) )
-                                            cLRT = CCOLORRGB( shadeHit( bgColorY,
-                                                                        rayLRT,
-                                                                        hitInfoLRT,
-                                                                        false,
-                                                                        0,
-                                                                        false ) );
-                                    }
                                 }
                             }
                         }
-                        else
-                            cLRT = cLRB_old[x];
+                    }
+                    else
+                        cLRT = cLRB_old[x];
 
 
-                        // Trace and shade cLTB
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLTB = bgColorYRGB;
+                    // Trace and shade cLTB
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cLTB = bgColorYRGB;
 
-                        if( x == 0 )
-                        {
-                            const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
-                            const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
+                    if( x == 0 )
+                    {
+                        const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
+                        const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
 
-                            // Trace the center ray
-                            RAY rayLTB;
-                            rayLTB.Init( ( oriLT + oriLB ) * 0.5f,
-                                            glm::normalize( ( dirLT + dirLB ) * 0.5f ) );
+                        // Trace the center ray
+                        RAY rayLTB;
+                        rayLTB.Init( ( oriLT + oriLB ) * 0.5f,
+                                        glm::normalize( ( dirLT + dirLB ) * 0.5f ) );
 
-                            HITINFO hitInfoLTB;
-                            hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
+                        HITINFO hitInfoLTB;
+                        hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
 
-                            if( hitPacket[ iLT ].m_hitresult &&
-                                hitPacket[ iLB ].m_hitresult &&
-                                ( hitPacket[ iLT ].m_HitInfo.pHitObject ==
-                                  hitPacket[ iLB ].m_HitInfo.pHitObject ) )
-                            {
-                                hitInfoLTB.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
-                                hitInfoLTB.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
-                                                      hitPacket[ iLB ].m_HitInfo.m_tHit ) * 0.5f;
-                                hitInfoLTB.m_HitNormal =
-                                        glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
-                                                          hitPacket[ iLB ].m_HitInfo.m_HitNormal ) * 0.5f );
-                                cLTB = CCOLORRGB( shadeHit( bgColorY, rayLTB, hitInfoLTB, false, 0, false ) );
-                                cLTB = BlendColor( cLTB, BlendColor( cLT, cLB) );
-                            }
-                            else
+                        if( hitPacket[ iLT ].m_hitresult &&
+                            hitPacket[ iLB ].m_hitresult &&
+                            ( hitPacket[ iLT ].m_HitInfo.pHitObject ==
+                              hitPacket[ iLB ].m_HitInfo.pHitObject ) )
+                        {
+                            hitInfoLTB.pHitObject = hitPacket[ iLT ].m_HitInfo.pHitObject;
+                            hitInfoLTB.m_tHit = ( hitPacket[ iLT ].m_HitInfo.m_tHit +
+                                                  hitPacket[ iLB ].m_HitInfo.m_tHit ) * 0.5f;
+                            hitInfoLTB.m_HitNormal =
+                                    glm::normalize( ( hitPacket[ iLT ].m_HitInfo.m_HitNormal +
+                                                      hitPacket[ iLB ].m_HitInfo.m_HitNormal ) * 0.5f );
+                            cLTB = CCOLORRGB( shadeHit( bgColorY, rayLTB, hitInfoLTB, false, 0, false ) );
+                            cLTB = BlendColor( cLTB, BlendColor( cLT, cLB) );
+                        }
+                        else
+                        {
+                            if( hitPacket[ iLT ].m_hitresult ||
+                                hitPacket[ iLB ].m_hitresult )                  // If any hits
                             {
-                                if( hitPacket[ iLT ].m_hitresult ||
-                                    hitPacket[ iLB ].m_hitresult )                  // If any hits
-                                {
-                                    const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
-                                    const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
+                                const unsigned int nodeLT = hitPacket[ iLT ].m_HitInfo.m_acc_node_info;
+                                const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
 
-                                    bool hittedLTB = false;
+                                bool hittedLTB = false;
 
-                                    if( nodeLT != 0 )
-                                        hittedLTB |= m_accelerator->Intersect( rayLTB,
-                                                                               hitInfoLTB,
-                                                                               nodeLT );
+                                if( nodeLT != 0 )
+                                    hittedLTB |= m_accelerator->Intersect( rayLTB,
+                                                                           hitInfoLTB,
+                                                                           nodeLT );
 
-                                    if( ( nodeLB != 0 ) &&
-                                        ( nodeLB != nodeLT ) )
-                                        hittedLTB |= m_accelerator->Intersect( rayLTB,
-                                                                               hitInfoLTB,
-                                                                               nodeLB );
+                                if( ( nodeLB != 0 ) &&
+                                    ( nodeLB != nodeLT ) )
+                                    hittedLTB |= m_accelerator->Intersect( rayLTB,
+                                                                           hitInfoLTB,
+                                                                           nodeLB );
 
-                                    if( hittedLTB )
+                                if( hittedLTB )
+                                    cLTB = CCOLORRGB( shadeHit( bgColorY,
+                                                                rayLTB,
+                                                                hitInfoLTB,
+                                                                false,
+                                                                0,
+                                                                false ) );
+                                else
+                                {
+                                    hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
+
+                                    if( m_accelerator->Intersect( rayLTB, hitInfoLTB ) )
                                         cLTB = CCOLORRGB( shadeHit( bgColorY,
                                                                     rayLTB,
                                                                     hitInfoLTB,
                                                                     false,
                                                                     0,
                                                                     false ) );
-                                    else
-                                    {
-                                        hitInfoLTB.m_tHit = std::numeric_limits<float>::infinity();
-
-                                        if( m_accelerator->Intersect( rayLTB, hitInfoLTB ) )
-                                            cLTB = CCOLORRGB( shadeHit( bgColorY,
-                                                                        rayLTB,
-                                                                        hitInfoLTB,
-                                                                        false,
-                                                                        0,
-                                                                        false ) );
-                                    }
                                 }
                             }
                         }
-                        else
-                            cLTB = cRTB_old;
+                    }
+                    else
+                        cLTB = cRTB_old;
 
 
-                        // Trace and shade cRTB
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cRTB = bgColorYRGB;
+                    // Trace and shade cRTB
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cRTB = bgColorYRGB;
 
-                        // Trace the center ray
-                        RAY rayRTB;
-                        rayRTB.Init( ( oriRT + oriRB ) * 0.5f,
-                                        glm::normalize( ( dirRT + dirRB ) * 0.5f ) );
+                    // Trace the center ray
+                    RAY rayRTB;
+                    rayRTB.Init( ( oriRT + oriRB ) * 0.5f,
+                                    glm::normalize( ( dirRT + dirRB ) * 0.5f ) );
 
-                        HITINFO hitInfoRTB;
-                        hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
+                    HITINFO hitInfoRTB;
+                    hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
 
-                        if( hitPacket[ iRT ].m_hitresult &&
-                            hitPacket[ iRB ].m_hitresult &&
-                            ( hitPacket[ iRT ].m_HitInfo.pHitObject ==
-                              hitPacket[ iRB ].m_HitInfo.pHitObject ) )
-                        {
-                            hitInfoRTB.pHitObject = hitPacket[ iRT ].m_HitInfo.pHitObject;
+                    if( hitPacket[ iRT ].m_hitresult &&
+                        hitPacket[ iRB ].m_hitresult &&
+                        ( hitPacket[ iRT ].m_HitInfo.pHitObject ==
+                          hitPacket[ iRB ].m_HitInfo.pHitObject ) )
+                    {
+                        hitInfoRTB.pHitObject = hitPacket[ iRT ].m_HitInfo.pHitObject;
 
-                            hitInfoRTB.m_tHit = ( hitPacket[ iRT ].m_HitInfo.m_tHit +
-                                                  hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
+                        hitInfoRTB.m_tHit = ( hitPacket[ iRT ].m_HitInfo.m_tHit +
+                                              hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
 
-                            hitInfoRTB.m_HitNormal =
-                                    glm::normalize( ( hitPacket[ iRT ].m_HitInfo.m_HitNormal +
-                                                      hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
+                        hitInfoRTB.m_HitNormal =
+                                glm::normalize( ( hitPacket[ iRT ].m_HitInfo.m_HitNormal +
+                                                  hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
 
-                            cRTB = CCOLORRGB( shadeHit( bgColorY, rayRTB, hitInfoRTB, false, 0, false ) );
-                            cRTB = BlendColor( cRTB, BlendColor( cRT, cRB) );
-                        }
-                        else
+                        cRTB = CCOLORRGB( shadeHit( bgColorY, rayRTB, hitInfoRTB, false, 0, false ) );
+                        cRTB = BlendColor( cRTB, BlendColor( cRT, cRB) );
+                    }
+                    else
+                    {
+                        if( hitPacket[ iRT ].m_hitresult ||
+                            hitPacket[ iRB ].m_hitresult )                  // If any hits
                         {
-                            if( hitPacket[ iRT ].m_hitresult ||
-                                hitPacket[ iRB ].m_hitresult )                  // If any hits
-                            {
-                                const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
-                                const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
+                            const unsigned int nodeRT = hitPacket[ iRT ].m_HitInfo.m_acc_node_info;
+                            const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
 
-                                bool hittedRTB = false;
+                            bool hittedRTB = false;
 
-                                if( nodeRT != 0 )
-                                    hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRT );
+                            if( nodeRT != 0 )
+                                hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRT );
 
-                                if( ( nodeRB != 0 ) &&
-                                    ( nodeRB != nodeRT ) )
-                                    hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRB );
+                            if( ( nodeRB != 0 ) &&
+                                ( nodeRB != nodeRT ) )
+                                hittedRTB |= m_accelerator->Intersect( rayRTB, hitInfoRTB, nodeRB );
+
+                            if( hittedRTB )
+                                cRTB = CCOLORRGB( shadeHit( bgColorY,
+                                                            rayRTB,
+                                                            hitInfoRTB,
+                                                            false,
+                                                            0,
+                                                            false) );
+                            else
+                            {
+                                hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
 
-                                if( hittedRTB )
+                                if( m_accelerator->Intersect( rayRTB, hitInfoRTB ) )
                                     cRTB = CCOLORRGB( shadeHit( bgColorY,
                                                                 rayRTB,
                                                                 hitInfoRTB,
                                                                 false,
                                                                 0,
-                                                                false) );
-                                else
-                                {
-                                    hitInfoRTB.m_tHit = std::numeric_limits<float>::infinity();
-
-                                    if( m_accelerator->Intersect( rayRTB, hitInfoRTB ) )
-                                        cRTB = CCOLORRGB( shadeHit( bgColorY,
-                                                                    rayRTB,
-                                                                    hitInfoRTB,
-                                                                    false,
-                                                                    0,
-                                                                    false ) );
-                                }
+                                                                false ) );
                             }
                         }
+                    }
 
-                        cRTB_old = cRTB;
+                    cRTB_old = cRTB;
 
 
-                        // Trace and shade cLRB
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLRB = bgColorYRGB;
+                    // Trace and shade cLRB
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cLRB = bgColorYRGB;
 
-                        const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
-                        const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
+                    const SFVEC3F &oriLB = blockPacket.m_ray[ iLB ].m_Origin;
+                    const SFVEC3F &dirLB = blockPacket.m_ray[ iLB ].m_Dir;
 
-                        // Trace the center ray
-                        RAY rayLRB;
-                        rayLRB.Init( ( oriLB + oriRB ) * 0.5f,
-                                        glm::normalize( ( dirLB + dirRB ) * 0.5f ) );
+                    // Trace the center ray
+                    RAY rayLRB;
+                    rayLRB.Init( ( oriLB + oriRB ) * 0.5f,
+                                    glm::normalize( ( dirLB + dirRB ) * 0.5f ) );
 
-                        HITINFO hitInfoLRB;
-                        hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
+                    HITINFO hitInfoLRB;
+                    hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
 
-                        if( hitPacket[ iLB ].m_hitresult &&
-                            hitPacket[ iRB ].m_hitresult &&
-                            ( hitPacket[ iLB ].m_HitInfo.pHitObject ==
-                              hitPacket[ iRB ].m_HitInfo.pHitObject ) )
-                        {
-                            hitInfoLRB.pHitObject = hitPacket[ iLB ].m_HitInfo.pHitObject;
+                    if( hitPacket[ iLB ].m_hitresult &&
+                        hitPacket[ iRB ].m_hitresult &&
+                        ( hitPacket[ iLB ].m_HitInfo.pHitObject ==
+                          hitPacket[ iRB ].m_HitInfo.pHitObject ) )
+                    {
+                        hitInfoLRB.pHitObject = hitPacket[ iLB ].m_HitInfo.pHitObject;
 
-                            hitInfoLRB.m_tHit = ( hitPacket[ iLB ].m_HitInfo.m_tHit +
-                                                  hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
+                        hitInfoLRB.m_tHit = ( hitPacket[ iLB ].m_HitInfo.m_tHit +
+                                              hitPacket[ iRB ].m_HitInfo.m_tHit ) * 0.5f;
 
-                            hitInfoLRB.m_HitNormal =
-                                    glm::normalize( ( hitPacket[ iLB ].m_HitInfo.m_HitNormal +
-                                                      hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
+                        hitInfoLRB.m_HitNormal =
+                                glm::normalize( ( hitPacket[ iLB ].m_HitInfo.m_HitNormal +
+                                                  hitPacket[ iRB ].m_HitInfo.m_HitNormal ) * 0.5f );
 
-                            cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
-                            cLRB = BlendColor( cLRB, BlendColor( cLB, cRB) );
-                        }
-                        else
+                        cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
+                        cLRB = BlendColor( cLRB, BlendColor( cLB, cRB) );
+                    }
+                    else
+                    {
+                        if( hitPacket[ iLB ].m_hitresult ||
+                            hitPacket[ iRB ].m_hitresult )                  // If any hits
                         {
-                            if( hitPacket[ iLB ].m_hitresult ||
-                                hitPacket[ iRB ].m_hitresult )                  // If any hits
-                            {
-                                const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
-                                const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
+                            const unsigned int nodeLB = hitPacket[ iLB ].m_HitInfo.m_acc_node_info;
+                            const unsigned int nodeRB = hitPacket[ iRB ].m_HitInfo.m_acc_node_info;
 
-                                bool hittedLRB = false;
+                            bool hittedLRB = false;
 
-                                if( nodeLB != 0 )
-                                    hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeLB );
+                            if( nodeLB != 0 )
+                                hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeLB );
 
-                                if( ( nodeRB != 0 ) &&
-                                    ( nodeRB != nodeLB ) )
-                                    hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeRB );
+                            if( ( nodeRB != 0 ) &&
+                                ( nodeRB != nodeLB ) )
+                                hittedLRB |= m_accelerator->Intersect( rayLRB, hitInfoLRB, nodeRB );
 
-                                if( hittedLRB )
-                                    cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
-                                else
-                                {
-                                    hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
+                            if( hittedLRB )
+                                cLRB = CCOLORRGB( shadeHit( bgColorY, rayLRB, hitInfoLRB, false, 0, false ) );
+                            else
+                            {
+                                hitInfoLRB.m_tHit = std::numeric_limits<float>::infinity();
 
-                                    if( m_accelerator->Intersect( rayLRB, hitInfoLRB ) )
-                                        cLRB = CCOLORRGB( shadeHit( bgColorY,
-                                                                    rayLRB,
-                                                                    hitInfoLRB,
-                                                                    false,
-                                                                    0,
-                                                                    false ) );
-                                }
+                                if( m_accelerator->Intersect( rayLRB, hitInfoLRB ) )
+                                    cLRB = CCOLORRGB( shadeHit( bgColorY,
+                                                                rayLRB,
+                                                                hitInfoLRB,
+                                                                false,
+                                                                0,
+                                                                false ) );
                             }
                         }
+                    }
 
-                        cLRB_old[x] = cLRB;
+                    cLRB_old[x] = cLRB;
 
 
-                        // Trace and shade cLTC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLTC = BlendColor( cLT , cC );
+                    // Trace and shade cLTC
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cLTC = BlendColor( cLT , cC );
 
-                        if( hitPacket[ iLT ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayLTC;
-                            rayLTC.Init( ( oriLT + oriC ) * 0.5f,
-                                         glm::normalize( ( dirLT + dirC ) * 0.5f ) );
+                    if( hitPacket[ iLT ].m_hitresult || hittedC )
+                    {
+                        // Trace the center ray
+                        RAY rayLTC;
+                        rayLTC.Init( ( oriLT + oriC ) * 0.5f,
+                                     glm::normalize( ( dirLT + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoLTC;
-                            hitInfoLTC.m_tHit = std::numeric_limits<float>::infinity();
+                        HITINFO hitInfoLTC;
+                        hitInfoLTC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                        bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayLTC, hitInfoLTC );
-                            else
-                                if( hitPacket[ iLT ].m_hitresult )
-                                    hitted = hitPacket[ iLT ].m_HitInfo.pHitObject->Intersect( rayLTC,
-                                                                                               hitInfoLTC );
+                        if( hittedC )
+                            hitted = centerHitInfo.pHitObject->Intersect( rayLTC, hitInfoLTC );
+                        else
+                            if( hitPacket[ iLT ].m_hitresult )
+                                hitted = hitPacket[ iLT ].m_HitInfo.pHitObject->Intersect( rayLTC,
+                                                                                           hitInfoLTC );
 
-                            if( hitted )
-                                cLTC = CCOLORRGB( shadeHit( bgColorY, rayLTC, hitInfoLTC, false, 0, false ) );
-                        }
+                        if( hitted )
+                            cLTC = CCOLORRGB( shadeHit( bgColorY, rayLTC, hitInfoLTC, false, 0, false ) );
+                    }
 
 
-                        // Trace and shade cRTC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cRTC = BlendColor( cRT , cC );
+                    // Trace and shade cRTC
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cRTC = BlendColor( cRT , cC );
 
-                        if( hitPacket[ iRT ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayRTC;
-                            rayRTC.Init( ( oriRT + oriC ) * 0.5f,
-                                         glm::normalize( ( dirRT + dirC ) * 0.5f ) );
+                    if( hitPacket[ iRT ].m_hitresult || hittedC )
+                    {
+                        // Trace the center ray
+                        RAY rayRTC;
+                        rayRTC.Init( ( oriRT + oriC ) * 0.5f,
+                                     glm::normalize( ( dirRT + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoRTC;
-                            hitInfoRTC.m_tHit = std::numeric_limits<float>::infinity();
+                        HITINFO hitInfoRTC;
+                        hitInfoRTC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                        bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayRTC, hitInfoRTC );
-                            else
-                                if( hitPacket[ iRT ].m_hitresult )
-                                    hitted = hitPacket[ iRT ].m_HitInfo.pHitObject->Intersect( rayRTC,
-                                                                                               hitInfoRTC );
+                        if( hittedC )
+                            hitted = centerHitInfo.pHitObject->Intersect( rayRTC, hitInfoRTC );
+                        else
+                            if( hitPacket[ iRT ].m_hitresult )
+                                hitted = hitPacket[ iRT ].m_HitInfo.pHitObject->Intersect( rayRTC,
+                                                                                           hitInfoRTC );
 
-                            if( hitted )
-                                cRTC = CCOLORRGB( shadeHit( bgColorY, rayRTC, hitInfoRTC, false, 0, false ) );
-                        }
+                        if( hitted )
+                            cRTC = CCOLORRGB( shadeHit( bgColorY, rayRTC, hitInfoRTC, false, 0, false ) );
+                    }
 
 
-                        // Trace and shade cLBC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cLBC = BlendColor( cLB , cC );
+                    // Trace and shade cLBC
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cLBC = BlendColor( cLB , cC );
 
-                        if( hitPacket[ iLB ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayLBC;
-                            rayLBC.Init( ( oriLB + oriC ) * 0.5f,
-                                         glm::normalize( ( dirLB + dirC ) * 0.5f ) );
+                    if( hitPacket[ iLB ].m_hitresult || hittedC )
+                    {
+                        // Trace the center ray
+                        RAY rayLBC;
+                        rayLBC.Init( ( oriLB + oriC ) * 0.5f,
+                                     glm::normalize( ( dirLB + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoLBC;
-                            hitInfoLBC.m_tHit = std::numeric_limits<float>::infinity();
+                        HITINFO hitInfoLBC;
+                        hitInfoLBC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                        bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayLBC, hitInfoLBC );
-                            else
-                                if( hitPacket[ iLB ].m_hitresult )
-                                    hitted = hitPacket[ iLB ].m_HitInfo.pHitObject->Intersect( rayLBC,
-                                                                                               hitInfoLBC );
+                        if( hittedC )
+                            hitted = centerHitInfo.pHitObject->Intersect( rayLBC, hitInfoLBC );
+                        else
+                            if( hitPacket[ iLB ].m_hitresult )
+                                hitted = hitPacket[ iLB ].m_HitInfo.pHitObject->Intersect( rayLBC,
+                                                                                           hitInfoLBC );
 
-                            if( hitted )
-                                cLBC = CCOLORRGB( shadeHit( bgColorY, rayLBC, hitInfoLBC, false, 0, false ) );
-                        }
+                        if( hitted )
+                            cLBC = CCOLORRGB( shadeHit( bgColorY, rayLBC, hitInfoLBC, false, 0, false ) );
+                    }
 
 
-                        // Trace and shade cRBC
-                        // /////////////////////////////////////////////////////////////
-                        CCOLORRGB cRBC = BlendColor( cRB , cC );
+                    // Trace and shade cRBC
+                    // /////////////////////////////////////////////////////////////
+                    CCOLORRGB cRBC = BlendColor( cRB , cC );
 
-                        if( hitPacket[ iRB ].m_hitresult || hittedC )
-                        {
-                            // Trace the center ray
-                            RAY rayRBC;
-                            rayRBC.Init( ( oriRB + oriC ) * 0.5f,
-                                         glm::normalize( ( dirRB + dirC ) * 0.5f ) );
+                    if( hitPacket[ iRB ].m_hitresult || hittedC )
+                    {
+                        // Trace the center ray
+                        RAY rayRBC;
+                        rayRBC.Init( ( oriRB + oriC ) * 0.5f,
+                                     glm::normalize( ( dirRB + dirC ) * 0.5f ) );
 
-                            HITINFO hitInfoRBC;
-                            hitInfoRBC.m_tHit = std::numeric_limits<float>::infinity();
+                        HITINFO hitInfoRBC;
+                        hitInfoRBC.m_tHit = std::numeric_limits<float>::infinity();
 
-                            bool hitted = false;
+                        bool hitted = false;
 
-                            if( hittedC )
-                                hitted = centerHitInfo.pHitObject->Intersect( rayRBC, hitInfoRBC );
-                            else
-                                if( hitPacket[ iRB ].m_hitresult )
-                                    hitted = hitPacket[ iRB ].m_HitInfo.pHitObject->Intersect( rayRBC,
-                                                                                               hitInfoRBC );
+                        if( hittedC )
+                            hitted = centerHitInfo.pHitObject->Intersect( rayRBC, hitInfoRBC );
+                        else
+                            if( hitPacket[ iRB ].m_hitresult )
+                                hitted = hitPacket[ iRB ].m_HitInfo.pHitObject->Intersect( rayRBC,
+                                                                                           hitInfoRBC );
 
-                            if( hitted )
-                                cRBC = CCOLORRGB( shadeHit( bgColorY, rayRBC, hitInfoRBC, false, 0, false ) );
-                        }
+                        if( hitted )
+                            cRBC = CCOLORRGB( shadeHit( bgColorY, rayRBC, hitInfoRBC, false, 0, false ) );
+                    }
 
 
-                        // Set pixel colors
-                        // /////////////////////////////////////////////////////////////
-
-                        GLubyte *ptr = &ptrPBO[ (4 * x + m_blockPositionsFast[iBlock].x +
-                                                 m_realBufferSize.x *
-                                                 (m_blockPositionsFast[iBlock].y + 4 * y)) * 4 ];
-                        SetPixel( ptr +  0, cLT );
-                        SetPixel( ptr +  4, BlendColor( cLT, cLRT, cLTC ) );
-                        SetPixel( ptr +  8, cLRT );
-                        SetPixel( ptr + 12, BlendColor( cLRT, cRT, cRTC ) );
-
-                        ptr += m_realBufferSize.x * 4;
-                        SetPixel( ptr +  0, BlendColor( cLT , cLTB, cLTC ) );
-                        SetPixel( ptr +  4, BlendColor( cLTC, BlendColor( cLT , cC ) ) );
-                        SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRT, cLTC, cRTC ) ) );
-                        SetPixel( ptr + 12, BlendColor( cRTC, BlendColor( cRT , cC ) ) );
-
-                        ptr += m_realBufferSize.x * 4;
-                        SetPixel( ptr +  0, cLTB );
-                        SetPixel( ptr +  4, BlendColor( cC, BlendColor( cLTB, cLTC, cLBC ) ) );
-                        SetPixel( ptr +  8, cC );
-                        SetPixel( ptr + 12, BlendColor( cC, BlendColor( cRTB, cRTC, cRBC ) ) );
-
-                        ptr += m_realBufferSize.x * 4;
-                        SetPixel( ptr +  0, BlendColor( cLB , cLTB, cLBC ) );
-                        SetPixel( ptr +  4, BlendColor( cLBC, BlendColor( cLB , cC ) ) );
-                        SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRB, cLBC, cRBC ) ) );
-                        SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
-                    }
+                    // Set pixel colors
+                    // /////////////////////////////////////////////////////////////
+
+                    GLubyte *ptr = &ptrPBO[ (4 * x + m_blockPositionsFast[iBlock].x +
+                                             m_realBufferSize.x *
+                                             (m_blockPositionsFast[iBlock].y + 4 * y)) * 4 ];
+                    SetPixel( ptr +  0, cLT );
+                    SetPixel( ptr +  4, BlendColor( cLT, cLRT, cLTC ) );
+                    SetPixel( ptr +  8, cLRT );
+                    SetPixel( ptr + 12, BlendColor( cLRT, cRT, cRTC ) );
+
+                    ptr += m_realBufferSize.x * 4;
+                    SetPixel( ptr +  0, BlendColor( cLT , cLTB, cLTC ) );
+                    SetPixel( ptr +  4, BlendColor( cLTC, BlendColor( cLT , cC ) ) );
+                    SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRT, cLTC, cRTC ) ) );
+                    SetPixel( ptr + 12, BlendColor( cRTC, BlendColor( cRT , cC ) ) );
+
+                    ptr += m_realBufferSize.x * 4;
+                    SetPixel( ptr +  0, cLTB );
+                    SetPixel( ptr +  4, BlendColor( cC, BlendColor( cLTB, cLTC, cLBC ) ) );
+                    SetPixel( ptr +  8, cC );
+                    SetPixel( ptr + 12, BlendColor( cC, BlendColor( cRTB, cRTC, cRBC ) ) );
+
+                    ptr += m_realBufferSize.x * 4;
+                    SetPixel( ptr +  0, BlendColor( cLB , cLTB, cLBC ) );
+                    SetPixel( ptr +  4, BlendColor( cLBC, BlendColor( cLB , cC ) ) );
+                    SetPixel( ptr +  8, BlendColor( cC, BlendColor( cLRB, cLBC, cRBC ) ) );
+                    SetPixel( ptr + 12, BlendColor( cRBC, BlendColor( cRB , cC ) ) );
                 }
             }
+        }
+    };
 
-            threadsFinished++;
-        } );
+    std::vector<std::future<void>> returns( parallelThreadCount );
 
-        t.detach();
-    }
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, preview_lambda );
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii].wait();
 }
 
 
@@ -37,6 +37,7 @@
 #include "clight.h"
 #include "../cpostshader_ssao.h"
 #include "cmaterial.h"
+#include "shapes3D/cmodel_instance.h"
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
@@ -47,6 +48,12 @@ typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 /// Maps a S3DMODEL pointer with a created CBLINN_PHONG_MATERIAL vector
 typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
+/// Meshes built for a S3DMODEL, one for each model matrix it was placed with
+typedef std::vector< std::pair< glm::mat4, CMODEL_MESH * > > MODEL_MESHES;
+
+/// Maps a S3DMODEL pointer with the meshes built for it
+typedef std::map< const S3DMODEL * , MODEL_MESHES > MAP_MODEL_MESHES;
+
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
@@ -93,6 +100,7 @@ private:
                              const HITINFO_PACKET *aHitPck_X0Y0,
                              const HITINFO_PACKET *aHitPck_AA_X1Y1,
                              const RAY *aRayPck,
+                             const bool *aPixelNeedsAA,
                              SFVEC3F *aOutHitColor );
 
     // Materials
@@ -196,11 +204,19 @@ private:
     void insert3DPadHole( const D_PAD* aPad );
     void load_3D_models();
     void add_3D_models( const S3DMODEL *a3DModel,
+                        const glm::mat4 &aPlacementMatrix,
                         const glm::mat4 &aModelMatrix );
+    CMODEL_MESH *get_3D_model_mesh( const S3DMODEL *a3DModel,
+                                    const glm::mat4 &aModelMatrix,
+                                    const MODEL_MATERIALS &aMaterials );
+    void free_3D_model_meshes();
 
     /// Stores materials of the 3D models
     MAP_MODEL_MATERIALS m_model_materials;
 
+    /// Stores the meshes of the 3D models, shared by all their placements
+    MAP_MODEL_MESHES m_model_meshes;
+
     void initialize_block_positions();
 
     void render( GLubyte *ptrPBO, REPORTER *aStatusTextReporter );
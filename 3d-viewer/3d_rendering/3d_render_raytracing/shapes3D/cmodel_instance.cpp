@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cmodel_instance.cpp
+ * @brief
+ */
+
+#include "cmodel_instance.h"
+#include "../accelerators/cbvh_pbrt.h"
+#include <wx/debug.h>   // For the wxASSERT
+
+
+CMODEL_MESH::CMODEL_MESH()
+{
+    m_accelerator = NULL;
+}
+
+
+CMODEL_MESH::~CMODEL_MESH()
+{
+    delete m_accelerator;
+}
+
+
+void CMODEL_MESH::Build()
+{
+    delete m_accelerator;
+
+    m_accelerator = new CBVH_PBRT( m_objects );
+}
+
+
+CMODEL_INSTANCE::CMODEL_INSTANCE( const CMODEL_MESH *aMesh,
+                                  const glm::mat4 &aPlacementMatrix ) :
+    COBJECT( OBJ3D_MODEL_INSTANCE )
+{
+    wxASSERT( aMesh->GetAccelerator() != NULL );
+
+    m_mesh = aMesh;
+
+    m_rotation = glm::mat3( aPlacementMatrix );
+    m_invRotation = glm::transpose( m_rotation );
+    m_invTranslation = -( m_invRotation * SFVEC3F( aPlacementMatrix[3] ) );
+
+    m_bbox.Reset();
+    m_bbox.Set( aMesh->GetBBox() );
+    m_bbox.ApplyTransformationAA( aPlacementMatrix );
+
+    // The transformed triangles must not stick out of the box due to rounding
+    m_bbox.ScaleNextUp();
+
+    m_centroid = m_bbox.GetCenter();
+}
+
+
+void CMODEL_INSTANCE::toLocal( const RAY &aRay, RAY &aLocalRay ) const
+{
+    aLocalRay.Init( m_invRotation * aRay.m_Origin + m_invTranslation,
+                    m_invRotation * aRay.m_Dir );
+}
+
+
+bool CMODEL_INSTANCE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
+{
+    RAY localRay;
+
+    toLocal( aRay, localRay );
+
+    if( !m_mesh->GetAccelerator()->Intersect( localRay, aHitInfo ) )
+        return false;
+
+    // The hit distance is the same in both spaces
+    aHitInfo.m_HitPoint = aRay.at( aHitInfo.m_tHit );
+    aHitInfo.m_HitNormal = m_rotation * aHitInfo.m_HitNormal;
+
+    return true;
+}
+
+
+bool CMODEL_INSTANCE::IntersectP( const RAY &aRay, float aMaxDistance ) const
+{
+    RAY localRay;
+
+    toLocal( aRay, localRay );
+
+    return m_mesh->GetAccelerator()->IntersectP( localRay, aMaxDistance );
+}
+
+
+bool CMODEL_INSTANCE::Intersects( const CBBOX &aBBox ) const
+{
+    return m_bbox.Intersects( aBBox );
+}
+
+
+SFVEC3F CMODEL_INSTANCE::GetDiffuseColor( const HITINFO &aHitInfo ) const
+{
+    // The hit object is the triangle of the mesh, so this is only reached by mistake
+    if( aHitInfo.pHitObject && ( aHitInfo.pHitObject != this ) )
+        return aHitInfo.pHitObject->GetDiffuseColor( aHitInfo );
+
+    return SFVEC3F( 0.0f );
+}
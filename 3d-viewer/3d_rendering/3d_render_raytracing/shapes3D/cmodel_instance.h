@@ -0,0 +1,103 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cmodel_instance.h
+ * @brief Placements of a 3D model sharing the triangles and the BVH of the model
+ */
+
+#ifndef _CMODEL_INSTANCE_H_
+#define _CMODEL_INSTANCE_H_
+
+#include "cobject.h"
+#include "../accelerators/ccontainer.h"
+
+class CGENERICACCELERATOR;
+
+
+/**
+ * The triangles of a 3D model and their BVH, built once and shared by all the placements
+ * (CMODEL_INSTANCE) of the model.  The triangles are in the model local space.
+ */
+class  CMODEL_MESH
+{
+public:
+    CMODEL_MESH();
+
+    ~CMODEL_MESH();
+
+    void Add( COBJECT *aObject ) { m_objects.Add( aObject ); }
+
+    /**
+     * Function Build
+     * Builds the BVH of the triangles, once they are all added.
+     */
+    void Build();
+
+    bool IsEmpty() const { return m_objects.GetList().empty(); }
+
+    const CBBOX &GetBBox() const { return m_objects.GetBBox(); }
+
+    const CGENERICACCELERATOR *GetAccelerator() const { return m_accelerator; }
+
+private:
+    CMODEL_MESH( const CMODEL_MESH& );
+    const CMODEL_MESH &operator=( const CMODEL_MESH& );
+
+    CCONTAINER m_objects;
+    CGENERICACCELERATOR *m_accelerator;
+};
+
+
+/**
+ * A placement of a CMODEL_MESH.  Rays are moved to the model local space to be tested
+ * against the mesh BVH, and the hits are moved back to the world space.
+ *
+ * The placement must be a rigid transformation (rotation and translation), so distances
+ * along the rays are the same in both spaces.  The hit object is the triangle of the mesh,
+ * which provides the material and the color.
+ */
+class  CMODEL_INSTANCE : public COBJECT
+{
+
+public:
+    CMODEL_INSTANCE( const CMODEL_MESH *aMesh, const glm::mat4 &aPlacementMatrix );
+
+// Imported from COBJECT
+    bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
+    bool IntersectP(const RAY &aRay , float aMaxDistance ) const override;
+    bool Intersects( const CBBOX &aBBox ) const override;
+    SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
+
+private:
+    void toLocal( const RAY &aRay, RAY &aLocalRay ) const;
+
+private:
+    const CMODEL_MESH *m_mesh;
+    glm::mat3 m_rotation;           ///< world orientation of the model
+    glm::mat3 m_invRotation;
+    SFVEC3F   m_invTranslation;
+};
+
+
+#endif // _CMODEL_INSTANCE_H_
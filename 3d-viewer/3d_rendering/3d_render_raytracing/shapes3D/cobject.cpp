@@ -50,7 +50,8 @@ static const char *OBJECT3D_STR[OBJ3D_MAX] =
     "OBJ3D_LAYERITEM",
     "OBJ3D_XYPLANE",
     "OBJ3D_ROUNDSEG",
-    "OBJ3D_TRIANGLE"
+    "OBJ3D_TRIANGLE",
+    "OBJ3D_MODEL_INSTANCE"
 };
 
 
@@ -70,6 +70,8 @@ public:
     SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
 
 private:
+    friend struct CTRIANGLE4;
+
     void pre_calc_const();
 
 private:
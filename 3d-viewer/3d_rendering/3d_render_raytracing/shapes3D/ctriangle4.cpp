@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  ctriangle4.cpp
+ * @brief
+ */
+
+#include "ctriangle4.h"
+#include <string.h>
+#include <wx/debug.h>   // For the wxASSERT
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 1 ) )
+#define CTRIANGLE4_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+
+// The lane tests follow CTRIANGLE::Intersect operation by operation, but a compiler may
+// still contract them differently, so the barycentric limits get a little slack. A false
+// positive only costs a call to CTRIANGLE::Intersect.
+static const float s_slack = 1.0e-5f;
+
+
+CTRIANGLE4::CTRIANGLE4()
+{
+    memset( this, 0, sizeof( CTRIANGLE4 ) );
+}
+
+
+void CTRIANGLE4::Set( unsigned int aLane, const CTRIANGLE &aTriangle )
+{
+    wxASSERT( aLane < 4 );
+
+    const unsigned int k = aTriangle.m_k;
+    const unsigned int ku = (k + 1) % 3;
+    const unsigned int kv = (k + 2) % 3;
+
+    m_nu[aLane] = aTriangle.m_nu;
+    m_nv[aLane] = aTriangle.m_nv;
+    m_nd[aLane] = aTriangle.m_nd;
+    m_bnu[aLane] = aTriangle.m_bnu;
+    m_bnv[aLane] = aTriangle.m_bnv;
+    m_cnu[aLane] = aTriangle.m_cnu;
+    m_cnv[aLane] = aTriangle.m_cnv;
+    m_au[aLane] = aTriangle.m_vertex[0][ku];
+    m_av[aLane] = aTriangle.m_vertex[0][kv];
+    m_k[aLane] = k;
+    m_ku[aLane] = ku;
+    m_kv[aLane] = kv;
+
+    m_laneMask |= 1 << aLane;
+}
+
+
+#ifdef CTRIANGLE4_USE_SSE
+
+unsigned int CTRIANGLE4::Intersect( const RAY &aRay, float aMaxDistance ) const
+{
+    const float O[3] = { aRay.m_Origin.x, aRay.m_Origin.y, aRay.m_Origin.z };
+    const float D[3] = { aRay.m_Dir.x, aRay.m_Dir.y, aRay.m_Dir.z };
+
+#define GATHER( v, idx ) _mm_setr_ps( v[idx[0]], v[idx[1]], v[idx[2]], v[idx[3]] )
+    const __m128 Ok  = GATHER( O, m_k );
+    const __m128 Oku = GATHER( O, m_ku );
+    const __m128 Okv = GATHER( O, m_kv );
+    const __m128 Dk  = GATHER( D, m_k );
+    const __m128 Dku = GATHER( D, m_ku );
+    const __m128 Dkv = GATHER( D, m_kv );
+#undef GATHER
+
+    const __m128 nu = _mm_loadu_ps( m_nu );
+    const __m128 nv = _mm_loadu_ps( m_nv );
+
+    const __m128 lnd = _mm_div_ps( _mm_set1_ps( 1.0f ),
+                                   _mm_add_ps( _mm_add_ps( Dk, _mm_mul_ps( nu, Dku ) ),
+                                               _mm_mul_ps( nv, Dkv ) ) );
+
+    const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( _mm_loadu_ps( m_nd ), Ok ),
+                                                         _mm_mul_ps( nu, Oku ) ),
+                                             _mm_mul_ps( nv, Okv ) ),
+                                 lnd );
+
+    __m128 hit = _mm_and_ps( _mm_cmpgt_ps( _mm_set1_ps( aMaxDistance ), t ),
+                             _mm_cmpgt_ps( t, _mm_setzero_ps() ) );
+
+    const __m128 hu = _mm_sub_ps( _mm_add_ps( Oku, _mm_mul_ps( t, Dku ) ), _mm_loadu_ps( m_au ) );
+    const __m128 hv = _mm_sub_ps( _mm_add_ps( Okv, _mm_mul_ps( t, Dkv ) ), _mm_loadu_ps( m_av ) );
+
+    const __m128 beta = _mm_add_ps( _mm_mul_ps( hv, _mm_loadu_ps( m_bnu ) ),
+                                    _mm_mul_ps( hu, _mm_loadu_ps( m_bnv ) ) );
+    const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, _mm_loadu_ps( m_cnu ) ),
+                                     _mm_mul_ps( hv, _mm_loadu_ps( m_cnv ) ) );
+
+    const __m128 slack = _mm_set1_ps( -s_slack );
+
+    hit = _mm_and_ps( hit, _mm_cmpge_ps( beta, slack ) );
+    hit = _mm_and_ps( hit, _mm_cmpge_ps( gamma, slack ) );
+    hit = _mm_and_ps( hit, _mm_cmple_ps( _mm_add_ps( beta, gamma ),
+                                         _mm_set1_ps( 1.0f + s_slack ) ) );
+
+    return _mm_movemask_ps( hit ) & m_laneMask;
+}
+
+#else
+
+unsigned int CTRIANGLE4::Intersect( const RAY &aRay, float aMaxDistance ) const
+{
+    const float O[3] = { aRay.m_Origin.x, aRay.m_Origin.y, aRay.m_Origin.z };
+    const float D[3] = { aRay.m_Dir.x, aRay.m_Dir.y, aRay.m_Dir.z };
+
+    unsigned int mask = 0;
+
+    for( unsigned int i = 0; i < 4; ++i )
+    {
+        const unsigned int k = m_k[i];
+        const unsigned int ku = m_ku[i];
+        const unsigned int kv = m_kv[i];
+
+        const float lnd = 1.0f / (D[k] + m_nu[i] * D[ku] + m_nv[i] * D[kv]);
+        const float t = (m_nd[i] - O[k] - m_nu[i] * O[ku] - m_nv[i] * O[kv]) * lnd;
+
+        if( !( (aMaxDistance > t) && (t > 0.0f) ) )
+            continue;
+
+        const float hu = O[ku] + t * D[ku] - m_au[i];
+        const float hv = O[kv] + t * D[kv] - m_av[i];
+        const float beta = hv * m_bnu[i] + hu * m_bnv[i];
+        const float gamma = hu * m_cnu[i] + hv * m_cnv[i];
+
+        if( (beta >= -s_slack) && (gamma >= -s_slack) && ((beta + gamma) <= 1.0f + s_slack) )
+            mask |= 1 << i;
+    }
+
+    return mask & m_laneMask;
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  ctriangle4.h
+ * @brief Intersection of a ray with blocks of four triangles, stored as structure of arrays
+ */
+
+#ifndef _CTRIANGLE4_H_
+#define _CTRIANGLE4_H_
+
+#include "ctriangle.h"
+
+/**
+ * The precomputed constants of up to four CTRIANGLEs, stored as structure of arrays so
+ * a ray can be tested against the four of them at once (with SSE when available).
+ *
+ * The test does the same computations as CTRIANGLE::Intersect, but it only reports which
+ * triangles may be hit: the hit information is then computed by the triangles themselves.
+ */
+struct CTRIANGLE4
+{
+    CTRIANGLE4();
+
+    /**
+     * Function Set
+     * Stores the constants of a triangle in a lane of the block.
+     */
+    void Set( unsigned int aLane, const CTRIANGLE &aTriangle );
+
+    /**
+     * Function Intersect
+     * @param aRay the ray to test
+     * @param aMaxDistance only the hits nearer than this distance are reported
+     * @return a mask with the bit i set if the triangle of lane i may be hit by the ray
+     */
+    unsigned int Intersect( const RAY &aRay, float aMaxDistance ) const;
+
+    float m_nu[4];
+    float m_nv[4];
+    float m_nd[4];
+    float m_bnu[4];
+    float m_bnv[4];
+    float m_cnu[4];
+    float m_cnv[4];
+    float m_au[4];              ///< first vertex, along the u axis of the triangle
+    float m_av[4];              ///< first vertex, along the v axis of the triangle
+    unsigned char m_k[4];       ///< projection axis of the triangle
+    unsigned char m_ku[4];
+    unsigned char m_kv[4];
+    unsigned int m_laneMask;    ///< lanes in use
+};
+
+#endif // _CTRIANGLE4_H_
@@ -68,6 +68,13 @@ static const wxChar EnableSvgImport[] = wxT( "EnableSvgImport" );
  */
 static const wxChar AllowLegacyCanvasInGtk3[] = wxT( "AllowLegacyCanvasInGtk3" );
 
+/**
+ * When converting texts to polygons (zone filling, plotting, 3D view), keep the outline of
+ * each distinct text and not only the outlines of its glyphs.  This is faster on boards
+ * where the same texts are used many times, at the expense of memory.
+ */
+static const wxChar CacheTextOutlines[] = wxT( "CacheTextOutlines" );
+
 } // namespace KEYS
 
 
@@ -147,6 +154,7 @@ ADVANCED_CFG::ADVANCED_CFG()
     // then the values will remain as set here.
     m_enableSvgImport = false;
     m_allowLegacyCanvasInGtk3 = false;
+    m_cacheTextOutlines = false;
 
     loadFromConfigFile();
 }
@@ -186,6 +194,9 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL(
             true, AC_KEYS::AllowLegacyCanvasInGtk3, &m_allowLegacyCanvasInGtk3, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL(
+            true, AC_KEYS::CacheTextOutlines, &m_cacheTextOutlines, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
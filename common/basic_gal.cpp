@@ -43,6 +43,7 @@ KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
 
 // the basic GAL doesn't get an external display option object
 BASIC_GAL basic_gal( basic_displayOptions );
+std::mutex basic_gal_lock;
 
 const VECTOR2D BASIC_GAL::transform( const VECTOR2D& aPoint ) const
 {
@@ -87,6 +87,8 @@ int Clamp_Text_PenSize( int aPenSize, wxSize aSize, bool aBold )
 
 int GraphicTextWidth( const wxString& aText, const wxSize& aSize, bool aItalic, bool aBold )
 {
+    std::lock_guard<std::mutex> lock( basic_gal_lock );
+
     basic_gal.SetFontItalic( aItalic );
     basic_gal.SetFontBold( aBold );
     basic_gal.SetGlyphSize( VECTOR2D( aSize ) );
@@ -149,9 +151,6 @@ void DrawGraphicText( EDA_RECT* aClipBox,
         fill_mode = false;
     }
 
-    basic_gal.SetIsFill( fill_mode );
-    basic_gal.SetLineWidth( aWidth );
-
     EDA_TEXT dummy;
     dummy.SetItalic( aItalic );
     dummy.SetBold( aBold );
@@ -166,6 +165,10 @@ void DrawGraphicText( EDA_RECT* aClipBox,
 
     dummy.SetTextSize( size );
 
+    std::lock_guard<std::mutex> lock( basic_gal_lock );
+
+    basic_gal.SetIsFill( fill_mode );
+    basic_gal.SetLineWidth( aWidth );
     basic_gal.SetTextAttributes( &dummy );
     basic_gal.SetPlotter( aPlotter );
     basic_gal.SetCallback( aCallback, aCallbackData );
@@ -177,6 +180,46 @@ void DrawGraphicText( EDA_RECT* aClipBox,
 }
 
 
+bool GraphicTextGlyphOffsets( const wxString& aText,
+                              const wxSize& aSize,
+                              enum EDA_TEXT_HJUSTIFY_T aH_justify,
+                              int aWidth,
+                              bool aItalic,
+                              bool aBold,
+                              std::vector<int>& aOffsets )
+{
+    // Same settings as DrawGraphicText()
+    if( aWidth == 0 && aBold )
+        aWidth = GetPenSizeForBold( std::min( aSize.x, aSize.y ) );
+
+    EDA_TEXT dummy;
+    dummy.SetItalic( aItalic );
+    dummy.SetBold( aBold );
+    dummy.SetHorizJustify( aH_justify );
+    dummy.SetMirrored( aSize.x < 0 );
+    dummy.SetTextSize( wxSize( std::abs( aSize.x ), aSize.y ) );
+
+    std::vector<double> offsets;
+
+    {
+        std::lock_guard<std::mutex> lock( basic_gal_lock );
+
+        basic_gal.SetLineWidth( std::abs( aWidth ) );
+        basic_gal.SetTextAttributes( &dummy );
+
+        if( !basic_gal.GetStrokeFont().ComputeGlyphOffsets( UTF8( aText ), offsets ) )
+            return false;
+    }
+
+    aOffsets.clear();
+
+    for( double offset : offsets )
+        aOffsets.push_back( KiROUND( offset ) );
+
+    return true;
+}
+
+
 void DrawGraphicHaloText( EDA_RECT* aClipBox, wxDC * aDC,
                           const wxPoint &aPos,
                           const COLOR4D aBgColor,
@@ -198,17 +198,13 @@ void EDA_DRAW_PANEL_GAL::DoRePaint()
         m_gal->SetCursorColor( settings->GetCursorColor() );
 
         // TODO: find why ClearScreen() must be called here in opengl mode
-        // and only if m_view->IsDirty() in Cairo mode to avoid distaly artifacts
-        // when moving the mouse cursor
+        // In Cairo mode the main buffer is cleared (or scrolled, when the view
+        // was only panned) by VIEW::ClearTargets()
         if( m_backend == GAL_TYPE_OPENGL )
             m_gal->ClearScreen();
 
         if( m_view->IsDirty() )
         {
-            if( m_backend != GAL_TYPE_OPENGL &&     // Already called in opengl
-                m_view->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
-                m_gal->ClearScreen();
-
             m_view->ClearTargets();
 
             // Grid has to be redrawn only when the NONCACHED target is redrawn
@@ -66,6 +66,8 @@ void EDA_TEXT::SwapEffects( EDA_TEXT& aTradingPartner )
 
 int EDA_TEXT::LenSize( const wxString& aLine, int aThickness ) const
 {
+    std::lock_guard<std::mutex> lock( basic_gal_lock );
+
     basic_gal.SetFontItalic( IsItalic() );
     basic_gal.SetFontBold( IsBold() );
     basic_gal.SetLineWidth( aThickness );
@@ -31,6 +31,9 @@
 #include <gal/cairo/cairo_compositor.h>
 #include <wx/log.h>
 
+#include <cstdlib>
+#include <cstring>
+
 using namespace KIGFX;
 
 CAIRO_COMPOSITOR::CAIRO_COMPOSITOR( cairo_t** aMainContext ) :
@@ -145,6 +148,87 @@ void CAIRO_COMPOSITOR::ClearBuffer( const COLOR4D& aColor )
 {
     // Clear the pixel storage
     memset( m_buffers[m_current].bitmap.get(), 0x00, m_bufferSize * sizeof(int) );
+
+    // Drop the clipping left by the last scroll, the whole buffer is going to be redrawn
+    cairo_reset_clip( m_buffers[m_current].context );
+}
+
+
+void CAIRO_COMPOSITOR::ScrollBuffer( unsigned int aBufferHandle, int aDx, int aDy )
+{
+    wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
+
+    CAIRO_BUFFER& buffer = m_buffers[aBufferHandle - 1];
+    unsigned char* data  = reinterpret_cast<unsigned char*>( buffer.bitmap.get() );
+    const int pixelSize  = sizeof( unsigned int );
+    const int width      = m_width;
+    const int height     = m_height;
+
+    cairo_surface_flush( buffer.surface );
+
+    if( std::abs( aDx ) >= width || std::abs( aDy ) >= height )
+    {
+        memset( data, 0x00, m_stride * m_height );
+    }
+    else
+    {
+        const int rowLength = ( width - std::abs( aDx ) ) * pixelSize;
+        const int srcX      = aDx < 0 ? -aDx : 0;
+        const int dstX      = aDx > 0 ? aDx : 0;
+
+        // Rows are moved in the order that does not overwrite the rows still to be copied
+        if( aDy > 0 )
+        {
+            for( int y = height - 1; y >= aDy; --y )
+                memmove( data + y * m_stride + dstX * pixelSize,
+                         data + ( y - aDy ) * m_stride + srcX * pixelSize, rowLength );
+        }
+        else
+        {
+            for( int y = 0; y < height + aDy; ++y )
+                memmove( data + y * m_stride + dstX * pixelSize,
+                         data + ( y - aDy ) * m_stride + srcX * pixelSize, rowLength );
+        }
+
+        // Clear the uncovered rows and columns
+        const int firstRow = aDy > 0 ? 0 : height + aDy;
+        const int firstCol = aDx > 0 ? 0 : width + aDx;
+
+        for( int y = firstRow; y < firstRow + std::abs( aDy ); ++y )
+            memset( data + y * m_stride, 0x00, width * pixelSize );
+
+        if( aDx != 0 )
+        {
+            for( int y = 0; y < height; ++y )
+                memset( data + y * m_stride + firstCol * pixelSize, 0x00,
+                        std::abs( aDx ) * pixelSize );
+        }
+    }
+
+    cairo_surface_mark_dirty( buffer.surface );
+
+    // Limit drawing to the uncovered areas, the rest of the buffer is up to date.
+    // The clip rectangles are given in the screen space.
+    cairo_t* context = buffer.context;
+    cairo_matrix_t matrix;
+
+    cairo_get_matrix( context, &matrix );
+    cairo_identity_matrix( context );
+    cairo_reset_clip( context );
+    cairo_new_path( context );
+
+    if( aDx > 0 )
+        cairo_rectangle( context, 0, 0, aDx, height );
+    else if( aDx < 0 )
+        cairo_rectangle( context, width + aDx, 0, -aDx, height );
+
+    if( aDy > 0 )
+        cairo_rectangle( context, 0, 0, width, aDy );
+    else if( aDy < 0 )
+        cairo_rectangle( context, 0, height + aDy, width, -aDy );
+
+    cairo_clip( context );
+    cairo_set_matrix( context, &matrix );
 }
 
 
@@ -1204,6 +1204,7 @@ CAIRO_GAL::CAIRO_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions,
     mainBuffer          = 0;
     overlayBuffer       = 0;
     validCompositor     = false;
+    validMainBuffer     = false;
     SetTarget( TARGET_NONCACHED );
 
     parentWindow  = aParent;
@@ -1437,6 +1438,57 @@ void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 
     // Restore the previous state
     compositor->SetBuffer( currentBuffer );
+
+    // The main buffer is going to be drawn from scratch using the current transformation
+    if( aTarget != TARGET_OVERLAY )
+    {
+        validMainBuffer  = true;
+        mainBufferMatrix = worldScreenMatrix;
+    }
+}
+
+
+bool CAIRO_GAL::ScrollTargets( std::vector<BOX2I>& aExposed )
+{
+    if( !validCompositor || !validMainBuffer )
+        return false;
+
+    // Only a translation by whole pixels keeps the already drawn contents valid
+    for( int i = 0; i < 2; ++i )
+    {
+        for( int j = 0; j < 2; ++j )
+        {
+            if( worldScreenMatrix.m_data[i][j] != mainBufferMatrix.m_data[i][j] )
+                return false;
+        }
+    }
+
+    const double dx = worldScreenMatrix.m_data[0][2] - mainBufferMatrix.m_data[0][2];
+    const double dy = worldScreenMatrix.m_data[1][2] - mainBufferMatrix.m_data[1][2];
+    const int    idx = KiROUND( dx );
+    const int    idy = KiROUND( dy );
+
+    if( std::fabs( dx - idx ) > 1e-3 || std::fabs( dy - idy ) > 1e-3 )
+        return false;
+
+    // Nothing would be left to reuse
+    if( std::abs( idx ) >= screenSize.x || std::abs( idy ) >= screenSize.y )
+        return false;
+
+    compositor->ScrollBuffer( mainBuffer, idx, idy );
+    mainBufferMatrix = worldScreenMatrix;
+
+    if( idx > 0 )
+        aExposed.emplace_back( VECTOR2I( 0, 0 ), VECTOR2I( idx, screenSize.y ) );
+    else if( idx < 0 )
+        aExposed.emplace_back( VECTOR2I( screenSize.x + idx, 0 ), VECTOR2I( -idx, screenSize.y ) );
+
+    if( idy > 0 )
+        aExposed.emplace_back( VECTOR2I( 0, 0 ), VECTOR2I( screenSize.x, idy ) );
+    else if( idy < 0 )
+        aExposed.emplace_back( VECTOR2I( 0, screenSize.y + idy ), VECTOR2I( screenSize.x, -idy ) );
+
+    return true;
 }
 
 
@@ -1509,6 +1561,7 @@ void CAIRO_GAL::setCompositor()
     overlayBuffer = compositor->CreateBuffer();
 
     validCompositor = true;
+    validMainBuffer = false;
 }
 
 
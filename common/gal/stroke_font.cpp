@@ -372,6 +372,55 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 }
 
 
+bool STROKE_FONT::ComputeGlyphOffsets( const UTF8& aText, std::vector<double>& aOffsets ) const
+{
+    if( aText.find( '\n' ) != aText.npos || aText.find( '~' ) != aText.npos )
+        return false;
+
+    VECTOR2D glyphSize( m_gal->GetGlyphSize() );
+    float    lineWidth = m_gal->GetLineWidth();
+
+    // Same line width as the one used by Draw()
+    if( m_gal->IsFontBold() )
+        lineWidth *= BOLD_FACTOR;
+
+    double textWidth = ComputeStringBoundaryLimits( aText, glyphSize, lineWidth ).x;
+    double xOffset = 0.0;
+
+    // See drawSingleLineText(): a mirrored text is the mirror image of the not mirrored one
+    switch( m_gal->GetHorizontalJustify() )
+    {
+    case GR_TEXT_HJUSTIFY_CENTER:
+        xOffset = -textWidth / 2.0;
+        break;
+
+    case GR_TEXT_HJUSTIFY_RIGHT:
+        xOffset = -textWidth;
+        break;
+
+    default:
+        break;
+    }
+
+    double sign = m_gal->IsTextMirrored() ? -1.0 : 1.0;
+
+    aOffsets.clear();
+
+    for( UTF8::uni_iter chIt = aText.ubegin(), end = aText.uend(); chIt < end; ++chIt )
+    {
+        int dd = *chIt - ' ';
+
+        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+            dd = '?' - ' ';
+
+        aOffsets.push_back( sign * xOffset );
+        xOffset += glyphSize.x * m_glyphBoundingBoxes[dd].GetEnd().x;
+    }
+
+    return true;
+}
+
+
 double STROKE_FONT::ComputeOverbarVerticalPosition( double aGlyphHeight, double aGlyphThickness ) const
 {
     // Static method.
@@ -0,0 +1,462 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+#include <geometry/poly_edge_index.h>
+#include <geometry/shape_poly_set.h>
+#include <math/math_util.h>
+
+
+// NearestPoint() rounds the projected point to integer coordinates, so a reported
+// distance may be slightly smaller than the geometric one. Search bounds are widened
+// by this amount so that no edge is ever missed.
+static const int ROUNDING_MARGIN = 2;
+
+// SHAPE_LINE_CHAIN::PointOnEdge() accepts points whose (rounded, truncated) distance to
+// an edge is 1, which can be up to ~2.5 units away. Edges are binned with this margin.
+static const int ON_EDGE_MARGIN = 3;
+
+
+POLY_EDGE_INDEX::POLY_EDGE_INDEX( const SHAPE_POLY_SET& aPolySet ) :
+    m_cellSize( 1 ),
+    m_cols( 0 ),
+    m_rows( 0 )
+{
+    // Edges that take part in the point in polygon crossing test. Same rules as
+    // SHAPE_LINE_CHAIN::PointInside(): closed contours with at least 3 vertices,
+    // non horizontal edges only.
+    std::vector<bool> crossing;
+
+    int64_t minX = INT64_MAX, minY = INT64_MAX;
+    int64_t maxX = INT64_MIN, maxY = INT64_MIN;
+
+    for( int polyIdx = 0; polyIdx < aPolySet.OutlineCount(); polyIdx++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aPolySet.CPolygon( polyIdx );
+
+        for( unsigned int contourIdx = 0; contourIdx < poly.size(); contourIdx++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = poly[contourIdx];
+            bool insideTest = chain.IsClosed() && chain.PointCount() >= 3;
+
+            for( int i = 0; i < chain.SegmentCount(); i++ )
+            {
+                const SEG seg = chain.CSegment( i );
+
+                m_edges.push_back( { seg, polyIdx, (int) contourIdx } );
+                crossing.push_back( insideTest && seg.A.y != seg.B.y );
+
+                minX = std::min<int64_t>( minX, std::min( seg.A.x, seg.B.x ) );
+                minY = std::min<int64_t>( minY, std::min( seg.A.y, seg.B.y ) );
+                maxX = std::max<int64_t>( maxX, std::max( seg.A.x, seg.B.x ) );
+                maxY = std::max<int64_t>( maxY, std::max( seg.A.y, seg.B.y ) );
+            }
+        }
+    }
+
+    if( m_edges.empty() )
+        return;
+
+    minX -= ON_EDGE_MARGIN;
+    minY -= ON_EDGE_MARGIN;
+    maxX += ON_EDGE_MARGIN;
+    maxY += ON_EDGE_MARGIN;
+
+    m_origin = VECTOR2I( minX, minY );
+
+    int64_t w = maxX - minX + 1;
+    int64_t h = maxY - minY + 1;
+    int64_t maxCells = 4 * (int64_t) m_edges.size() + 16;
+
+    // Aim for roughly one cell per edge
+    double cellSize = std::sqrt( (double) w * (double) h / (double) m_edges.size() );
+    m_cellSize = std::max( 1, (int) std::min<double>( std::ceil( cellSize ), INT32_MAX / 2 ) );
+
+    while( ( ( w - 1 ) / m_cellSize + 1 ) * ( ( h - 1 ) / m_cellSize + 1 ) > maxCells )
+        m_cellSize = std::min<int64_t>( (int64_t) m_cellSize * 2, INT32_MAX / 2 );
+
+    m_cols = ( w - 1 ) / m_cellSize + 1;
+    m_rows = ( h - 1 ) / m_cellSize + 1;
+
+    // Walks the cells covered by an edge inflated by ON_EDGE_MARGIN, row by row, so that
+    // long diagonal edges do not populate their whole bounding box.
+    auto forEachCell = [&]( const SEG& aSeg, const std::function<void( int )>& aFunc )
+    {
+        int64_t segMinY = std::min( aSeg.A.y, aSeg.B.y );
+        int64_t segMaxY = std::max( aSeg.A.y, aSeg.B.y );
+        int64_t segMinX = std::min( aSeg.A.x, aSeg.B.x );
+        int64_t segMaxX = std::max( aSeg.A.x, aSeg.B.x );
+        int row0 = cellY( segMinY - ON_EDGE_MARGIN );
+        int row1 = cellY( segMaxY + ON_EDGE_MARGIN );
+
+        for( int row = row0; row <= row1; row++ )
+        {
+            int64_t xlo = segMinX - ON_EDGE_MARGIN;
+            int64_t xhi = segMaxX + ON_EDGE_MARGIN;
+
+            if( aSeg.A.y != aSeg.B.y && row0 != row1 )
+            {
+                // y span of the row, widened to cover the inflated edge
+                int64_t rowY = (int64_t) m_origin.y + (int64_t) row * m_cellSize;
+                int64_t ylo = std::max<int64_t>( segMinY, rowY - ON_EDGE_MARGIN );
+                int64_t yhi = std::min<int64_t>( segMaxY, rowY + m_cellSize - 1 + ON_EDGE_MARGIN );
+                double dxdy = (double) ( aSeg.B.x - aSeg.A.x ) / (double) ( aSeg.B.y - aSeg.A.y );
+                double x0 = aSeg.A.x + dxdy * (double) ( ylo - aSeg.A.y );
+                double x1 = aSeg.A.x + dxdy * (double) ( yhi - aSeg.A.y );
+
+                xlo = std::max<int64_t>( xlo, (int64_t) std::floor( std::min( x0, x1 ) )
+                                                      - ON_EDGE_MARGIN - 1 );
+                xhi = std::min<int64_t>( xhi, (int64_t) std::ceil( std::max( x0, x1 ) )
+                                                      + ON_EDGE_MARGIN + 1 );
+            }
+
+            int col0 = cellX( xlo );
+            int col1 = cellX( xhi );
+
+            for( int col = col0; col <= col1; col++ )
+                aFunc( row * m_cols + col );
+        }
+    };
+
+    m_bandStart.assign( m_rows + 1, 0 );
+    m_cellStart.assign( m_cols * m_rows + 1, 0 );
+
+    for( unsigned int i = 0; i < m_edges.size(); i++ )
+    {
+        const SEG& seg = m_edges[i].seg;
+
+        if( crossing[i] )
+        {
+            int band1 = cellY( std::max( seg.A.y, seg.B.y ) );
+
+            for( int band = cellY( std::min( seg.A.y, seg.B.y ) ); band <= band1; band++ )
+                m_bandStart[band + 1]++;
+        }
+
+        forEachCell( seg, [&]( int aCell ) { m_cellStart[aCell + 1]++; } );
+    }
+
+    for( int i = 0; i < m_rows; i++ )
+        m_bandStart[i + 1] += m_bandStart[i];
+
+    for( int i = 0; i < m_cols * m_rows; i++ )
+        m_cellStart[i + 1] += m_cellStart[i];
+
+    m_bandEdges.resize( m_bandStart.back() );
+    m_cellEdges.resize( m_cellStart.back() );
+
+    std::vector<int> bandFill( m_bandStart.begin(), m_bandStart.end() - 1 );
+    std::vector<int> cellFill( m_cellStart.begin(), m_cellStart.end() - 1 );
+
+    // Edges are stored in (polygon, contour) order, which Contains() relies on
+    for( unsigned int i = 0; i < m_edges.size(); i++ )
+    {
+        const SEG& seg = m_edges[i].seg;
+
+        if( crossing[i] )
+        {
+            int band1 = cellY( std::max( seg.A.y, seg.B.y ) );
+
+            for( int band = cellY( std::min( seg.A.y, seg.B.y ) ); band <= band1; band++ )
+                m_bandEdges[bandFill[band]++] = i;
+        }
+
+        forEachCell( seg, [&]( int aCell ) { m_cellEdges[cellFill[aCell]++] = i; } );
+    }
+}
+
+
+int POLY_EDGE_INDEX::cellX( int64_t aX ) const
+{
+    int64_t col = ( aX - m_origin.x ) / m_cellSize;
+
+    if( aX < m_origin.x )
+        return 0;
+
+    return std::min<int64_t>( col, m_cols - 1 );
+}
+
+
+int POLY_EDGE_INDEX::cellY( int64_t aY ) const
+{
+    int64_t row = ( aY - m_origin.y ) / m_cellSize;
+
+    if( aY < m_origin.y )
+        return 0;
+
+    return std::min<int64_t>( row, m_rows - 1 );
+}
+
+
+template <class VISITOR>
+bool POLY_EDGE_INDEX::visitCells( int aX0, int aY0, int aX1, int aY1, VISITOR aVisitor ) const
+{
+    for( int row = aY0; row <= aY1; row++ )
+    {
+        for( int col = aX0; col <= aX1; col++ )
+        {
+            int cell = row * m_cols + col;
+
+            for( int i = m_cellStart[cell]; i < m_cellStart[cell + 1]; i++ )
+            {
+                if( aVisitor( m_edges[m_cellEdges[i]] ) )
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+bool POLY_EDGE_INDEX::pointOnEdge( const VECTOR2I& aP, int aPolygon, int aContour ) const
+{
+    if( m_edges.empty() || aP.x < m_origin.x || aP.y < m_origin.y
+            || aP.x >= (int64_t) m_origin.x + (int64_t) m_cols * m_cellSize
+            || aP.y >= (int64_t) m_origin.y + (int64_t) m_rows * m_cellSize )
+        return false;
+
+    int col = cellX( aP.x );
+    int row = cellY( aP.y );
+
+    return visitCells( col, row, col, row, [&]( const EDGE& aEdge )
+    {
+        if( aEdge.polygon != aPolygon || aEdge.contour != aContour )
+            return false;
+
+        // Same test as SHAPE_LINE_CHAIN::EdgeContainingPoint()
+        return aEdge.seg.A == aP || aEdge.seg.B == aP || aEdge.seg.Distance( aP ) <= 1;
+    } );
+}
+
+
+bool POLY_EDGE_INDEX::Contains( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles ) const
+{
+    if( m_bandEdges.empty() || aP.y < m_origin.y
+            || aP.y >= (int64_t) m_origin.y + (int64_t) m_rows * m_cellSize )
+        return false;
+
+    int band = cellY( aP.y );
+
+    int  curPolygon = -1;
+    int  curContour = -1;
+    bool parity = false;
+    bool outlineIn = false;
+    bool holeIn = false;
+
+    // The band edges are sorted by polygon then contour, so the outline of each polygon
+    // is always tested before its holes.
+    auto closeContour = [&]()
+    {
+        if( !parity )
+            return;
+
+        if( curContour == 0 )
+            outlineIn = !pointOnEdge( aP, curPolygon, 0 );
+        else if( outlineIn && !holeIn )
+            holeIn = !pointOnEdge( aP, curPolygon, curContour );
+    };
+
+    for( int i = m_bandStart[band]; i < m_bandStart[band + 1]; i++ )
+    {
+        const EDGE& edge = m_edges[m_bandEdges[i]];
+
+        if( aSubpolyIndex >= 0 && edge.polygon != aSubpolyIndex )
+            continue;
+
+        if( edge.polygon != curPolygon || edge.contour != curContour )
+        {
+            closeContour();
+
+            if( edge.polygon != curPolygon )
+            {
+                if( outlineIn && !holeIn )
+                    return true;
+
+                curPolygon = edge.polygon;
+                outlineIn = false;
+                holeIn = false;
+            }
+
+            curContour = edge.contour;
+            parity = false;
+        }
+
+        if( curContour > 0 && ( aIgnoreHoles || !outlineIn || holeIn ) )
+            continue;
+
+        // Same crossing test as SHAPE_LINE_CHAIN::PointInside()
+        const VECTOR2I& p1 = edge.seg.A;
+        const VECTOR2I& p2 = edge.seg.B;
+        const VECTOR2I diff = p2 - p1;
+        const int d = rescale( diff.x, ( aP.y - p1.y ), diff.y );
+
+        if( ( ( p1.y > aP.y ) != ( p2.y > aP.y ) ) && ( aP.x - p1.x < d ) )
+            parity = !parity;
+    }
+
+    closeContour();
+
+    return outlineIn && !holeIn;
+}
+
+
+SEG::ecoord POLY_EDGE_INDEX::nearestEdge( const VECTOR2I& aP, int aPolygon ) const
+{
+    SEG::ecoord best = VECTOR2I::ECOORD_MAX;
+
+    if( m_edges.empty() )
+        return best;
+
+    const int cx = cellX( aP.x );
+    const int cy = cellY( aP.y );
+
+    auto visitor = [&]( const EDGE& aEdge )
+    {
+        if( aPolygon < 0 || aEdge.polygon == aPolygon )
+            best = std::min( best, aEdge.seg.SquaredDistance( aP ) );
+
+        return best == 0;
+    };
+
+    // Visit the cells in growing square rings around aP until the closest edge found so
+    // far is nearer than any cell not visited yet.
+    for( int r = 0; ; r++ )
+    {
+        int x0 = std::max( cx - r, 0 );
+        int x1 = std::min( cx + r, m_cols - 1 );
+        int y0 = std::max( cy - r, 0 );
+        int y1 = std::min( cy + r, m_rows - 1 );
+
+        if( cy - r >= 0 && visitCells( x0, cy - r, x1, cy - r, visitor ) )
+            break;
+
+        if( r > 0 && cy + r < m_rows && visitCells( x0, cy + r, x1, cy + r, visitor ) )
+            break;
+
+        if( r > 0 )
+        {
+            int ry0 = std::max( cy - r + 1, 0 );
+            int ry1 = std::min( cy + r - 1, m_rows - 1 );
+
+            if( cx - r >= 0 && visitCells( cx - r, ry0, cx - r, ry1, visitor ) )
+                break;
+
+            if( cx + r < m_cols && visitCells( cx + r, ry0, cx + r, ry1, visitor ) )
+                break;
+        }
+
+        // Lower bound of the distance from aP to the cells outside the visited area
+        int64_t bound = INT64_MAX;
+        bool unvisited = false;
+
+        if( x0 > 0 )
+        {
+            bound = std::min( bound, aP.x - ( (int64_t) m_origin.x + (int64_t) x0 * m_cellSize ) );
+            unvisited = true;
+        }
+
+        if( x1 < m_cols - 1 )
+        {
+            bound = std::min( bound, (int64_t) m_origin.x + (int64_t) ( x1 + 1 ) * m_cellSize - aP.x );
+            unvisited = true;
+        }
+
+        if( y0 > 0 )
+        {
+            bound = std::min( bound, aP.y - ( (int64_t) m_origin.y + (int64_t) y0 * m_cellSize ) );
+            unvisited = true;
+        }
+
+        if( y1 < m_rows - 1 )
+        {
+            bound = std::min( bound, (int64_t) m_origin.y + (int64_t) ( y1 + 1 ) * m_cellSize - aP.y );
+            unvisited = true;
+        }
+
+        if( !unvisited )
+            break;
+
+        bound -= ROUNDING_MARGIN;
+
+        if( bound > 0 && (double) best <= (double) bound * (double) bound )
+            break;
+    }
+
+    return best;
+}
+
+
+SEG::ecoord POLY_EDGE_INDEX::SquaredDistance( const VECTOR2I& aP, int aPolygon ) const
+{
+    return nearestEdge( aP, aPolygon );
+}
+
+
+SEG::ecoord POLY_EDGE_INDEX::SquaredDistance( const SEG& aSeg, int aPolygon ) const
+{
+    // The distance to the edges nearest to one end of the segment is an upper bound,
+    // limiting the search to the cells around the segment.
+    SEG::ecoord best = nearestEdge( aSeg.A, aPolygon );
+
+    if( best == 0 || best == VECTOR2I::ECOORD_MAX )
+        return best;
+
+    int64_t r = (int64_t) std::ceil( std::sqrt( (double) best ) ) + ROUNDING_MARGIN;
+
+    int x0 = cellX( std::min( aSeg.A.x, aSeg.B.x ) - r );
+    int x1 = cellX( std::max( aSeg.A.x, aSeg.B.x ) + r );
+    int y0 = cellY( std::min( aSeg.A.y, aSeg.B.y ) - r );
+    int y1 = cellY( std::max( aSeg.A.y, aSeg.B.y ) + r );
+
+    visitCells( x0, y0, x1, y1, [&]( const EDGE& aEdge )
+    {
+        if( aPolygon < 0 || aEdge.polygon == aPolygon )
+            best = std::min( best, aEdge.seg.SquaredDistance( aSeg ) );
+
+        return best == 0;
+    } );
+
+    return best;
+}
+
+
+bool POLY_EDGE_INDEX::IntersectsEdge( const SEG& aSeg ) const
+{
+    if( m_edges.empty() )
+        return false;
+
+    int x0 = cellX( std::min( aSeg.A.x, aSeg.B.x ) );
+    int x1 = cellX( std::max( aSeg.A.x, aSeg.B.x ) );
+    int y0 = cellY( std::min( aSeg.A.y, aSeg.B.y ) );
+    int y1 = cellY( std::max( aSeg.A.y, aSeg.B.y ) );
+
+    return visitCells( x0, y0, x1, y1, [&]( const EDGE& aEdge )
+    {
+        return (bool) aEdge.seg.Intersect( aSeg, true );
+    } );
+}
@@ -34,6 +34,10 @@
 #include <algorithm>
 #include <unordered_set>
 #include <memory>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
 
 #include <md5_hash.h>
 #include <map>
@@ -45,6 +49,7 @@
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
 #include <geometry/polygon_triangulation.h>
+#include <geometry/poly_edge_index.h>
 
 using namespace ClipperLib;
 
@@ -55,13 +60,21 @@ SHAPE_POLY_SET::SHAPE_POLY_SET() :
 
 
 SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy ) :
-    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys )
+    SHAPE( SH_POLY_SET ), m_polys( aOther.m_polys ),
+    m_edgeIndex( aOther.m_edgeIndex ), m_edgeIndexHash( aOther.m_edgeIndexHash )
 {
     if( aOther.IsTriangulationUpToDate() )
     {
-        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
-            m_triangulatedPolys.push_back(
-                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
+        if( aDeepCopy )
+        {
+            for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
+                m_triangulatedPolys.push_back(
+                        std::make_shared<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
+        }
+        else
+        {
+            m_triangulatedPolys = aOther.m_triangulatedPolys;
+        }
 
         m_hash = aOther.GetHash();
         m_triangulationValid = true;
@@ -165,6 +178,8 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    m_edgeIndex.reset();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
@@ -177,6 +192,8 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    m_edgeIndex.reset();
+
     SHAPE_LINE_CHAIN empty_path;
 
     empty_path.SetClosed( true );
@@ -194,6 +211,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    m_edgeIndex.reset();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -215,6 +234,8 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    m_edgeIndex.reset();
+
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -268,7 +289,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.m_polys.push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -277,6 +298,8 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aIndex, int aOutline, int aHole )
 {
+    m_edgeIndex.reset();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -315,6 +338,8 @@ const VECTOR2I& SHAPE_POLY_SET::CVertex( int aIndex, int aOutline, int aHole ) c
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aGlobalIndex )
 {
+    m_edgeIndex.reset();
+
     SHAPE_POLY_SET::VERTEX_INDEX index;
 
     // Assure the passed index references a legal position; abort otherwise
@@ -437,6 +462,8 @@ bool SHAPE_POLY_SET::IsSelfIntersecting() const
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    m_edgeIndex.reset();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -451,6 +478,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    m_edgeIndex.reset();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -475,6 +504,228 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType, const SHAPE_POLY_SET
 }
 
 
+// Operands with fewer polygons than this are handled by a single Clipper pass
+static const size_t PARALLEL_BOOLEAN_MIN_POLYS = 256;
+
+// Smallest number of polygons merged by one thread at the leaves of the parallel union
+static const size_t PARALLEL_BOOLEAN_LEAF_POLYS = 64;
+
+
+static void addPolygonPaths( Clipper& aClipper, const SHAPE_POLY_SET::POLYGON& aPoly,
+                             PolyType aType )
+{
+    for( size_t i = 0; i < aPoly.size(); i++ )
+        aClipper.AddPath( aPoly[i].convertToClipper( i == 0 ), aType, true );
+}
+
+
+/**
+ * Returns the position of aP along a Z-order curve covering aBox, used to sort polygons so
+ * that the ones merged together are close to each other.
+ */
+static uint32_t zOrderKey( const VECTOR2I& aP, const BOX2I& aBox )
+{
+    uint32_t x = (uint32_t) ( (double) ( aP.x - aBox.GetX() ) * 65535.0
+                              / std::max<double>( aBox.GetWidth(), 1.0 ) );
+    uint32_t y = (uint32_t) ( (double) ( aP.y - aBox.GetY() ) * 65535.0
+                              / std::max<double>( aBox.GetHeight(), 1.0 ) );
+    uint32_t key = 0;
+
+    for( int bit = 0; bit < 16; bit++ )
+    {
+        key |= ( ( x >> bit ) & 1 ) << ( 2 * bit );
+        key |= ( ( y >> bit ) & 1 ) << ( 2 * bit + 1 );
+    }
+
+    return key;
+}
+
+
+// Number of threads currently merging boolean operands, callers included.  Operations run
+// concurrently (e.g. zones filled on several threads) share the cores through this count
+// instead of each one starting as many workers as there are cores.
+static std::atomic<size_t> s_booleanThreadsInUse( 0 );
+
+
+/**
+ * Reserves up to aWanted threads for a parallel merge, the calling thread included.
+ * @return the number of threads reserved, at least 1 (the calling thread); it must be
+ * given back with releaseBooleanThreads().
+ */
+static size_t reserveBooleanThreads( size_t aWanted )
+{
+    size_t cores = std::thread::hardware_concurrency();
+    size_t inUse = s_booleanThreadsInUse;
+    size_t reserved;
+
+    do
+    {
+        size_t available = cores > inUse ? cores - inUse : 0;
+        reserved = std::max<size_t>( 1, std::min( aWanted, available ) );
+    } while( !s_booleanThreadsInUse.compare_exchange_weak( inUse, inUse + reserved ) );
+
+    return reserved;
+}
+
+
+static void releaseBooleanThreads( size_t aCount )
+{
+    s_booleanThreadsInUse -= aCount;
+}
+
+
+/**
+ * Runs aWorker on the given number of threads; aWorker pulls its jobs from a shared counter.
+ * All the threads are joined before returning; an exception thrown by a worker is then
+ * rethrown to the caller.
+ */
+static void runWorkers( const std::function<void()>& aWorker, size_t aThreadCount )
+{
+    if( aThreadCount <= 1 )
+    {
+        aWorker();
+        return;
+    }
+
+    std::vector<std::future<void>> returns( aThreadCount );
+    std::exception_ptr error;
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, aWorker );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+    {
+        try
+        {
+            returns[ii].get();
+        }
+        catch( ... )
+        {
+            if( !error )
+                error = std::current_exception();
+        }
+    }
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+
+/**
+ * Merges the partial results of a parallel union pairwise, always in the same order,
+ * until no more than two remain.
+ */
+static void mergePairs( std::vector<Paths>& aResults, size_t aThreadCount )
+{
+    std::atomic<size_t> nextItem( 0 );
+
+    while( aResults.size() > 2 )
+    {
+        size_t pairCount = aResults.size() / 2;
+        std::vector<Paths> merged( ( aResults.size() + 1 ) / 2 );
+
+        // An odd result out is carried over to the next level
+        if( aResults.size() % 2 )
+            merged.back().swap( aResults.back() );
+
+        nextItem = 0;
+
+        auto mergeWorker = [&]()
+        {
+            for( size_t i = nextItem++; i < pairCount; i = nextItem++ )
+            {
+                Clipper c;
+
+                c.AddPaths( aResults[2 * i], ptSubject, true );
+                c.AddPaths( aResults[2 * i + 1], ptClip, true );
+                c.Execute( ctUnion, merged[i], pftNonZero, pftNonZero );
+            }
+        };
+
+        runWorkers( mergeWorker, std::min( aThreadCount, pairCount ) );
+        aResults.swap( merged );
+    }
+}
+
+
+/**
+ * Function parallelUnion
+ * merges the given polygons (non-zero fill rule) on several threads.  The polygons are
+ * sorted along a Z-order curve and merged in spatially coherent batches, then the partial
+ * results are merged pairwise until no more than two remain.  They are left for the
+ * caller to merge into its final result.
+ * Batches and pairs only depend on the polygons, and partial results are always merged in
+ * the same order, so the result does not depend on the number of threads or on their
+ * scheduling.
+ * @throw the exception thrown by Clipper on any thread.
+ */
+static std::vector<Paths> parallelUnion( std::vector<const SHAPE_POLY_SET::POLYGON*>& aPolys )
+{
+    BOX2I bbox;
+    std::vector<std::pair<uint32_t, const SHAPE_POLY_SET::POLYGON*>> sorted;
+
+    for( const SHAPE_POLY_SET::POLYGON* poly : aPolys )
+    {
+        if( poly->front().PointCount() )
+            bbox.Merge( poly->front().BBox() );
+    }
+
+    for( const SHAPE_POLY_SET::POLYGON* poly : aPolys )
+    {
+        uint32_t key = 0;
+
+        if( poly->front().PointCount() )
+            key = zOrderKey( poly->front().BBox().Centre(), bbox );
+
+        sorted.emplace_back( key, poly );
+    }
+
+    std::sort( sorted.begin(), sorted.end(),
+            []( const std::pair<uint32_t, const SHAPE_POLY_SET::POLYGON*>& a,
+                const std::pair<uint32_t, const SHAPE_POLY_SET::POLYGON*>& b )
+            {
+                return a.first < b.first;
+            } );
+
+    size_t leafCount = ( sorted.size() + PARALLEL_BOOLEAN_LEAF_POLYS - 1 )
+                       / PARALLEL_BOOLEAN_LEAF_POLYS;
+    std::vector<Paths> results( leafCount );
+    std::atomic<size_t> nextItem( 0 );
+    size_t threadCount = reserveBooleanThreads( leafCount );
+
+    // Intermediate results only need to be merged again, so they are computed in fast mode.
+    auto leafWorker = [&]()
+    {
+        for( size_t i = nextItem++; i < leafCount; i = nextItem++ )
+        {
+            size_t first = i * sorted.size() / leafCount;
+            size_t last = ( i + 1 ) * sorted.size() / leafCount;
+            Clipper c;
+
+            for( size_t j = first; j < last; j++ )
+                addPolygonPaths( c, *sorted[j].second, ptSubject );
+
+            c.Execute( ctUnion, results[i], pftNonZero, pftNonZero );
+        }
+    };
+
+    try
+    {
+        runWorkers( leafWorker, threadCount );
+        mergePairs( results, threadCount );
+    }
+    catch( ... )
+    {
+        releaseBooleanThreads( threadCount );
+        throw;
+    }
+
+    releaseBooleanThreads( threadCount );
+
+    return results;
+}
+
+
 void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
         const SHAPE_POLY_SET& aShape,
         const SHAPE_POLY_SET& aOtherShape,
@@ -484,16 +735,64 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
 
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
 
-    for( auto poly : aShape.m_polys )
+    // Large operands are first merged on several threads, by spatially coherent batches.
+    // The region covered by an operand is the union of its polygons, so this does not
+    // change the covered region, but vertices created at edge intersections may be rounded
+    // differently than by a single Clipper pass.  Only the final merge below is done in the
+    // requested mode.
+    // For unions both operands are merged; for the other operations only the clip operand
+    // is, because the operation only uses the region it covers.
+    bool mergeAll = aType == ctUnion
+                    && aShape.m_polys.size() + aOtherShape.m_polys.size()
+                               >= PARALLEL_BOOLEAN_MIN_POLYS;
+    bool mergeClip = !mergeAll && aOtherShape.m_polys.size() >= PARALLEL_BOOLEAN_MIN_POLYS;
+    std::vector<Paths> merged;
+
+    if( mergeAll || mergeClip )
     {
-        for( size_t i = 0 ; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptSubject, true );
+        std::vector<const POLYGON*> polys;
+
+        if( mergeAll )
+        {
+            for( const POLYGON& poly : aShape.m_polys )
+                polys.push_back( &poly );
+        }
+
+        for( const POLYGON& poly : aOtherShape.m_polys )
+            polys.push_back( &poly );
+
+        try
+        {
+            merged = parallelUnion( polys );
+        }
+        catch( const std::exception& )
+        {
+            // Fall back to a single Clipper pass, which reports its own errors
+            mergeAll = mergeClip = false;
+            merged.clear();
+        }
     }
 
-    for( auto poly : aOtherShape.m_polys )
+    if( mergeAll )
     {
-        for( size_t i = 0; i < poly.size(); i++ )
-            c.AddPath( poly[i].convertToClipper( i == 0 ), ptClip, true );
+        for( size_t i = 0; i < merged.size(); i++ )
+            c.AddPaths( merged[i], i == 0 ? ptSubject : ptClip, true );
+    }
+    else
+    {
+        for( const POLYGON& poly : aShape.m_polys )
+            addPolygonPaths( c, poly, ptSubject );
+
+        if( mergeClip )
+        {
+            for( const Paths& paths : merged )
+                c.AddPaths( paths, ptClip, true );
+        }
+        else
+        {
+            for( const POLYGON& poly : aOtherShape.m_polys )
+                addPolygonPaths( c, poly, ptClip );
+        }
     }
 
     PolyTree solution;
@@ -568,8 +867,10 @@ void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount, bool aPrese
     // aFactor.  Setting jtMiter and forcing the limit to be aFactor creates sharp corners.
     JoinType type = aPreseveCorners ? jtMiter : jtRound;
 
-    for( const POLYGON& poly : m_polys )
+    for( int ii = 0; ii < OutlineCount(); ii++ )
     {
+        const POLYGON& poly = CPolygon( ii );
+
         for( size_t i = 0; i < poly.size(); i++ )
             c.AddPath( poly[i].convertToClipper( i == 0 ), type, etClosedPolygon );
     }
@@ -607,6 +908,8 @@ void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount, bool aPrese
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    m_edgeIndex.reset();
+
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -845,6 +1148,8 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
+    m_edgeIndex.reset();
+
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
     for( POLYGON& paths : m_polys )
@@ -1032,6 +1337,8 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
+    m_edgeIndex.reset();
+
     for( POLYGON& path : m_polys )
     {
         unfractureSingle( path );
@@ -1051,6 +1358,8 @@ void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 
 int SHAPE_POLY_SET::NormalizeAreaOutlines()
 {
+    m_edgeIndex.reset();
+
     // We are expecting only one main outline, but this main outline can have holes
     // if holes: combine holes and remove them from the main outline.
     // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
@@ -1109,6 +1418,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    m_edgeIndex.reset();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -1202,6 +1513,8 @@ bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 
 bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 {
+    if( aClearance <= 0 && m_edgeIndex )
+        return Contains( aSeg.A ) || m_edgeIndex->IntersectsEdge( aSeg );
 
     SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
 
@@ -1233,6 +1546,10 @@ bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 
 bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 {
+    // No need to copy the set if it is not inflated
+    if( aClearance <= 0 )
+        return Contains( aP );
+
     SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
 
     // Inflate the polygon if necessary.
@@ -1249,12 +1566,16 @@ bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    m_edgeIndex.reset();
+
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    m_edgeIndex.reset();
+
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
@@ -1265,6 +1586,8 @@ void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 
 int SHAPE_POLY_SET::RemoveNullSegments()
 {
+    m_edgeIndex.reset();
+
     int removed = 0;
 
     ITERATOR iterator = IterateWithHoles();
@@ -1318,18 +1641,24 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    m_edgeIndex.reset();
+
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    m_edgeIndex.reset();
+
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
 
 void SHAPE_POLY_SET::Append( const VECTOR2I& aP, int aOutline, int aHole )
 {
+    m_edgeIndex.reset();
+
     Append( aP.x, aP.y, aOutline, aHole );
 }
 
@@ -1407,6 +1736,9 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, bool aIgno
     if( m_polys.size() == 0 ) // empty set?
         return false;
 
+    if( m_edgeIndex )
+        return m_edgeIndex->Contains( aP, aSubpolyIndex, aIgnoreHoles );
+
     // If there is a polygon specified, check the condition against that polygon
     if( aSubpolyIndex >= 0 )
         return containsSingle( aP, aSubpolyIndex, aIgnoreHoles );
@@ -1436,12 +1768,17 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    m_edgeIndex.reset();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
 
 bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles ) const
 {
+    if( m_edgeIndex )
+        return m_edgeIndex->Contains( aP, aSubpolyIndex, aIgnoreHoles );
+
     // Check that the point is inside the outline
     if( pointInPolygon( aP, m_polys[aSubpolyIndex][0] ) )
     {
@@ -1474,6 +1811,8 @@ bool SHAPE_POLY_SET::pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN&
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    m_edgeIndex.reset();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1486,6 +1825,8 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    m_edgeIndex.reset();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1535,6 +1876,9 @@ int SHAPE_POLY_SET::DistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex )
     if( containsSingle( aPoint, aPolygonIndex ) )
         return 0;
 
+    if( m_edgeIndex )
+        return sqrt( m_edgeIndex->SquaredDistance( aPoint, aPolygonIndex ) );
+
     SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
 
     SEG polygonEdge = *iterator;
@@ -1563,19 +1907,28 @@ int SHAPE_POLY_SET::DistanceToPolygon( SEG aSegment, int aPolygonIndex, int aSeg
     if( containsSingle( aSegment.A, aPolygonIndex ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
+    int minDistance;
 
-    SEG polygonEdge = *iterator;
-    int minDistance = polygonEdge.Distance( aSegment );
-
-    for( iterator++; iterator && minDistance > 0; iterator++ )
+    if( m_edgeIndex )
     {
-        polygonEdge = *iterator;
+        minDistance = sqrt( m_edgeIndex->SquaredDistance( aSegment, aPolygonIndex ) );
+    }
+    else
+    {
+        SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
 
-        int currentDistance = polygonEdge.Distance( aSegment );
+        SEG polygonEdge = *iterator;
+        minDistance = polygonEdge.Distance( aSegment );
 
-        if( currentDistance < minDistance )
-            minDistance = currentDistance;
+        for( iterator++; iterator && minDistance > 0; iterator++ )
+        {
+            polygonEdge = *iterator;
+
+            int currentDistance = polygonEdge.Distance( aSegment );
+
+            if( currentDistance < minDistance )
+                minDistance = currentDistance;
+        }
     }
 
     // Take into account the width of the segment
@@ -1589,6 +1942,15 @@ int SHAPE_POLY_SET::DistanceToPolygon( SEG aSegment, int aPolygonIndex, int aSeg
 
 int SHAPE_POLY_SET::Distance( VECTOR2I aPoint )
 {
+    // A single search over the edges of all the polygons
+    if( m_edgeIndex && !m_polys.empty() )
+    {
+        if( Contains( aPoint ) )
+            return 0;
+
+        return sqrt( m_edgeIndex->SquaredDistance( aPoint ) );
+    }
+
     int currentDistance;
     int minDistance = DistanceToPolygon( aPoint, 0 );
 
@@ -1607,6 +1969,19 @@ int SHAPE_POLY_SET::Distance( VECTOR2I aPoint )
 
 int SHAPE_POLY_SET::Distance( const SEG& aSegment, int aSegmentWidth )
 {
+    if( m_edgeIndex && !m_polys.empty() )
+    {
+        if( Contains( aSegment.A ) )
+            return 0;
+
+        int minDistance = sqrt( m_edgeIndex->SquaredDistance( aSegment ) );
+
+        if( aSegmentWidth > 0 )
+            minDistance -= aSegmentWidth / 2;
+
+        return minDistance < 0 ? 0 : minDistance;
+    }
+
     int currentDistance;
     int minDistance = DistanceToPolygon( aSegment, 0, aSegmentWidth );
 
@@ -1826,10 +2201,25 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
     static_cast<SHAPE&>(*this) = aOther;
     m_polys = aOther.m_polys;
 
-    // reset poly cache:
-    m_hash = MD5_HASH{};
-    m_triangulationValid = false;
+    // the edge index does not depend on anything but the contours, it can be shared
+    m_edgeIndex = aOther.m_edgeIndex;
+    m_edgeIndexHash = aOther.m_edgeIndexHash;
+
+    // the triangulation is never modified once built, it can be shared too
     m_triangulatedPolys.clear();
+
+    if( aOther.IsTriangulationUpToDate() )
+    {
+        m_triangulatedPolys = aOther.m_triangulatedPolys;
+        m_hash = aOther.GetHash();
+        m_triangulationValid = true;
+    }
+    else
+    {
+        m_hash = MD5_HASH{};
+        m_triangulationValid = false;
+    }
+
     return *this;
 }
 
@@ -1842,6 +2232,38 @@ MD5_HASH SHAPE_POLY_SET::GetHash() const
 }
 
 
+size_t SHAPE_POLY_SET::GetMemoryUsage() const
+{
+    size_t usage = 0;
+
+    if( m_polys.ShareCount() > 0 )
+    {
+        size_t polysUsage = 0;
+
+        for( const POLYGON& poly : m_polys )
+        {
+            polysUsage += sizeof( POLYGON ) + poly.capacity() * sizeof( SHAPE_LINE_CHAIN );
+
+            for( const SHAPE_LINE_CHAIN& path : poly )
+                polysUsage += path.PointCount() * sizeof( VECTOR2I );
+        }
+
+        usage += polysUsage / m_polys.ShareCount();
+    }
+
+    for( const std::shared_ptr<TRIANGULATED_POLYGON>& tri : m_triangulatedPolys )
+    {
+        size_t triUsage = sizeof( TRIANGULATED_POLYGON )
+                          + tri->GetTriangleCount() * sizeof( TRIANGULATED_POLYGON::TRI )
+                          + tri->GetVertexCount() * sizeof( VECTOR2I );
+
+        usage += triUsage / tri.use_count();
+    }
+
+    return usage;
+}
+
+
 bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 {
     if( !m_triangulationValid )
@@ -1888,7 +2310,7 @@ void SHAPE_POLY_SET::CacheTriangulation()
 
     while( tmpSet.OutlineCount() > 0 )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
+        m_triangulatedPolys.push_back( std::make_shared<TRIANGULATED_POLYGON>() );
         PolygonTriangulation tess( *m_triangulatedPolys.back() );
 
         // If the tesselation fails, we re-fracture the polygon, which will
@@ -1910,6 +2332,24 @@ void SHAPE_POLY_SET::CacheTriangulation()
 }
 
 
+void SHAPE_POLY_SET::CacheEdgeIndex()
+{
+    MD5_HASH hash = checksum();
+
+    if( m_edgeIndex && hash == m_edgeIndexHash )
+        return;
+
+    m_edgeIndex = std::make_shared<POLY_EDGE_INDEX>( *this );
+    m_edgeIndexHash = hash;
+}
+
+
+bool SHAPE_POLY_SET::IsEdgeIndexUpToDate() const
+{
+    return m_edgeIndex && m_edgeIndexHash == checksum();
+}
+
+
 MD5_HASH SHAPE_POLY_SET::checksum() const
 {
     MD5_HASH hash;
@@ -22,6 +22,10 @@
 #include <lib_tree_model.h>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <iterator>
+#include <thread>
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
 #include <make_unique.h>
@@ -120,6 +124,7 @@ LIB_TREE_NODE::LIB_TREE_NODE()
       IntrinsicRank( 0 ),
       Score( kLowestDefaultScore ),
       Normalized( false ),
+      Indexed( false ),
       Unit( 0 ),
       IsRoot( false ),
       VisLen( 0 )
@@ -196,6 +201,7 @@ void LIB_TREE_NODE_LIB_ID::Update( LIB_TREE_ITEM* aItem )
 
     SearchText = aItem->GetSearchText();
     Normalized = false;
+    Indexed = false;
 
     IsRoot = aItem->IsRoot();
     Children.clear();
@@ -205,17 +211,23 @@ void LIB_TREE_NODE_LIB_ID::Update( LIB_TREE_ITEM* aItem )
 }
 
 
-void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
+void LIB_TREE_NODE_LIB_ID::Normalize()
 {
-    if( Score <= 0 )
-        return; // Leaf nodes without scores are out of the game.
-
     if( !Normalized )
     {
         MatchName = MatchName.Lower();
         SearchText = SearchText.Lower();
         Normalized = true;
     }
+}
+
+
+void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
+{
+    if( Score <= 0 )
+        return; // Leaf nodes without scores are out of the game.
+
+    Normalize();
 
     // Keywords and description we only count if the match string is at
     // least two characters long. That avoids spurious, low quality
@@ -336,3 +348,275 @@ void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
         child->UpdateScore( aMatcher );
 }
 
+
+void LIB_TREE_NODE_ROOT::UpdateScore( wxString const& aTerm )
+{
+    // Below this many candidates, scoring them is cheaper than starting threads.
+    const size_t parallelThreshold = 2000;
+
+    std::vector<LIB_TREE_NODE*> candidates;
+
+    m_searchIndex.Update( *this );
+
+    if( !m_searchIndex.FindCandidates( aTerm, candidates ) )
+    {
+        EDA_COMBINED_MATCHER matcher( aTerm );
+        UpdateScore( matcher );
+        return;
+    }
+
+    // The nodes which are not candidates drop out, as if none of the matchers had found
+    // the term in them.
+    std::vector<int> scores;
+
+    for( auto node : candidates )
+        scores.push_back( node->Score );
+
+    for( auto& lib : Children )
+    {
+        for( auto& child : lib->Children )
+            child->Score = 0;
+    }
+
+    for( size_t i = 0; i < candidates.size(); ++i )
+        candidates[i]->Score = scores[i];
+
+    // The matchers are not reentrant, so each thread gets its own.  They are built here
+    // because compiling a regex changes the global log level.
+    size_t parallelThreadCount = 1;
+
+    if( candidates.size() >= parallelThreshold )
+    {
+        parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                candidates.size() / parallelThreshold );
+        parallelThreadCount = std::max<size_t>( parallelThreadCount, 1 );
+    }
+
+    std::vector<std::unique_ptr<EDA_COMBINED_MATCHER>> matchers;
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        matchers.push_back( std::make_unique<EDA_COMBINED_MATCHER>( aTerm ) );
+
+    std::atomic<size_t> nextItem( 0 );
+
+    auto score_lambda = [&]( EDA_COMBINED_MATCHER* aMatcher ) -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextItem++; i < candidates.size(); i = nextItem++ )
+        {
+            candidates[i]->UpdateScore( *aMatcher );
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+    {
+        score_lambda( matchers[0].get() );
+    }
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, score_lambda, matchers[ii].get() );
+
+        for( auto& ret : returns )
+            ret.wait();
+    }
+
+    // Libraries take the best score of their nodes; empty ones are matched on their name.
+    for( auto& lib : Children )
+    {
+        if( lib->Children.empty() )
+        {
+            lib->UpdateScore( *matchers[0] );
+            continue;
+        }
+
+        lib->Score = 0;
+
+        for( auto& child : lib->Children )
+            lib->Score = std::max( lib->Score, child->Score );
+    }
+}
+
+
+// Trigrams of a lowercase string, packed as three 21 bit code points.
+static void getTrigrams( wxString const& aText, std::vector<uint64_t>& aTrigrams )
+{
+    uint64_t key = 0;
+    size_t   count = 0;
+
+    for( wxUniChar c : aText )
+    {
+        key = ( ( key << 21 ) | ( c.GetValue() & 0x1FFFFF ) ) & ( ( uint64_t( 1 ) << 63 ) - 1 );
+
+        if( ++count >= 3 )
+            aTrigrams.push_back( key );
+    }
+}
+
+
+// A term is plain when all the matchers of EDA_COMBINED_MATCHER reduce to a substring search
+// for it: it has no regex or wildcard syntax, and no relational operator.
+static bool isPlainTerm( wxString const& aTerm )
+{
+    static const wxString special = wxT( ".*+?^${}()|[]\\<>=" );
+
+    for( wxUniChar c : aTerm )
+    {
+        if( special.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
+bool LIB_TREE_SEARCH_INDEX::isUpToDate( LIB_TREE_NODE_ROOT const& aRoot ) const
+{
+    if( aRoot.Children.size() != m_libs.size() )
+        return false;
+
+    for( size_t i = 0; i < m_libs.size(); ++i )
+    {
+        LIB_ENTRY const& entry = m_libs[i];
+        LIB_TREE_NODE const* lib = aRoot.Children[i].get();
+
+        if( lib != entry.lib || lib->Children.size() != entry.last - entry.first )
+            return false;
+
+        for( size_t j = 0; j < lib->Children.size(); ++j )
+        {
+            LIB_TREE_NODE const* node = lib->Children[j].get();
+
+            if( node != m_nodes[entry.first + j] || !node->Indexed )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+void LIB_TREE_SEARCH_INDEX::Update( LIB_TREE_NODE_ROOT& aRoot )
+{
+    if( isUpToDate( aRoot ) )
+        return;
+
+    m_libs.clear();
+    m_nodes.clear();
+    m_postings.clear();
+
+    std::vector<uint64_t> trigrams;
+
+    for( auto& lib : aRoot.Children )
+    {
+        LIB_ENTRY entry;
+
+        entry.lib = lib.get();
+        entry.first = m_nodes.size();
+
+        for( auto& child : lib->Children )
+        {
+            auto node = static_cast<LIB_TREE_NODE_LIB_ID*>( child.get() );
+            unsigned index = m_nodes.size();
+
+            node->Normalize();
+            node->Indexed = true;
+            m_nodes.push_back( node );
+
+            trigrams.clear();
+            getTrigrams( node->MatchName, trigrams );
+            getTrigrams( node->SearchText, trigrams );
+
+            std::sort( trigrams.begin(), trigrams.end() );
+            trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+            for( uint64_t trigram : trigrams )
+                m_postings[trigram].push_back( index );
+        }
+
+        entry.last = m_nodes.size();
+        m_libs.push_back( entry );
+    }
+}
+
+
+bool LIB_TREE_SEARCH_INDEX::FindCandidates( wxString const& aTerm,
+                                            std::vector<LIB_TREE_NODE*>& aCandidates ) const
+{
+    aCandidates.clear();
+
+    if( aTerm.length() < 3 || !isPlainTerm( aTerm ) )
+        return false;
+
+    std::vector<uint64_t> trigrams;
+    std::vector<const std::vector<unsigned>*> lists;
+
+    getTrigrams( aTerm, trigrams );
+    std::sort( trigrams.begin(), trigrams.end() );
+    trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+    for( uint64_t trigram : trigrams )
+    {
+        auto it = m_postings.find( trigram );
+
+        if( it == m_postings.end() )
+        {
+            lists.clear();
+            break;
+        }
+
+        lists.push_back( &it->second );
+    }
+
+    // Nodes containing all the trigrams of the term, starting from the rarest trigram
+    std::vector<unsigned> found;
+
+    if( lists.size() == trigrams.size() )
+    {
+        std::sort( lists.begin(), lists.end(),
+                []( const std::vector<unsigned>* a, const std::vector<unsigned>* b )
+                    { return a->size() < b->size(); } );
+
+        found = *lists[0];
+
+        for( size_t i = 1; i < lists.size() && !found.empty(); ++i )
+        {
+            std::vector<unsigned> both;
+
+            std::set_intersection( found.begin(), found.end(), lists[i]->begin(),
+                                   lists[i]->end(), std::back_inserter( both ) );
+            found.swap( both );
+        }
+    }
+
+    // All the nodes of a library match when its name does
+    bool libFound = false;
+
+    for( LIB_ENTRY const& entry : m_libs )
+    {
+        if( entry.first != entry.last && entry.lib->MatchName.Find( aTerm ) != wxNOT_FOUND )
+        {
+            for( size_t i = entry.first; i < entry.last; ++i )
+                found.push_back( i );
+
+            libFound = true;
+        }
+    }
+
+    if( libFound )
+    {
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+    }
+
+    for( unsigned index : found )
+        aCandidates.push_back( m_nodes[index] );
+
+    return true;
+}
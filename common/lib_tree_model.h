@@ -22,13 +22,16 @@
 #ifndef LIB_TREE_MODEL_H
 #define LIB_TREE_MODEL_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <wx/string.h>
 #include <lib_tree_item.h>
 
 
 class EDA_COMBINED_MATCHER;
+class LIB_TREE_NODE_ROOT;
 
 
 /**
@@ -69,6 +72,7 @@ class EDA_COMBINED_MATCHER;
  * - `Desc` - description of the alias, to be displayed
  * - `MatchName` - Name, normalized to lowercase for matching
  * - `SearchText` - normalized composite of keywords and description
+ * - `Indexed` - set once the node is in the search index of the root
  * - `LibId` - the #LIB_ID this alias or unit is from, or not valid
  * - `Unit` - the unit number, or zero for non-units
  */
@@ -99,6 +103,7 @@ public:
     wxString    MatchName;   ///< Normalized name for matching
     wxString    SearchText;  ///< Descriptive text to search
     bool        Normalized;  ///< Support for lazy normalization.
+    bool        Indexed;     ///< Node is in the search index; cleared when its text changes.
 
 
     LIB_ID      LibId;       ///< LIB_ID determined by the parent library nickname and alias name.
@@ -209,6 +214,11 @@ public:
      */
     void Update( LIB_TREE_ITEM* aItem );
 
+    /**
+     * Normalize MatchName and SearchText to lowercase, if not done yet.
+     */
+    void Normalize();
+
     /**
      * Perform the actual search.
      */
@@ -258,6 +268,52 @@ public:
 };
 
 
+/**
+ * Trigram index over the names, keywords and descriptions of the #LIB_ID nodes of a tree.
+ *
+ * Most search terms are plain substrings, which can only match the nodes containing all of
+ * their trigrams (or whose library name contains them).  The index returns these candidate
+ * nodes so the matchers only have to run on them instead of on the whole tree.
+ */
+class LIB_TREE_SEARCH_INDEX
+{
+public:
+    /**
+     * Rebuild the index if nodes have been added to, removed from or updated in the tree
+     * since it was built.
+     */
+    void Update( LIB_TREE_NODE_ROOT& aRoot );
+
+    /**
+     * Find the #LIB_ID nodes which may match a search term.  The others cannot match it.
+     *
+     * @param aTerm         the search term, normalized to lowercase
+     * @param aCandidates   receives the candidate nodes, in tree order
+     * @return false if the term cannot be looked up in the index (it is too short or uses
+     *         pattern syntax), in which case every node is a candidate
+     */
+    bool FindCandidates( wxString const& aTerm, std::vector<LIB_TREE_NODE*>& aCandidates ) const;
+
+private:
+    struct LIB_ENTRY
+    {
+        LIB_TREE_NODE* lib;
+        size_t         first;    ///< first node of the library in m_nodes
+        size_t         last;     ///< one past the last node of the library in m_nodes
+    };
+
+    ///> Returns true if the nodes and their texts are unchanged since the index was built.
+    bool isUpToDate( LIB_TREE_NODE_ROOT const& aRoot ) const;
+
+    ///> Libraries and their nodes, in tree order.
+    std::vector<LIB_ENTRY>      m_libs;
+    std::vector<LIB_TREE_NODE*> m_nodes;
+
+    ///> Indices in m_nodes of the nodes containing each trigram, in increasing order.
+    std::unordered_map<uint64_t, std::vector<unsigned>> m_postings;
+};
+
+
 /**
  * Node type: root
  */
@@ -282,6 +338,18 @@ public:
     LIB_TREE_NODE_LIB& AddLib( wxString const& aName, wxString const& aDesc );
 
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+    /**
+     * Update the scores for a search term.  This gives the same scores as
+     * UpdateScore( EDA_COMBINED_MATCHER& ), but only runs the matchers on the nodes found
+     * by the search index, in parallel when there are many of them.
+     *
+     * @param aTerm     the search term, normalized to lowercase
+     */
+    void UpdateScore( wxString const& aTerm );
+
+private:
+    LIB_TREE_SEARCH_INDEX m_searchIndex;
 };
 
 
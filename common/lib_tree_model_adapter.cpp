@@ -21,8 +21,6 @@
 
 #include <lib_tree_model_adapter.h>
 
-#include <eda_pattern_match.h>
-
 #include <wx/progdlg.h>
 #include <wx/tokenzr.h>
 #include <wx/wupdlock.h>
@@ -145,9 +143,8 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( wxString const& aSearch )
     while( tokenizer.HasMoreTokens() )
     {
         const wxString term = tokenizer.GetNextToken().Lower();
-        EDA_COMBINED_MATCHER matcher( term );
 
-        m_tree.UpdateScore( matcher );
+        m_tree.UpdateScore( term );
     }
 
     m_tree.SortNodes();
@@ -53,6 +53,7 @@ public:
         m_flags( KIGFX::VISIBLE ),
         m_requiredUpdate( KIGFX::NONE ),
         m_drawPriority( 0 ),
+        m_bboxSize( 0 ),
         m_groups( nullptr ),
         m_groupsSize( 0 ) {}
 
@@ -86,10 +87,23 @@ private:
         aCount = m_layers.size();
     }
 
+    /**
+     * Function saveBboxSize()
+     * Stores the larger dimension of the item bounding box, so the level of detail culling
+     * does not have to recompute the bounding box for every redraw.
+     *
+     * @param aBBox is the current bounding box of the item.
+     */
+    void saveBboxSize( const BOX2I& aBBox )
+    {
+        m_bboxSize = std::max( aBBox.GetWidth(), aBBox.GetHeight() );
+    }
+
     VIEW*   m_view;             ///< Current dynamic view the item is assigned to.
     int     m_flags;            ///< Visibility flags
     int     m_requiredUpdate;   ///< Flag required for updating
     int     m_drawPriority;     ///< Order to draw this item in a layer, lowest first
+    int     m_bboxSize;         ///< Larger dimension of the bounding box, used for LOD culling
 
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
@@ -291,6 +305,7 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_painter( NULL ),
     m_gal( NULL ),
     m_dynamic( aIsDynamic ),
+    m_panOnly( false ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
     m_reverseDrawOrder( false )
@@ -339,6 +354,7 @@ void VIEW::AddLayer( int aLayer, bool aDisplayOnly )
         m_layers[aLayer].visible        = true;
         m_layers[aLayer].displayOnly    = aDisplayOnly;
         m_layers[aLayer].target         = TARGET_CACHED;
+        m_layers[aLayer].minScreenSize  = 0.0;
     }
 }
 
@@ -358,6 +374,7 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
 
     aItem->ViewGetLayers( layers, layers_count );
     aItem->viewPrivData()->saveLayers( layers, layers_count );
+    aItem->viewPrivData()->saveBboxSize( aItem->ViewBBox() );
 
     m_allItems->push_back( aItem );
 
@@ -600,6 +617,11 @@ void VIEW::SetScale( double aScale, const VECTOR2D& aAnchor )
 
 void VIEW::SetCenter( const VECTOR2D& aCenter )
 {
+    // Panning alone does not invalidate what has been drawn so far, so the GAL may only
+    // shift its targets and redraw the uncovered parts of the screen
+    bool panOnly = m_panOnly
+                   || !( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) );
+
     m_center = aCenter;
 
     if( !m_boundary.Contains( aCenter ) )
@@ -620,6 +642,7 @@ void VIEW::SetCenter( const VECTOR2D& aCenter )
 
     // Redraw everything after the viewport has changed
     MarkDirty();
+    m_panOnly = panOnly;
 }
 
 
@@ -962,6 +985,14 @@ struct VIEW::drawItem
         useDrawPriority( aUseDrawPriority ),
         reverseDrawOrder( aReverseDrawOrder )
     {
+        const VIEW_LAYER& l = aView->m_layers.at( aLayer );
+
+        // Items that would be smaller than the layer threshold on the screen are skipped,
+        // unless the view is printed
+        if( l.minScreenSize > 0.0 && aView->m_printMode <= 0 )
+            minSize = aView->ToWorld( l.minScreenSize );
+        else
+            minSize = 0.0;
     }
 
     bool operator()( VIEW_ITEM* aItem )
@@ -970,6 +1001,7 @@ struct VIEW::drawItem
 
         // Conditions that have to be fulfilled for an item to be drawn
         bool drawCondition = aItem->viewPrivData()->isRenderable() &&
+                             aItem->viewPrivData()->m_bboxSize >= minSize &&
                              aItem->ViewGetLOD( layer, view ) < view->m_scale;
         if( !drawCondition )
             return true;
@@ -1002,6 +1034,7 @@ struct VIEW::drawItem
     VIEW* view;
     int layer, layers[VIEW_MAX_LAYERS];
     bool useDrawPriority, reverseDrawOrder;
+    double minSize;
     std::vector<VIEW_ITEM*> drawItems;
 };
 
@@ -1075,38 +1108,6 @@ void VIEW::draw( VIEW_GROUP* aGroup, bool aImmediate )
 }
 
 
-struct VIEW::recacheItem
-{
-    recacheItem( VIEW* aView, GAL* aGal, int aLayer ) :
-        view( aView ), gal( aGal ), layer( aLayer )
-    {
-    }
-
-    bool operator()( VIEW_ITEM* aItem )
-    {
-        auto viewData = aItem->viewPrivData();
-
-        if( !viewData )
-            return false;
-
-        // Remove previously cached group
-        int group = viewData->getGroup( layer );
-
-        if( group >= 0 )
-            gal->DeleteGroup( group );
-
-        viewData->setGroup( layer, -1 );
-        view->Update( aItem );
-
-        return true;
-    }
-
-    VIEW* view;
-    GAL* gal;
-    int layer;
-};
-
-
 void VIEW::Clear()
 {
     BOX2I r;
@@ -1124,14 +1125,26 @@ void VIEW::Clear()
 
 void VIEW::ClearTargets()
 {
+    m_exposedAreas.clear();
+
     if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
     {
-        // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
-        // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
-        m_gal->ClearTarget( TARGET_NONCACHED );
-        m_gal->ClearTarget( TARGET_CACHED );
+        // If the view has only been panned, the GAL may keep the targets contents
+        // and ask for redrawing the uncovered areas only
+        if( m_panOnly && m_gal->ScrollTargets( m_exposedAreas ) )
+        {
+            MarkTargetDirty( TARGET_OVERLAY );
+        }
+        else
+        {
+            // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
+            // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
+            m_gal->ClearTarget( TARGET_NONCACHED );
+            m_gal->ClearTarget( TARGET_CACHED );
 
-        MarkDirty();
+            m_exposedAreas.clear();
+            MarkDirty();
+        }
     }
 
     if( IsTargetDirty( TARGET_OVERLAY ) )
@@ -1160,11 +1173,46 @@ void VIEW::Redraw()
             rect.GetHeight() > std::numeric_limits<int>::max() )
         recti.SetMaximum();
 
-    redrawRect( recti );
+    if( m_exposedAreas.empty() )
+    {
+        redrawRect( recti );
+    }
+    else
+    {
+        // The cached and noncached targets were scrolled, so only the uncovered areas have
+        // to be drawn there. The overlay target is still redrawn entirely.
+        bool overlayDirty = IsTargetDirty( TARGET_OVERLAY );
+        markTargetClean( TARGET_OVERLAY );
+
+        for( const BOX2I& area : m_exposedAreas )
+        {
+            BOX2D exposed( ToWorld( VECTOR2D( area.GetOrigin() ) ),
+                           ToWorld( VECTOR2D( area.GetEnd() ) )
+                                   - ToWorld( VECTOR2D( area.GetOrigin() ) ) );
+            exposed.Normalize();
+
+            // Items touching the area border have to be drawn as well
+            exposed.Inflate( ToWorld( 1.0 ) );
+            redrawRect( BOX2I( exposed.GetPosition(), exposed.GetSize() ) );
+        }
+
+        markTargetClean( TARGET_CACHED );
+        markTargetClean( TARGET_NONCACHED );
+
+        if( overlayDirty )
+        {
+            m_dirtyTargets[TARGET_OVERLAY] = true;
+            redrawRect( recti );
+        }
+
+        m_exposedAreas.clear();
+    }
+
     // All targets were redrawn, so nothing is dirty
     markTargetClean( TARGET_CACHED );
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
+    m_panOnly = false;
 
 #ifdef __WXDEBUG__
     totalRealTime.Stop();
@@ -1325,6 +1373,9 @@ void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
     int layers[VIEW_MAX_LAYERS], layers_count;
 
+    if( aItem->viewPrivData() )
+        aItem->viewPrivData()->saveBboxSize( aItem->ViewBBox() );
+
     aItem->ViewGetLayers( layers, layers_count );
 
     for( int i = 0; i < layers_count; ++i )
@@ -1370,6 +1421,7 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     viewData->saveLayers( layers, layers_count );
+    viewData->saveBboxSize( aItem->ViewBBox() );
 
     for( int i = 0; i < layers_count; i++ )
     {
@@ -1400,20 +1452,25 @@ bool VIEW::areRequiredLayersEnabled( int aLayerId ) const
 
 void VIEW::RecacheAllItems()
 {
-    BOX2I r;
-
-    r.SetMaximum();
+    // Every cached group is going to be rebuilt, so instead of deleting the groups one by one
+    // (which leaves the vertex container heavily fragmented and makes the following UpdateItems()
+    // hunt for free chunks and move the growing items around) drop the whole cache at once.
+    // The container keeps its current size, so the new groups are appended one after another
+    // into a contiguous buffer that is uploaded in a single pass when the update context ends.
+    m_gal->ClearCache();
 
-    for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+    for( VIEW_ITEM* item : *m_allItems )
     {
-        VIEW_LAYER* l = &( ( *i ).second );
+        auto viewData = item->viewPrivData();
 
-        if( IsCached( l->id ) )
-        {
-            recacheItem visitor( this, m_gal, l->id );
-            l->items->Query( r, visitor );
-        }
+        if( !viewData )
+            continue;
+
+        viewData->deleteGroups();
+        viewData->m_requiredUpdate |= ALL;
     }
+
+    MarkDirty();
 }
 
 
@@ -0,0 +1,588 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstring>
+#include <memory>
+
+#include <wx/strconv.h>
+
+#include <common.h>
+#include <ki_exception.h>
+#include <xml_stream_parser.h>
+
+
+/// Size of the blocks read from the file
+static const size_t READ_BLOCK_SIZE = 64 * 1024;
+
+
+static void appendUTF8( std::string& aText, unsigned long aCodePoint )
+{
+    if( aCodePoint < 0x80 )
+    {
+        aText += (char) aCodePoint;
+    }
+    else if( aCodePoint < 0x800 )
+    {
+        aText += (char) ( 0xC0 | ( aCodePoint >> 6 ) );
+        aText += (char) ( 0x80 | ( aCodePoint & 0x3F ) );
+    }
+    else if( aCodePoint < 0x10000 )
+    {
+        aText += (char) ( 0xE0 | ( aCodePoint >> 12 ) );
+        aText += (char) ( 0x80 | ( ( aCodePoint >> 6 ) & 0x3F ) );
+        aText += (char) ( 0x80 | ( aCodePoint & 0x3F ) );
+    }
+    else
+    {
+        aText += (char) ( 0xF0 | ( aCodePoint >> 18 ) );
+        aText += (char) ( 0x80 | ( ( aCodePoint >> 12 ) & 0x3F ) );
+        aText += (char) ( 0x80 | ( ( aCodePoint >> 6 ) & 0x3F ) );
+        aText += (char) ( 0x80 | ( aCodePoint & 0x3F ) );
+    }
+}
+
+
+static inline bool isSpace( int aChar )
+{
+    return aChar == ' ' || aChar == '\t' || aChar == '\r' || aChar == '\n';
+}
+
+
+XML_STREAM_PARSER::XML_STREAM_PARSER( const wxString& aFileName ) :
+    m_fileName( aFileName ),
+    m_bufPos( 0 ),
+    m_lineNumber( 1 )
+{
+    m_fp = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !m_fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ), aFileName ) );
+}
+
+
+XML_STREAM_PARSER::~XML_STREAM_PARSER()
+{
+    if( !m_captured.empty() )
+        delete m_captured.front().node;
+
+    fclose( m_fp );
+}
+
+
+void XML_STREAM_PARSER::Parse( START_HANDLER aOnStart, ELEMENT_HANDLER aOnElement )
+{
+    m_onStart = aOnStart;
+    m_onElement = aOnElement;
+
+    // Forget the state left by a previous parse interrupted by an exception
+    if( !m_captured.empty() )
+        delete m_captured.front().node;
+
+    m_captured.clear();
+    m_openNames.clear();
+    m_pathLength.clear();
+    m_path.clear();
+    m_text.clear();
+    m_buffer.clear();
+    m_bufPos = 0;
+    m_lineNumber = 1;
+
+    readEncoding();
+
+    for( int c = peek(); c != EOF; c = peek() )
+    {
+        if( c != '<' )
+            readText();
+        else if( accept( "<?" ) )           // XML declaration and processing instructions
+            skipPast( "?>" );
+        else if( accept( "<!--" ) )
+            skipPast( "-->" );
+        else if( accept( "<![CDATA[" ) )
+        {
+            std::string data;
+
+            flushText();
+            skipPast( "]]>", &data );
+
+            if( !m_captured.empty() )
+                addCaptured( new wxXmlNode( wxXML_CDATA_SECTION_NODE, wxS( "cdata" ),
+                                            fromUTF8( data ), m_lineNumber ) );
+        }
+        else if( accept( "<!" ) )
+            readDoctype();
+        else if( accept( "</" ) )
+            readEndTag( false );
+        else
+        {
+            next();
+            readStartTag();
+        }
+    }
+
+    if( !m_openNames.empty() )
+        error( wxString::Format( _( "Missing end tag for <%s>" ),
+                                 fromUTF8( m_openNames.back() ) ) );
+}
+
+
+void XML_STREAM_PARSER::readEncoding()
+{
+    char head[256];
+    size_t start = 0;
+
+    rewind( m_fp );
+    size_t count = fread( head, 1, sizeof( head ) - 1, m_fp );
+    head[count] = 0;
+
+    m_charMap.clear();
+
+    if( count >= 3 && !memcmp( head, "\xEF\xBB\xBF", 3 ) )
+        start = 3;
+    else if( count >= 2 && ( !memcmp( head, "\xFF\xFE", 2 ) || !memcmp( head, "\xFE\xFF", 2 ) ) )
+        error( _( "UTF-16 files are not supported" ) );
+
+    fseek( m_fp, start, SEEK_SET );
+
+    // The encoding name is in the XML declaration, if any: <?xml ... encoding="name"?>
+    const char* decl = head + start;
+
+    if( strncmp( decl, "<?xml", 5 ) != 0 )
+        return;
+
+    const char* declEnd = strstr( decl, "?>" );
+    const char* enc = strstr( decl, "encoding" );
+
+    if( !declEnd || !enc || enc > declEnd )
+        return;
+
+    enc = strpbrk( enc, "\"'" );
+
+    if( !enc || enc > declEnd )
+        return;
+
+    const char* encEnd = strchr( enc + 1, *enc );
+
+    if( !encEnd || encEnd > declEnd )
+        return;
+
+    wxString name = wxString::FromAscii( enc + 1, encEnd - enc - 1 ).Lower();
+
+    if( name == "utf-8" || name == "utf8" || name == "us-ascii" )
+        return;
+
+    // 8 bit encodings are converted to UTF-8 when the input is read
+    wxCSConv conv( name );
+
+    if( !conv.IsOk() )
+        error( wxString::Format( _( "Unsupported encoding \"%s\"" ), name ) );
+
+    m_charMap.resize( 256 );
+
+    for( int ii = 0; ii < 256; ++ii )
+    {
+        char    byte = (char) ii;
+        wchar_t wc[2];
+
+        if( conv.ToWChar( wc, 2, &byte, 1 ) == wxCONV_FAILED )
+            m_charMap[ii] = 0xFFFD;
+        else
+            m_charMap[ii] = wc[0];
+    }
+}
+
+
+bool XML_STREAM_PARSER::fillBuffer()
+{
+    m_buffer.erase( 0, m_bufPos );
+    m_bufPos = 0;
+
+    m_rawBuffer.resize( READ_BLOCK_SIZE );
+    size_t count = fread( m_rawBuffer.data(), 1, m_rawBuffer.size(), m_fp );
+
+    if( count == 0 )
+        return false;
+
+    if( m_charMap.empty() )
+    {
+        m_buffer.append( m_rawBuffer.data(), count );
+    }
+    else
+    {
+        for( size_t ii = 0; ii < count; ++ii )
+            appendUTF8( m_buffer, m_charMap[(unsigned char) m_rawBuffer[ii]] );
+    }
+
+    return true;
+}
+
+
+bool XML_STREAM_PARSER::accept( const char* aToken )
+{
+    size_t len = strlen( aToken );
+
+    while( m_buffer.size() - m_bufPos < len )
+    {
+        if( !fillBuffer() )
+            return false;
+    }
+
+    if( m_buffer.compare( m_bufPos, len, aToken ) != 0 )
+        return false;
+
+    m_bufPos += len;
+    return true;
+}
+
+
+void XML_STREAM_PARSER::skipPast( const char* aTerminator, std::string* aText )
+{
+    while( !accept( aTerminator ) )
+    {
+        int c = next();
+
+        if( c == EOF )
+            error( wxString::Format( _( "Unexpected end of file, expected \"%s\"" ),
+                                     aTerminator ) );
+
+        if( aText )
+            *aText += (char) c;
+    }
+}
+
+
+void XML_STREAM_PARSER::skipSpaces()
+{
+    while( isSpace( peek() ) )
+        next();
+}
+
+
+void XML_STREAM_PARSER::readName( std::string& aName )
+{
+    aName.clear();
+
+    for( int c = peek(); c != EOF; c = peek() )
+    {
+        if( isSpace( c ) || c == '/' || c == '>' || c == '=' || c == '<' )
+            break;
+
+        aName += (char) next();
+    }
+
+    if( aName.empty() )
+        error( _( "Missing name" ) );
+}
+
+
+void XML_STREAM_PARSER::readReference( std::string& aText )
+{
+    // The leading '&' is already read
+    std::string ref;
+
+    for( int c = next(); c != ';'; c = next() )
+    {
+        if( c == EOF || c == '<' || isSpace( c ) || ref.size() > 10 )
+            error( _( "Malformed entity reference" ) );
+
+        ref += (char) c;
+    }
+
+    if( ref == "amp" )
+        aText += '&';
+    else if( ref == "lt" )
+        aText += '<';
+    else if( ref == "gt" )
+        aText += '>';
+    else if( ref == "quot" )
+        aText += '"';
+    else if( ref == "apos" )
+        aText += '\'';
+    else if( ref.size() > 1 && ref[0] == '#' )
+    {
+        char* end;
+        unsigned long codePoint;
+
+        if( ref[1] == 'x' )
+            codePoint = strtoul( ref.c_str() + 2, &end, 16 );
+        else
+            codePoint = strtoul( ref.c_str() + 1, &end, 10 );
+
+        if( *end || codePoint == 0 || codePoint > 0x10FFFF )
+            error( wxString::Format( _( "Invalid character reference \"&%s;\"" ), ref ) );
+
+        appendUTF8( aText, codePoint );
+    }
+    else
+    {
+        // Entities declared in a DTD are not expanded, keep them as they are
+        aText += '&';
+        aText += ref;
+        aText += ';';
+    }
+}
+
+
+void XML_STREAM_PARSER::readAttributeValue( std::string& aValue )
+{
+    int quote = next();
+
+    if( quote != '"' && quote != '\'' )
+        error( _( "Attribute value is not quoted" ) );
+
+    aValue.clear();
+
+    for( int c = next(); c != quote; c = next() )
+    {
+        if( c == EOF || c == '<' )
+            error( _( "Unterminated attribute value" ) );
+
+        if( c == '&' )
+            readReference( aValue );
+        else if( c == '\r' )
+        {
+            // Line ends, like other white space, are normalized to a single space
+            if( peek() == '\n' )
+                next();
+
+            aValue += ' ';
+        }
+        else if( isSpace( c ) )
+            aValue += ' ';
+        else
+            aValue += (char) c;
+    }
+}
+
+
+void XML_STREAM_PARSER::readText()
+{
+    // Character data is only kept inside captured elements
+    std::string* text = m_captured.empty() ? nullptr : &m_text;
+
+    for( int c = peek(); c != EOF && c != '<'; c = peek() )
+    {
+        next();
+
+        if( !text )
+            continue;
+
+        if( c == '&' )
+            readReference( *text );
+        else if( c == '\r' )
+        {
+            if( peek() == '\n' )
+                next();
+
+            *text += '\n';
+        }
+        else
+            *text += (char) c;
+    }
+}
+
+
+void XML_STREAM_PARSER::readDoctype()
+{
+    // The document type declaration, including its internal subset, is skipped
+    int  depth = 0;
+    int  quote = 0;
+
+    for( int c = next(); ; c = next() )
+    {
+        if( c == EOF )
+            error( _( "Unterminated document type declaration" ) );
+
+        if( quote )
+        {
+            if( c == quote )
+                quote = 0;
+        }
+        else if( c == '"' || c == '\'' )
+            quote = c;
+        else if( c == '[' )
+            depth++;
+        else if( c == ']' )
+            depth--;
+        else if( c == '>' && depth <= 0 )
+            return;
+    }
+}
+
+
+void XML_STREAM_PARSER::readStartTag()
+{
+    // The leading '<' is already read
+    std::string name;
+    std::string attrName;
+    std::string attrValue;
+    int         line = m_lineNumber;
+
+    flushText();
+    readName( name );
+
+    std::unique_ptr<wxXmlNode> node( new wxXmlNode( wxXML_ELEMENT_NODE, fromUTF8( name ),
+                                                    wxEmptyString, line ) );
+    bool empty = false;
+
+    for( ;; )
+    {
+        skipSpaces();
+
+        if( accept( "/>" ) )
+        {
+            empty = true;
+            break;
+        }
+
+        if( accept( ">" ) )
+            break;
+
+        readName( attrName );
+        skipSpaces();
+
+        if( next() != '=' )
+            error( wxString::Format( _( "Missing value for attribute \"%s\"" ),
+                                     fromUTF8( attrName ) ) );
+
+        skipSpaces();
+        readAttributeValue( attrValue );
+
+        node->AddAttribute( fromUTF8( attrName ), fromUTF8( attrValue ) );
+    }
+
+    if( !m_captured.empty() )
+    {
+        wxXmlNode* child = node.release();
+
+        addCaptured( child );
+        m_captured.push_back( { child, nullptr } );
+    }
+    else
+    {
+        m_pathLength.push_back( m_path.length() );
+
+        if( !m_path.empty() )
+            m_path += '.';
+
+        m_path += node->GetName();
+
+        if( m_onStart( m_path, *node ) )
+            m_captured.push_back( { node.release(), nullptr } );
+    }
+
+    m_openNames.push_back( name );
+
+    if( empty )
+        readEndTag( true );
+}
+
+
+void XML_STREAM_PARSER::readEndTag( bool aEmptyTag )
+{
+    // The leading "</" is already read, an empty element tag ("<name/>") has no end tag
+    if( !aEmptyTag )
+    {
+        std::string name;
+
+        readName( name );
+        skipSpaces();
+
+        if( next() != '>' )
+            error( _( "Malformed end tag" ) );
+
+        if( m_openNames.empty() || m_openNames.back() != name )
+            error( wxString::Format( _( "Unexpected end tag </%s>" ), fromUTF8( name ) ) );
+    }
+
+    flushText();
+    m_openNames.pop_back();
+
+    if( m_captured.size() > 1 )
+    {
+        m_captured.pop_back();
+        return;
+    }
+
+    if( m_captured.size() == 1 )
+    {
+        std::unique_ptr<wxXmlNode> element( m_captured.front().node );
+
+        m_captured.clear();
+        m_onElement( m_path, element.get() );
+    }
+
+    m_path.Truncate( m_pathLength.back() );
+    m_pathLength.pop_back();
+}
+
+
+void XML_STREAM_PARSER::flushText()
+{
+    if( m_text.empty() )
+        return;
+
+    // As wxXmlDocument does, drop the white space between elements
+    bool whiteOnly = true;
+
+    for( char c : m_text )
+    {
+        if( !isSpace( c ) )
+        {
+            whiteOnly = false;
+            break;
+        }
+    }
+
+    if( !whiteOnly && !m_captured.empty() )
+        addCaptured( new wxXmlNode( wxXML_TEXT_NODE, wxS( "text" ), fromUTF8( m_text ),
+                                    m_lineNumber ) );
+
+    m_text.clear();
+}
+
+
+void XML_STREAM_PARSER::addCaptured( wxXmlNode* aNode )
+{
+    CAPTURED& parent = m_captured.back();
+
+    // Appending after the known last child avoids walking the list of children
+    parent.node->InsertChildAfter( aNode, parent.lastChild );
+    parent.lastChild = aNode;
+}
+
+
+wxString XML_STREAM_PARSER::fromUTF8( const std::string& aText )
+{
+    wxString text = wxString::FromUTF8( aText.data(), aText.size() );
+
+    if( text.empty() && !aText.empty() )
+        error( _( "Invalid UTF-8 text" ) );
+
+    return text;
+}
+
+
+void XML_STREAM_PARSER::error( const wxString& aProblem )
+{
+    THROW_PARSE_ERROR( aProblem, m_fileName, "", m_lineNumber, 0 );
+}
@@ -278,10 +278,12 @@ bool SCH_EDIT_FRAME::HandleBlockEnd( wxDC* aDC )
                         item->GetEndPoints( internalPoints );
                     }
 
+                    DANGLING_END_INDEX internalIndex( internalPoints );
+
                     for( unsigned i = 0; i < block->GetCount(); ++i )
                     {
                         auto item = static_cast<SCH_ITEM*>( block->GetItem( i ) );
-                        item->UpdateDanglingState( internalPoints );
+                        internalIndex.UpdateDanglingState( item );
                     }
                 }
 
@@ -276,9 +276,11 @@ bool SCH_EDIT_FRAME::TestDanglingEnds()
     for( SCH_ITEM* item = GetScreen()->GetDrawList().begin(); item; item = item->Next() )
         item->GetEndPoints( endPoints );
 
+    DANGLING_END_INDEX endPointIndex( endPoints );
+
     for( SCH_ITEM* item = GetScreen()->GetDrawList().begin(); item; item = item->Next() )
     {
-        if( item->UpdateDanglingState( endPoints ) )
+        if( endPointIndex.UpdateDanglingState( item ) )
         {
             GetCanvas()->GetView()->Update( item, KIGFX::REPAINT );
             hasStateChanged = true;
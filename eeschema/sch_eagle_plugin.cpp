@@ -54,6 +54,7 @@
 #include <symbol_lib_table.h>
 #include <sch_legacy_plugin.h>
 #include <sch_eagle_plugin.h>
+#include <xml_stream_parser.h>
 
 
 
@@ -375,15 +376,11 @@ SCH_SHEET* SCH_EAGLE_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
     wxASSERT( !aFileName || aKiway != NULL );
     LOCALE_IO toggle;     // toggles on, then off, the C locale.
 
-    // Load the document
-    wxXmlDocument xmlDocument;
-
     m_filename = aFileName;
     m_kiway = aKiway;
 
-    if( !xmlDocument.Load( m_filename.GetFullPath() ) )
-        THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ),
-                        m_filename.GetFullPath() ) );
+    // The document is read as a stream, it is never loaded as a whole
+    XML_STREAM_PARSER parser( m_filename.GetFullPath() );
 
     // Delete on exception, if I own m_rootSheet, according to aAppendToMe
     unique_ptr<SCH_SHEET> deleter( aAppendToMe ? nullptr : m_rootSheet );
@@ -440,18 +437,8 @@ SCH_SHEET* SCH_EAGLE_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
         m_kiway->Prj().SchSymbolLibTable();
     }
 
-    // Retrieve the root as current node
-    wxXmlNode* currentNode = xmlDocument.GetRoot();
-
-    // If the attribute is found, store the Eagle version;
-    // otherwise, store the dummy "0.0" version.
-    m_version = currentNode->GetAttribute( "version", "0.0" );
-
-    // Map all children into a readable dictionary
-    NODE_MAP children = MapChildren( currentNode );
-
     // Load drawing
-    loadDrawing( children["drawing"] );
+    loadDrawing( parser );
 
     m_pi->SaveLibrary( getLibFileName().GetFullPath() );
 
@@ -459,154 +446,137 @@ SCH_SHEET* SCH_EAGLE_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
 }
 
 
-void SCH_EAGLE_PLUGIN::loadDrawing( wxXmlNode* aDrawingNode )
+void SCH_EAGLE_PLUGIN::loadDrawing( XML_STREAM_PARSER& aParser )
 {
-    // Map all children into a readable dictionary
-    NODE_MAP drawingChildren = MapChildren( aDrawingNode );
-
-    // Board nodes should not appear in .sch files
-    // wxXmlNode* board = drawingChildren["board"]
-
-    // wxXmlNode* grid = drawingChildren["grid"]
-
-    auto layers = drawingChildren["layers"];
-
-    if( layers )
-        loadLayerDefs( layers );
-
-    // wxXmlNode* library = drawingChildren["library"]
+    // First pass: read the layers and the parts, find all nets and count how many sheets
+    // they appear on (local labels will be used for nets found only on one sheet).  The
+    // libraries and the sheets are skipped without building any node.
+    int  sheetCount = 0;
+    bool hasParts = false;
+    bool hasLibraries = false;
 
-    // wxXmlNode* settings = drawingChildren["settings"]
-
-
-    // Load schematic
-    auto schematic = drawingChildren["schematic"];
-    if( schematic )
-        loadSchematic( schematic );
-}
-
-
-void SCH_EAGLE_PLUGIN::countNets( wxXmlNode* aSchematicNode )
-{
-    // Map all children into a readable dictionary
-    NODE_MAP schematicChildren = MapChildren( aSchematicNode );
-    // Loop through all the sheets
-
-    wxXmlNode* sheetNode = getChildrenNodes( schematicChildren, "sheets" );
-
-    while( sheetNode )
-    {
-        NODE_MAP sheetChildren = MapChildren( sheetNode );
-        // Loop through all nets
-        // From the DTD: "Net is an electrical connection in a schematic."
-        wxXmlNode* netNode = getChildrenNodes( sheetChildren, "nets" );
+    m_version = "0.0";
 
-        while( netNode )
-        {
-            wxString netName = netNode->GetAttribute( "name" );
+    aParser.Parse(
+            [&]( const wxString& aPath, const wxXmlNode& aElement )
+            {
+                if( aPath == "eagle" )
+                {
+                    // If the attribute is found, store the Eagle version;
+                    // otherwise, store the dummy "0.0" version.
+                    m_version = aElement.GetAttribute( "version", "0.0" );
+                }
+                else if( aPath == "eagle.drawing.schematic.parts.part" )
+                {
+                    hasParts = true;
+                }
+                else if( aPath == "eagle.drawing.schematic.libraries.library" )
+                {
+                    hasLibraries = true;
+                }
+                else if( aPath == "eagle.drawing.schematic.sheets.sheet" )
+                {
+                    sheetCount++;
+                }
+                else if( aPath == "eagle.drawing.schematic.sheets.sheet.nets.net" )
+                {
+                    // From the DTD: "Net is an electrical connection in a schematic."
+                    m_netCounts[aElement.GetAttribute( "name" )]++;
+                }
 
-            if( m_netCounts.count( netName ) )
-                m_netCounts[netName] = m_netCounts[netName] + 1;
-            else
-                m_netCounts[netName] = 1;
+                // Board nodes should not appear in .sch files
+                return aPath == "eagle.drawing.layers"
+                       || aPath == "eagle.drawing.schematic.parts.part";
+            },
+            [&]( const wxString& aPath, wxXmlNode* aElement )
+            {
+                if( aPath == "eagle.drawing.layers" )
+                {
+                    loadLayerDefs( aElement );
+                }
+                else
+                {
+                    std::unique_ptr<EPART> epart( new EPART( aElement ) );
 
-            // Get next net
-            netNode = netNode->GetNext();
-        }
+                    // N.B. Eagle parts are case-insensitive in matching but we keep the
+                    // display case
+                    m_partlist[epart->name.Upper()] = std::move( epart );
+                }
+            } );
 
-        sheetNode = sheetNode->GetNext();
-    }
+    if( hasParts && hasLibraries && sheetCount > 0 )
+        loadSchematic( aParser, sheetCount );
 }
 
 
-void SCH_EAGLE_PLUGIN::loadSchematic( wxXmlNode* aSchematicNode )
+void SCH_EAGLE_PLUGIN::loadSchematic( XML_STREAM_PARSER& aParser, int aSheetCount )
 {
-    // Map all children into a readable dictionary
-    NODE_MAP schematicChildren = MapChildren( aSchematicNode );
-    auto partNode = getChildrenNodes( schematicChildren, "parts" );
-    auto libraryNode = getChildrenNodes( schematicChildren, "libraries" );
-    auto sheetNode = getChildrenNodes( schematicChildren, "sheets" );
-
-    if( !partNode || !libraryNode || !sheetNode )
-        return;
-
-    while( partNode )
-    {
-        std::unique_ptr<EPART> epart( new EPART( partNode ) );
-
-        // N.B. Eagle parts are case-insensitive in matching but we keep the display case
-        m_partlist[epart->name.Upper()] = std::move( epart );
-        partNode = partNode->GetNext();
-    }
-
-    // Loop through all the libraries
-    while( libraryNode )
-    {
-        // Read the library name
-        wxString libName = libraryNode->GetAttribute( "name" );
-
-        EAGLE_LIBRARY* elib = &m_eagleLibs[libName];
-        elib->name = libName;
-
-        loadLibrary( libraryNode, &m_eagleLibs[libName] );
-
-        libraryNode = libraryNode->GetNext();
-    }
-
-    m_pi->SaveLibrary( getLibFileName().GetFullPath() );
-
-    // find all nets and count how many sheets they appear on.
-    // local labels will be used for nets found only on that sheet.
-    countNets( aSchematicNode );
+    // Second pass: load the libraries and then the sheets, one at a time.
+    // If eagle schematic has multiple sheets then create corresponding subsheets on the
+    // root sheet.
+    bool libSaved = false;
+    int  x = 1;
+    int  y = 1;
+    int  i = 1;
+
+    aParser.Parse(
+            []( const wxString& aPath, const wxXmlNode& )
+            {
+                return aPath == "eagle.drawing.schematic.libraries.library"
+                       || aPath == "eagle.drawing.schematic.sheets.sheet";
+            },
+            [&]( const wxString& aPath, wxXmlNode* aElement )
+            {
+                if( aPath == "eagle.drawing.schematic.libraries.library" )
+                {
+                    // Read the library name
+                    wxString libName = aElement->GetAttribute( "name" );
 
-    // Loop through all the sheets
-    int sheet_count = countChildren( sheetNode->GetParent(), "sheet" );
+                    EAGLE_LIBRARY* elib = &m_eagleLibs[libName];
+                    elib->name = libName;
 
-    // If eagle schematic has multiple sheets then create corresponding subsheets on the root sheet
-    if( sheet_count > 1 )
-    {
-        int x, y, i;
-        i   = 1;
-        x   = 1;
-        y   = 1;
+                    loadLibrary( aElement, &m_eagleLibs[libName] );
+                    return;
+                }
 
-        while( sheetNode )
-        {
-            wxPoint pos = wxPoint( x * 1000, y * 1000 );
-            std::unique_ptr<SCH_SHEET> sheet( new SCH_SHEET( pos ) );
-            SCH_SCREEN* screen = new SCH_SCREEN( m_kiway );
+                // The libraries come before the sheets
+                if( !libSaved )
+                {
+                    m_pi->SaveLibrary( getLibFileName().GetFullPath() );
+                    libSaved = true;
+                }
 
-            sheet->SetTimeStamp( GetNewTimeStamp() - i );    // minus the sheet index to make it unique.
-            sheet->SetParent( m_rootSheet );
-            sheet->SetScreen( screen );
-            sheet->GetScreen()->SetFileName( sheet->GetFileName() );
+                if( aSheetCount > 1 )
+                {
+                    wxPoint pos = wxPoint( x * 1000, y * 1000 );
+                    std::unique_ptr<SCH_SHEET> sheet( new SCH_SHEET( pos ) );
+                    SCH_SCREEN* screen = new SCH_SCREEN( m_kiway );
 
-            m_currentSheet = sheet.get();
-            loadSheet( sheetNode, i );
-            m_rootSheet->GetScreen()->Append( sheet.release() );
+                    sheet->SetTimeStamp( GetNewTimeStamp() - i );    // minus the sheet index to make it unique.
+                    sheet->SetParent( m_rootSheet );
+                    sheet->SetScreen( screen );
+                    sheet->GetScreen()->SetFileName( sheet->GetFileName() );
 
-            sheetNode = sheetNode->GetNext();
-            x += 2;
+                    m_currentSheet = sheet.get();
+                    loadSheet( aElement, i );
+                    m_rootSheet->GetScreen()->Append( sheet.release() );
 
-            if( x > 10 )    // start next row
-            {
-                x = 1;
-                y += 2;
-            }
+                    x += 2;
 
-            i++;
-        }
-    }
-    else
-    {
-        while( sheetNode )
-        {
-            m_currentSheet = m_rootSheet;
-            loadSheet( sheetNode, 0 );
-            sheetNode = sheetNode->GetNext();
-        }
-    }
+                    if( x > 10 )    // start next row
+                    {
+                        x = 1;
+                        y += 2;
+                    }
 
+                    i++;
+                }
+                else
+                {
+                    m_currentSheet = m_rootSheet;
+                    loadSheet( aElement, 0 );
+                }
+            } );
 
     // Handle the missing component units that need to be instantiated
     // to create the missing implicit connections
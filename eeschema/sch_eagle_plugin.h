@@ -50,6 +50,7 @@ class SCH_COMPONENT;
 class SCH_FIELD;
 class PROPERTIES;
 class SCH_EAGLE_PLUGIN_CACHE;
+class XML_STREAM_PARSER;
 class LIB_PART;
 class PART_LIB;
 class LIB_ALIAS;
@@ -132,13 +133,18 @@ public:
     //void SymbolLibOptions( PROPERTIES* aListToAppendTo ) const override;
 
 private:
-    void loadDrawing( wxXmlNode* aDrawingNode );
+    /**
+     * Loads the document.  It is streamed: the libraries and the sheets are converted one at
+     * a time as they are read, so the document is never held in memory as a whole.
+     */
+    void loadDrawing( XML_STREAM_PARSER& aParser );
     void loadLayerDefs( wxXmlNode* aLayers );
-    void loadSchematic( wxXmlNode* aSchematicNode );
+
+    /// Loads the libraries and the sheets, once the parts and the nets are known.
+    void loadSchematic( XML_STREAM_PARSER& aParser, int aSheetCount );
     void loadSheet( wxXmlNode* aSheetNode, int sheetcount );
     void loadInstance( wxXmlNode* aInstanceNode );
     EAGLE_LIBRARY* loadLibrary( wxXmlNode* aLibraryNode, EAGLE_LIBRARY* aEagleLib );
-    void countNets( wxXmlNode* aSchematicNode );
 
     /// Moves any labels on the wire to the new end point of the wire.
     void moveLabels( SCH_ITEM* aWire, const wxPoint& aNewEndPoint );
@@ -26,10 +26,13 @@
  * @file sch_item_struct.cpp
  */
 
+#include <algorithm>
+
 #include <fctsys.h>
 #include <common.h>
 #include <gr_basic.h>
 #include <base_struct.h>
+#include <trigo.h>
 #include <trace_helpers.h>
 #include <sch_item_struct.h>
 #include <sch_screen.h>
@@ -39,6 +42,136 @@
 #include <general.h>
 
 
+/// Size of the grid cells used to bin the wire and bus segments, in internal units.
+static const int DANGLING_END_CELL_SIZE = 500;
+
+
+static inline bool isSegmentEnd( DANGLING_END_T aType )
+{
+    return aType == WIRE_START_END || aType == WIRE_END_END
+           || aType == BUS_START_END || aType == BUS_END_END;
+}
+
+
+static inline int cellCoord( int aCoord )
+{
+    // Rounds towards minus infinity, so negative coordinates get their own cells
+    return aCoord >= 0 ? aCoord / DANGLING_END_CELL_SIZE
+                       : ( aCoord + 1 ) / DANGLING_END_CELL_SIZE - 1;
+}
+
+
+DANGLING_END_INDEX::DANGLING_END_INDEX( const std::vector<DANGLING_END_ITEM>& aEndPoints ) :
+    m_endPoints( aEndPoints )
+{
+    for( size_t ii = 0; ii < m_endPoints.size(); ++ii )
+    {
+        const DANGLING_END_ITEM& item = m_endPoints[ii];
+
+        if( !isSegmentEnd( item.GetType() ) )
+        {
+            m_points.push_back( ii );
+            continue;
+        }
+
+        // Wires and buses are stored in the list as a pair, start and end.  Only the start
+        // is indexed, the end is always the next item.
+        if( item.GetType() != WIRE_START_END && item.GetType() != BUS_START_END )
+            continue;
+
+        wxCHECK2_MSG( ii + 1 < m_endPoints.size(), break,
+                      wxT( "Dangling end type list overflow." ) );
+
+        const wxPoint& start = item.GetPosition();
+        const wxPoint& end = m_endPoints[ii + 1].GetPosition();
+
+        int x0 = cellCoord( std::min( start.x, end.x ) );
+        int x1 = cellCoord( std::max( start.x, end.x ) );
+        int y0 = cellCoord( std::min( start.y, end.y ) );
+        int y1 = cellCoord( std::max( start.y, end.y ) );
+
+        for( int x = x0; x <= x1; ++x )
+        {
+            for( int y = y0; y <= y1; ++y )
+                m_segmentCells[ cellKey( x, y ) ].push_back( ii );
+        }
+    }
+
+    std::sort( m_points.begin(), m_points.end(),
+               [&]( size_t a, size_t b ) -> bool
+               {
+                   const wxPoint& pa = m_endPoints[a].GetPosition();
+                   const wxPoint& pb = m_endPoints[b].GetPosition();
+                   return pa.x < pb.x || ( pa.x == pb.x && pa.y < pb.y );
+               } );
+}
+
+
+uint64_t DANGLING_END_INDEX::cellKey( int aCellX, int aCellY )
+{
+    // Cells are negative for items at negative coordinates: shift the unsigned values
+    return ( (uint64_t) (uint32_t) aCellX << 32 ) | (uint32_t) aCellY;
+}
+
+
+void DANGLING_END_INDEX::GetItemsAt( const std::vector<wxPoint>& aPoints,
+                                     std::vector<DANGLING_END_ITEM>& aList ) const
+{
+    // Indices of the matching items; the wire and bus pairs are stored with their start index.
+    std::vector<size_t> found;
+
+    auto lessPos = [&]( size_t a, const wxPoint& b ) -> bool
+    {
+        const wxPoint& pa = m_endPoints[a].GetPosition();
+        return pa.x < b.x || ( pa.x == b.x && pa.y < b.y );
+    };
+
+    for( const wxPoint& pt : aPoints )
+    {
+        auto it = std::lower_bound( m_points.begin(), m_points.end(), pt, lessPos );
+
+        for( ; it != m_points.end() && m_endPoints[*it].GetPosition() == pt; ++it )
+            found.push_back( *it );
+
+        auto cell = m_segmentCells.find( cellKey( cellCoord( pt.x ), cellCoord( pt.y ) ) );
+
+        if( cell == m_segmentCells.end() )
+            continue;
+
+        for( size_t ii : cell->second )
+        {
+            if( IsPointOnSegment( m_endPoints[ii].GetPosition(),
+                                  m_endPoints[ii + 1].GetPosition(), pt ) )
+                found.push_back( ii );
+        }
+    }
+
+    // Keep the order of the indexed list, some UpdateDanglingState() implementations rely on it
+    std::sort( found.begin(), found.end() );
+    found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+    for( size_t ii : found )
+    {
+        aList.push_back( m_endPoints[ii] );
+
+        if( isSegmentEnd( m_endPoints[ii].GetType() ) )
+            aList.push_back( m_endPoints[ii + 1] );
+    }
+}
+
+
+bool DANGLING_END_INDEX::UpdateDanglingState( SCH_ITEM* aItem ) const
+{
+    std::vector<wxPoint> connections;
+    std::vector<DANGLING_END_ITEM> nearby;
+
+    aItem->GetConnectionPoints( connections );
+    GetItemsAt( connections, nearby );
+
+    return aItem->UpdateDanglingState( nearby );
+}
+
+
 /* Constructor and destructor for SCH_ITEM */
 /* They are not inline because this creates problems with gcc at linking time
  * in debug mode
@@ -30,6 +30,8 @@
 #ifndef SCH_ITEM_STRUCT_H
 #define SCH_ITEM_STRUCT_H
 
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 #include <base_screen.h>
 #include <general.h>
@@ -105,6 +107,53 @@ public:
 };
 
 
+/**
+ * Class DANGLING_END_INDEX
+ * is a helper class used to speed up the dangling end test of a whole list of items.
+ *
+ * It indexes a list of DANGLING_END_ITEMs by position, so each item is only tested against
+ * the end points that can actually connect to it instead of the whole list.  The index
+ * keeps a reference to the list, which must not be modified while the index is in use.
+ */
+class DANGLING_END_INDEX
+{
+public:
+    DANGLING_END_INDEX( const std::vector<DANGLING_END_ITEM>& aEndPoints );
+
+    /**
+     * Function GetItemsAt
+     * fills \a aList with the indexed end points located at one of \a aPoints, and with
+     * the wire and bus segments passing through one of them.
+     *
+     * The end points keep their order in the indexed list, and wire and bus segments keep
+     * their start and end pair, so the result can be given to SCH_ITEM::UpdateDanglingState().
+     */
+    void GetItemsAt( const std::vector<wxPoint>& aPoints,
+                     std::vector<DANGLING_END_ITEM>& aList ) const;
+
+    /**
+     * Function UpdateDanglingState
+     * updates the dangling state of \a aItem from the end points located at its connection
+     * points.  The result is the same as testing \a aItem against the whole indexed list.
+     *
+     * @return true if the dangling state of \a aItem has changed.
+     */
+    bool UpdateDanglingState( SCH_ITEM* aItem ) const;
+
+private:
+    ///> Hash key of a grid cell.
+    static uint64_t cellKey( int aCellX, int aCellY );
+
+    const std::vector<DANGLING_END_ITEM>& m_endPoints;
+
+    ///> Indices of the point end items, sorted by position.
+    std::vector<size_t> m_points;
+
+    ///> Indices of the wire and bus start items, binned by the grid cells their segment covers.
+    std::unordered_map<uint64_t, std::vector<size_t>> m_segmentCells;
+};
+
+
 /**
  * Class SCH_ITEM
  * is a base class for any item which can be embedded within the SCHEMATIC
@@ -943,9 +943,11 @@ bool SCH_SCREEN::TestDanglingEnds()
     for( item = m_drawList.begin(); item; item = item->Next() )
         item->GetEndPoints( endPoints );
 
+    DANGLING_END_INDEX endPointIndex( endPoints );
+
     for( item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( item->UpdateDanglingState( endPoints ) )
+        if( endPointIndex.UpdateDanglingState( item ) )
         {
             hasStateChanged = true;
         }
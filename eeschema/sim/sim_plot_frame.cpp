@@ -25,6 +25,8 @@
  */
 
 #include <wx/stc/stc.h>
+#include <wx/textdlg.h>
+#include <wx/thread.h>
 
 #include <sch_edit_frame.h>
 #include <eeschema_id.h>
@@ -40,6 +42,7 @@
 
 #include "sim_plot_frame.h"
 #include "sim_plot_panel.h"
+#include "sim_sweep.h"
 #include "spice_simulator.h"
 #include "spice_reporter.h"
 
@@ -118,7 +121,7 @@ TRACE_DESC::TRACE_DESC( const NETLIST_EXPORTER_PSPICE_SIM& aExporter, const wxSt
 wxString SIM_PLOT_FRAME::m_savedWorkbooksPath;
 
 SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
-    : SIM_PLOT_FRAME_BASE( aParent ), m_lastSimPlot( nullptr )
+    : SIM_PLOT_FRAME_BASE( aParent ), m_sweepPlot( nullptr ), m_lastSimPlot( nullptr )
 {
     SetKiway( this, aKiway );
     m_signalsIconColorList = NULL;
@@ -159,12 +162,16 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
 
     updateNetlistExporter();
 
+    m_sweep.reset( new SIM_SWEEP( this ) );
+
     Connect( wxEVT_CLOSE_WINDOW, wxCloseEventHandler( SIM_PLOT_FRAME::onClose ), NULL, this );
     Connect( EVT_SIM_UPDATE, wxCommandEventHandler( SIM_PLOT_FRAME::onSimUpdate ), NULL, this );
     Connect( EVT_SIM_REPORT, wxCommandEventHandler( SIM_PLOT_FRAME::onSimReport ), NULL, this );
     Connect( EVT_SIM_STARTED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimStarted ), NULL, this );
     Connect( EVT_SIM_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimFinished ), NULL, this );
     Connect( EVT_SIM_CURSOR_UPDATE, wxCommandEventHandler( SIM_PLOT_FRAME::onCursorUpdate ), NULL, this );
+    Connect( EVT_SIM_SWEEP_RESULT, wxCommandEventHandler( SIM_PLOT_FRAME::onSweepResult ), NULL, this );
+    Connect( EVT_SIM_SWEEP_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onSweepFinished ), NULL, this );
 
     // Toolbar buttons
     m_toolSimulate = m_toolBar->AddTool( ID_SIM_RUN, _( "Run/Stop Simulation" ),
@@ -197,6 +204,10 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onShowNetlist, this, m_showNetlist->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onSettings,    this, m_settings->GetId() );
 
+    wxMenuItem* runSweep = m_simulationMenu->Insert( 1, wxID_ANY, _( "Run Parameter Sweep..." ),
+            _( "Simulate the current plot for a list of component or parameter values" ) );
+    Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onRunSweep,    this, runSweep->GetId() );
+
     m_toolBar->Realize();
     m_plotNotebook->SetPageText( 0, _( "Welcome!" ) );
 
@@ -319,6 +330,117 @@ bool SIM_PLOT_FRAME::IsSimulationRunning()
 }
 
 
+void SIM_PLOT_FRAME::StartSweep( const wxString& aSpec )
+{
+    STRING_FORMATTER formatter;
+    SIM_PLOT_PANEL* plotPanel = CurrentPlot();
+    std::vector<SIM_SWEEP_POINT> points;
+    wxString error;
+
+    if( m_sweep->IsRunning() )
+        m_sweep->Stop();
+
+    if( !plotPanel || m_plots[plotPanel].m_traces.empty() )
+    {
+        DisplayInfoMessage( this, _( "You need to run simulation and add signals first." ) );
+        return;
+    }
+
+    if( !SIM_SWEEP::ParseSpec( aSpec, points, error ) )
+    {
+        DisplayError( this, error );
+        return;
+    }
+
+    if( points.size() == 1 && points[0].empty() )
+    {
+        DisplayError( this, _( "There are no values to sweep." ) );
+        return;
+    }
+
+    if( !m_settingsDlg )
+        m_settingsDlg = new DIALOG_SIM_SETTINGS( this );
+
+    updateNetlistExporter();
+    m_exporter->SetSimCommand( m_plots[plotPanel].m_simCommand );
+
+    if( !m_exporter->Format( &formatter, m_settingsDlg->GetNetlistOptions() ) )
+    {
+        DisplayError( this, _( "There were errors during netlist export, aborted." ) );
+        return;
+    }
+
+    if( m_exporter->GetSimType() != plotPanel->GetType()
+            || !SIM_PLOT_PANEL::IsPlottable( m_exporter->GetSimType() ) )
+    {
+        DisplayInfoMessage( this, _( "Sweeps are available only for plotted analyses." ) );
+        return;
+    }
+
+    // Tuned values are used for the components that are not swept
+    updateTuners();
+
+    for( SIM_SWEEP_POINT& point : points )
+    {
+        for( TUNER_SLIDER* tuner : m_tuners )
+        {
+            if( !point.count( tuner->GetComponentName() ) )
+                point[tuner->GetComponentName()] = tuner->GetValue().ToSpiceString();
+        }
+    }
+
+    // Remove the traces of the previous sweep
+    if( m_plots.count( m_sweepPlot ) )
+    {
+        for( const wxString& name : m_sweepTraces )
+        {
+            m_plots[m_sweepPlot].m_traces.erase( name );
+
+            if( m_sweepPlot->TraceShown( name ) )
+                m_sweepPlot->DeleteTrace( name );
+        }
+    }
+
+    m_sweepPlot = plotPanel;
+    m_sweepTraces.clear();
+    m_sweepSignals.clear();
+
+    // Signals to save: one per plotted trace (split DC traces share their descriptor)
+    std::set<wxString> titles;
+    std::vector<wxString> signals;
+
+    for( const auto& trace : m_plots[plotPanel].m_traces )
+    {
+        const TRACE_DESC& descriptor = trace.second;
+
+        if( !titles.insert( descriptor.GetTitle() ).second )
+            continue;
+
+        /// @todo no ngspice hardcoding
+        wxString vector = m_exporter->GetSpiceVector( descriptor.GetName(),
+                descriptor.GetType(), descriptor.GetParam() );
+
+        if( descriptor.GetType() & SPT_AC_MAG )
+            vector = "mag(" + vector + ")";
+        else if( descriptor.GetType() & SPT_AC_PHASE )
+            vector = "ph(" + vector + ")";
+
+        signals.push_back( vector );
+        m_sweepSignals.push_back( descriptor );
+    }
+
+    m_simConsole->Clear();
+    m_simConsole->AppendText( wxString::Format( _( "Running %u simulations\n" ),
+                                                (unsigned int) points.size() ) );
+
+    m_sweep->Start( FROM_UTF8( formatter.GetString().c_str() ), *m_exporter, points, signals,
+                    wxThread::GetCPUCount() );
+
+    updateSignalList();
+    updateCursors();
+}
+
+
 SIM_PLOT_PANEL* SIM_PLOT_FRAME::NewPlotPanel( SIM_TYPE aSimType )
 {
     SIM_PLOT_PANEL* plotPanel = new SIM_PLOT_PANEL( aSimType, m_plotNotebook, wxID_ANY );
@@ -1012,6 +1134,14 @@ void SIM_PLOT_FRAME::onPlotClose( wxAuiNotebookEvent& event )
         return;
 
     m_plots.erase( plotPanel );
+
+    if( plotPanel == m_sweepPlot )
+    {
+        m_sweep->Stop();
+        m_sweepPlot = nullptr;
+        m_sweepTraces.clear();
+    }
+
     updateSignalList();
     updateCursors();
 }
@@ -1183,6 +1313,21 @@ void SIM_PLOT_FRAME::onShowNetlist( wxCommandEvent& event )
 }
 
 
+void SIM_PLOT_FRAME::onRunSweep( wxCommandEvent& event )
+{
+    wxTextEntryDialog dlg( this, _( "Values of the components or parameters to sweep, one per line, "
+                                    "e.g.:\n\nR1=1k,2k,5k\nC1=10n+-10%\nRUNS=20" ),
+                           _( "Parameter Sweep" ), m_sweepSpec,
+                           wxOK | wxCANCEL | wxTE_MULTILINE );
+
+    if( dlg.ShowModal() != wxID_OK )
+        return;
+
+    m_sweepSpec = dlg.GetValue();
+    StartSweep( m_sweepSpec );
+}
+
+
 void SIM_PLOT_FRAME::onClose( wxCloseEvent& aEvent )
 {
     SaveSettings( config() );
@@ -1272,7 +1417,12 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 
         for( auto it = traceMap.begin(); it != traceMap.end(); /* iteration occurs in the loop */)
         {
-            if( !updatePlot( it->second, plotPanel ) )
+            // Sweep results do not come from the simulator
+            if( plotPanel == m_sweepPlot && m_sweepTraces.count( it->first ) )
+            {
+                ++it;
+            }
+            else if( !updatePlot( it->second, plotPanel ) )
             {
                 removePlot( it->first, false );
                 it = traceMap.erase( it );       // remove a plot that does not exist anymore
@@ -1301,6 +1451,61 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 }
 
 
+void SIM_PLOT_FRAME::onSweepResult( wxCommandEvent& aEvent )
+{
+    // Results of a sweep stopped or restarted since they were queued
+    if( !m_sweep->IsCurrent( aEvent ) )
+        return;
+
+    size_t index = aEvent.GetInt();
+    const SIM_SWEEP::RESULT& result = m_sweep->GetResult( index );
+    wxString point = SIM_SWEEP::FormatPoint( m_sweep->GetPoints()[index] );
+
+    if( !result.m_ok )
+    {
+        m_simConsole->AppendText( wxString::Format( _( "Simulation failed for %s:\n%s\n" ),
+                                                    point, result.m_log ) );
+        m_simConsole->SetInsertionPointEnd();
+        return;
+    }
+
+    if( !m_plots.count( m_sweepPlot ) )
+        return;
+
+    for( size_t i = 0; i < m_sweepSignals.size(); ++i )
+    {
+        const TRACE_DESC& descriptor = m_sweepSignals[i];
+        wxString name = wxString::Format( "%s [%s]", descriptor.GetTitle(), point );
+
+        if( m_sweepPlot->AddTrace( name, result.m_x.size(), result.m_x.data(),
+                                   result.m_signals[i].data(), descriptor.GetType() ) )
+        {
+            m_plots[m_sweepPlot].m_traces.insert( std::make_pair( name, descriptor ) );
+            m_sweepTraces.insert( name );
+        }
+    }
+
+    if( m_sweepPlot == CurrentPlot() )
+        updateSignalList();
+}
+
+
+void SIM_PLOT_FRAME::onSweepFinished( wxCommandEvent& aEvent )
+{
+    if( !m_sweep->IsCurrent( aEvent ) )
+        return;
+
+    m_simConsole->AppendText( _( "Sweep finished\n" ) );
+    m_simConsole->SetInsertionPointEnd();
+
+    if( m_plots.count( m_sweepPlot ) )
+    {
+        m_sweepPlot->UpdateAll();
+        m_sweepPlot->ResetScales();
+    }
+}
+
+
 void SIM_PLOT_FRAME::onSimUpdate( wxCommandEvent& aEvent )
 {
     if( IsSimulationRunning() )
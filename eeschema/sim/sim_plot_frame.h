@@ -45,6 +45,7 @@
 #include <list>
 #include <memory>
 #include <map>
+#include <set>
 
 class SCH_EDIT_FRAME;
 class SCH_COMPONENT;
@@ -53,6 +54,7 @@ class SPICE_SIMULATOR;
 class NETLIST_EXPORTER_PSPICE_SIM;
 class SIM_PLOT_PANEL;
 class SIM_THREAD_REPORTER;
+class SIM_SWEEP;
 class TUNER_SLIDER;
 
 ///> Trace descriptor class
@@ -117,6 +119,13 @@ public:
     void StopSimulation();
     bool IsSimulationRunning();
 
+    /**
+     * @brief Simulates the current plot for a list of component/parameter values in
+     * external ngspice processes, and adds a trace per value and plotted signal.
+     * @param aSpec is the sweep specification (see SIM_SWEEP::ParseSpec()).
+     */
+    void StartSweep( const wxString& aSpec );
+
     /**
      * @brief Creates a new plot panel for a given simulation type and adds it to the main
      * notebook.
@@ -267,6 +276,7 @@ private:
     void onProbe( wxCommandEvent& event );
     void onTune( wxCommandEvent& event );
     void onShowNetlist( wxCommandEvent& event );
+    void onRunSweep( wxCommandEvent& event );
 
     void onClose( wxCloseEvent& aEvent );
 
@@ -275,6 +285,8 @@ private:
     void onSimReport( wxCommandEvent& aEvent );
     void onSimStarted( wxCommandEvent& aEvent );
     void onSimFinished( wxCommandEvent& aEvent );
+    void onSweepResult( wxCommandEvent& aEvent );
+    void onSweepFinished( wxCommandEvent& aEvent );
 
     // adjust the sash dimension of splitter windows after reading
     // the config settings
@@ -311,6 +323,17 @@ private:
     ///> List of currently displayed tuners
     std::list<TUNER_SLIDER*> m_tuners;
 
+    ///> Parameter sweep run in external simulator processes
+    std::unique_ptr<SIM_SWEEP> m_sweep;
+
+    ///> Last sweep specification, proposed again in the sweep dialog
+    wxString m_sweepSpec;
+
+    ///> Panel receiving the sweep traces, the signals it simulates and the traces added so far
+    SIM_PLOT_PANEL* m_sweepPlot;
+    std::vector<TRACE_DESC> m_sweepSignals;
+    std::set<wxString> m_sweepTraces;
+
     // Trick to preserve settings between runs:
     // the DIALOG_SIM_SETTINGS is not destroyed after closing the dialog.
     // Once created it will be not shown (shown only on request) during a session
@@ -361,6 +361,137 @@ void CURSOR::UpdateReference()
 }
 
 
+constexpr size_t TRACE::DECIMATION_THRESHOLD;
+constexpr int TRACE::POINTS_PER_PIXEL;
+
+
+void TRACE::buildLevels()
+{
+    m_levels.clear();
+    m_drawXs = &m_xs;
+    m_drawYs = &m_ys;
+    m_begin = 0;
+    m_end = m_xs.size();
+
+    // The visible range is found by a binary search on X values
+    if( m_xs.size() <= DECIMATION_THRESHOLD || !std::is_sorted( m_xs.begin(), m_xs.end() ) )
+        return;
+
+    const std::vector<double>* xs = &m_xs;
+    const std::vector<double>* ys = &m_ys;
+
+    // Each level merges groups of 4 points of the previous one (or of the samples)
+    while( xs->size() > DECIMATION_THRESHOLD )
+    {
+        LEVEL level;
+        size_t count = xs->size();
+
+        level.m_xs.reserve( count / 2 + 2 );
+        level.m_ys.reserve( count / 2 + 2 );
+
+        for( size_t first = 0; first < count; first += 4 )
+        {
+            size_t last = std::min( first + 4, count );
+            size_t minIdx = first, maxIdx = first;
+
+            for( size_t i = first + 1; i < last; ++i )
+            {
+                if( (*ys)[i] < (*ys)[minIdx] )
+                    minIdx = i;
+
+                if( (*ys)[i] > (*ys)[maxIdx] )
+                    maxIdx = i;
+            }
+
+            size_t left = std::min( minIdx, maxIdx );
+            size_t right = std::max( minIdx, maxIdx );
+
+            level.m_xs.push_back( (*xs)[left] );
+            level.m_ys.push_back( (*ys)[left] );
+            level.m_xs.push_back( (*xs)[right] );
+            level.m_ys.push_back( (*ys)[right] );
+        }
+
+        m_levels.push_back( std::move( level ) );
+        xs = &m_levels.back().m_xs;
+        ys = &m_levels.back().m_ys;
+    }
+}
+
+
+void TRACE::Plot( wxDC& aDC, mpWindow& aWindow )
+{
+    m_drawXs = &m_xs;
+    m_drawYs = &m_ys;
+    m_begin = 0;
+    m_end = m_xs.size();
+
+    if( !m_levels.empty() && m_scaleX )
+    {
+        wxCoord startPx = m_drawOutsideMargins ? 0 : aWindow.GetMarginLeft();
+        wxCoord endPx   = m_drawOutsideMargins ? aWindow.GetScrX() : aWindow.GetScrX() - aWindow.GetMarginRight();
+        double  minX    = s2x( aWindow.p2x( startPx ) );
+        double  maxX    = s2x( aWindow.p2x( endPx ) );
+
+        if( minX > maxX )
+            std::swap( minX, maxX );
+
+        // Visible samples, and one more on each side for the lines leaving the plot area
+        size_t first = std::lower_bound( m_xs.begin(), m_xs.end(), minX ) - m_xs.begin();
+        size_t last = std::upper_bound( m_xs.begin(), m_xs.end(), maxX ) - m_xs.begin();
+
+        first = first > 0 ? first - 1 : 0;
+        last = std::min( last + 1, m_xs.size() );
+
+        if( first < last )
+        {
+            m_begin = first;
+            m_end = last;
+
+            // Use the coarsest level which still has enough points for the plot width
+            size_t minPoints = POINTS_PER_PIXEL * std::max( endPx - startPx, 1 );
+            size_t bucket = 4;
+
+            for( const LEVEL& level : m_levels )
+            {
+                size_t begin = 2 * ( first / bucket );
+                size_t end = std::min( 2 * ( ( last - 1 ) / bucket ) + 2, level.m_xs.size() );
+
+                if( end - begin < minPoints )
+                    break;
+
+                m_drawXs = &level.m_xs;
+                m_drawYs = &level.m_ys;
+                m_begin = begin;
+                m_end = end;
+                bucket *= 2;
+            }
+        }
+    }
+
+    mpFXYVector::Plot( aDC, aWindow );
+}
+
+
+void TRACE::Rewind()
+{
+    m_index = m_begin;
+}
+
+
+bool TRACE::GetNextXY( double& aX, double& aY )
+{
+    if( m_index >= m_end )
+        return false;
+
+    aX = (*m_drawXs)[m_index];
+    aY = (*m_drawYs)[m_index];
+    ++m_index;
+
+    return true;
+}
+
+
 SIM_PLOT_PANEL::SIM_PLOT_PANEL( SIM_TYPE aType, wxWindow* parent, wxWindowID id, const wxPoint& pos,
                 const wxSize& size, long style, const wxString& name )
     : mpWindow( parent, id, pos, size, style ), m_colorIdx( 0 ),
@@ -88,7 +88,8 @@ class TRACE : public mpFXYVector
 {
 public:
     TRACE( const wxString& aName ) :
-        mpFXYVector( aName ), m_cursor( nullptr ), m_flags( 0 )
+        mpFXYVector( aName ), m_cursor( nullptr ), m_flags( 0 ),
+        m_drawXs( &m_xs ), m_drawYs( &m_ys ), m_begin( 0 ), m_end( 0 )
     {
         SetContinuity( true );
         SetDrawOutsideMargins( false );
@@ -106,8 +107,15 @@ public:
             m_cursor->Update();
 
         mpFXYVector::SetData( aX, aY );
+        buildLevels();
     }
 
+    /**
+     * @brief Draws the visible part of the trace, using the decimated data matching the
+     * number of pixels of the plot area when the trace has a lot of points.
+     */
+    void Plot( wxDC& aDC, mpWindow& aWindow ) override;
+
     const std::vector<double>& GetDataX() const
     {
         return m_xs;
@@ -154,9 +162,40 @@ public:
     }
 
 protected:
+    void Rewind() override;
+
+    bool GetNextXY( double& aX, double& aY ) override;
+
     CURSOR* m_cursor;
     int m_flags;
     wxColour m_traceColour;
+
+private:
+    ///> Decimated copy of the trace: each bucket of samples is replaced by two points,
+    ///> its minimum and its maximum in X order, so peaks are kept whatever the zoom level.
+    struct LEVEL
+    {
+        std::vector<double> m_xs;
+        std::vector<double> m_ys;
+    };
+
+    ///> Builds m_levels from m_xs and m_ys
+    void buildLevels();
+
+    ///> Level i holds buckets of 4 << i samples. Empty for short traces and for traces
+    ///> whose X values are not sorted.
+    std::vector<LEVEL> m_levels;
+
+    ///> Data used by GetNextXY(): the samples or one of the levels, and the range to draw
+    const std::vector<double>* m_drawXs;
+    const std::vector<double>* m_drawYs;
+    size_t m_begin, m_end;
+
+    ///> Traces with less points are not decimated
+    static constexpr size_t DECIMATION_THRESHOLD = 10000;
+
+    ///> Minimal number of points drawn per pixel of the plot area
+    static constexpr int POINTS_PER_PIXEL = 4;
 };
 
 
@@ -0,0 +1,597 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "sim_sweep.h"
+#include "netlist_exporter_pspice_sim.h"
+#include "spice_value.h"
+
+#include <common.h>
+#include <ki_exception.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/regex.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+#include <algorithm>
+#include <locale>
+#include <random>
+#include <sstream>
+
+wxDEFINE_EVENT( EVT_SIM_SWEEP_RESULT, wxCommandEvent );
+wxDEFINE_EVENT( EVT_SIM_SWEEP_FINISHED, wxCommandEvent );
+
+
+///> Upper limit of the number of simulations of a sweep
+static const size_t MAX_SWEEP_POINTS = 100000;
+
+
+static wxString ngspiceExecutable()
+{
+    wxString exe;
+
+    if( !wxGetEnv( "KICAD_NGSPICE", &exe ) || exe.IsEmpty() )
+        exe = "ngspice";
+
+    return exe;
+}
+
+
+static bool isValidName( const wxString& aName )
+{
+    if( aName.IsEmpty() )
+        return false;
+
+    for( wxUniChar c : aName )
+    {
+        if( !c.IsAscii() || !( isalnum( (int) c.GetValue() ) || c == '_' ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+SIM_SWEEP::SIM_SWEEP( wxEvtHandler* aParent ) :
+    m_parent( aParent ), m_next( 0 ), m_workers( 1 ), m_generation( 0 )
+{
+}
+
+
+SIM_SWEEP::~SIM_SWEEP()
+{
+    Stop();
+
+    if( !m_baseName.IsEmpty() )
+        wxRemoveFile( m_baseName );
+}
+
+
+bool SIM_SWEEP::ParseSpec( const wxString& aSpec, std::vector<SIM_SWEEP_POINT>& aPoints,
+                           wxString& aError )
+{
+    struct TOLERANCE
+    {
+        wxString m_name;
+        double   m_value;
+        double   m_tolerance;
+    };
+
+    std::vector<std::pair<wxString, std::vector<wxString>>> lists;
+    std::vector<TOLERANCE> tolerances;
+    long runs = 1;
+    long seed = -1;
+
+    wxStringTokenizer tokens( aSpec, "\n;", wxTOKEN_STRTOK );
+
+    while( tokens.HasMoreTokens() )
+    {
+        wxString line = tokens.GetNextToken().Trim().Trim( false );
+
+        if( line.IsEmpty() || line[0] == '*' )
+            continue;
+
+        wxString name = line.BeforeFirst( '=' ).Trim();
+        wxString value = line.AfterFirst( '=' ).Trim( false );
+
+        if( !line.Contains( "=" ) || !isValidName( name ) || value.IsEmpty() )
+        {
+            aError = wxString::Format( _( "Invalid sweep definition \"%s\"" ), line );
+            return false;
+        }
+
+        if( name.CmpNoCase( "RUNS" ) == 0 )
+        {
+            if( !value.ToLong( &runs ) || runs < 1 )
+            {
+                aError = wxString::Format( _( "Invalid number of runs \"%s\"" ), value );
+                return false;
+            }
+        }
+        else if( name.CmpNoCase( "SEED" ) == 0 )
+        {
+            if( !value.ToLong( &seed ) || seed < 0 )
+            {
+                aError = wxString::Format( _( "Invalid random seed \"%s\"" ), value );
+                return false;
+            }
+        }
+        else if( value.Contains( "+-" ) )
+        {
+            TOLERANCE tolerance;
+            int       separator = value.Find( "+-" );
+            wxString  percent = value.Mid( separator + 2 ).Trim().Trim( false );
+
+            tolerance.m_name = name;
+
+            try
+            {
+                tolerance.m_value = SPICE_VALUE( value.Left( separator ).Trim() ).ToDouble();
+            }
+            catch( const KI_PARAM_ERROR& )
+            {
+                aError = wxString::Format( _( "Invalid value for %s" ), name );
+                return false;
+            }
+
+            if( !percent.EndsWith( "%" ) || !percent.RemoveLast().Trim().ToCDouble(
+                        &tolerance.m_tolerance ) || tolerance.m_tolerance < 0.0 )
+            {
+                aError = wxString::Format( _( "Invalid tolerance for %s (expected %%)" ), name );
+                return false;
+            }
+
+            tolerance.m_tolerance /= 100.0;
+            tolerances.push_back( tolerance );
+        }
+        else
+        {
+            std::vector<wxString> values;
+            wxStringTokenizer     valueTokens( value, ",", wxTOKEN_STRTOK );
+
+            while( valueTokens.HasMoreTokens() )
+            {
+                wxString v = valueTokens.GetNextToken().Trim().Trim( false );
+
+                if( !v.IsEmpty() )
+                    values.push_back( v );
+            }
+
+            if( values.empty() )
+            {
+                aError = wxString::Format( _( "No value given for %s" ), name );
+                return false;
+            }
+
+            lists.emplace_back( name, values );
+        }
+    }
+
+    size_t combinations = 1;
+
+    for( const auto& list : lists )
+    {
+        combinations *= list.second.size();
+
+        if( combinations > MAX_SWEEP_POINTS )
+            break;
+    }
+
+    if( combinations > MAX_SWEEP_POINTS || (size_t) runs > MAX_SWEEP_POINTS / combinations )
+    {
+        aError = wxString::Format( _( "Too many simulations (the limit is %lu)" ),
+                                   (unsigned long) MAX_SWEEP_POINTS );
+        return false;
+    }
+
+    std::mt19937 rng( seed >= 0 ? (unsigned) seed : std::random_device()() );
+
+    aPoints.clear();
+    aPoints.reserve( combinations * runs );
+
+    for( size_t combination = 0; combination < combinations; ++combination )
+    {
+        SIM_SWEEP_POINT point;
+        size_t          index = combination;
+
+        // The first list is the outer loop
+        for( auto it = lists.rbegin(); it != lists.rend(); ++it )
+        {
+            point[it->first] = it->second[index % it->second.size()];
+            index /= it->second.size();
+        }
+
+        for( long run = 0; run < runs; ++run )
+        {
+            for( const TOLERANCE& tolerance : tolerances )
+            {
+                double range = std::abs( tolerance.m_value ) * tolerance.m_tolerance;
+                std::uniform_real_distribution<double> distribution( tolerance.m_value - range,
+                                                                     tolerance.m_value + range );
+
+                point[tolerance.m_name] = SPICE_VALUE( distribution( rng ) ).ToSpiceString();
+            }
+
+            aPoints.push_back( point );
+        }
+    }
+
+    return true;
+}
+
+
+wxString SIM_SWEEP::FormatPoint( const SIM_SWEEP_POINT& aPoint )
+{
+    wxString str;
+
+    for( const auto& var : aPoint )
+    {
+        if( !str.IsEmpty() )
+            str += ", ";
+
+        str += var.first + "=" + var.second;
+    }
+
+    return str;
+}
+
+
+/**
+ * Sets the value of a .param parameter, or adds its definition after the title line if
+ * the netlist does not define it.
+ */
+static void setParam( wxArrayString& aLines, const wxString& aName, const wxString& aValue )
+{
+    wxRegEx param( wxString::Format( "(^|[[:space:]])%s[[:space:]]*=[[:space:]]*[^[:space:]]+",
+                                     aName ), wxRE_EXTENDED | wxRE_ICASE );
+
+    for( wxString& line : aLines )
+    {
+        if( !line.Lower().StartsWith( ".param" ) || !param.Matches( line ) )
+            continue;
+
+        size_t start, len;
+        param.GetMatch( &start, &len, 0 );
+
+        line = line.Left( start ) + param.GetMatch( line, 1 ) + aName + "=" + aValue
+               + line.Mid( start + len );
+        return;
+    }
+
+    wxString definition = ".param " + aName + "=" + aValue;
+
+    if( aLines.IsEmpty() )
+        aLines.Add( definition );
+    else
+        aLines.Insert( definition, 1 );
+}
+
+
+wxString SIM_SWEEP::ApplyPoint( const wxString& aNetlist,
+                                const NETLIST_EXPORTER_PSPICE_SIM& aExporter,
+                                const SIM_SWEEP_POINT& aPoint )
+{
+    wxArrayString lines;
+    wxStringSplit( aNetlist, lines, '\n' );
+
+    for( const auto& var : aPoint )
+    {
+        const auto& items = aExporter.GetSpiceItems();
+        // SPICE names are case insensitive
+        auto item = std::find_if( items.begin(), items.end(), [&]( const SPICE_ITEM& aItem ) {
+            return aItem.m_refName.CmpNoCase( var.first ) == 0;
+        } );
+
+        if( item == items.end() )
+        {
+            setParam( lines, var.first, var.second );
+            continue;
+        }
+
+        // Component lines end with the component value (see NETLIST_EXPORTER_PSPICE::Format())
+        wxString device = aExporter.GetSpiceDevice( item->m_refName ) + " ";
+
+        for( wxString& line : lines )
+        {
+            if( !line.StartsWith( device ) )
+                continue;
+
+            if( !item->m_model.IsEmpty() && line.EndsWith( item->m_model ) )
+                line = line.Left( line.length() - item->m_model.length() ) + var.second;
+            else
+                line = line.BeforeLast( ' ' ) + " " + var.second;
+
+            break;
+        }
+    }
+
+    wxString netlist;
+
+    for( const wxString& line : lines )
+        netlist += line + "\n";
+
+    return netlist;
+}
+
+
+bool SIM_SWEEP::ParseOutput( const std::string& aData, size_t aSignals, RESULT& aResult )
+{
+    std::istringstream stream( aData );
+    std::string        line;
+    bool               header = true;
+
+    aResult.m_x.clear();
+    aResult.m_signals.assign( aSignals, std::vector<double>() );
+
+    while( std::getline( stream, line ) )
+    {
+        if( line.find_first_not_of( " \t\r" ) == std::string::npos )
+            continue;
+
+        // The first line holds the vector names
+        if( header )
+        {
+            header = false;
+            continue;
+        }
+
+        std::istringstream  row( line );
+        std::vector<double> values;
+        double              value;
+
+        row.imbue( std::locale::classic() );
+
+        while( row >> value )
+            values.push_back( value );
+
+        // Complex vectors (e.g. the AC frequency) are written as real and imaginary parts
+        size_t first, step;
+
+        if( values.size() == aSignals + 1 )
+        {
+            first = 1;
+            step = 1;
+        }
+        else if( values.size() == aSignals + 2 )
+        {
+            first = 2;
+            step = 1;
+        }
+        else if( values.size() == 2 * ( aSignals + 1 ) )
+        {
+            first = 2;
+            step = 2;
+        }
+        else
+        {
+            return false;
+        }
+
+        aResult.m_x.push_back( values[0] );
+
+        for( size_t ii = 0; ii < aSignals; ++ii )
+            aResult.m_signals[ii].push_back( values[first + ii * step] );
+    }
+
+    return !aResult.m_x.empty();
+}
+
+
+bool SIM_SWEEP::Start( const wxString& aNetlist, const NETLIST_EXPORTER_PSPICE_SIM& aExporter,
+                       const std::vector<SIM_SWEEP_POINT>& aPoints,
+                       const std::vector<wxString>& aSignals, int aWorkers )
+{
+    if( IsRunning() )
+        return false;
+
+    if( !m_baseName.IsEmpty() )
+        wxRemoveFile( m_baseName );
+
+    m_baseName = wxFileName::CreateTempFileName( "kicad_sweep" );
+
+    if( m_baseName.IsEmpty() )
+        return false;
+
+    // Events of the previous sweep still in the queue are dropped, see IsCurrent()
+    m_generation++;
+    m_points = aPoints;
+    m_signals = aSignals;
+    m_workers = std::max( aWorkers, 1 );
+    m_next = 0;
+    m_results.assign( aPoints.size(), RESULT() );
+    m_netlists.clear();
+
+    // Commands run by ngspice in batch mode, to save the signals in a text file
+    size_t   end = aNetlist.Lower().rfind( ".end" );
+    wxString netlist = end == wxString::npos ? aNetlist : aNetlist.Left( end );
+
+    for( size_t ii = 0; ii < aPoints.size(); ++ii )
+    {
+        wxString control = ".control\n"
+                           "set wr_singlescale\n"
+                           "set wr_vecnames\n"
+                           "run\n"
+                           "wrdata " + wxFileName( outputFile( ii ) ).GetFullName();
+
+        for( const wxString& signal : aSignals )
+            control += " " + signal;
+
+        control += "\nquit\n.endc\n.end\n";
+
+        m_netlists.push_back( ApplyPoint( netlist, aExporter, aPoints[ii] ) + control );
+    }
+
+    launch();
+
+    return true;
+}
+
+
+void SIM_SWEEP::Stop()
+{
+    for( PROCESS* process : m_running )
+    {
+        process->m_sweep = nullptr;
+        wxProcess::Kill( process->m_pid, wxSIGKILL, wxKILL_CHILDREN );
+        removeFiles( process->m_index );
+    }
+
+    m_running.clear();
+    m_next = m_netlists.size();
+    m_generation++;
+}
+
+
+bool SIM_SWEEP::IsCurrent( const wxCommandEvent& aEvent ) const
+{
+    if( aEvent.GetExtraLong() != m_generation )
+        return false;
+
+    return aEvent.GetEventType() != EVT_SIM_SWEEP_RESULT
+           || ( aEvent.GetInt() >= 0 && (size_t) aEvent.GetInt() < m_results.size() );
+}
+
+
+void SIM_SWEEP::notify( wxEventType aType, size_t aIndex )
+{
+    wxCommandEvent* event = new wxCommandEvent( aType );
+
+    event->SetInt( (int) aIndex );
+    event->SetExtraLong( m_generation );
+    wxQueueEvent( m_parent, event );
+}
+
+
+void SIM_SWEEP::PROCESS::OnTerminate( int aPid, int aStatus )
+{
+    if( m_sweep )
+        m_sweep->onTerminate( this, aStatus );
+
+    delete this;
+}
+
+
+void SIM_SWEEP::launch()
+{
+    wxExecuteEnv env;
+    env.cwd = wxFileName( m_baseName ).GetPath();
+
+    while( (int) m_running.size() < m_workers && m_next < m_netlists.size() )
+    {
+        size_t   index = m_next++;
+        RESULT&  result = m_results[index];
+        wxFFile  file( netlistFile( index ), "wb" );
+
+        if( !file.IsOpened() || !file.Write( m_netlists[index], wxConvUTF8 ) || !file.Close() )
+        {
+            result.m_done = true;
+            result.m_log = wxString::Format( _( "Cannot write file \"%s\"" ),
+                                             netlistFile( index ) );
+        }
+        else
+        {
+            PROCESS* process = new PROCESS( this, index );
+            wxString cmd = wxString::Format( "\"%s\" -b -o \"%s\" \"%s\"", ngspiceExecutable(),
+                                             wxFileName( logFile( index ) ).GetFullName(),
+                                             wxFileName( netlistFile( index ) ).GetFullName() );
+
+            process->m_pid = wxExecute( cmd, wxEXEC_ASYNC | wxEXEC_HIDE_CONSOLE, process, &env );
+
+            if( process->m_pid > 0 )
+            {
+                m_running.push_back( process );
+                continue;
+            }
+
+            delete process;
+            removeFiles( index );
+            result.m_done = true;
+            result.m_log = wxString::Format( _( "Cannot run \"%s\"" ), cmd );
+        }
+
+        notify( EVT_SIM_SWEEP_RESULT, index );
+    }
+
+    if( !IsRunning() )
+        notify( EVT_SIM_SWEEP_FINISHED, 0 );
+}
+
+
+void SIM_SWEEP::onTerminate( PROCESS* aProcess, int aStatus )
+{
+    m_running.erase( std::find( m_running.begin(), m_running.end(), aProcess ) );
+
+    size_t  index = aProcess->m_index;
+    RESULT& result = m_results[index];
+    wxFFile output( outputFile( index ), "rb" );
+    wxString data;
+
+    result.m_done = true;
+
+    if( aStatus == 0 && output.IsOpened() && output.ReadAll( &data, wxConvUTF8 ) )
+        result.m_ok = ParseOutput( (const char*) data.utf8_str(), m_signals.size(), result );
+
+    if( !result.m_ok )
+    {
+        wxFFile log( logFile( index ), "rb" );
+
+        if( !log.IsOpened() || !log.ReadAll( &result.m_log, wxConvUTF8 ) )
+            result.m_log = wxString::Format( _( "ngspice exited with status %d" ), aStatus );
+    }
+
+    output.Close();
+    removeFiles( index );
+
+    notify( EVT_SIM_SWEEP_RESULT, index );
+
+    launch();
+}
+
+
+wxString SIM_SWEEP::netlistFile( size_t aIndex ) const
+{
+    return m_baseName + wxString::Format( "_%lu.cir", (unsigned long) aIndex );
+}
+
+
+wxString SIM_SWEEP::outputFile( size_t aIndex ) const
+{
+    return m_baseName + wxString::Format( "_%lu.txt", (unsigned long) aIndex );
+}
+
+
+wxString SIM_SWEEP::logFile( size_t aIndex ) const
+{
+    return m_baseName + wxString::Format( "_%lu.log", (unsigned long) aIndex );
+}
+
+
+void SIM_SWEEP::removeFiles( size_t aIndex ) const
+{
+    for( const wxString& file : { netlistFile( aIndex ), outputFile( aIndex ), logFile( aIndex ) } )
+    {
+        if( wxFileExists( file ) )
+            wxRemoveFile( file );
+    }
+}
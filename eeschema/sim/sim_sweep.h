@@ -0,0 +1,200 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SIM_SWEEP_H
+#define SIM_SWEEP_H
+
+#include <wx/event.h>
+#include <wx/process.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+class NETLIST_EXPORTER_PSPICE_SIM;
+
+///> Values of the swept variables for one simulation of a sweep. Keys are either component
+///> references (to change the component value) or names of .param parameters.
+typedef std::map<wxString, wxString> SIM_SWEEP_POINT;
+
+
+/**
+ * @brief Runs a netlist for a list of component or parameter values, in a pool of ngspice
+ * processes running in batch mode.
+ *
+ * The ngspice executable is the one found in the path, unless the KICAD_NGSPICE environment
+ * variable gives another one. The results are notified to the parent event handler with
+ * EVT_SIM_SWEEP_RESULT events (the event int is the index of the point), and the end of the
+ * sweep with an EVT_SIM_SWEEP_FINISHED event.  Events may still be queued when the sweep is
+ * stopped or restarted: the handlers must drop the ones for which IsCurrent() is false.
+ */
+class SIM_SWEEP : public wxEvtHandler
+{
+public:
+    ///> Outcome of the simulation of a point of the sweep
+    struct RESULT
+    {
+        RESULT() : m_done( false ), m_ok( false ) {}
+
+        bool m_done;
+        bool m_ok;
+
+        ///> X axis (time, frequency or swept source)
+        std::vector<double> m_x;
+
+        ///> One vector per signal, in the order given to Start()
+        std::vector<std::vector<double>> m_signals;
+
+        ///> ngspice output, when the simulation failed
+        wxString m_log;
+    };
+
+    SIM_SWEEP( wxEvtHandler* aParent );
+    ~SIM_SWEEP();
+
+    /**
+     * @brief Parses a sweep specification, made of lines (or ';' separated items) like:
+     * - NAME=V1,V2,... to use each value of the list,
+     * - NAME=VALUE+-TOL% to use a random value in the tolerance range (Monte Carlo),
+     * - RUNS=N to run each combination of the lists N times (default 1),
+     * - SEED=N to get the same random values at each sweep.
+     * NAME is either a component reference or a parameter name. Lines starting with '*' are
+     * comments.
+     * @param aPoints receives every combination of the listed values.
+     * @param aError receives the error message if the specification is not valid.
+     * @return true if successful.
+     */
+    static bool ParseSpec( const wxString& aSpec, std::vector<SIM_SWEEP_POINT>& aPoints,
+                           wxString& aError );
+
+    /**
+     * @brief Returns aPoint in a form suitable for trace names (e.g. "R1=2k, Rload=10").
+     */
+    static wxString FormatPoint( const SIM_SWEEP_POINT& aPoint );
+
+    /**
+     * @brief Returns aNetlist, created by aExporter, with the values of aPoint.
+     */
+    static wxString ApplyPoint( const wxString& aNetlist,
+                                const NETLIST_EXPORTER_PSPICE_SIM& aExporter,
+                                const SIM_SWEEP_POINT& aPoint );
+
+    /**
+     * @brief Reads the data written by the ngspice wrdata command (with the wr_vecnames and
+     * wr_singlescale options) for aSignals signals.
+     * @return false if the data is not valid.
+     */
+    static bool ParseOutput( const std::string& aData, size_t aSignals, RESULT& aResult );
+
+    /**
+     * @brief Starts the simulation of all points.
+     * @param aNetlist is the netlist created by aExporter.
+     * @param aSignals are the vectors to save (real valued expressions).
+     * @param aWorkers is the maximal number of ngspice processes running at the same time.
+     * @return false if a sweep is already running.
+     */
+    bool Start( const wxString& aNetlist, const NETLIST_EXPORTER_PSPICE_SIM& aExporter,
+                const std::vector<SIM_SWEEP_POINT>& aPoints,
+                const std::vector<wxString>& aSignals, int aWorkers );
+
+    /**
+     * @brief Kills the running simulations and drops the ones not started yet. No event is
+     * sent for them.
+     */
+    void Stop();
+
+    /**
+     * @brief Returns true if aEvent was sent by the current sweep, and refers to one of its
+     * points. Events sent before the last call to Start() or Stop() are not current.
+     */
+    bool IsCurrent( const wxCommandEvent& aEvent ) const;
+
+    bool IsRunning() const
+    {
+        return !m_running.empty() || m_next < m_netlists.size();
+    }
+
+    const std::vector<SIM_SWEEP_POINT>& GetPoints() const
+    {
+        return m_points;
+    }
+
+    const RESULT& GetResult( size_t aIndex ) const
+    {
+        return m_results[aIndex];
+    }
+
+private:
+    ///> ngspice process simulating one point
+    class PROCESS : public wxProcess
+    {
+    public:
+        PROCESS( SIM_SWEEP* aSweep, size_t aIndex ) :
+            m_sweep( aSweep ), m_index( aIndex ), m_pid( 0 )
+        {
+        }
+
+        void OnTerminate( int aPid, int aStatus ) override;
+
+        SIM_SWEEP* m_sweep;     ///< nullptr once the sweep does not wait for it anymore
+        size_t     m_index;
+        long       m_pid;
+    };
+
+    ///> Starts simulations until there are m_workers running
+    void launch();
+
+    ///> Collects the results of a terminated simulation
+    void onTerminate( PROCESS* aProcess, int aStatus );
+
+    ///> Files used to simulate a point, in the temporary directory
+    wxString netlistFile( size_t aIndex ) const;
+    wxString outputFile( size_t aIndex ) const;
+    wxString logFile( size_t aIndex ) const;
+
+    void removeFiles( size_t aIndex ) const;
+
+    ///> Queues an event of the current sweep to the parent
+    void notify( wxEventType aType, size_t aIndex );
+
+    wxEvtHandler* m_parent;
+
+    std::vector<SIM_SWEEP_POINT> m_points;
+    std::vector<wxString>        m_netlists;
+    std::vector<RESULT>          m_results;
+    std::vector<wxString>        m_signals;
+
+    std::vector<PROCESS*> m_running;
+    size_t                m_next;       ///< next point to simulate
+    int                   m_workers;
+    long                  m_generation; ///< sweep id, sent with the events
+
+    ///> Temporary file whose name is the base name of the simulation files
+    wxString m_baseName;
+};
+
+
+wxDECLARE_EVENT( EVT_SIM_SWEEP_RESULT, wxCommandEvent );
+wxDECLARE_EVENT( EVT_SIM_SWEEP_FINISHED, wxCommandEvent );
+
+#endif /* SIM_SWEEP_H */
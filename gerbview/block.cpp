@@ -209,13 +209,7 @@ void GERBVIEW_FRAME::Block_Move()
             continue;
 
         /* Move items in block */
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
-        {
-            GERBER_DRAW_ITEM* gerb_item = item;
-
-            if( gerb_item->HitTest( GetScreen()->m_BlockLocate ) )
-                gerb_item->MoveAB( delta );
-        }
+        gerber->MoveItems( GetScreen()->m_BlockLocate, delta );
     }
 
     m_canvas->Refresh( true );
@@ -326,6 +326,7 @@ void GERBVIEW_FRAME::OnSelectHighlightChoice( wxCommandEvent& event )
         }
 
         GetGalCanvas()->GetView()->UpdateAllItems( KIGFX::COLOR );
+        GERBER_PRIMITIVES_BLOCK::RepaintAll( GetGalCanvas()->GetView() );
         GetGalCanvas()->Refresh();
     }
     else
@@ -392,10 +392,12 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     X2_ATTRIBUTE dummy;
     char* text = (char*)file_attribute;
     int dummyline = 0;
-    dummy.ParseAttribCmd( NULL, NULL, 0, text, dummyline );
+    dummy.ParseAttribCmd( NULL, text, dummyline );
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    BuildItemsIndex();
+
     m_InUse = true;
 
     return true;
@@ -257,10 +257,11 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
         if( pcb_layer_number <= pcbCopperLayerMax ) // copper layer
             continue;
 
-        GERBER_DRAW_ITEM* gerb_item = gerber->GetItemsList();
-
-        for( ; gerb_item; gerb_item = gerb_item->Next() )
+        gerber->VisitItems( [&]( GERBER_DRAW_ITEM* gerb_item ) -> bool
+        {
             export_non_copper_item( gerb_item, pcb_layer_number );
+            return true;
+        } );
     }
 
     // Copper layers
@@ -276,10 +277,11 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
         if( pcb_layer_number < 0 || pcb_layer_number > pcbCopperLayerMax )
             continue;
 
-        GERBER_DRAW_ITEM* gerb_item = gerber->GetItemsList();
-
-        for( ; gerb_item; gerb_item = gerb_item->Next() )
+        gerber->VisitItems( [&]( GERBER_DRAW_ITEM* gerb_item ) -> bool
+        {
             export_copper_item( gerb_item, pcb_layer_number );
+            return true;
+        } );
     }
 
     fprintf( m_fp, ")\n" );
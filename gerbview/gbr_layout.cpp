@@ -65,7 +65,7 @@ EDA_RECT GBR_LAYOUT::ComputeBoundingBox() const
         if( gerber == NULL )    // Graphic layer not yet used
             continue;
 
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
+        gerber->VisitItems( [&]( GERBER_DRAW_ITEM* item ) -> bool
         {
             if( first_item )
             {
@@ -74,7 +74,9 @@ EDA_RECT GBR_LAYOUT::ComputeBoundingBox() const
             }
             else
                 bbox.Merge( item->GetBoundingBox() );
-        }
+
+            return true;
+        } );
     }
 
     bbox.Normalize();
@@ -273,10 +275,10 @@ void GBR_LAYOUT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
 
         // Now we can draw the current layer to the bitmap buffer
         // When needed, the previous bitmap is already copied to the screen buffer.
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
+        gerber->VisitItems( [&]( GERBER_DRAW_ITEM* item ) -> bool
         {
             if( item->GetLayer() != layer )
-                continue;
+                return true;
 
             GR_DRAWMODE drawMode = layerdrawMode;
 
@@ -297,7 +299,9 @@ void GBR_LAYOUT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
 
             item->Draw( aPanel, plotDC, drawMode, wxPoint(0,0), aDisplayOptions );
             doBlit = true;
-        }
+
+            return true;
+        } );
     }
 
     if( doBlit && useBufferBitmap )     // Blit is used only if aDrawMode >= 0
@@ -367,14 +371,14 @@ void GBR_LAYOUT::DrawItemsDCodeID( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
         if( !gerbFrame->IsLayerVisible( layer ) )
             continue;
 
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item != NULL; item = item->Next() )
+        gerber->VisitItems( [&]( GERBER_DRAW_ITEM* item ) -> bool
         {
             wxPoint pos;
             int     size;
             double  orient;
 
             if( ! item->GetTextD_CodePrms( size, pos, orient ) )
-                continue;
+                return true;
 
             Line.Printf( wxT( "D%d" ), item->m_DCode );
 
@@ -390,7 +394,9 @@ void GBR_LAYOUT::DrawItemsDCodeID( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
                                  GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER,
                                  0, false, false );
             }
-        }
+
+            return true;
+        } );
     }
 }
 
@@ -26,6 +26,8 @@
  * @file gerber_draw_item.cpp
  */
 
+#include <tuple>
+
 #include <fctsys.h>
 #include <gr_basic.h>
 #include <common.h>
@@ -41,6 +43,36 @@
 #include <gerber_file_image_list.h>
 
 
+GERBER_ITEM_ATTRIBUTES::GERBER_ITEM_ATTRIBUTES()
+{
+    m_LayerNegative = false;
+    m_SwapAxis      = false;
+    m_MirrorA       = false;
+    m_MirrorB       = false;
+    m_DrawScale.x   = m_DrawScale.y = 1.0;
+    m_LyrRotation   = 0;
+}
+
+
+bool GERBER_ITEM_ATTRIBUTES::operator<( const GERBER_ITEM_ATTRIBUTES& aOther ) const
+{
+    const GBR_NETLIST_METADATA& net = m_NetAttributes;
+    const GBR_NETLIST_METADATA& otherNet = aOther.m_NetAttributes;
+
+    return std::tie( m_LayerNegative, m_SwapAxis, m_MirrorA, m_MirrorB,
+                     m_DrawScale.x, m_DrawScale.y, m_LayerOffset.x, m_LayerOffset.y,
+                     m_LyrRotation, net.m_NetAttribType, net.m_NotInNet,
+                     net.m_Padname, net.m_Cmpref, net.m_Netname, m_AperFunction )
+         < std::tie( aOther.m_LayerNegative, aOther.m_SwapAxis,
+                     aOther.m_MirrorA, aOther.m_MirrorB,
+                     aOther.m_DrawScale.x, aOther.m_DrawScale.y,
+                     aOther.m_LayerOffset.x, aOther.m_LayerOffset.y,
+                     aOther.m_LyrRotation, otherNet.m_NetAttribType, otherNet.m_NotInNet,
+                     otherNet.m_Padname, otherNet.m_Cmpref, otherNet.m_Netname,
+                     aOther.m_AperFunction );
+}
+
+
 GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     EDA_ITEM( (EDA_ITEM*)NULL, GERBER_DRAW_ITEM_T )
 {
@@ -49,15 +81,13 @@ GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     m_Flashed       = false;
     m_DCode         = 0;
     m_UnitsMetric   = false;
-    m_LayerNegative = false;
-    m_swapAxis      = false;
-    m_mirrorA       = false;
-    m_mirrorB       = false;
-    m_drawScale.x   = m_drawScale.y = 1.0;
-    m_lyrRotation   = 0;
+    m_attributesIndex = -1;
 
     if( m_GerberImageFile )
-        SetLayerParameters();
+    {
+        m_UnitsMetric = m_GerberImageFile->m_GerbMetric;
+        m_attributesIndex = m_GerberImageFile->GetLayerAttributesIndex();
+    }
 }
 
 
@@ -66,16 +96,49 @@ GERBER_DRAW_ITEM::~GERBER_DRAW_ITEM()
 }
 
 
+const GERBER_ITEM_ATTRIBUTES& GERBER_DRAW_ITEM::attributes() const
+{
+    static const GERBER_ITEM_ATTRIBUTES defaultAttributes;
+
+    if( !m_GerberImageFile || m_attributesIndex < 0 )
+        return defaultAttributes;
+
+    return m_GerberImageFile->GetItemAttributes( m_attributesIndex );
+}
+
+
+void GERBER_DRAW_ITEM::setAttributes( const GERBER_ITEM_ATTRIBUTES& aAttributes )
+{
+    // Items without image (used only to calculate shapes) have the default attributes
+    if( m_GerberImageFile )
+        m_attributesIndex = m_GerberImageFile->AddItemAttributes( aAttributes );
+}
+
+
 void GERBER_DRAW_ITEM::SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
 {
-    m_netAttributes = aNetAttributes;
+    if( m_GerberImageFile )
+        m_attributesIndex = m_GerberImageFile->ChangeNetAttributes( m_attributesIndex,
+                                                                    aNetAttributes );
+}
+
+
+void GERBER_DRAW_ITEM::SetAperFunction( const wxString& aAperFunction )
+{
+    if( m_GerberImageFile )
+        m_attributesIndex = m_GerberImageFile->ChangeAperFunction( m_attributesIndex,
+                                                                   aAperFunction );
+}
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
-        ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
-        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( m_netAttributes.m_Cmpref, 0 ) );
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
-        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( m_netAttributes.m_Netname, 0 ) );
+void GERBER_DRAW_ITEM::SetLayerPolarity( bool aNegative )
+{
+    if( attributes().m_LayerNegative == aNegative )
+        return;
+
+    GERBER_ITEM_ATTRIBUTES itemAttributes = attributes();
+    itemAttributes.m_LayerNegative = aNegative;
+    setAttributes( itemAttributes );
 }
 
 
@@ -158,25 +221,26 @@ wxPoint GERBER_DRAW_ITEM::GetABPosition( const wxPoint& aXYPosition ) const
      * For instance: Rotation must be made after or before mirroring ?
      * Note: if something is changed here, GetYXPosition must reflect changes
      */
+    const GERBER_ITEM_ATTRIBUTES& attr = attributes();
     wxPoint abPos = aXYPosition + m_GerberImageFile->m_ImageJustifyOffset;
 
-    if( m_swapAxis )
+    if( attr.m_SwapAxis )
         std::swap( abPos.x, abPos.y );
 
-    abPos  += m_layerOffset + m_GerberImageFile->m_ImageOffset;
-    abPos.x = KiROUND( abPos.x * m_drawScale.x );
-    abPos.y = KiROUND( abPos.y * m_drawScale.y );
-    double rotation = m_lyrRotation * 10 + m_GerberImageFile->m_ImageRotation * 10;
+    abPos  += attr.m_LayerOffset + m_GerberImageFile->m_ImageOffset;
+    abPos.x = KiROUND( abPos.x * attr.m_DrawScale.x );
+    abPos.y = KiROUND( abPos.y * attr.m_DrawScale.y );
+    double rotation = attr.m_LyrRotation * 10 + m_GerberImageFile->m_ImageRotation * 10;
 
     if( rotation )
         RotatePoint( &abPos, -rotation );
 
     // Negate A axis if mirrored
-    if( m_mirrorA )
+    if( attr.m_MirrorA )
         abPos.x = -abPos.x;
 
     // abPos.y must be negated when no mirror, because draw axis is top to bottom
-    if( !m_mirrorB )
+    if( !attr.m_MirrorB )
         abPos.y = -abPos.y;
     return abPos;
 }
@@ -185,24 +249,25 @@ wxPoint GERBER_DRAW_ITEM::GetABPosition( const wxPoint& aXYPosition ) const
 wxPoint GERBER_DRAW_ITEM::GetXYPosition( const wxPoint& aABPosition ) const
 {
     // do the inverse transform made by GetABPosition
+    const GERBER_ITEM_ATTRIBUTES& attr = attributes();
     wxPoint xyPos = aABPosition;
 
-    if( m_mirrorA )
+    if( attr.m_MirrorA )
         xyPos.x = -xyPos.x;
 
-    if( !m_mirrorB )
+    if( !attr.m_MirrorB )
         xyPos.y = -xyPos.y;
 
-    double rotation = m_lyrRotation * 10 + m_GerberImageFile->m_ImageRotation * 10;
+    double rotation = attr.m_LyrRotation * 10 + m_GerberImageFile->m_ImageRotation * 10;
 
     if( rotation )
         RotatePoint( &xyPos, rotation );
 
-    xyPos.x = KiROUND( xyPos.x / m_drawScale.x );
-    xyPos.y = KiROUND( xyPos.y / m_drawScale.y );
-    xyPos  -= m_layerOffset + m_GerberImageFile->m_ImageOffset;
+    xyPos.x = KiROUND( xyPos.x / attr.m_DrawScale.x );
+    xyPos.y = KiROUND( xyPos.y / attr.m_DrawScale.y );
+    xyPos  -= attr.m_LayerOffset + m_GerberImageFile->m_ImageOffset;
 
-    if( m_swapAxis )
+    if( attr.m_SwapAxis )
         std::swap( xyPos.x, xyPos.y );
 
     return xyPos - m_GerberImageFile->m_ImageJustifyOffset;
@@ -212,17 +277,24 @@ wxPoint GERBER_DRAW_ITEM::GetXYPosition( const wxPoint& aABPosition ) const
 void GERBER_DRAW_ITEM::SetLayerParameters()
 {
     m_UnitsMetric = m_GerberImageFile->m_GerbMetric;
-    m_swapAxis    = m_GerberImageFile->m_SwapAxis;     // false if A = X, B = Y;
+
+    if( m_GerberImageFile->HasLayerParameters( attributes() ) )
+        return;
+
+    GERBER_ITEM_ATTRIBUTES attr = attributes();
+    attr.m_SwapAxis    = m_GerberImageFile->m_SwapAxis;     // false if A = X, B = Y;
 
     // true if A =Y, B = Y
-    m_mirrorA     = m_GerberImageFile->m_MirrorA;      // true: mirror / axe A
-    m_mirrorB     = m_GerberImageFile->m_MirrorB;      // true: mirror / axe B
-    m_drawScale   = m_GerberImageFile->m_Scale;        // A and B scaling factor
-    m_layerOffset = m_GerberImageFile->m_Offset;       // Offset from OF command
+    attr.m_MirrorA     = m_GerberImageFile->m_MirrorA;      // true: mirror / axe A
+    attr.m_MirrorB     = m_GerberImageFile->m_MirrorB;      // true: mirror / axe B
+    attr.m_DrawScale   = m_GerberImageFile->m_Scale;        // A and B scaling factor
+    attr.m_LayerOffset = m_GerberImageFile->m_Offset;       // Offset from OF command
 
     // Rotation from RO command:
-    m_lyrRotation = m_GerberImageFile->m_LocalRotation;
-    m_LayerNegative = m_GerberImageFile->GetLayerParams().m_LayerNegative;
+    attr.m_LyrRotation = m_GerberImageFile->m_LocalRotation;
+    attr.m_LayerNegative = m_GerberImageFile->GetLayerParams().m_LayerNegative;
+
+    setAttributes( attr );
 }
 
 
@@ -305,7 +377,8 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
 
     case GBR_CIRCLE:
     {
-        double radius = GetLineLength( m_Start, m_End );
+        // The outline is drawn with the pen width m_Size.x
+        double radius = GetLineLength( m_Start, m_End ) + ( m_Size.x + 1 ) / 2;
         bbox.Inflate( radius, radius );
         break;
     }
@@ -369,28 +442,20 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
 
     case GBR_SEGMENT:
     {
-        if( code && code->m_Shape == APT_RECT )
-        {
-            if( m_Polygon.OutlineCount() > 0 )
-            {
-                auto bb = m_Polygon.BBox();
-                bbox.Inflate( bb.GetWidth() / 2, bb.GetHeight() / 2 );
-                bbox.SetOrigin( bb.GetOrigin().x, bb.GetOrigin().y );
-            }
-        }
-        else
-        {
-            int radius = ( m_Size.x + 1 ) / 2;
+        // A segment drawn with a rectangular aperture is the rectangle swept from m_Start to
+        // m_End, so its bounding box is known before ConvertSegmentToPolygon() is called.
+        wxSize halfSize( ( m_Size.x + 1 ) / 2, ( m_Size.x + 1 ) / 2 );
 
-            int ymax = std::max( m_Start.y, m_End.y ) + radius;
-            int xmax = std::max( m_Start.x, m_End.x ) + radius;
+        if( code && code->m_Shape == APT_RECT )
+            halfSize.y = ( m_Size.y + 1 ) / 2;
 
-            int ymin = std::min( m_Start.y, m_End.y ) - radius;
-            int xmin = std::min( m_Start.x, m_End.x ) - radius;
+        int ymax = std::max( m_Start.y, m_End.y ) + halfSize.y;
+        int xmax = std::max( m_Start.x, m_End.x ) + halfSize.x;
 
-            bbox = EDA_RECT( wxPoint( xmin, ymin ), wxSize( xmax - xmin + 1, ymax - ymin + 1 ) );
-        }
+        int ymin = std::min( m_Start.y, m_End.y ) - halfSize.y;
+        int xmin = std::min( m_Start.x, m_End.x ) - halfSize.x;
 
+        bbox = EDA_RECT( wxPoint( xmin, ymin ), wxSize( xmax - xmin + 1, ymax - ymin + 1 ) );
         break;
     }
     default:
@@ -398,16 +463,19 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
         break;
     }
 
-    // calculate the corners coordinates in current gerber axis orientations
-    wxPoint org = GetABPosition( bbox.GetOrigin() );
-    wxPoint end = GetABPosition( bbox.GetEnd() );
+    // calculate the corners coordinates in current gerber axis orientations.
+    // All the corners are needed when the layer or the image is rotated.
+    const wxPoint corners[4] = { bbox.GetOrigin(),
+                                 wxPoint( bbox.GetRight(), bbox.GetY() ),
+                                 bbox.GetEnd(),
+                                 wxPoint( bbox.GetX(), bbox.GetBottom() ) };
 
-    // Set the corners position:
-    bbox.SetOrigin( org );
-    bbox.SetEnd( end );
-    bbox.Normalize();
+    EDA_RECT abBox( GetABPosition( corners[0] ), wxSize( 0, 0 ) );
 
-    return bbox;
+    for( int ii = 1; ii < 4; ii++ )
+        abBox.Merge( GetABPosition( corners[ii] ) );
+
+    return abBox;
 }
 
 
@@ -443,7 +511,7 @@ void GERBER_DRAW_ITEM::MoveXY( const wxPoint& aMoveVector )
 
 bool GERBER_DRAW_ITEM::HasNegativeItems()
 {
-    bool isClear = m_LayerNegative ^ m_GerberImageFile->m_ImageNegative;
+    bool isClear = GetLayerPolarity() ^ m_GerberImageFile->m_ImageNegative;
 
     // if isClear is true, this item has negative shape
     return isClear;
@@ -473,7 +541,7 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
      *   color other than the background color, else use the background color
      *   when drawing so that an erasure happens.
      */
-    bool isDark = !(m_LayerNegative ^ m_GerberImageFile->m_ImageNegative);
+    bool isDark = !( GetLayerPolarity() ^ m_GerberImageFile->m_ImageNegative );
 
     if( !isDark )
     {
@@ -698,10 +766,10 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_UNITS_T aUnits, std::vector< MSG_PAN
     {
         msg = _( "Attribute" );
 
-        if( m_AperFunction.IsEmpty() )
+        if( GetAperFunction().IsEmpty() )
             text = _( "No attribute" );
         else
-            text = m_AperFunction;
+            text = GetAperFunction();
     }
     else
     {
@@ -720,57 +788,61 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_UNITS_T aUnits, std::vector< MSG_PAN
     msg = GERBER_FILE_IMAGE_LIST::GetImagesList().GetDisplayName( GetLayer(), true );
     aList.push_back( MSG_PANEL_ITEM( _( "Graphic Layer" ), msg, DARKGREEN ) );
 
+    const GERBER_ITEM_ATTRIBUTES& attr = attributes();
+
     // Display item rotation
-    // The full rotation is Image rotation + m_lyrRotation
-    // but m_lyrRotation is specific to this object
+    // The full rotation is Image rotation + m_LyrRotation
+    // but m_LyrRotation is specific to this object
     // so we display only this parameter
-    msg.Printf( wxT( "%f" ), m_lyrRotation );
+    msg.Printf( wxT( "%f" ), attr.m_LyrRotation );
     aList.push_back( MSG_PANEL_ITEM( _( "Rotation" ), msg, BLUE ) );
 
     // Display item polarity (item specific)
-    msg = m_LayerNegative ? _("Clear") : _("Dark");
+    msg = attr.m_LayerNegative ? _("Clear") : _("Dark");
     aList.push_back( MSG_PANEL_ITEM( _( "Polarity" ), msg, BLUE ) );
 
     // Display mirroring (item specific)
     msg.Printf( wxT( "A:%s B:%s" ),
-                m_mirrorA ? _("Yes") : _("No"),
-                m_mirrorB ? _("Yes") : _("No"));
+                attr.m_MirrorA ? _("Yes") : _("No"),
+                attr.m_MirrorB ? _("Yes") : _("No"));
     aList.push_back( MSG_PANEL_ITEM( _( "Mirror" ), msg, DARKRED ) );
 
     // Display AB axis swap (item specific)
-    msg = m_swapAxis ? wxT( "A=Y B=X" ) : wxT( "A=X B=Y" );
+    msg = attr.m_SwapAxis ? wxT( "A=Y B=X" ) : wxT( "A=X B=Y" );
     aList.push_back( MSG_PANEL_ITEM( _( "AB axis" ), msg, DARKRED ) );
 
+    const GBR_NETLIST_METADATA& netAttributes = attr.m_NetAttributes;
+
     // Display net info, if exists
-    if( m_netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
+    if( netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
         return;
 
     // Build full net info:
     wxString net_msg;
     wxString cmp_pad_msg;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+    if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
     {
         net_msg = _( "Net:" );
         net_msg << " ";
 
-        if( m_netAttributes.m_Netname.IsEmpty() )
+        if( netAttributes.m_Netname.IsEmpty() )
             net_msg << "<no net name>";
         else
-            net_msg << m_netAttributes.m_Netname;
+            net_msg << netAttributes.m_Netname;
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
         cmp_pad_msg.Printf( _( "Cmp: %s;  Pad: %s" ),
-                                GetChars( m_netAttributes.m_Cmpref ),
-                                GetChars( m_netAttributes.m_Padname ) );
+                                GetChars( netAttributes.m_Cmpref ),
+                                GetChars( netAttributes.m_Padname ) );
     }
 
-    else if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
+    else if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
     {
         cmp_pad_msg = _( "Cmp:" );
-        cmp_pad_msg << " " << m_netAttributes.m_Cmpref;
+        cmp_pad_msg << " " << netAttributes.m_Cmpref;
     }
 
     aList.push_back( MSG_PANEL_ITEM( net_msg, cmp_pad_msg, DARKCYAN ) );
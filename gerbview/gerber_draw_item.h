@@ -63,10 +63,38 @@ enum Gbr_Basic_Shapes {
     GBR_LAST                // last value for this list
 };
 
+
+/**
+ * Struct GERBER_ITEM_ATTRIBUTES
+ * holds the parameters used to draw a gerber item which can change along a gerber file,
+ * but are shared by many items: layer parameters, net attributes and aperture function.
+ * Each GERBER_FILE_IMAGE keeps one copy of each set of these parameters, and its items
+ * only store the index of their set (see GERBER_FILE_IMAGE::AddItemAttributes()).
+ */
+struct GERBER_ITEM_ATTRIBUTES
+{
+    bool        m_LayerNegative;            // true = item in negative Layer
+    bool        m_SwapAxis;                 // false if A = X, B = Y; true if A =Y, B = Y
+    bool        m_MirrorA;                  // true: mirror / axe A
+    bool        m_MirrorB;                  // true: mirror / axe B
+    wxRealPoint m_DrawScale;                // A and B scaling factor
+    wxPoint     m_LayerOffset;              // Offset for A and B axis, from OF parameter
+    double      m_LyrRotation;              // Fine rotation, from OR parameter, in degrees
+    GBR_NETLIST_METADATA m_NetAttributes;   // the string given by a %TO attribute set in aperture
+    wxString    m_AperFunction;             // the aperture function set by a %TA.AperFunction
+                                            // for regions, which do not have a DCode
+
+    GERBER_ITEM_ATTRIBUTES();
+
+    bool operator<( const GERBER_ITEM_ATTRIBUTES& aOther ) const;
+};
+
 /***/
 
 class GERBER_DRAW_ITEM : public EDA_ITEM
 {
+    friend class GERBER_PRIMITIVES;
+
     // make SetNext() and SetBack() private so that they may not be called from anywhere.
     // list management is done on GERBER_DRAW_ITEMs using DLIST<GERBER_DRAW_ITEM> only.
 private:
@@ -92,10 +120,6 @@ public:
                                             // values 0 to 9 can be used for special purposes
                                             // Regions (polygons) doo not use DCode,
                                             // so it is set to 0
-    wxString m_AperFunction;                // the aperture function set by a %TA.AperFunction, xxx
-                                            // (stores thre xxx value).
-                                            // used for regions that do not have a attached DCode, but
-                                            // have a TA.AperFunction defined
     GERBER_FILE_IMAGE* m_GerberImageFile;   /* Gerber file image source of this item
                                              * Note: some params stored in this class are common
                                              * to the whole gerber file (i.e) the whole graphic
@@ -105,19 +129,13 @@ public:
                                              */
 
 private:
-    // These values are used to draw this item, according to gerber layers parameters
-    // Because they can change inside a gerber image, they are stored here
-    // for each item
-    bool        m_LayerNegative;            // true = item in negative Layer
-    bool        m_swapAxis;                 // false if A = X, B = Y; true if A =Y, B = Y
-    bool        m_mirrorA;                  // true: mirror / axe A
-    bool        m_mirrorB;                  // true: mirror / axe B
-    wxRealPoint m_drawScale;                // A and B scaling factor
-    wxPoint     m_layerOffset;              // Offset for A and B axis, from OF parameter
-    double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
-    GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
-                                            ///< (dcode). Stored in each item, because %TO is
-                                            ///< a dynamic object attribute
+    // The values used to draw this item, according to gerber layers parameters, and
+    // the net attributes. Because they can change inside a gerber image, they are
+    // stored for each item, as an index in the image attributes table
+    int         m_attributesIndex;
+
+    const GERBER_ITEM_ATTRIBUTES& attributes() const;
+    void setAttributes( const GERBER_ITEM_ATTRIBUTES& aAttributes );
 
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
@@ -127,7 +145,15 @@ public:
     GERBER_DRAW_ITEM* Back() const { return static_cast<GERBER_DRAW_ITEM*>( Pback ); }
 
     void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
-    const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
+    const GBR_NETLIST_METADATA& GetNetAttributes() const { return attributes().m_NetAttributes; }
+
+    /**
+     * Function SetAperFunction
+     * sets the aperture function of a region (set by a %TA.AperFunction, xxx,
+     * this is the xxx value). Other items use the aperture function of their DCode.
+     */
+    void SetAperFunction( const wxString& aAperFunction );
+    const wxString& GetAperFunction() const { return attributes().m_AperFunction; }
 
     /**
      * Function GetLayer
@@ -137,7 +163,7 @@ public:
 
     bool GetLayerPolarity() const
     {
-        return m_LayerNegative;
+        return attributes().m_LayerNegative;
     }
 
     /**
@@ -174,10 +200,7 @@ public:
      */
     void SetLayerParameters();
 
-    void SetLayerPolarity( bool aNegative)
-    {
-        m_LayerNegative = aNegative;
-    }
+    void SetLayerPolarity( bool aNegative );
 
     /**
      * Function MoveAB
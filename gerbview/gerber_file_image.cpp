@@ -39,7 +39,10 @@
 #include <X2_gerber_attributes.h>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <map>
+#include <thread>
 
 
 /**
@@ -90,7 +93,8 @@ void GERBER_LAYER::ResetDefaultValues()
 
 
 GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
-    EDA_ITEM( (EDA_ITEM*)NULL, GERBER_IMAGE_T )
+    EDA_ITEM( (EDA_ITEM*)NULL, GERBER_IMAGE_T ),
+    m_primitives( this )
 {
     m_GraphicLayer = aLayer;        // Graphic layer Number
     m_IsVisible    = true;          // must be drawn
@@ -98,6 +102,9 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
     m_Selected_Tool = 0;
     m_FileFunction = NULL;          // file function parameters
+    m_layerAttributesIndex = -1;
+    m_netChangeFrom = m_netChangeTo = -1;
+    m_aperChangeFrom = m_aperChangeTo = -1;
 
     ResetDefaultValues();
 
@@ -128,6 +135,481 @@ GERBER_DRAW_ITEM * GERBER_FILE_IMAGE::GetItemsList()
 }
 
 
+void GERBER_FILE_IMAGE::AddPrimitive( const GERBER_DRAW_ITEM& aItem )
+{
+    m_primitives.Append( aItem );
+    StepAndRepeatItem( aItem );
+}
+
+
+const std::vector<std::unique_ptr<GERBER_PRIMITIVES_BLOCK>>& GERBER_FILE_IMAGE::GetPrimitiveBlocks()
+{
+    if( !m_primitivesIndex )
+        BuildItemsIndex();
+
+    return m_primitiveBlocks;
+}
+
+
+GERBER_DRAW_ITEM* GERBER_FILE_IMAGE::GetPrimitiveItem( size_t aIndex )
+{
+    wxASSERT( !m_primitives.IsItemMark( aIndex ) );
+
+    std::unique_ptr<GERBER_DRAW_ITEM>& item = m_primitiveItems[aIndex];
+
+    if( !item )
+    {
+        item.reset( new GERBER_DRAW_ITEM( NULL ) );
+        m_primitives.Load( aIndex, *item );
+    }
+
+    return item.get();
+}
+
+
+void GERBER_FILE_IMAGE::VisitItems( std::function<bool( GERBER_DRAW_ITEM* )> aVisitor )
+{
+    GERBER_DRAW_ITEM* item = GetItemsList();
+    GERBER_DRAW_ITEM  primitive( NULL );
+
+    for( size_t ii = 0; ii < m_primitives.GetCount(); ++ii )
+    {
+        if( m_primitives.IsItemMark( ii ) )
+        {
+            wxASSERT( item );
+
+            if( !item )
+                continue;
+
+            if( !aVisitor( item ) )
+                return;
+
+            item = item->Next();
+        }
+        else
+        {
+            m_primitives.Load( ii, primitive );
+
+            if( !aVisitor( &primitive ) )
+                return;
+        }
+    }
+
+    // The items of drill files have no mark
+    for( ; item; item = item->Next() )
+    {
+        if( !aVisitor( item ) )
+            return;
+    }
+}
+
+
+bool GERBER_FILE_IMAGE::MoveItems( const EDA_RECT& aArea, const wxPoint& aMoveVector )
+{
+    std::vector<GERBER_DRAW_ITEM*> items;
+    std::vector<size_t>            primitives;
+    GERBER_DRAW_ITEM               primitive( NULL );
+
+    queryIndex( aArea,
+                [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                {
+                    if( aItem->HitTest( aArea ) )
+                        items.push_back( aItem );
+
+                    return true;
+                },
+                [&]( size_t aIndex ) -> bool
+                {
+                    m_primitives.Load( aIndex, primitive );
+
+                    if( primitive.HitTest( aArea ) )
+                        primitives.push_back( aIndex );
+
+                    return true;
+                } );
+
+    for( GERBER_DRAW_ITEM* item : items )
+        item->MoveAB( aMoveVector );
+
+    for( size_t index : primitives )
+    {
+        m_primitives.Load( index, primitive );
+        primitive.MoveAB( aMoveVector );
+        m_primitives.Store( index, primitive );
+
+        auto it = m_primitiveItems.find( index );
+
+        if( it != m_primitiveItems.end() )
+            m_primitives.Load( index, *it->second );
+    }
+
+    if( items.empty() && primitives.empty() )
+        return false;
+
+    InvalidateItemsIndex();
+    return true;
+}
+
+
+void GERBER_FILE_IMAGE::BuildItemsIndex()
+{
+    std::vector<GERBER_DRAW_ITEM*> items;
+
+    for( GERBER_DRAW_ITEM* item = GetItemsList(); item; item = item->Next() )
+        items.push_back( item );
+
+    const size_t primitiveCount = m_primitives.GetCount();
+    std::vector<EDA_RECT> bboxes( items.size() );
+    std::vector<EDA_RECT> primitiveBboxes( primitiveCount );
+
+    // The primitive blocks are created only when primitives were added, because they
+    // are in the view
+    const size_t primitiveBlockCount = ( primitiveCount + GERBER_PRIMITIVES_BLOCK_SIZE - 1 )
+                                       / GERBER_PRIMITIVES_BLOCK_SIZE;
+    size_t blocksEnd = 0;
+
+    if( !m_primitiveBlocks.empty() )
+        blocksEnd = m_primitiveBlocks.back()->GetFirst() + m_primitiveBlocks.back()->GetCount();
+
+    if( blocksEnd != primitiveCount )
+    {
+        m_primitiveBlocks.clear();
+
+        for( size_t ii = 0; ii < primitiveBlockCount; ++ii )
+        {
+            size_t first = ii * GERBER_PRIMITIVES_BLOCK_SIZE;
+            size_t count = std::min<size_t>( GERBER_PRIMITIVES_BLOCK_SIZE,
+                                             primitiveCount - first );
+
+            m_primitiveBlocks.emplace_back( new GERBER_PRIMITIVES_BLOCK( this, first, count ) );
+        }
+    }
+
+    // The bounding boxes of aperture macros and regular polygons are calculated from
+    // shapes cached by their D_CODE, so they cannot be calculated in parallel.
+    auto isSequential = []( int aShape ) -> bool
+    {
+        return aShape == GBR_SPOT_MACRO || aShape == GBR_SPOT_POLY;
+    };
+
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        if( isSequential( items[ii]->m_Shape ) )
+            bboxes[ii] = items[ii]->GetBoundingBox();
+    }
+
+    GERBER_DRAW_ITEM primitive( NULL );
+
+    for( size_t ii = 0; ii < primitiveCount; ++ii )
+    {
+        if( isSequential( m_primitives.GetShape( ii ) ) )
+        {
+            m_primitives.Load( ii, primitive );
+            primitiveBboxes[ii] = primitive.GetBoundingBox();
+        }
+    }
+
+    // Items are handled by blocks, to keep the threads synchronization cheap.
+    // The primitives are handled by primitive block, to set the block bounding box.
+    const size_t blockSize = 1000;
+    const size_t itemBlockCount = ( items.size() + blockSize - 1 ) / blockSize;
+    const size_t blockCount = itemBlockCount + primitiveBlockCount;
+    std::atomic<size_t> nextBlock( 0 );
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   blockCount );
+    const int dcodeLayer = GERBER_DCODE_LAYER( GERBER_DRAW_LAYER( m_GraphicLayer ) );
+
+    auto bbox_lambda = [&] () -> size_t
+    {
+        // Each thread has its own item to load the primitives
+        GERBER_DRAW_ITEM threadPrimitive( NULL );
+        size_t num = 0;
+
+        for( size_t block = nextBlock++; block < blockCount; block = nextBlock++ )
+        {
+            if( block < itemBlockCount )
+            {
+                size_t end = std::min( items.size(), ( block + 1 ) * blockSize );
+
+                for( size_t ii = block * blockSize; ii < end; ++ii )
+                {
+                    if( !isSequential( items[ii]->m_Shape ) )
+                        bboxes[ii] = items[ii]->GetBoundingBox();
+                }
+            }
+            else
+            {
+                GERBER_PRIMITIVES_BLOCK* primitiveBlock =
+                        m_primitiveBlocks[block - itemBlockCount].get();
+                size_t       end = primitiveBlock->GetFirst() + primitiveBlock->GetCount();
+                EDA_RECT     blockBbox;
+                bool         emptyBlock = true;
+                unsigned int dcodeLOD = 0;
+
+                for( size_t ii = primitiveBlock->GetFirst(); ii < end; ++ii )
+                {
+                    if( m_primitives.IsItemMark( ii ) )
+                        continue;
+
+                    m_primitives.Load( ii, threadPrimitive );
+
+                    if( !isSequential( threadPrimitive.m_Shape ) )
+                        primitiveBboxes[ii] = threadPrimitive.GetBoundingBox();
+
+                    if( emptyBlock )
+                        blockBbox = primitiveBboxes[ii];
+                    else
+                        blockBbox.Merge( primitiveBboxes[ii] );
+
+                    emptyBlock = false;
+
+                    // The D code of the smallest primitive must be shown when the one of
+                    // larger primitives is
+                    if( threadPrimitive.m_DCode > 0 )
+                    {
+                        dcodeLOD = std::max( dcodeLOD,
+                                             threadPrimitive.ViewGetLOD( dcodeLayer, nullptr ) );
+                    }
+                }
+
+                primitiveBlock->SetBoundingBox( blockBbox );
+                primitiveBlock->SetDCodeLOD( dcodeLOD );
+            }
+
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        bbox_lambda();
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, bbox_lambda );
+
+        // Finalize the bounding boxes
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    m_itemsIndex.reset( new RTree<GERBER_DRAW_ITEM*, int, 2, double>() );
+
+    for( size_t ii = 0; ii < items.size(); ++ii )
+    {
+        const EDA_RECT& bbox = bboxes[ii];
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_itemsIndex->Insert( mmin, mmax, items[ii] );
+    }
+
+    m_primitivesIndex.reset( new RTree<size_t, int, 2, double>() );
+
+    for( size_t ii = 0; ii < primitiveCount; ++ii )
+    {
+        if( m_primitives.IsItemMark( ii ) )
+            continue;
+
+        const EDA_RECT& bbox = primitiveBboxes[ii];
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_primitivesIndex->Insert( mmin, mmax, ii );
+    }
+}
+
+
+void GERBER_FILE_IMAGE::queryIndex( const EDA_RECT& aArea,
+                                    std::function<bool( GERBER_DRAW_ITEM* )> aItemVisitor,
+                                    std::function<bool( size_t )> aPrimitiveVisitor )
+{
+    if( !m_itemsIndex || !m_primitivesIndex )
+        BuildItemsIndex();
+
+    EDA_RECT area( aArea );
+    area.Normalize();
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+    bool      goOn = true;
+
+    m_itemsIndex->Search( mmin, mmax, [&]( GERBER_DRAW_ITEM* const& aItem ) -> bool
+                                      {
+                                          goOn = aItemVisitor( aItem );
+                                          return goOn;
+                                      } );
+
+    if( goOn )
+        m_primitivesIndex->Search( mmin, mmax, aPrimitiveVisitor );
+}
+
+
+void GERBER_FILE_IMAGE::QueryItems( const EDA_RECT& aArea,
+                                    std::function<bool( GERBER_DRAW_ITEM* )> aVisitor,
+                                    std::function<bool( const GERBER_DRAW_ITEM* )> aFilter )
+{
+    GERBER_DRAW_ITEM primitive( NULL );
+
+    queryIndex( aArea,
+                [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                {
+                    if( aFilter && !aFilter( aItem ) )
+                        return true;
+
+                    return aVisitor( aItem );
+                },
+                [&]( size_t aIndex ) -> bool
+                {
+                    if( aFilter )
+                    {
+                        m_primitives.Load( aIndex, primitive );
+
+                        if( !aFilter( &primitive ) )
+                            return true;
+                    }
+
+                    return aVisitor( GetPrimitiveItem( aIndex ) );
+                } );
+}
+
+
+void GERBER_FILE_IMAGE::HitTestItems( const wxPoint& aRefPos,
+                                      std::function<bool( GERBER_DRAW_ITEM* )> aVisitor )
+{
+    // GERBER_DRAW_ITEM::HitTest() uses a minimal radius of 0.01 mm for very thin items,
+    // which is not included in their bounding box
+    EDA_RECT area( aRefPos, wxSize( 0, 0 ) );
+    area.Inflate( Millimeter2iu( 0.01 ) );
+
+    QueryItems( area, aVisitor,
+                [&]( const GERBER_DRAW_ITEM* aItem ) -> bool
+                {
+                    return aItem->HitTest( aRefPos );
+                } );
+}
+
+
+int GERBER_FILE_IMAGE::AddItemAttributes( const GERBER_ITEM_ATTRIBUTES& aAttributes )
+{
+    auto it = m_itemAttributes.find( aAttributes );
+
+    if( it != m_itemAttributes.end() )
+        return it->second;
+
+    int index = (int) m_itemAttributesList.size();
+    it = m_itemAttributes.insert( std::make_pair( aAttributes, index ) ).first;
+    m_itemAttributesList.push_back( &it->first );
+
+    // New net attributes can bring new component and net names
+    const GBR_NETLIST_METADATA& netAttributes = aAttributes.m_NetAttributes;
+
+    if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
+        ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+        m_ComponentsList.insert( std::make_pair( netAttributes.m_Cmpref, 0 ) );
+
+    if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+        m_NetnamesList.insert( std::make_pair( netAttributes.m_Netname, 0 ) );
+
+    return index;
+}
+
+
+bool GERBER_FILE_IMAGE::HasLayerParameters( const GERBER_ITEM_ATTRIBUTES& aAttributes ) const
+{
+    return aAttributes.m_SwapAxis == m_SwapAxis
+        && aAttributes.m_MirrorA == m_MirrorA
+        && aAttributes.m_MirrorB == m_MirrorB
+        && aAttributes.m_DrawScale == m_Scale
+        && aAttributes.m_LayerOffset == m_Offset
+        && aAttributes.m_LyrRotation == m_LocalRotation
+        && aAttributes.m_LayerNegative == m_GBRLayerParams.m_LayerNegative;
+}
+
+
+int GERBER_FILE_IMAGE::GetLayerAttributesIndex()
+{
+    if( m_layerAttributesIndex >= 0
+            && HasLayerParameters( GetItemAttributes( m_layerAttributesIndex ) ) )
+        return m_layerAttributesIndex;
+
+    GERBER_ITEM_ATTRIBUTES attr;
+
+    attr.m_SwapAxis    = m_SwapAxis;        // false if A = X, B = Y;
+    attr.m_MirrorA     = m_MirrorA;         // true: mirror / axe A
+    attr.m_MirrorB     = m_MirrorB;         // true: mirror / axe B
+    attr.m_DrawScale   = m_Scale;           // A and B scaling factor
+    attr.m_LayerOffset = m_Offset;          // Offset from OF command
+    attr.m_LyrRotation = m_LocalRotation;   // Rotation from RO command
+    attr.m_LayerNegative = GetLayerParams().m_LayerNegative;
+
+    m_layerAttributesIndex = AddItemAttributes( attr );
+
+    return m_layerAttributesIndex;
+}
+
+
+static bool sameNetAttributes( const GBR_NETLIST_METADATA& aFirst,
+                               const GBR_NETLIST_METADATA& aSecond )
+{
+    return aFirst.m_NetAttribType == aSecond.m_NetAttribType
+        && aFirst.m_NotInNet == aSecond.m_NotInNet
+        && aFirst.m_Padname == aSecond.m_Padname
+        && aFirst.m_Cmpref == aSecond.m_Cmpref
+        && aFirst.m_Netname == aSecond.m_Netname;
+}
+
+
+int GERBER_FILE_IMAGE::ChangeNetAttributes( int aIndex, const GBR_NETLIST_METADATA& aNetAttributes )
+{
+    if( aIndex >= 0 )
+    {
+        if( sameNetAttributes( GetItemAttributes( aIndex ).m_NetAttributes, aNetAttributes ) )
+            return aIndex;
+
+        if( aIndex == m_netChangeFrom
+                && sameNetAttributes( m_netChangeAttributes, aNetAttributes ) )
+            return m_netChangeTo;
+    }
+
+    GERBER_ITEM_ATTRIBUTES attr = aIndex >= 0 ? GetItemAttributes( aIndex )
+                                              : GERBER_ITEM_ATTRIBUTES();
+    attr.m_NetAttributes = aNetAttributes;
+
+    m_netChangeFrom = aIndex;
+    m_netChangeTo = AddItemAttributes( attr );
+    m_netChangeAttributes = aNetAttributes;
+
+    return m_netChangeTo;
+}
+
+
+int GERBER_FILE_IMAGE::ChangeAperFunction( int aIndex, const wxString& aAperFunction )
+{
+    if( aIndex >= 0 )
+    {
+        if( GetItemAttributes( aIndex ).m_AperFunction == aAperFunction )
+            return aIndex;
+
+        if( aIndex == m_aperChangeFrom && m_aperChangeFunction == aAperFunction )
+            return m_aperChangeTo;
+    }
+
+    GERBER_ITEM_ATTRIBUTES attr = aIndex >= 0 ? GetItemAttributes( aIndex )
+                                              : GERBER_ITEM_ATTRIBUTES();
+    attr.m_AperFunction = aAperFunction;
+
+    m_aperChangeFrom = aIndex;
+    m_aperChangeTo = AddItemAttributes( attr );
+    m_aperChangeFunction = aAperFunction;
+
+    return m_aperChangeTo;
+}
+
+
 D_CODE* GERBER_FILE_IMAGE::GetDCODEOrCreate( int aDCODE, bool aCreateIfNoExist )
 {
     unsigned ndx = aDCODE - FIRST_DCODE;
@@ -247,16 +729,16 @@ bool GERBER_FILE_IMAGE::HasNegativeItems()
         else
         {
             m_hasNegativeItems = 0;
-            for( GERBER_DRAW_ITEM* item = GetItemsList(); item; item = item->Next() )
-            {
-                if( item->GetLayer() != m_GraphicLayer )
-                    continue;
-                if( item->HasNegativeItems() )
-                {
-                    m_hasNegativeItems = 1;
-                    break;
-                }
-            }
+            VisitItems( [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                        {
+                            if( aItem->GetLayer() == m_GraphicLayer && aItem->HasNegativeItems() )
+                            {
+                                m_hasNegativeItems = 1;
+                                return false;
+                            }
+
+                            return true;
+                        } );
         }
     }
     return m_hasNegativeItems == 1;
@@ -298,6 +780,8 @@ void GERBER_FILE_IMAGE::InitToolTable()
  * This function must be called when reading a gerber file and
  * after creating a new gerber item that must be repeated
  * (i.e when m_XRepeatCount or m_YRepeatCount are > 1)
+ * The copies of a region are added to the items list, and the copies of other
+ * items to the primitives.
  * @param aItem = the item to repeat
  */
 void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
@@ -315,14 +799,25 @@ void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
             // create duplicate only if ii or jj > 0
             if( jj == 0 && ii == 0 )
                 continue;
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
             wxPoint           move_vector;
             move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
                                    GetLayerParams().m_StepForRepeatMetric );
             move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
                                    GetLayerParams().m_StepForRepeatMetric );
-            dupItem->MoveXY( move_vector );
-            m_Drawings.Append( dupItem );
+
+            if( aItem.m_Shape == GBR_POLYGON )
+            {
+                GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
+                dupItem->MoveXY( move_vector );
+                m_Drawings.Append( dupItem );
+                m_primitives.AppendItemMark();
+            }
+            else
+            {
+                GERBER_DRAW_ITEM dupItem( aItem );
+                dupItem.MoveXY( move_vector );
+                m_primitives.Append( dupItem );
+            }
         }
     }
 }
@@ -417,6 +912,15 @@ SEARCH_RESULT GERBER_FILE_IMAGE::Visit( INSPECTOR inspector, void* testData, con
 
         case GERBER_DRAW_ITEM_T:
             result = IterateForward( &m_Drawings[0], inspector, testData, p );
+
+            // The inspector can keep the primitives, so they are given as their
+            // items owned by the image
+            for( size_t ii = 0; ii < m_primitives.GetCount() && result != SEARCH_QUIT; ++ii )
+            {
+                if( !m_primitives.IsItemMark( ii ) )
+                    result = GetPrimitiveItem( ii )->Visit( inspector, testData, p );
+            }
+
             ++p;
             break;
 
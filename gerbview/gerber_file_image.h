@@ -25,11 +25,16 @@
 #ifndef GERBER_FILE_IMAGE_H
 #define GERBER_FILE_IMAGE_H
 
+#include <functional>
+#include <map>
+#include <memory>
 #include <vector>
 #include <set>
 
+#include <geometry/rtree.h>
 #include <dcode.h>
 #include <gerber_draw_item.h>
+#include <gerber_primitives.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
 
@@ -39,6 +44,7 @@
 
 class GERBVIEW_FRAME;
 class D_CODE;
+class LINE_READER;
 
 /* gerber files have different parameters to define units and how items must be plotted.
  *  some are for the entire file, and other can change along a file.
@@ -113,6 +119,9 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
 
 public:
     DLIST<GERBER_DRAW_ITEM> m_Drawings;                         // linked list of Gerber Items to draw
+                                                                // (the regions, and all the items
+                                                                // of drill files): flashes, lines
+                                                                // and arcs are in m_primitives
 
     bool               m_InUse;                                 // true if this image is currently in use
                                                                 // (a file is loaded in it)
@@ -179,6 +188,23 @@ public:
     std::map<wxString, int> m_NetnamesList;                     // list of net names
 
 private:
+    std::map<GERBER_ITEM_ATTRIBUTES, int> m_itemAttributes;     // attributes sets used by items,
+                                                                // and their index
+    std::vector<const GERBER_ITEM_ATTRIBUTES*> m_itemAttributesList; // the same sets, by index
+    int                m_layerAttributesIndex;                  // set given to new items, -1 if none
+    int                m_netChangeFrom;                         // last change made by
+    int                m_netChangeTo;                           // ChangeNetAttributes(), reused
+    GBR_NETLIST_METADATA m_netChangeAttributes;                 // by the next items
+    int                m_aperChangeFrom;                        // last change made by
+    int                m_aperChangeTo;                          // ChangeAperFunction(), reused
+    wxString           m_aperChangeFunction;                    // by the next items
+    GERBER_PRIMITIVES  m_primitives;                            // flashes, lines and arcs
+    std::vector<std::unique_ptr<GERBER_PRIMITIVES_BLOCK>> m_primitiveBlocks; // their view items
+    std::map<size_t, std::unique_ptr<GERBER_DRAW_ITEM>> m_primitiveItems; // items built for some
+                                                                // primitives by GetPrimitiveItem()
+    std::unique_ptr<RTree<GERBER_DRAW_ITEM*, int, 2, double>> m_itemsIndex; // items bounding boxes
+                                                                // (NULL when it must be rebuilt)
+    std::unique_ptr<RTree<size_t, int, 2, double>> m_primitivesIndex; // primitives bounding boxes
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -191,27 +217,26 @@ private:
      * test for an end of line
      * if a end of line is found:
      *   read a new line
-     * @param aBuff = buffer (size = GERBER_BUFZ) to fill with a new line
-     * @param aText = pointer to the last useful char in aBuff
+     * @param aReader = the reader of the GERBER file, or NULL when no line can be read
+     * @param aText = pointer to the last useful char in the current line
      *          on return: points the beginning of the next line.
-     * @param aBuffSize = the size in bytes of aBuff
-     * @param aFile = the opened GERBER file to read
      * @return a pointer to the beginning of the next line or NULL if end of file
     */
-    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile );
+    char* GetNextLine( LINE_READER* aReader, char* aText );
 
-    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* aGerberFile );
+    bool GetEndOfBlock( LINE_READER* aReader, char*& aText );
 
     /**
       * reads a single RS274X command terminated with a %
      */
-    bool ReadRS274XCommand( char *aBuff, unsigned int aBuffSize, char*& aText );
+    bool ReadRS274XCommand( LINE_READER* aReader, char*& aText );
 
     /**
      * executes a RS274X command
+     * @param aReader is the reader of the gerber file, or NULL for a command found
+     * in a X1 comment, which cannot continue on the next lines
      */
-    bool ExecuteRS274XCommand( int aCommand, char* aBuff,
-                               unsigned int aBuffSize, char*& aText );
+    bool ExecuteRS274XCommand( int aCommand, LINE_READER* aReader, char*& aText );
 
     /**
      * reads two bytes of data and assembles them into an int with the first
@@ -225,21 +250,25 @@ private:
 
     /**
      * reads in an aperture macro and saves it in m_aperture_macros.
-     * @param aBuff a character buffer at least GERBER_BUFZ long that can be
-     *          used to read successive lines from the gerber file.
+     * @param aReader the reader used to read successive lines from the gerber file.
      * @param text A reference to a character pointer which gives the initial
      *              text to read from.
-     * @param aBuffSize is the size of aBuff
-     * @param gerber_file Which file to read from for continuation.
      * @return bool - true if a macro was read in successfully, else false.
      */
-    bool ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
-                            char* & text, FILE * gerber_file );
+    bool ReadApertureMacro( LINE_READER* aReader, char* & text );
 
     // functions to execute G commands or D basic commands:
     bool    Execute_G_Command( char*& text, int G_command );
     bool    Execute_DCODE_Command( char*& text, int D_command );
 
+    /**
+     * calls aItemVisitor for the items of m_Drawings and aPrimitiveVisitor for the
+     * primitives whose bounding box intersects aArea, until a visitor returns false
+     */
+    void queryIndex( const EDA_RECT& aArea,
+                     std::function<bool( GERBER_DRAW_ITEM* )> aItemVisitor,
+                     std::function<bool( size_t )> aPrimitiveVisitor );
+
 public:
     GERBER_FILE_IMAGE( int layer );
     virtual ~GERBER_FILE_IMAGE();
@@ -273,10 +302,144 @@ public:
 
     /**
      * Function GetItemsList
-     * @return the first GERBER_DRAW_ITEM * item of the items list
+     * @return the first GERBER_DRAW_ITEM * item of the items list.
+     * The flashes, lines and arcs of gerber files are not in this list, but in the
+     * primitives store: use VisitItems() to see all the items.
      */
     GERBER_DRAW_ITEM * GetItemsList();
 
+    /**
+     * Function GetPrimitives
+     * @return the flashes, lines and arcs of the image
+     */
+    const GERBER_PRIMITIVES& GetPrimitives() const
+    {
+        return m_primitives;
+    }
+
+    /**
+     * Function AddPrimitive
+     * adds the flash, line or arc aItem, and its copies for the current step and repeat
+     * parameters, to the primitives of the image.
+     */
+    void AddPrimitive( const GERBER_DRAW_ITEM& aItem );
+
+    /**
+     * Function GetPrimitiveBlocks
+     * @return the view items which draw the primitives of the image
+     */
+    const std::vector<std::unique_ptr<GERBER_PRIMITIVES_BLOCK>>& GetPrimitiveBlocks();
+
+    /**
+     * Function GetPrimitiveItem
+     * @return a GERBER_DRAW_ITEM for the primitive aIndex, for the code which needs to keep
+     * an item, like the selection and the collectors. The item is built on the first call
+     * and is owned by the image.
+     */
+    GERBER_DRAW_ITEM* GetPrimitiveItem( size_t aIndex );
+
+    /**
+     * Function VisitItems
+     * calls aVisitor for the items of the items list and the primitives, in the order
+     * of the file, until aVisitor returns false.
+     * A primitive is given as a temporary item, only valid during the call: it must not
+     * be modified or kept.
+     */
+    void VisitItems( std::function<bool( GERBER_DRAW_ITEM* )> aVisitor );
+
+    /**
+     * Function MoveItems
+     * moves the items and primitives hit by aArea (see GERBER_DRAW_ITEM::HitTest()).
+     * @param aArea is the area, in A,B plotter axis
+     * @param aMoveVector is the move, in A,B plotter axis
+     * @return true if something was moved
+     */
+    bool MoveItems( const EDA_RECT& aArea, const wxPoint& aMoveVector );
+
+    /**
+     * Function AddItemAttributes
+     * adds a set of attributes to the attributes shared by the items of this image,
+     * if it is not already known.
+     * @return the index of aAttributes, to give to GetItemAttributes()
+     */
+    int AddItemAttributes( const GERBER_ITEM_ATTRIBUTES& aAttributes );
+
+    const GERBER_ITEM_ATTRIBUTES& GetItemAttributes( int aIndex ) const
+    {
+        return *m_itemAttributesList[aIndex];
+    }
+
+    /**
+     * Function GetLayerAttributesIndex
+     * @return the index of the attributes of a new item: the current layer parameters,
+     * without net attributes and aperture function.
+     * The set of the previous new item is reused while the layer parameters do not change.
+     */
+    int GetLayerAttributesIndex();
+
+    /**
+     * Function HasLayerParameters
+     * @return true if aAttributes has the current layer parameters of this image
+     */
+    bool HasLayerParameters( const GERBER_ITEM_ATTRIBUTES& aAttributes ) const;
+
+    /**
+     * Function ChangeNetAttributes
+     * @return the index of the set aIndex (-1 for the default set) with aNetAttributes as
+     * net attributes.
+     * Consecutive items usually have the same attributes, so the last change is reused
+     * without searching the known sets.
+     */
+    int ChangeNetAttributes( int aIndex, const GBR_NETLIST_METADATA& aNetAttributes );
+
+    /**
+     * Function ChangeAperFunction
+     * @return the index of the set aIndex (-1 for the default set) with aAperFunction as
+     * aperture function. The last change is reused, like in ChangeNetAttributes().
+     */
+    int ChangeAperFunction( int aIndex, const wxString& aAperFunction );
+
+    /**
+     * Function BuildItemsIndex
+     * builds the spatial index of the items and primitives bounding boxes used by
+     * QueryItems(), and sets the bounding boxes of the primitive blocks.
+     * The bounding boxes are calculated on several threads.
+     * Called after a file is loaded, and on demand by QueryItems() after a call to
+     * InvalidateItemsIndex().
+     */
+    void BuildItemsIndex();
+
+    /**
+     * Function InvalidateItemsIndex
+     * must be called after items are moved, added or removed.
+     */
+    void InvalidateItemsIndex()
+    {
+        m_itemsIndex.reset();
+        m_primitivesIndex.reset();
+    }
+
+    /**
+     * Function QueryItems
+     * calls aVisitor for each item and primitive whose bounding box intersects aArea,
+     * and which is accepted by aFilter, until aVisitor returns false.
+     * A primitive is given to aFilter as a temporary item, and to aVisitor as the item
+     * returned by GetPrimitiveItem(): using a filter avoids building items for the
+     * primitives which are not needed.
+     * @param aArea is the search area, in A,B plotter axis
+     */
+    void QueryItems( const EDA_RECT& aArea, std::function<bool( GERBER_DRAW_ITEM* )> aVisitor,
+                     std::function<bool( const GERBER_DRAW_ITEM* )> aFilter = nullptr );
+
+    /**
+     * Function HitTestItems
+     * calls aVisitor for each item hit by aRefPos (see GERBER_DRAW_ITEM::HitTest()),
+     * until aVisitor returns false
+     * @param aRefPos is the position to test, in A,B plotter axis
+     */
+    void HitTestItems( const wxPoint& aRefPos,
+                       std::function<bool( GERBER_DRAW_ITEM* )> aVisitor );
+
     /**
      * Function GetLayerParams
      * @return the current layers params
@@ -0,0 +1,85 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file gerber_line_reader.cpp
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <gerber_line_reader.h>
+
+
+GERBER_LINE_READER::GERBER_LINE_READER( FILE* aFile, const wxString& aFileName,
+                                        unsigned aMaxLineLength, size_t aChunkSize ) :
+    LINE_READER( aMaxLineLength ),
+    m_fp( aFile ),
+    m_chunk( std::max<size_t>( aChunkSize, 1 ) ),
+    m_chunkPos( 0 ),
+    m_chunkEnd( 0 )
+{
+    m_source = aFileName;
+}
+
+
+bool GERBER_LINE_READER::fillChunk()
+{
+    m_chunkPos = 0;
+    m_chunkEnd = m_fp ? fread( m_chunk.data(), 1, m_chunk.size(), m_fp ) : 0;
+
+    return m_chunkEnd > 0;
+}
+
+
+char* GERBER_LINE_READER::ReadLine()
+{
+    m_length = 0;
+
+    while( m_length < m_maxLineLength )
+    {
+        if( m_chunkPos >= m_chunkEnd && !fillChunk() )
+            break;
+
+        const char* start = m_chunk.data() + m_chunkPos;
+        size_t      count = std::min<size_t>( m_chunkEnd - m_chunkPos,
+                                              m_maxLineLength - m_length );
+        const char* eol = (const char*) memchr( start, '\n', count );
+
+        if( eol )
+            count = eol - start + 1;
+
+        if( m_length + count >= m_capacity )
+            expandCapacity( std::max<unsigned>( m_capacity * 2, m_length + count + 1 ) );
+
+        memcpy( m_line + m_length, start, count );
+        m_length += count;
+        m_chunkPos += count;
+
+        if( eol )
+            break;
+    }
+
+    m_line[ m_length ] = 0;
+
+    // Like FILE_LINE_READER, m_lineNum is incremented even if there was no line read
+    ++m_lineNum;
+
+    return m_length ? m_line : NULL;
+}
@@ -0,0 +1,76 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file gerber_line_reader.h
+ */
+
+#ifndef GERBER_LINE_READER_H
+#define GERBER_LINE_READER_H
+
+#include <vector>
+
+#include <richio.h>
+
+// size of a single line of text from a gerber file.
+// warning: some files can have *very long* lines, so the buffer must be large.
+#define GERBER_BUFZ 1000000
+
+// size of the blocks of the file read at once
+#define GERBER_READ_CHUNK_SIZE ( 1 << 20 )
+
+/**
+ * Class GERBER_LINE_READER
+ * reads the lines of a gerber file from big chunks of the file, instead of one
+ * fgets() call per line.
+ * Unlike FILE_LINE_READER, a line longer than the maximum length is not an error:
+ * like with fgets(), it is returned in several pieces, because some gerber files are
+ * written on a single line.
+ */
+class GERBER_LINE_READER : public LINE_READER
+{
+public:
+    /**
+     * Constructor GERBER_LINE_READER
+     * @param aFile is an open file, which is not closed by this reader.
+     * @param aFileName is the name of the file, for error messages.
+     * @param aMaxLineLength is the max length of the returned lines.
+     * @param aChunkSize is the size of the blocks of aFile read at once.
+     */
+    GERBER_LINE_READER( FILE* aFile, const wxString& aFileName,
+                        unsigned aMaxLineLength = GERBER_BUFZ,
+                        size_t aChunkSize = GERBER_READ_CHUNK_SIZE );
+
+    char* ReadLine() override;
+
+private:
+    /**
+     * Function fillChunk
+     * reads the next block of the file in m_chunk.
+     * @return false at the end of the file
+     */
+    bool fillChunk();
+
+    FILE*             m_fp;             ///< the file to read, not owned
+    std::vector<char> m_chunk;          ///< the last block read in the file
+    size_t            m_chunkPos;       ///< position of the next char to return in m_chunk
+    size_t            m_chunkEnd;       ///< count of chars read in m_chunk
+};
+
+#endif  // GERBER_LINE_READER_H
@@ -0,0 +1,183 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file gerber_primitives.cpp
+ */
+
+#include <algorithm>
+
+#include <fctsys.h>
+#include <view/view.h>
+
+#include <gerber_primitives.h>
+#include <gerber_file_image.h>
+
+
+GERBER_PRIMITIVES::GERBER_PRIMITIVES( GERBER_FILE_IMAGE* aImage ) :
+    m_image( aImage )
+{
+}
+
+
+void GERBER_PRIMITIVES::Append( const GERBER_DRAW_ITEM& aItem )
+{
+    wxASSERT( aItem.m_Shape != GBR_POLYGON );
+
+    uint8_t type = aItem.m_Shape & SHAPE_MASK;
+
+    if( aItem.m_UnitsMetric )
+        type |= UNITS_METRIC;
+
+    m_type.push_back( type );
+    m_dcode.push_back( aItem.m_DCode );
+    m_attributes.push_back( aItem.m_attributesIndex );
+    m_start.push_back( aItem.m_Start );
+    m_end.push_back( aItem.m_End );
+    m_size.push_back( aItem.m_Size );
+
+    if( aItem.m_Shape == GBR_ARC || aItem.m_Shape == GBR_CIRCLE )
+    {
+        m_arcs.push_back( m_type.size() - 1 );
+        m_arcCentres.push_back( aItem.m_ArcCentre );
+    }
+}
+
+
+void GERBER_PRIMITIVES::AppendItemMark()
+{
+    m_type.push_back( GBR_POLYGON );
+    m_dcode.push_back( 0 );
+    m_attributes.push_back( -1 );
+    m_start.emplace_back( 0, 0 );
+    m_end.emplace_back( 0, 0 );
+    m_size.emplace_back( 0, 0 );
+}
+
+
+int GERBER_PRIMITIVES::findArc( size_t aIndex ) const
+{
+    auto it = std::lower_bound( m_arcs.begin(), m_arcs.end(), aIndex );
+
+    if( it == m_arcs.end() || *it != aIndex )
+        return -1;
+
+    return it - m_arcs.begin();
+}
+
+
+void GERBER_PRIMITIVES::Load( size_t aIndex, GERBER_DRAW_ITEM& aItem ) const
+{
+    int shape = GetShape( aIndex );
+
+    aItem.m_GerberImageFile = m_image;
+    aItem.m_Shape = shape;
+    aItem.m_Flashed = shape >= GBR_SPOT_CIRCLE;
+    aItem.m_UnitsMetric = ( m_type[aIndex] & UNITS_METRIC ) != 0;
+    aItem.m_DCode = m_dcode[aIndex];
+    aItem.m_attributesIndex = m_attributes[aIndex];
+    aItem.m_Start = m_start[aIndex];
+    aItem.m_End = m_end[aIndex];
+    aItem.m_Size = m_size[aIndex];
+    aItem.m_ArcCentre = wxPoint( 0, 0 );
+
+    if( shape == GBR_ARC || shape == GBR_CIRCLE )
+    {
+        int arc = findArc( aIndex );
+
+        if( arc >= 0 )
+            aItem.m_ArcCentre = m_arcCentres[arc];
+    }
+
+    // The polygon of a line drawn with a rectangular aperture is built when needed
+    if( aItem.m_Polygon.OutlineCount() )
+        aItem.m_Polygon.RemoveAllContours();
+}
+
+
+void GERBER_PRIMITIVES::Store( size_t aIndex, const GERBER_DRAW_ITEM& aItem )
+{
+    wxASSERT( aItem.m_Shape == GetShape( aIndex ) );
+
+    m_start[aIndex] = aItem.m_Start;
+    m_end[aIndex] = aItem.m_End;
+
+    int arc = findArc( aIndex );
+
+    if( arc >= 0 )
+        m_arcCentres[arc] = aItem.m_ArcCentre;
+}
+
+
+void GERBER_PRIMITIVES::Clear()
+{
+    m_type.clear();
+    m_dcode.clear();
+    m_attributes.clear();
+    m_start.clear();
+    m_end.clear();
+    m_size.clear();
+    m_arcs.clear();
+    m_arcCentres.clear();
+}
+
+
+GERBER_PRIMITIVES_BLOCK::GERBER_PRIMITIVES_BLOCK( GERBER_FILE_IMAGE* aImage,
+                                                  size_t aFirst, size_t aCount ) :
+    EDA_ITEM( (EDA_ITEM*)NULL, GERBER_PRIMITIVES_BLOCK_T ),
+    m_image( aImage ),
+    m_first( aFirst ),
+    m_count( aCount ),
+    m_dcodeLOD( 0 )
+{
+}
+
+
+void GERBER_PRIMITIVES_BLOCK::RepaintAll( KIGFX::VIEW* aView )
+{
+    aView->UpdateAllItemsConditionally( KIGFX::REPAINT, []( KIGFX::VIEW_ITEM* aItem )
+    {
+        return dynamic_cast<GERBER_PRIMITIVES_BLOCK*>( aItem ) != nullptr;
+    } );
+}
+
+
+void GERBER_PRIMITIVES_BLOCK::ViewGetLayers( int aLayers[], int& aCount ) const
+{
+    aCount = 2;
+
+    aLayers[0] = GERBER_DRAW_LAYER( m_image->m_GraphicLayer );
+    aLayers[1] = GERBER_DCODE_LAYER( aLayers[0] );
+}
+
+
+const BOX2I GERBER_PRIMITIVES_BLOCK::ViewBBox() const
+{
+    return BOX2I( VECTOR2I( m_boundingBox.GetOrigin() ),
+                  VECTOR2I( m_boundingBox.GetSize() ) );
+}
+
+
+unsigned int GERBER_PRIMITIVES_BLOCK::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    if( IsDCodeLayer( aLayer ) )
+        return m_dcodeLOD;
+
+    return 0;
+}
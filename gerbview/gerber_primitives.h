@@ -0,0 +1,174 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2018 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file gerber_primitives.h
+ */
+
+#ifndef GERBER_PRIMITIVES_H
+#define GERBER_PRIMITIVES_H
+
+#include <cstdint>
+#include <vector>
+
+#include <gerber_draw_item.h>
+
+class GERBER_FILE_IMAGE;
+
+// count of primitives drawn by a GERBER_PRIMITIVES_BLOCK
+#define GERBER_PRIMITIVES_BLOCK_SIZE 1024
+
+/**
+ * Class GERBER_PRIMITIVES
+ * stores the flashes, lines and arcs of a gerber image as arrays of their shape,
+ * D code, coordinates, size and attributes set, instead of one GERBER_DRAW_ITEM per
+ * primitive. Files with millions of flashes need much less memory this way.
+ *
+ * Regions stay GERBER_DRAW_ITEMs, in GERBER_FILE_IMAGE::m_Drawings: the store only keeps
+ * a mark at their position, so all the items can still be visited in the file order.
+ *
+ * A primitive is given to the code using GERBER_DRAW_ITEMs by loading it in an item,
+ * see Load().
+ */
+class GERBER_PRIMITIVES
+{
+public:
+    GERBER_PRIMITIVES( GERBER_FILE_IMAGE* aImage );
+
+    /**
+     * Function Append
+     * adds the flash, line or arc aItem.
+     */
+    void Append( const GERBER_DRAW_ITEM& aItem );
+
+    /**
+     * Function AppendItemMark
+     * adds a mark for the next item of GERBER_FILE_IMAGE::m_Drawings.
+     */
+    void AppendItemMark();
+
+    /**
+     * Function Load
+     * sets aItem to the primitive aIndex: shape, D code, coordinates, size, units,
+     * attributes and image. The polygon of aItem is cleared.
+     */
+    void Load( size_t aIndex, GERBER_DRAW_ITEM& aItem ) const;
+
+    /**
+     * Function Store
+     * sets the coordinates of the primitive aIndex to the ones of aItem, which must have
+     * been loaded from it.
+     */
+    void Store( size_t aIndex, const GERBER_DRAW_ITEM& aItem );
+
+    void Clear();
+
+    size_t GetCount() const { return m_type.size(); }
+
+    /**
+     * Function GetShape
+     * @return the Gbr_Basic_Shapes value of the primitive aIndex, GBR_POLYGON for a mark
+     */
+    int GetShape( size_t aIndex ) const { return m_type[aIndex] & SHAPE_MASK; }
+
+    bool IsItemMark( size_t aIndex ) const { return GetShape( aIndex ) == GBR_POLYGON; }
+
+private:
+    enum TYPE_FLAGS
+    {
+        SHAPE_MASK = 0x0F,      // the Gbr_Basic_Shapes value
+        UNITS_METRIC = 0x80     // the primitive has metric units
+    };
+
+    int findArc( size_t aIndex ) const;
+
+    GERBER_FILE_IMAGE*    m_image;          // the image of the primitives
+    std::vector<uint8_t>  m_type;           // shape and TYPE_FLAGS
+    std::vector<int16_t>  m_dcode;
+    std::vector<int>      m_attributes;     // index of the attributes set in m_image
+    std::vector<wxPoint>  m_start;
+    std::vector<wxPoint>  m_end;
+    std::vector<wxSize>   m_size;
+    std::vector<size_t>   m_arcs;           // index of the arcs and circles, by increasing values
+    std::vector<wxPoint>  m_arcCentres;     // and their centres
+};
+
+
+/**
+ * Class GERBER_PRIMITIVES_BLOCK
+ * is the view item of consecutive primitives of a gerber image, drawn by
+ * GERBVIEW_PAINTER. The view would need much more memory and time to handle one view
+ * item per primitive.
+ * The blocks are owned by their image, and their bounding box is set by
+ * GERBER_FILE_IMAGE::BuildItemsIndex().
+ */
+class GERBER_PRIMITIVES_BLOCK : public EDA_ITEM
+{
+public:
+    GERBER_PRIMITIVES_BLOCK( GERBER_FILE_IMAGE* aImage, size_t aFirst, size_t aCount );
+
+    GERBER_FILE_IMAGE* GetImage() const { return m_image; }
+
+    size_t GetFirst() const { return m_first; }
+    size_t GetCount() const { return m_count; }
+
+    const EDA_RECT GetBoundingBox() const override { return m_boundingBox; }
+    void SetBoundingBox( const EDA_RECT& aBoundingBox ) { m_boundingBox = aBoundingBox; }
+
+    /**
+     * Function SetDCodeLOD
+     * sets the level of detail of the D codes layer: the block has a single level for
+     * all its primitives, the one of the smallest primitive.
+     */
+    void SetDCodeLOD( unsigned int aLOD ) { m_dcodeLOD = aLOD; }
+
+    /**
+     * Function RepaintAll
+     * marks all the blocks of aView to be drawn again. Their primitives have different
+     * colors, so the color of a block cannot be changed by a KIGFX::COLOR update.
+     */
+    static void RepaintAll( KIGFX::VIEW* aView );
+
+    wxString GetClass() const override
+    {
+        return wxT( "GERBER_PRIMITIVES_BLOCK" );
+    }
+
+#if defined(DEBUG)
+    void Show( int nestLevel, std::ostream& os ) const override { ShowDummy( os ); }
+#endif
+
+    /// @copydoc VIEW_ITEM::ViewGetLayers()
+    virtual void ViewGetLayers( int aLayers[], int& aCount ) const override;
+
+    /// @copydoc VIEW_ITEM::ViewBBox()
+    virtual const BOX2I ViewBBox() const override;
+
+    /// @copydoc VIEW_ITEM::ViewGetLOD()
+    virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
+private:
+    GERBER_FILE_IMAGE* m_image;
+    size_t             m_first;         // index of the first primitive of the block
+    size_t             m_count;
+    EDA_RECT           m_boundingBox;
+    unsigned int       m_dcodeLOD;
+};
+
+#endif  // GERBER_PRIMITIVES_H
@@ -90,6 +90,7 @@ void GERBVIEW_DRAW_PANEL_GAL::SetHighContrastLayer( int aLayer )
     rSettings->SetActiveLayer( GERBER_DCODE_LAYER( aLayer ) );
 
     m_view->UpdateAllLayersColor();
+    GERBER_PRIMITIVES_BLOCK::RepaintAll( m_view );
 }
 
 
@@ -141,6 +142,9 @@ bool GERBVIEW_DRAW_PANEL_GAL::SwitchBackend( GAL_TYPE aGalType )
                 {
                     m_view->Add (item );
                 }
+
+                for( auto& block : gerber->GetPrimitiveBlocks() )
+                    m_view->Add( block.get() );
             }
         }
     }
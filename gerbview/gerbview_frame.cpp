@@ -461,6 +461,10 @@ void GERBVIEW_FRAME::SetElementVisibility( int aLayerID, bool aNewState )
 
         view->UpdateAllItemsConditionally( KIGFX::REPAINT, []( KIGFX::VIEW_ITEM* aItem )
         {
+            // Primitive blocks can have negative primitives
+            if( dynamic_cast<GERBER_PRIMITIVES_BLOCK*>( aItem ) )
+                return true;
+
             auto item = static_cast<GERBER_DRAW_ITEM*>( aItem );
 
             // GetLayerPolarity() returns true for negative items
@@ -665,6 +669,10 @@ void GERBVIEW_FRAME::UpdateDisplayOptions( const GBR_DISPLAY_OPTIONS& aOptions )
     {
         view->UpdateAllItemsConditionally( KIGFX::REPAINT, []( KIGFX::VIEW_ITEM* aItem )
         {
+            // Flashes, lines and arcs are drawn by the primitive blocks
+            if( dynamic_cast<GERBER_PRIMITIVES_BLOCK*>( aItem ) )
+                return true;
+
             auto item = static_cast<GERBER_DRAW_ITEM*>( aItem );
 
             switch( item->m_Shape )
@@ -685,6 +693,10 @@ void GERBVIEW_FRAME::UpdateDisplayOptions( const GBR_DISPLAY_OPTIONS& aOptions )
     {
         view->UpdateAllItemsConditionally( KIGFX::REPAINT, []( KIGFX::VIEW_ITEM* aItem )
         {
+            // Flashes, lines and arcs are drawn by the primitive blocks
+            if( dynamic_cast<GERBER_PRIMITIVES_BLOCK*>( aItem ) )
+                return true;
+
             auto item = static_cast<GERBER_DRAW_ITEM*>( aItem );
 
             switch( item->m_Shape )
@@ -703,6 +715,10 @@ void GERBVIEW_FRAME::UpdateDisplayOptions( const GBR_DISPLAY_OPTIONS& aOptions )
     {
         view->UpdateAllItemsConditionally( KIGFX::REPAINT, []( KIGFX::VIEW_ITEM* aItem )
         {
+            // Regions are never drawn by the primitive blocks
+            if( dynamic_cast<GERBER_PRIMITIVES_BLOCK*>( aItem ) )
+                return false;
+
             auto item = static_cast<GERBER_DRAW_ITEM*>( aItem );
 
             return ( item->m_Shape == GBR_POLYGON );
@@ -710,6 +726,7 @@ void GERBVIEW_FRAME::UpdateDisplayOptions( const GBR_DISPLAY_OPTIONS& aOptions )
     }
 
     view->UpdateAllItems( KIGFX::COLOR );
+    GERBER_PRIMITIVES_BLOCK::RepaintAll( view );
 
     m_canvas->Refresh( true );
 }
@@ -34,6 +34,7 @@
 #include <gerbview.h>
 #include <gerbview_frame.h>
 #include <gerber_file_image_list.h>
+#include <gerber_primitives.h>
 #include <layer_widget.h>
 #include <gerbview_layer_widget.h>
 
@@ -272,6 +273,7 @@ void GERBER_LAYER_WIDGET::OnLayerColorChange( int aLayer, COLOR4D aColor )
         KIGFX::VIEW* view = myframe->GetGalCanvas()->GetView();
         view->GetPainter()->GetSettings()->ImportLegacyColors( myframe->m_colorsSettings );
         view->UpdateLayerColor( GERBER_DRAW_LAYER( aLayer ) );
+        GERBER_PRIMITIVES_BLOCK::RepaintAll( view );
     }
 
     myframe->GetCanvas()->Refresh();
@@ -324,6 +326,7 @@ void GERBER_LAYER_WIDGET::OnRenderColorChange( int aId, COLOR4D aColor )
 
         view->MarkTargetDirty( KIGFX::TARGET_NONCACHED );
         view->UpdateAllItems( KIGFX::COLOR );
+        GERBER_PRIMITIVES_BLOCK::RepaintAll( view );
     }
 
     if( galCanvas && myframe->IsGalCanvasActive() )
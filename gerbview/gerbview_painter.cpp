@@ -175,6 +175,10 @@ bool GERBVIEW_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
         draw( static_cast<GERBER_DRAW_ITEM*>( const_cast<EDA_ITEM*>( item ) ), aLayer );
         break;
 
+    case GERBER_PRIMITIVES_BLOCK_T:
+        draw( static_cast<const GERBER_PRIMITIVES_BLOCK*>( item ), aLayer );
+        break;
+
     default:
         // Painter does not know how to draw the object
         return false;
@@ -184,6 +188,25 @@ bool GERBVIEW_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void GERBVIEW_PAINTER::draw( const GERBER_PRIMITIVES_BLOCK* aBlock, int aLayer )
+{
+    const GERBER_PRIMITIVES& primitives = aBlock->GetImage()->GetPrimitives();
+    const size_t             end = aBlock->GetFirst() + aBlock->GetCount();
+
+    // Each primitive is drawn like the item it would be
+    GERBER_DRAW_ITEM item( NULL );
+
+    for( size_t ii = aBlock->GetFirst(); ii < end; ++ii )
+    {
+        if( primitives.IsItemMark( ii ) )
+            continue;
+
+        primitives.Load( ii, item );
+        draw( &item, aLayer );
+    }
+}
+
+
 // TODO(JE) aItem can't be const because of GetDcodeDescr()
 // Probably that can be refactored in GERBER_DRAW_ITEM to allow const here.
 void GERBVIEW_PAINTER::draw( /*const*/ GERBER_DRAW_ITEM* aItem, int aLayer )
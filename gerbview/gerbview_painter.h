@@ -34,6 +34,7 @@ class COLORS_DESIGN_SETTINGS;
 
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
+class GERBER_PRIMITIVES_BLOCK;
 
 
 namespace KIGFX
@@ -190,6 +191,7 @@ protected:
 
     // Drawing functions
     void draw( /*const*/ GERBER_DRAW_ITEM* aVia, int aLayer );
+    void draw( const GERBER_PRIMITIVES_BLOCK* aBlock, int aLayer );
 
     /// Helper routine to draw a polygon
     void drawPolygon( GERBER_DRAW_ITEM* aParent, SHAPE_POLY_SET& aPolygon, bool aFilled );
@@ -53,19 +53,16 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
 
     GERBER_DRAW_ITEM* gerb_item = nullptr;
 
+    auto firstHit = [&gerb_item]( GERBER_DRAW_ITEM* aItem ) -> bool
+    {
+        gerb_item = aItem;
+        return false;
+    };
+
     // Search first on active layer
     // A not used graphic layer can be selected. So gerber can be NULL
     if( gerber && gerber->m_IsVisible )
-    {
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
-        {
-            if( item->HitTest( ref ) )
-            {
-                gerb_item = item;
-                break;
-            }
-        }
-    }
+        gerber->HitTestItems( ref, firstHit );
 
     if( gerb_item == nullptr ) // Search on all layers
     {
@@ -82,14 +79,7 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
             if( layer == GetActiveLayer() )
                 continue;
 
-            for( auto item = gerber->GetItemsList(); item; item = item->Next() )
-            {
-                if( item->HitTest( ref ) )
-                {
-                    gerb_item = item;
-                    break;
-                }
-            }
+            gerber->HitTestItems( ref, firstHit );
 
             if( gerb_item )
                 break;
@@ -30,6 +30,7 @@
 #include <gerbview_frame.h>
 #include <gerber_file_image.h>
 #include <gerber_file_image_list.h>
+#include <gerber_line_reader.h>
 #include <view/view.h>
 
 #include <html_messagebox.h>
@@ -103,6 +104,9 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         {
             view->Add( (KIGFX::VIEW_ITEM*) item );
         }
+
+        for( auto& block : gerber->GetPrimitiveBlocks() )
+            view->Add( block.get() );
     }
 
     return true;
@@ -110,12 +114,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 
 
 
-// size of a single line of text from a gerber file.
-// warning: some files can have *very long* lines, so the buffer must be large.
-#define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
-
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
     int      G_command = 0;        // command number for G commands like G04
@@ -137,13 +135,16 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     wxString msg;
 
+    // The file is read by big chunks, which is much faster than reading it line by line
+    GERBER_LINE_READER reader( m_Current_File, aFullFileName );
+
     while( true )
     {
-        if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
+        if( reader.ReadLine() == NULL )
             break;
 
         m_LineNum++;
-        text = StrPurge( lineBuffer );
+        text = StrPurge( reader.Line() );
 
         while( text && *text )
         {
@@ -200,7 +201,7 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
                 if( m_CommandState != ENTER_RS274X_CMD )
                 {
                     m_CommandState = ENTER_RS274X_CMD;
-                    ReadRS274XCommand( lineBuffer, GERBER_BUFZ, text );
+                    ReadRS274XCommand( &reader, text );
                 }
                 else        //Error
                 {
@@ -221,6 +222,8 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     fclose( m_Current_File );
 
+    BuildItemsIndex();
+
     m_InUse = true;
 
     return true;
@@ -495,7 +495,7 @@ bool GERBER_FILE_IMAGE::Execute_G_Command( char*& text, int G_command )
 
             char* cptr = (char*)x2buf.data();
             int code_command = ReadXCommandID( cptr );
-            ExecuteRS274XCommand( code_command, NULL, 0, cptr );
+            ExecuteRS274XCommand( code_command, NULL, cptr );
         }
 
         while( *text && (*text != '*') )
@@ -622,6 +622,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 m_Exposure = true;
                 gbritem    = new GERBER_DRAW_ITEM( this );
                 m_Drawings.Append( gbritem );
+                m_primitives.AppendItemMark();
                 gbritem->m_Shape = GBR_POLYGON;
                 gbritem->m_Flashed = false;
                 gbritem->m_DCode = 0;   // No DCode for a Polygon (Region in Gerber dialect)
@@ -630,7 +631,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 if( gbritem->m_GerberImageFile )
                 {
                     gbritem->SetNetAttributes( gbritem->m_GerberImageFile->m_NetAttributeDict );
-                    gbritem->m_AperFunction = gbritem->m_GerberImageFile->m_AperFunction;
+                    gbritem->SetAperFunction( gbritem->m_GerberImageFile->m_AperFunction );
                 }
             }
 
@@ -709,22 +710,23 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             switch( m_Iterpolation )
             {
             case GERB_INTERPOL_LINEAR_1X:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+            {
+                GERBER_DRAW_ITEM line( this );
 
-                fillLineGBRITEM( gbritem, dcode, m_PreviousPos,
+                fillLineGBRITEM( &line, dcode, m_PreviousPos,
                                  m_CurrentPos, size, GetLayerParams().m_LayerNegative );
-                StepAndRepeatItem( *gbritem );
+                AddPrimitive( line );
                 break;
+            }
 
             case GERB_INTERPOL_ARC_NEG:
             case GERB_INTERPOL_ARC_POS:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+            {
+                GERBER_DRAW_ITEM arc( this );
 
                 if( m_LastCoordIsIJPos )
                 {
-                    fillArcGBRITEM( gbritem, dcode, m_PreviousPos,
+                    fillArcGBRITEM( &arc, dcode, m_PreviousPos,
                                     m_CurrentPos, m_IJPos, size,
                                     ( m_Iterpolation == GERB_INTERPOL_ARC_NEG ) ?
                                     false : true, m_360Arc_enbl, GetLayerParams().m_LayerNegative );
@@ -732,13 +734,14 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 }
                 else
                 {
-                    fillLineGBRITEM( gbritem, dcode, m_PreviousPos,
+                    fillLineGBRITEM( &arc, dcode, m_PreviousPos,
                                      m_CurrentPos, size, GetLayerParams().m_LayerNegative );
                 }
 
-                StepAndRepeatItem( *gbritem );
+                AddPrimitive( arc );
 
                 break;
+            }
 
             default:
                 msg.Printf( wxT( "RS274D: DCODE Command: interpol error (type %X)" ),
@@ -756,6 +759,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             break;
 
         case 3:     // code D3: flash aperture
+        {
             tool = GetDCODE( m_Current_Tool );
             if( tool )
             {
@@ -764,13 +768,14 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 aperture = tool->m_Shape;
             }
 
-            gbritem = new GERBER_DRAW_ITEM( this );
-            m_Drawings.Append( gbritem );
-            fillFlashedGBRITEM( gbritem, aperture, dcode, m_CurrentPos,
+            GERBER_DRAW_ITEM flash( this );
+
+            fillFlashedGBRITEM( &flash, aperture, dcode, m_CurrentPos,
                                 size, GetLayerParams().m_LayerNegative );
-            StepAndRepeatItem( *gbritem );
+            AddPrimitive( flash );
             m_PreviousPos = m_CurrentPos;
             break;
+        }
 
         default:
             return false;
@@ -21,6 +21,7 @@
 #include <view/view.h>
 #include <gerbview_painter.h>
 #include <gerbview_frame.h>
+#include <gerber_primitives.h>
 #include <tool/tool_manager.h>
 #include <menus_helpers.h>
 #include <hotkeys.h>
@@ -159,6 +160,7 @@ int GERBVIEW_CONTROL::HighlightControl( const TOOL_EVENT& aEvent )
     }
 
     m_frame->GetGalCanvas()->GetView()->UpdateAllItems( KIGFX::COLOR );
+    GERBER_PRIMITIVES_BLOCK::RepaintAll( m_frame->GetGalCanvas()->GetView() );
     m_frame->GetGalCanvas()->Refresh();
 
     return 0;
@@ -44,6 +44,8 @@ using namespace std::placeholders;
 
 #include <gerbview_id.h>
 #include <gerbview_painter.h>
+#include <gerber_file_image.h>
+#include <gerber_file_image_list.h>
 
 #include "selection_tool.h"
 #include "gerbview_actions.h"
@@ -396,13 +398,9 @@ bool GERBVIEW_SELECTION_TOOL::selectMultiple()
             view->SetVisible( &area, false );
 
             // Mark items within the selection box as selected
-            std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> selectedItems;
+            std::vector<GERBER_DRAW_ITEM*> selectedItems;
 
-            // Filter the view items based on the selection box
             BOX2I selectionBox = area.ViewBBox();
-            view->Query( selectionBox, selectedItems );         // Get the list of selected items
-
-            std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR>::iterator it, it_end;
 
             int width = area.GetEnd().x - area.GetOrigin().x;
             int height = area.GetEnd().y - area.GetOrigin().y;
@@ -413,39 +411,45 @@ bool GERBVIEW_SELECTION_TOOL::selectMultiple()
 
             selectionRect.Normalize();
 
-            for( it = selectedItems.begin(), it_end = selectedItems.end(); it != it_end; ++it )
+            // Most items are not in the view, but drawn by primitive blocks: they are
+            // found in the images
+            GERBER_FILE_IMAGE_LIST* images = m_frame->GetImagesList();
+
+            for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
             {
-                auto item = static_cast<GERBER_DRAW_ITEM*>( it->first );
+                GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
 
-                if( !item || !selectable( item ) )
+                if( gerber == NULL )    // Graphic layer not yet used
                     continue;
 
-                /* Selection mode depends on direction of drag-selection:
-                 * Left > Right : Select objects that are fully enclosed by selection
-                 * Right > Left : Select objects that are crossed by selection
-                 */
-
-                if( width >= 0 )
-                {
-                    if( selectionBox.Contains( item->ViewBBox() ) )
-                    {
-                        if( m_subtractive )
-                            unselect( item );
-                        else
-                            select( item );
-                    }
-                }
+                gerber->QueryItems( selectionRect,
+                        [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                        {
+                            selectedItems.push_back( aItem );
+                            return true;
+                        },
+                        [&]( const GERBER_DRAW_ITEM* aItem ) -> bool
+                        {
+                            if( !selectable( aItem ) )
+                                return false;
+
+                            /* Selection mode depends on direction of drag-selection:
+                             * Left > Right : Select objects that are fully enclosed by selection
+                             * Right > Left : Select objects that are crossed by selection
+                             */
+                            if( width >= 0 )
+                                return selectionBox.Contains( aItem->ViewBBox() );
+
+                            return aItem->HitTest( selectionRect );
+                        } );
+            }
+
+            for( GERBER_DRAW_ITEM* item : selectedItems )
+            {
+                if( m_subtractive )
+                    unselect( item );
                 else
-                {
-                    if( item->HitTest( selectionRect ) )
-                    {
-                        if( m_subtractive )
-                            unselect( item );
-                        else
-                            select( item );
-                    }
-
-                }
+                    select( item );
             }
 
             if( m_selection.Size() == 1 )
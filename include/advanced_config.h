@@ -73,6 +73,12 @@ public:
      */
     bool m_enableSvgImport;
 
+    /**
+     * Keep the merged polygonal outline of each distinct text converted to polygons, in
+     * addition to the outlines of the glyphs.
+     */
+    bool m_cacheTextOutlines;
+
     /**
      * Helper to determine if legacy canvas is allowed (according to platform
      * and config)
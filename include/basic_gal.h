@@ -25,6 +25,8 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
@@ -167,4 +169,8 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/// basic_gal holds the state of the text being drawn, so its users must hold this lock
+/// when they can be called from worker threads.
+extern std::mutex basic_gal_lock;
+
 #endif      // define BASIC_GAL_H
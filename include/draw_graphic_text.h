@@ -122,6 +122,24 @@ void DrawGraphicText( EDA_RECT* aClipBox,
                       PLOTTER * aPlotter = nullptr );
 
 
+/**
+ * Function GraphicTextGlyphOffsets
+ * gives the layout of a single line text drawn by DrawGraphicText() with the same
+ * parameters, as the X offset of each of its glyphs (before rotation) relative to the
+ * same glyph drawn alone at the text position and left justified.
+ *  @param aOffsets = receives one offset per glyph of aText
+ *  @return false if the text cannot be built from separate glyphs (multiline texts or
+ *          texts with overbars)
+ */
+bool GraphicTextGlyphOffsets( const wxString& aText,
+                              const wxSize& aSize,
+                              enum EDA_TEXT_HJUSTIFY_T aH_justify,
+                              int aWidth,
+                              bool aItalic,
+                              bool aBold,
+                              std::vector<int>& aOffsets );
+
+
 /**
  * Draw graphic text with a border, so that it can be read on different
  * backgrounds. See DrawGraphicText for most of the parameters.
@@ -75,6 +75,18 @@ public:
     /// @copydoc COMPOSITOR::Present()
     virtual void Present() override;
 
+    /**
+     * Function ScrollBuffer()
+     * Shifts the contents of a buffer by a number of pixels. The uncovered areas are cleared
+     * and all the drawing done on the buffer is clipped to them until it is cleared or
+     * scrolled again.
+     *
+     * @param aBufferHandle is the buffer to be scrolled.
+     * @param aDx is the horizontal offset, in pixels.
+     * @param aDy is the vertical offset, in pixels.
+     */
+    void ScrollBuffer( unsigned int aBufferHandle, int aDx, int aDy );
+
     void SetAntialiasingMode( CAIRO_ANTIALIASING_MODE aMode ); // clears all buffers
     CAIRO_ANTIALIASING_MODE GetAntialiasingMode() const
     {
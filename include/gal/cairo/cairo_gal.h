@@ -386,6 +386,8 @@ public:
 
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
+    virtual bool ScrollTargets( std::vector<BOX2I>& aExposed ) override;
+
     /**
      * Function PostPaint
      * posts an event to m_paint_listener.  A post is used so that the actual drawing
@@ -411,6 +413,8 @@ protected:
     unsigned int            overlayBuffer;          ///< Handle to the overlay buffer
     RENDER_TARGET           currentTarget;          ///< Current rendering target
     bool                    validCompositor;        ///< Compositor initialization flag
+    bool                    validMainBuffer;        ///< Main buffer holds a complete view
+    MATRIX3x3D              mainBufferMatrix;       ///< Transformation used to draw main buffer
 
     // Variables related to wxWidgets
     wxWindow*               parentWindow;           ///< Parent window
@@ -30,8 +30,10 @@
 #include <deque>
 #include <stack>
 #include <limits>
+#include <vector>
 
 #include <math/matrix3x3.h>
+#include <math/box2.h>
 
 #include <gal/color4d.h>
 #include <gal/definitions.h>
@@ -835,6 +837,19 @@ public:
      */
     virtual void ClearTarget( RENDER_TARGET aTarget ) {};
 
+    /**
+     * @brief Reuses the contents of the cached and noncached targets after the view was panned.
+     *
+     * If the current world to screen transformation differs from the one used to draw the
+     * targets only by a whole number of pixels, the targets are shifted accordingly instead
+     * of being cleared. Subsequent drawing on them is limited to the uncovered areas.
+     *
+     * @param aExposed receives the screen areas (in pixels) that have to be redrawn.
+     * @return true if the targets were shifted, false if they have to be cleared and
+     * redrawn entirely.
+     */
+    virtual bool ScrollTargets( std::vector<BOX2I>& aExposed ) { return false; };
+
     /**
      * @brief Sets negative draw mode in the renderer
      *
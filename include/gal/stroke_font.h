@@ -113,6 +113,18 @@ public:
      */
     static double GetInterline( double aGlyphHeight, double aGlyphThickness );
 
+    /**
+     * Compute the X offset of each glyph of a single line of text drawn with the current
+     * text attributes, relative to the same glyph drawn alone and left justified.  This
+     * allows one to build a text from shapes prepared once per glyph.
+     *
+     * @param aText is the text string (one line).
+     * @param aOffsets receives one offset per glyph.
+     * @return false if the text cannot be built from separate glyphs (multiline texts or
+     * texts with overbars).
+     */
+    bool ComputeGlyphOffsets( const UTF8& aText, std::vector<double>& aOffsets ) const;
+
 
 
 private:
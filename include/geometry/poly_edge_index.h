@@ -0,0 +1,130 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_EDGE_INDEX_H
+#define __POLY_EDGE_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include <geometry/seg.h>
+#include <math/vector2d.h>
+
+class SHAPE_POLY_SET;
+
+/**
+ * Class POLY_EDGE_INDEX
+ *
+ * Spatial index over all the edges (outlines and holes) of a SHAPE_POLY_SET, used to speed
+ * up point containment, edge collision and distance queries on large polygon sets such as
+ * filled zones.
+ *
+ * The edges are binned into a uniform grid of cells (for proximity queries) and into
+ * horizontal bands (for the ray crossing test used by point containment).  The index keeps
+ * its own copy of the edges, so it stays valid when the polygon set it was built from is
+ * copied.  It must be rebuilt whenever the polygon set changes.
+ *
+ * All the queries give exactly the same results as the linear scans done by SHAPE_POLY_SET
+ * and SHAPE_LINE_CHAIN, and are safe to call concurrently.
+ */
+class POLY_EDGE_INDEX
+{
+public:
+    POLY_EDGE_INDEX( const SHAPE_POLY_SET& aPolySet );
+
+    /**
+     * Function Contains
+     * Point containment test with the same semantics as SHAPE_POLY_SET::Contains().
+     * @param aP is the point to check.
+     * @param aSubpolyIndex is the polygon to check, or -1 to check all of them.
+     * @param aIgnoreHoles controls whether the point may lie in a hole.
+     */
+    bool Contains( const VECTOR2I& aP, int aSubpolyIndex = -1, bool aIgnoreHoles = false ) const;
+
+    /**
+     * Function SquaredDistance
+     * @return the smallest squared distance between aP and the edges (including holes) of
+     * polygon aPolygon, or of all the polygons if aPolygon is -1.  Containment is not taken
+     * into account.
+     */
+    SEG::ecoord SquaredDistance( const VECTOR2I& aP, int aPolygon = -1 ) const;
+
+    /**
+     * Function SquaredDistance
+     * @return the smallest squared distance between aSeg and the edges (including holes) of
+     * polygon aPolygon, or of all the polygons if aPolygon is -1.  Containment is not taken
+     * into account.
+     */
+    SEG::ecoord SquaredDistance( const SEG& aSeg, int aPolygon = -1 ) const;
+
+    /**
+     * Function IntersectsEdge
+     * @return true if aSeg crosses any edge of the set, ignoring endpoint contacts (see
+     * SEG::Intersect()).
+     */
+    bool IntersectsEdge( const SEG& aSeg ) const;
+
+    int EdgeCount() const
+    {
+        return m_edges.size();
+    }
+
+private:
+    struct EDGE
+    {
+        SEG seg;
+        int polygon;
+        int contour;
+    };
+
+    ///> Visits the edges binned in the cells overlapping the given box (in cell coordinates).
+    template <class VISITOR>
+    bool visitCells( int aX0, int aY0, int aX1, int aY1, VISITOR aVisitor ) const;
+
+    ///> Cell column/row of a coordinate, clamped to the grid.
+    int cellX( int64_t aX ) const;
+    int cellY( int64_t aY ) const;
+
+    ///> Returns true if aP lies on an edge (see SHAPE_LINE_CHAIN::PointOnEdge()) of the given contour.
+    bool pointOnEdge( const VECTOR2I& aP, int aPolygon, int aContour ) const;
+
+    ///> Nearest edge search around aP; returns the smallest squared distance found.
+    SEG::ecoord nearestEdge( const VECTOR2I& aP, int aPolygon ) const;
+
+    std::vector<EDGE> m_edges;
+
+    ///> Edges taking part in the crossing test, binned by horizontal band (CSR layout).
+    std::vector<int> m_bandStart;
+    std::vector<int> m_bandEdges;
+
+    ///> Edges binned by grid cell (CSR layout).
+    std::vector<int> m_cellStart;
+    std::vector<int> m_cellEdges;
+
+    VECTOR2I m_origin;
+    int m_cellSize;
+    int m_cols;
+    int m_rows;
+};
+
+#endif
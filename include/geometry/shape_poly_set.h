@@ -29,11 +29,13 @@
 #include <vector>
 #include <cstdio>
 #include <memory>
+#include <type_traits>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 
 #include <md5_hash.h>
 
+class POLY_EDGE_INDEX;
 
 /**
  * Class SHAPE_POLY_SET
@@ -49,7 +51,7 @@
  *      outline or a hole.
  *      - Vertex (or corner): each one of the points that define a contour.
  *
- * TODO: add convex partitioning & spatial index
+ * TODO: add convex partitioning
  */
 class SHAPE_POLY_SET : public SHAPE
 {
@@ -231,7 +233,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Point( m_currentVertex );
+                return point( m_poly );
             }
 
             T& operator*()
@@ -263,7 +265,19 @@ class SHAPE_POLY_SET : public SHAPE
         private:
             friend class SHAPE_POLY_SET;
 
-            SHAPE_POLY_SET* m_poly;
+            ///> Const iterators use the const accessors, which keep the polygons shared
+            const VECTOR2I& point( const SHAPE_POLY_SET* aPoly ) const
+            {
+                return aPoly->CPolygon( m_currentPolygon )[m_currentContour].CPoint( m_currentVertex );
+            }
+
+            VECTOR2I& point( SHAPE_POLY_SET* aPoly ) const
+            {
+                return aPoly->m_polys[m_currentPolygon][m_currentContour].Point( m_currentVertex );
+            }
+
+            typename std::conditional<std::is_const<T>::value,
+                                      const SHAPE_POLY_SET*, SHAPE_POLY_SET*>::type m_poly;
             int m_currentPolygon;
             int m_currentContour;
             int m_currentVertex;
@@ -353,7 +367,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment( m_currentSegment );
             }
 
             T operator*()
@@ -429,9 +443,11 @@ class SHAPE_POLY_SET : public SHAPE
 
         /**
          * Copy constructor SHAPE_POLY_SET
-         * Performs a deep copy of \p aOther into \p this.
+         * Copies \p aOther into \p this.  The polygons are shared until one of the sets is
+         * modified (see POLYSET_STORAGE).
          * @param aOther is the SHAPE_POLY_SET object that will be copied.
-         * @param aDeepCopy if true, make new copies of the triangulated unique_ptr vector
+         * @param aDeepCopy if true, make new copies of the triangulated polygons instead of
+         *                  sharing them with \p aOther.
          */
         SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther, bool aDeepCopy = false );
 
@@ -579,6 +595,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            m_edgeIndex.reset();
             return m_polys[aIndex][0];
         }
 
@@ -601,12 +618,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            m_edgeIndex.reset();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            m_edgeIndex.reset();
             return m_polys[aIndex];
         }
 
@@ -649,6 +668,9 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            // the vertices may be modified through the iterator
+            m_edgeIndex.reset();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -706,7 +728,7 @@ class SHAPE_POLY_SET : public SHAPE
         {
             CONST_ITERATOR iter;
 
-            iter.m_poly = const_cast<SHAPE_POLY_SET*>( this );
+            iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
             iter.m_currentContour = 0;
@@ -1228,7 +1250,71 @@ class SHAPE_POLY_SET : public SHAPE
 
         typedef std::vector<POLYGON> POLYSET;
 
-        POLYSET m_polys;
+        /**
+         * Class POLYSET_STORAGE
+         *
+         * Copy-on-write container for the polygons of the set.  Copies of a set share their
+         * polygons until one of them is modified, so copying a large set (e.g. the filled
+         * areas of a zone stored in the undo list) does not duplicate its contours.
+         *
+         * The non-const accessors make the storage unique before returning, so the references
+         * they return must not be kept across a copy of the set.
+         */
+        class POLYSET_STORAGE
+        {
+        public:
+            typedef POLYSET::iterator iterator;
+            typedef POLYSET::const_iterator const_iterator;
+
+            size_t size() const { return m_data ? m_data->size() : 0; }
+            bool empty() const { return size() == 0; }
+
+            const POLYGON& operator[]( size_t aIndex ) const { return (*m_data)[aIndex]; }
+            POLYGON& operator[]( size_t aIndex ) { return mutableData()[aIndex]; }
+
+            const POLYGON& back() const { return m_data->back(); }
+            POLYGON& back() { return mutableData().back(); }
+
+            const_iterator begin() const { return constData().begin(); }
+            const_iterator end() const { return constData().end(); }
+            iterator begin() { return mutableData().begin(); }
+            iterator end() { return mutableData().end(); }
+
+            void push_back( const POLYGON& aPolygon ) { mutableData().push_back( aPolygon ); }
+            iterator erase( iterator aPosition ) { return mutableData().erase( aPosition ); }
+
+            template <class INPUT_IT>
+            void insert( iterator aPosition, INPUT_IT aFirst, INPUT_IT aLast )
+            {
+                mutableData().insert( aPosition, aFirst, aLast );
+            }
+
+            void clear() { m_data.reset(); }
+
+            ///> Returns the number of sets sharing the polygons (0 if there are none)
+            long ShareCount() const { return m_data.use_count(); }
+
+        private:
+            const POLYSET& constData() const
+            {
+                static const POLYSET empty;
+                return m_data ? *m_data : empty;
+            }
+
+            POLYSET& mutableData()
+            {
+                if( !m_data )
+                    m_data = std::make_shared<POLYSET>();
+                else if( m_data.use_count() > 1 )
+                    m_data = std::make_shared<POLYSET>( *m_data );
+
+                return *m_data;
+            }
+
+            std::shared_ptr<POLYSET> m_data;
+        };
+
+        POLYSET_STORAGE m_polys;
 
     public:
 
@@ -1237,16 +1323,41 @@ class SHAPE_POLY_SET : public SHAPE
         void CacheTriangulation();
         bool IsTriangulationUpToDate() const;
 
+        /**
+         * Function CacheEdgeIndex
+         * builds a spatial index of the edges, used by Contains(), Collide(), Distance() and
+         * DistanceToPolygon() to avoid scanning every edge of the set.
+         *
+         * The index is dropped by every modification made through the SHAPE_POLY_SET API
+         * (including the non-const accessors and iterators).  Contours modified through
+         * references obtained before calling CacheEdgeIndex() must be followed by another call.
+         */
+        void CacheEdgeIndex();
+        bool IsEdgeIndexUpToDate() const;
+
         MD5_HASH GetHash() const;
 
+        /**
+         * Function GetMemoryUsage
+         * @return an estimate of the memory used by the polygons and the triangulation of the
+         * set, in bytes.  The storage shared with copies of the set is divided between them,
+         * so the sum over all the copies is the memory they actually use together.
+         */
+        size_t GetMemoryUsage() const;
+
     private:
 
         MD5_HASH checksum() const;
 
-        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
+        ///> Triangulation, shared between copies of the set as it is never modified once built
+        std::vector<std::shared_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
+        ///> Edge index, shared between copies of the set as it is never modified once built
+        std::shared_ptr<const POLY_EDGE_INDEX> m_edgeIndex;
+        MD5_HASH m_edgeIndexHash;
+
 };
 
 #endif
@@ -79,6 +79,9 @@ protected:
 
     PCB_GENERAL_SETTINGS m_configSettings;
 
+    int                  m_UndoMemoryMax;   ///< undo/redo lists memory budget in MB, to be
+                                            ///< handed to screens (0 = no limit)
+
     void updateZoomSelectBox();
     virtual void unitsChangeRefresh() override;
 
@@ -30,6 +30,8 @@
 #define PCB_SCREEN_H
 
 
+#include <deque>
+
 #include <base_screen.h>
 #include <class_board_item.h>
 
@@ -37,6 +39,10 @@
 class UNDO_REDO_CONTAINER;
 
 
+/// Default memory budget of the undo and redo lists, in MB
+#define DEFAULT_MAX_UNDO_MEMORY_MB 1024
+
+
 /* Handle info to display a board */
 class PCB_SCREEN : public BASE_SCREEN
 {
@@ -84,8 +90,36 @@ public:
     /* full undo redo management : */
 
     // use BASE_SCREEN::ClearUndoRedoList()
-    // use BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aItem )
-    // use BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aItem )
+
+    /**
+     * Function PushCommandToUndoList
+     * adds a command to the undo list, and deletes the oldest commands when either the max
+     * count of undo commands or the memory budget of the list is reached.
+     */
+    void PushCommandToUndoList( PICKED_ITEMS_LIST* aItem ) override;
+
+    /**
+     * Function PushCommandToRedoList
+     * adds a command to the redo list, and deletes the oldest commands when either the max
+     * count of redo commands or the memory budget of the list is reached.
+     */
+    void PushCommandToRedoList( PICKED_ITEMS_LIST* aItem ) override;
+
+    ///> Pop the last command of the undo or redo list, see BASE_SCREEN.
+    PICKED_ITEMS_LIST* PopCommandFromUndoList() override;
+    PICKED_ITEMS_LIST* PopCommandFromRedoList() override;
+
+    /**
+     * Function SetMaxUndoMemory
+     * sets the memory budget of each of the undo and redo lists, in bytes.  The memory used
+     * by a command is an estimate of the size of the item copies it owns, made when the
+     * command is pushed; the payloads shared with the board (e.g. zone polygons) are only
+     * partly accounted for (see SHAPE_POLY_SET::GetMemoryUsage()).  The last command pushed
+     * is always kept.
+     * @param aBytes is the budget, or 0 for no limit.
+     */
+    void SetMaxUndoMemory( size_t aBytes ) { m_undoMemoryMax = aBytes; }
+    size_t GetMaxUndoMemory() const { return m_undoMemoryMax; }
 
     /**
      * Function ClearUndoORRedoList
@@ -100,6 +134,31 @@ public:
      * So this function can be called to remove old commands
      */
     void ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount = -1 ) override;
+
+private:
+    /**
+     * Function trimUndoORRedoList
+     * deletes the oldest commands of \a aList until it fits in the memory budget.
+     */
+    void trimUndoORRedoList( UNDO_REDO_CONTAINER& aList );
+
+    /// Estimated memory used by the commands of a list, computed when they are pushed
+    struct UNDO_MEMORY
+    {
+        std::deque<size_t> m_CommandsUsage;     ///< memory used by each command, in list order
+        size_t             m_Total;             ///< sum of m_CommandsUsage
+
+        UNDO_MEMORY() : m_Total( 0 ) {}
+    };
+
+    UNDO_MEMORY& undoMemory( const UNDO_REDO_CONTAINER& aList )
+    {
+        return &aList == &m_UndoList ? m_undoMemory : m_redoMemory;
+    }
+
+    size_t m_undoMemoryMax;     ///< memory budget of the undo and redo lists (0 = no limit)
+    UNDO_MEMORY m_undoMemory;
+    UNDO_MEMORY m_redoMemory;
 };
 
 #endif  // PCB_SCREEN_H
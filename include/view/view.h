@@ -448,6 +448,20 @@ public:
         m_layers[aLayer].target = aTarget;
     }
 
+    /**
+     * Function SetLayerMinScreenSize()
+     * Sets the level of detail threshold for a particular layer. Items whose bounding box
+     * would be smaller than the given size on the screen are not drawn on that layer, so
+     * zoomed out views do not spend time on details that cannot be seen anyway.
+     * @param aLayer is the layer.
+     * @param aPixels is the minimal on-screen size of an item, in pixels (0 disables culling).
+     */
+    inline void SetLayerMinScreenSize( int aLayer, double aPixels )
+    {
+        wxCHECK( aLayer < (int) m_layers.size(), /*void*/ );
+        m_layers[aLayer].minScreenSize = aPixels;
+    }
+
     /**
      * Function SetLayerOrder()
      * Sets rendering order of a particular layer. Lower values are rendered first.
@@ -546,7 +560,8 @@ public:
 
     /**
      * Function RecacheAllItems()
-     * Rebuilds GAL display lists.
+     * Rebuilds GAL display lists. The current cache is dropped at once and all the items are
+     * redrawn into it on the next UpdateItems() call.
      */
     void RecacheAllItems();
 
@@ -597,6 +612,9 @@ public:
     {
         wxCHECK( aTarget < TARGETS_NUMBER, /* void */ );
         m_dirtyTargets[aTarget] = true;
+
+        if( aTarget != TARGET_OVERLAY )
+            m_panOnly = false;
     }
 
     /// Returns true if the layer is cached
@@ -622,6 +640,8 @@ public:
     {
         for( int i = 0; i < TARGETS_NUMBER; ++i )
             m_dirtyTargets[i] = true;
+
+        m_panOnly = false;
     }
 
     /**
@@ -721,6 +741,7 @@ protected:
         int                     id;              ///< layer ID
         RENDER_TARGET           target;          ///< where the layer should be rendered
         std::set<int>           requiredLayers;  ///< layers that have to be enabled to show the layer
+        double                  minScreenSize;   ///< items smaller than that (in pixels) are not drawn
     };
 
     // Convenience typedefs
@@ -731,7 +752,6 @@ protected:
 
     // Function objects that need to access VIEW/VIEW_ITEM private/protected members
     struct clearLayerCache;
-    struct recacheItem;
     struct drawItem;
     struct unlinkItem;
     struct updateItemsColor;
@@ -865,6 +885,12 @@ protected:
     /// Flags to mark targets as dirty, so they have to be redrawn on the next refresh event
     bool m_dirtyTargets[TARGETS_NUMBER];
 
+    /// True if the cached and noncached targets are dirty only because the view was panned
+    bool m_panOnly;
+
+    /// Screen areas uncovered by scrolling the targets, the only ones that need to be redrawn
+    std::vector<BOX2I> m_exposedAreas;
+
     /// Rendering order modifier for layers that are marked as top layers
     static const int TOP_LAYER_MODIFIER;
 
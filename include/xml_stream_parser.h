@@ -0,0 +1,165 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef XML_STREAM_PARSER_H_
+#define XML_STREAM_PARSER_H_
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+#include <wx/xml/xml.h>
+
+
+/**
+ * Class XML_STREAM_PARSER
+ * reads an XML file sequentially and reports its elements as they are found, without
+ * building the document tree.
+ *
+ * Each element start is passed to a start handler, together with its path (the names of
+ * the element and its ancestors joined by dots, e.g. "eagle.drawing.board.signals.signal").
+ * The start handler can ask for the element to be captured: the element and all its
+ * children are then collected into a wxXmlNode tree, given to the element handler once the
+ * end tag is read and freed right after.  Elements inside a captured element are not
+ * passed to the start handler.
+ *
+ * The memory in use is therefore bounded by the largest captured element instead of by
+ * the document size.  Captured trees follow the wxXmlDocument conventions: whitespace only
+ * text and comments are dropped, and entities are expanded.
+ *
+ * The input must be UTF-8 (the default) or use a single byte encoding declared in the XML
+ * declaration.  Malformed input throws a PARSE_ERROR with the line of the problem.
+ */
+class XML_STREAM_PARSER
+{
+public:
+    /**
+     * Start handler.  aElement holds the name and the attributes of the element, but not
+     * its children.
+     * @return true to capture the element and its children.
+     */
+    typedef std::function<bool( const wxString& aPath, const wxXmlNode& aElement )>
+            START_HANDLER;
+
+    /**
+     * Element handler, called for each captured element.  The tree is owned by the parser
+     * and deleted when the handler returns.
+     */
+    typedef std::function<void( const wxString& aPath, wxXmlNode* aElement )> ELEMENT_HANDLER;
+
+    /**
+     * @param aFileName is the file to read.
+     * @throw IO_ERROR if the file cannot be opened.
+     */
+    XML_STREAM_PARSER( const wxString& aFileName );
+
+    ~XML_STREAM_PARSER();
+
+    /**
+     * Function Parse
+     * reads the whole file, calling the handlers on the way.  The file can be parsed more
+     * than once, each call starts again from its beginning.
+     * @throw PARSE_ERROR if the file is not well formed; the exceptions thrown by the
+     *        handlers are passed through.
+     */
+    void Parse( START_HANDLER aOnStart, ELEMENT_HANDLER aOnElement );
+
+private:
+    /// A partially built captured element, and its last child so far.
+    struct CAPTURED
+    {
+        wxXmlNode* node;
+        wxXmlNode* lastChild;
+    };
+
+    void readEncoding();
+    bool fillBuffer();
+
+    int peek()
+    {
+        if( m_bufPos == m_buffer.size() && !fillBuffer() )
+            return EOF;
+
+        return (unsigned char) m_buffer[m_bufPos];
+    }
+
+    int next()
+    {
+        int c = peek();
+
+        if( c != EOF )
+        {
+            m_bufPos++;
+
+            if( c == '\n' )
+                m_lineNumber++;
+        }
+
+        return c;
+    }
+
+    /// Consumes aToken if the input continues with it.
+    bool accept( const char* aToken );
+
+    /// Reads up to and including aTerminator, appending what comes before it to aText
+    /// if not null.
+    void skipPast( const char* aTerminator, std::string* aText = nullptr );
+
+    void skipSpaces();
+    void readName( std::string& aName );
+    void readReference( std::string& aText );
+    void readAttributeValue( std::string& aValue );
+    void readText();
+    void readDoctype();
+    void readStartTag();
+    void readEndTag( bool aEmptyTag );
+    void flushText();
+
+    /// Adds aNode to the innermost captured element.
+    void addCaptured( wxXmlNode* aNode );
+
+    wxString fromUTF8( const std::string& aText );
+    void error( const wxString& aProblem );
+
+    FILE*                   m_fp;
+    wxString                m_fileName;
+
+    std::string             m_buffer;       ///< Read ahead input, converted to UTF-8.
+    size_t                  m_bufPos;
+    std::vector<char>       m_rawBuffer;
+    std::vector<wxChar>     m_charMap;      ///< Byte to character map for 8 bit encodings.
+    int                     m_lineNumber;
+
+    START_HANDLER           m_onStart;
+    ELEMENT_HANDLER         m_onElement;
+
+    wxString                m_path;
+    std::vector<size_t>     m_pathLength;   ///< Length of m_path before each open element.
+    std::vector<std::string> m_openNames;
+    std::vector<CAPTURED>   m_captured;
+    std::string             m_text;         ///< Pending character data.
+};
+
+#endif  // XML_STREAM_PARSER_H_
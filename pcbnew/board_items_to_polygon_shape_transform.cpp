@@ -30,6 +30,8 @@
 /* Function to convert pad and track shapes to polygons
  * Used to fill zones areas and in 3D viewer
  */
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <fctsys.h>
@@ -49,17 +51,17 @@
 #include <class_edge_mod.h>
 #include <convert_basic_shapes_to_polygon.h>
 #include <geometry/geometry_utils.h>
+#include <advanced_config.h>
 
 // A helper struct for the callback function
 // These variables are parameters used in addTextSegmToPoly.
 // But addTextSegmToPoly is a call-back function,
-// so we cannot send them as arguments.
+// so they are sent through its aData argument.
 struct TSEGM_2_POLY_PRMS {
     int m_textWidth;
     int m_textCircle2SegmentCount;
     SHAPE_POLY_SET* m_cornerBuffer;
 };
-TSEGM_2_POLY_PRMS prms;
 
 // The max error is the distance between the middle of a segment, and the circle
 // for circle/arc to segment approximation.
@@ -67,6 +69,155 @@ TSEGM_2_POLY_PRMS prms;
 // 0.05 to 0.01 mm is a reasonable value
 double s_error_max = Millimeter2iu( 0.02 );
 
+
+/**
+ * Class PAD_SHAPE_CACHE
+ * keeps the polygonal outlines of pads and vias, relative to their shape position.
+ *
+ * A board uses few distinct combinations of pad shape, size, orientation and clearance,
+ * so each outline is built once and then only moved to the position of the pads sharing
+ * it.  The cache is shared by the zone filler, the plotter, the 3D viewer and the DRC,
+ * which can run in several threads.  Custom shapes are not cached.
+ */
+class PAD_SHAPE_CACHE
+{
+public:
+    enum OUTLINE_KIND
+    {
+        PAD_CLEARANCE_OUTLINE,      ///< D_PAD::TransformShapeWithClearanceToPolygon()
+        PAD_INFLATED_OUTLINE,       ///< D_PAD::BuildPadShapePolygon()
+        PAD_THERMAL_RELIEF,         ///< CreateThermalReliefPadPolygon()
+        VIA_CLEARANCE_OUTLINE       ///< TRACK::TransformShapeWithClearanceToPolygon()
+    };
+
+    struct KEY
+    {
+        KEY( OUTLINE_KIND aKind, int aSegments, double aCorrection ) :
+            m_kind( aKind ), m_shape( 0 ), m_radius( 0 ), m_orient( 0.0 ),
+            m_segments( aSegments ), m_correction( aCorrection ), m_rotation( 0.0 )
+        {
+            m_params[0] = m_params[1] = m_params[2] = 0;
+        }
+
+        KEY( OUTLINE_KIND aKind, const D_PAD& aPad, int aSegments, double aCorrection ) :
+            KEY( aKind, aSegments, aCorrection )
+        {
+            m_shape  = aPad.GetShape();
+            m_size   = aPad.GetSize();
+            m_delta  = aPad.GetDelta();
+            m_orient = aPad.GetOrientation();
+
+            if( m_shape == PAD_SHAPE_ROUNDRECT )
+                m_radius = aPad.GetRoundRectCornerRadius();
+        }
+
+        bool operator==( const KEY& aOther ) const
+        {
+            return m_kind == aOther.m_kind && m_shape == aOther.m_shape
+                   && m_size == aOther.m_size && m_delta == aOther.m_delta
+                   && m_radius == aOther.m_radius && m_orient == aOther.m_orient
+                   && m_params[0] == aOther.m_params[0] && m_params[1] == aOther.m_params[1]
+                   && m_params[2] == aOther.m_params[2] && m_segments == aOther.m_segments
+                   && m_correction == aOther.m_correction && m_rotation == aOther.m_rotation;
+        }
+
+        int    m_kind;
+        int    m_shape;
+        wxSize m_size;
+        wxSize m_delta;
+        int    m_radius;
+        double m_orient;
+        int    m_params[3];         ///< clearance, inflate or thermal values
+        int    m_segments;
+        double m_correction;
+        double m_rotation;
+    };
+
+    static PAD_SHAPE_CACHE& Instance()
+    {
+        static PAD_SHAPE_CACHE cache;
+        return cache;
+    }
+
+    /**
+     * Function Append
+     * appends to aBuffer the outline of aKey moved to aPosition.
+     * @return false if the outline is not in the cache.
+     */
+    bool Append( const KEY& aKey, const wxPoint& aPosition, SHAPE_POLY_SET& aBuffer )
+    {
+        SHAPE_POLY_SET outline;
+
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+            auto it = m_outlines.find( aKey );
+
+            if( it == m_outlines.end() )
+                return false;
+
+            outline = it->second;
+        }
+
+        outline.Move( aPosition );
+        aBuffer.Append( outline );
+        return true;
+    }
+
+    /**
+     * Function Store
+     * adds aOutline, built for a shape at aPosition, to the cache.
+     */
+    void Store( const KEY& aKey, const wxPoint& aPosition, const SHAPE_POLY_SET& aOutline )
+    {
+        SHAPE_POLY_SET outline( aOutline );
+        outline.Move( -aPosition );
+
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        // Boards needing more outlines than that are not worth the memory
+        if( m_outlines.size() >= MAX_OUTLINES )
+            m_outlines.clear();
+
+        m_outlines.emplace( aKey, outline );
+    }
+
+private:
+    struct KEY_HASH
+    {
+        size_t operator()( const KEY& aKey ) const
+        {
+            size_t seed = 0;
+
+            auto combine = [&seed]( size_t aValue )
+            {
+                seed ^= aValue + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+            };
+
+            combine( std::hash<int>()( aKey.m_kind ) );
+            combine( std::hash<int>()( aKey.m_shape ) );
+            combine( std::hash<int>()( aKey.m_size.x ) );
+            combine( std::hash<int>()( aKey.m_size.y ) );
+            combine( std::hash<int>()( aKey.m_delta.x ) );
+            combine( std::hash<int>()( aKey.m_delta.y ) );
+            combine( std::hash<int>()( aKey.m_radius ) );
+            combine( std::hash<double>()( aKey.m_orient ) );
+            combine( std::hash<int>()( aKey.m_params[0] ) );
+            combine( std::hash<int>()( aKey.m_params[1] ) );
+            combine( std::hash<int>()( aKey.m_params[2] ) );
+            combine( std::hash<int>()( aKey.m_segments ) );
+            combine( std::hash<double>()( aKey.m_correction ) );
+            combine( std::hash<double>()( aKey.m_rotation ) );
+
+            return seed;
+        }
+    };
+
+    static const size_t MAX_OUTLINES = 20000;
+
+    std::mutex m_lock;
+    std::unordered_map<KEY, SHAPE_POLY_SET, KEY_HASH> m_outlines;
+};
+
 // This is a call back function, used by DrawGraphicText to draw the 3D text shape:
 static void addTextSegmToPoly( int x0, int y0, int xf, int yf, void* aData )
 {
@@ -77,6 +228,219 @@ static void addTextSegmToPoly( int x0, int y0, int xf, int yf, void* aData )
 }
 
 
+/**
+ * Class TEXT_SHAPE_CACHE
+ * keeps the polygonal outlines of the stroke font glyphs, as built by DrawGraphicText()
+ * for a given size, pen width, style and polygon width, relative to the text position.
+ *
+ * The outline of a text is assembled from the outlines of its glyphs, moved to their place
+ * in the line, then rotated and moved to the text position.  When enabled in the advanced
+ * config, the merged outline of each distinct text is also kept.
+ */
+class TEXT_SHAPE_CACHE
+{
+public:
+    struct KEY
+    {
+        bool operator==( const KEY& aOther ) const
+        {
+            return m_text == aOther.m_text && m_size == aOther.m_size
+                   && m_hJustify == aOther.m_hJustify && m_vJustify == aOther.m_vJustify
+                   && m_penWidth == aOther.m_penWidth && m_italic == aOther.m_italic
+                   && m_bold == aOther.m_bold && m_width == aOther.m_width
+                   && m_segments == aOther.m_segments;
+        }
+
+        wxString            m_text;
+        wxSize              m_size;         ///< size.x < 0 for mirrored texts
+        EDA_TEXT_HJUSTIFY_T m_hJustify;
+        EDA_TEXT_VJUSTIFY_T m_vJustify;
+        int                 m_penWidth;     ///< the DrawGraphicText() line width
+        bool                m_italic;
+        bool                m_bold;
+        int                 m_width;        ///< the width of the segments converted to polygons
+        int                 m_segments;
+    };
+
+    static TEXT_SHAPE_CACHE& Instance()
+    {
+        static TEXT_SHAPE_CACHE cache;
+        return cache;
+    }
+
+    /**
+     * Function Append
+     * appends to aBuffer the outline of the text aKey drawn at aPosition with the
+     * orientation aOrient (in 0.1 degrees).
+     */
+    void Append( const KEY& aKey, const wxPoint& aPosition, double aOrient,
+                 SHAPE_POLY_SET& aBuffer )
+    {
+        bool           keepTexts = ADVANCED_CFG::GetCfg().m_cacheTextOutlines;
+        SHAPE_POLY_SET outline;
+
+        if( !keepTexts || !find( m_texts, aKey, outline ) )
+        {
+            if( !buildText( aKey, outline ) )
+            {
+                // Not a text that can be built from its glyphs: draw it directly
+                TSEGM_2_POLY_PRMS prms;
+                prms.m_cornerBuffer = &aBuffer;
+                prms.m_textWidth = aKey.m_width;
+                prms.m_textCircle2SegmentCount = aKey.m_segments;
+
+                DrawGraphicText( NULL, NULL, aPosition, BLACK, aKey.m_text, aOrient,
+                                 aKey.m_size, aKey.m_hJustify, aKey.m_vJustify,
+                                 aKey.m_penWidth, aKey.m_italic, aKey.m_bold,
+                                 addTextSegmToPoly, &prms );
+                return;
+            }
+
+            if( keepTexts )
+            {
+                outline.Simplify( SHAPE_POLY_SET::PM_FAST );
+                store( m_texts, aKey, outline );
+            }
+        }
+
+        // Same rotation as DrawGraphicText()
+        outline.Rotate( -aOrient * M_PI / 1800, VECTOR2I( 0, 0 ) );
+        outline.Move( aPosition );
+        aBuffer.Append( outline );
+    }
+
+private:
+    struct KEY_HASH
+    {
+        size_t operator()( const KEY& aKey ) const
+        {
+            size_t seed = std::hash<wxString>()( aKey.m_text );
+
+            auto combine = [&seed]( int aValue )
+            {
+                seed ^= std::hash<int>()( aValue ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+            };
+
+            combine( aKey.m_size.x );
+            combine( aKey.m_size.y );
+            combine( aKey.m_hJustify );
+            combine( aKey.m_vJustify );
+            combine( aKey.m_penWidth );
+            combine( aKey.m_italic );
+            combine( aKey.m_bold );
+            combine( aKey.m_width );
+            combine( aKey.m_segments );
+
+            return seed;
+        }
+    };
+
+    typedef std::unordered_map<KEY, SHAPE_POLY_SET, KEY_HASH> OUTLINE_MAP;
+
+    bool find( const OUTLINE_MAP& aMap, const KEY& aKey, SHAPE_POLY_SET& aOutline )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        auto it = aMap.find( aKey );
+
+        if( it == aMap.end() )
+            return false;
+
+        aOutline = it->second;
+        return true;
+    }
+
+    void store( OUTLINE_MAP& aMap, const KEY& aKey, const SHAPE_POLY_SET& aOutline )
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        if( aMap.size() >= MAX_OUTLINES )
+            aMap.clear();
+
+        aMap.emplace( aKey, aOutline );
+    }
+
+    /**
+     * Builds in aOutline the outline of the text aKey drawn at (0,0) with no rotation,
+     * from the outlines of its glyphs.
+     * @return false if the text cannot be built from separate glyphs.
+     */
+    bool buildText( const KEY& aKey, SHAPE_POLY_SET& aOutline )
+    {
+        std::vector<int> offsets;
+
+        if( !GraphicTextGlyphOffsets( aKey.m_text, aKey.m_size, aKey.m_hJustify,
+                                      aKey.m_penWidth, aKey.m_italic, aKey.m_bold, offsets ) )
+            return false;
+
+        UTF8   text( aKey.m_text );
+        KEY    glyphKey( aKey );
+        size_t ii = 0;
+
+        glyphKey.m_hJustify = GR_TEXT_HJUSTIFY_LEFT;
+
+        for( UTF8::uni_iter it = text.ubegin(), end = text.uend(); it < end; ++it, ++ii )
+        {
+            SHAPE_POLY_SET glyph;
+
+            glyphKey.m_text = wxString( wxUniChar( *it ) );
+
+            if( !find( m_glyphs, glyphKey, glyph ) )
+            {
+                TSEGM_2_POLY_PRMS prms;
+                prms.m_cornerBuffer = &glyph;
+                prms.m_textWidth = aKey.m_width;
+                prms.m_textCircle2SegmentCount = aKey.m_segments;
+
+                DrawGraphicText( NULL, NULL, wxPoint( 0, 0 ), BLACK, glyphKey.m_text, 0,
+                                 glyphKey.m_size, glyphKey.m_hJustify, glyphKey.m_vJustify,
+                                 glyphKey.m_penWidth, glyphKey.m_italic, glyphKey.m_bold,
+                                 addTextSegmToPoly, &prms );
+
+                store( m_glyphs, glyphKey, glyph );
+            }
+
+            glyph.Move( VECTOR2I( offsets[ii], 0 ) );
+            aOutline.Append( glyph );
+        }
+
+        return true;
+    }
+
+    static const size_t MAX_OUTLINES = 20000;
+
+    std::mutex  m_lock;
+    OUTLINE_MAP m_glyphs;
+    OUTLINE_MAP m_texts;
+};
+
+
+/**
+ * Function transformTextToPolygon
+ * converts a single text drawn by DrawGraphicText() to polygons, like the
+ * addTextSegmToPoly callback does, using the glyph outlines cache.
+ */
+static void transformTextToPolygon( SHAPE_POLY_SET& aCornerBuffer, const wxPoint& aPosition,
+                                    const wxString& aText, double aOrient, const wxSize& aSize,
+                                    EDA_TEXT_HJUSTIFY_T aH_justify,
+                                    EDA_TEXT_VJUSTIFY_T aV_justify, int aPenWidth,
+                                    bool aItalic, int aWidth, int aCircleToSegmentsCount )
+{
+    TEXT_SHAPE_CACHE::KEY key;
+
+    key.m_text     = aText;
+    key.m_size     = aSize;
+    key.m_hJustify = aH_justify;
+    key.m_vJustify = aV_justify;
+    key.m_penWidth = aPenWidth;
+    key.m_italic   = aItalic;
+    key.m_bold     = true;
+    key.m_width    = aWidth;
+    key.m_segments = aCircleToSegmentsCount;
+
+    TEXT_SHAPE_CACHE::Instance().Append( key, aPosition, aOrient, aCornerBuffer );
+}
+
+
 void BOARD::ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aOutlines )
 {
     // Number of segments to convert a circle to a polygon
@@ -266,28 +630,26 @@ void MODULE::TransformGraphicShapesWithClearanceToPolygonSet(
     if( Value().GetLayer() == aLayer && Value().IsVisible() )
         texts.push_back( &Value() );
 
-    prms.m_cornerBuffer = &aCornerBuffer;
-
     // To allow optimization of circles approximated by segments,
     // aCircleToSegmentsCountForTexts, when not 0, is used.
     // if 0 (default value) the aCircleToSegmentsCount is used
-    prms.m_textCircle2SegmentCount = aCircleToSegmentsCountForTexts ?
+    int textCircle2SegmentCount = aCircleToSegmentsCountForTexts ?
                                 aCircleToSegmentsCountForTexts : aCircleToSegmentsCount;
 
     for( unsigned ii = 0; ii < texts.size(); ii++ )
     {
         TEXTE_MODULE *textmod = texts[ii];
-        prms.m_textWidth  = textmod->GetThickness() + ( 2 * aInflateValue );
+        int textWidth = textmod->GetThickness() + ( 2 * aInflateValue );
         wxSize size = textmod->GetTextSize();
 
         if( textmod->IsMirrored() )
             size.x = -size.x;
 
-        DrawGraphicText( NULL, NULL, textmod->GetTextPos(), BLACK,
-                         textmod->GetShownText(), textmod->GetDrawRotation(), size,
-                         textmod->GetHorizJustify(), textmod->GetVertJustify(),
-                         textmod->GetThickness(), textmod->IsItalic(),
-                         true, addTextSegmToPoly, &prms );
+        transformTextToPolygon( aCornerBuffer, textmod->GetTextPos(),
+                                textmod->GetShownText(), textmod->GetDrawRotation(), size,
+                                textmod->GetHorizJustify(), textmod->GetVertJustify(),
+                                textmod->GetThickness(), textmod->IsItalic(),
+                                textWidth, textCircle2SegmentCount );
     }
 
 }
@@ -335,28 +697,26 @@ void MODULE::TransformGraphicTextWithClearanceToPolygonSet(
     if( Value().GetLayer() == aLayer && Value().IsVisible() )
         texts.push_back( &Value() );
 
-    prms.m_cornerBuffer = &aCornerBuffer;
-
     // To allow optimization of circles approximated by segments,
     // aCircleToSegmentsCountForTexts, when not 0, is used.
     // if 0 (default value) the aCircleToSegmentsCount is used
-    prms.m_textCircle2SegmentCount = aCircleToSegmentsCountForTexts ?
+    int textCircle2SegmentCount = aCircleToSegmentsCountForTexts ?
                                 aCircleToSegmentsCountForTexts : aCircleToSegmentsCount;
 
     for( unsigned ii = 0; ii < texts.size(); ii++ )
     {
         TEXTE_MODULE *textmod = texts[ii];
-        prms.m_textWidth = textmod->GetThickness() + ( 2 * aInflateValue );
+        int textWidth = textmod->GetThickness() + ( 2 * aInflateValue );
         wxSize size = textmod->GetTextSize();
 
         if( textmod->IsMirrored() )
             size.x = -size.x;
 
-        DrawGraphicText( NULL, NULL, textmod->GetTextPos(), BLACK,
-                         textmod->GetShownText(), textmod->GetDrawRotation(), size,
-                         textmod->GetHorizJustify(), textmod->GetVertJustify(),
-                         textmod->GetThickness(), textmod->IsItalic(),
-                         true, addTextSegmToPoly, &prms );
+        transformTextToPolygon( aCornerBuffer, textmod->GetTextPos(),
+                                textmod->GetShownText(), textmod->GetDrawRotation(), size,
+                                textmod->GetHorizJustify(), textmod->GetVertJustify(),
+                                textmod->GetThickness(), textmod->IsItalic(),
+                                textWidth, textCircle2SegmentCount );
     }
 
 }
@@ -465,10 +825,7 @@ void TEXTE_PCB::TransformShapeWithClearanceToPolygonSet(
     if( IsMirrored() )
         size.x = -size.x;
 
-    prms.m_cornerBuffer = &aCornerBuffer;
-    prms.m_textWidth  = GetThickness() + ( 2 * aClearanceValue );
-    prms.m_textCircle2SegmentCount = aCircleToSegmentsCount;
-    COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by DrawGraphicText
+    int textWidth = GetThickness() + ( 2 * aClearanceValue );
 
     if( IsMultilineAllowed() )
     {
@@ -481,20 +838,18 @@ void TEXTE_PCB::TransformShapeWithClearanceToPolygonSet(
         for( unsigned ii = 0; ii < strings_list.Count(); ii++ )
         {
             wxString txt = strings_list.Item( ii );
-            DrawGraphicText( NULL, NULL, positions[ii], color,
-                             txt, GetTextAngle(), size,
-                             GetHorizJustify(), GetVertJustify(),
-                             GetThickness(), IsItalic(),
-                             true, addTextSegmToPoly, &prms );
+            transformTextToPolygon( aCornerBuffer, positions[ii], txt, GetTextAngle(), size,
+                                    GetHorizJustify(), GetVertJustify(),
+                                    GetThickness(), IsItalic(),
+                                    textWidth, aCircleToSegmentsCount );
         }
     }
     else
     {
-        DrawGraphicText( NULL, NULL, GetTextPos(), color,
-                         GetShownText(), GetTextAngle(), size,
-                         GetHorizJustify(), GetVertJustify(),
-                         GetThickness(), IsItalic(),
-                         true, addTextSegmToPoly, &prms );
+        transformTextToPolygon( aCornerBuffer, GetTextPos(), GetShownText(), GetTextAngle(),
+                                size, GetHorizJustify(), GetVertJustify(),
+                                GetThickness(), IsItalic(),
+                                textWidth, aCircleToSegmentsCount );
     }
 }
 
@@ -669,9 +1024,21 @@ void TRACK::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
     {
     case PCB_VIA_T:
     {
+        PAD_SHAPE_CACHE::KEY key( PAD_SHAPE_CACHE::VIA_CLEARANCE_OUTLINE,
+                                  aCircleToSegmentsCount, aCorrectionFactor );
+        key.m_size.x = m_Width;
+        key.m_params[0] = aClearanceValue;
+
+        if( PAD_SHAPE_CACHE::Instance().Append( key, m_Start, aCornerBuffer ) )
+            break;
+
+        SHAPE_POLY_SET outline;
         int radius = (m_Width / 2) + aClearanceValue;
         radius = KiROUND( radius * aCorrectionFactor );
-        TransformCircleToPolygon( aCornerBuffer, m_Start, radius, aCircleToSegmentsCount );
+        TransformCircleToPolygon( outline, m_Start, radius, aCircleToSegmentsCount );
+
+        PAD_SHAPE_CACHE::Instance().Store( key, m_Start, outline );
+        aCornerBuffer.Append( outline );
     }
         break;
 
@@ -713,11 +1080,24 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
     wxPoint padShapePos = ShapePos();               /* Note: for pad having a shape offset,
                                                      * the pad position is NOT the shape position */
 
+    // The outline is the same for all the pads having the same shape parameters, up to
+    // a translation: use the cached one if any.
+    bool cacheable = GetShape() != PAD_SHAPE_CUSTOM;
+    PAD_SHAPE_CACHE::KEY key( PAD_SHAPE_CACHE::PAD_CLEARANCE_OUTLINE, *this,
+                              aCircleToSegmentsCount, aCorrectionFactor );
+    key.m_params[0] = aClearanceValue;
+
+    if( cacheable && PAD_SHAPE_CACHE::Instance().Append( key, padShapePos, aCornerBuffer ) )
+        return;
+
+    SHAPE_POLY_SET  cached;
+    SHAPE_POLY_SET& buffer = cacheable ? cached : aCornerBuffer;
+
     switch( GetShape() )
     {
     case PAD_SHAPE_CIRCLE:
         dx = KiROUND( dx * aCorrectionFactor );
-        TransformCircleToPolygon( aCornerBuffer, padShapePos, dx,
+        TransformCircleToPolygon( buffer, padShapePos, dx,
                                   aCircleToSegmentsCount );
         break;
 
@@ -727,7 +1107,7 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
         if( dx == dy )
         {
             dx = KiROUND( dx * aCorrectionFactor );
-            TransformCircleToPolygon( aCornerBuffer, padShapePos, dx,
+            TransformCircleToPolygon( buffer, padShapePos, dx,
                                       aCircleToSegmentsCount );
         }
         else
@@ -748,7 +1128,7 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
             RotatePoint( &shape_offset, angle );
             wxPoint start = padShapePos - shape_offset;
             wxPoint end = padShapePos + shape_offset;
-            TransformOvalClearanceToPolygon( aCornerBuffer, start, end, width,
+            TransformOvalClearanceToPolygon( buffer, start, end, width,
                                     aCircleToSegmentsCount, aCorrectionFactor );
         }
         break;
@@ -771,7 +1151,7 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
         int rounding_radius = int( aClearanceValue * aCorrectionFactor );
         outline.Inflate( rounding_radius, aCircleToSegmentsCount );
 
-        aCornerBuffer.Append( outline );
+        buffer.Append( outline );
     }
         break;
 
@@ -788,7 +1168,7 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
         TransformRoundRectToPolygon( outline, padShapePos, shapesize, angle,
                                      rounding_radius, aCircleToSegmentsCount );
 
-        aCornerBuffer.Append( outline );
+        buffer.Append( outline );
     }
         break;
 
@@ -801,10 +1181,16 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
         outline.Simplify( SHAPE_POLY_SET::PM_FAST );
         outline.Inflate( clearance, aCircleToSegmentsCount );
         outline.Fracture( SHAPE_POLY_SET::PM_FAST );
-        aCornerBuffer.Append( outline );
+        buffer.Append( outline );
     }
         break;
     }
+
+    if( cacheable )
+    {
+        PAD_SHAPE_CACHE::Instance().Store( key, padShapePos, cached );
+        aCornerBuffer.Append( cached );
+    }
 }
 
 
@@ -823,6 +1209,28 @@ void D_PAD::BuildPadShapePolygon( SHAPE_POLY_SET& aCornerBuffer,
     wxPoint corners[4];
     wxPoint padShapePos = ShapePos();       /* Note: for pad having a shape offset,
                                              * the pad position is NOT the shape position */
+
+    if( GetShape() == PAD_SHAPE_CUSTOM )
+    {
+        // for a custom shape, that is in fact a polygon (with holes), we can use only a inflate value.
+        // so use ( aInflateValue.x + aInflateValue.y ) / 2 as polygon inflate value.
+        // (different values for aInflateValue.x and aInflateValue.y has no sense for a custom pad)
+        TransformShapeWithClearanceToPolygon( aCornerBuffer,
+                                              ( aInflateValue.x + aInflateValue.y ) / 2,
+                                              aSegmentsPerCircle, aCorrectionFactor );
+        return;
+    }
+
+    PAD_SHAPE_CACHE::KEY key( PAD_SHAPE_CACHE::PAD_INFLATED_OUTLINE, *this,
+                              aSegmentsPerCircle, aCorrectionFactor );
+    key.m_params[0] = aInflateValue.x;
+    key.m_params[1] = aInflateValue.y;
+
+    if( PAD_SHAPE_CACHE::Instance().Append( key, padShapePos, aCornerBuffer ) )
+        return;
+
+    SHAPE_POLY_SET outline;
+
     switch( GetShape() )
     {
     case PAD_SHAPE_CIRCLE:
@@ -837,33 +1245,30 @@ void D_PAD::BuildPadShapePolygon( SHAPE_POLY_SET& aCornerBuffer,
         // a wxSize to inflate the pad size
         D_PAD dummy( *this );
         dummy.SetSize( GetSize() + aInflateValue + aInflateValue );
-        dummy.TransformShapeWithClearanceToPolygon( aCornerBuffer, 0,
+        dummy.TransformShapeWithClearanceToPolygon( outline, 0,
                                                     aSegmentsPerCircle, aCorrectionFactor );
     }
         break;
 
     case PAD_SHAPE_TRAPEZOID:
     case PAD_SHAPE_RECT:
-        aCornerBuffer.NewOutline();
+        outline.NewOutline();
 
         BuildPadPolygon( corners, aInflateValue, m_Orient );
         for( int ii = 0; ii < 4; ii++ )
         {
             corners[ii] += padShapePos;          // Shift origin to position
-            aCornerBuffer.Append( corners[ii].x, corners[ii].y );
+            outline.Append( corners[ii].x, corners[ii].y );
         }
 
         break;
 
-    case PAD_SHAPE_CUSTOM:
-        // for a custom shape, that is in fact a polygon (with holes), we can use only a inflate value.
-        // so use ( aInflateValue.x + aInflateValue.y ) / 2 as polygon inflate value.
-        // (different values for aInflateValue.x and aInflateValue.y has no sense for a custom pad)
-        TransformShapeWithClearanceToPolygon( aCornerBuffer,
-                                              ( aInflateValue.x + aInflateValue.y ) / 2,
-                                              aSegmentsPerCircle, aCorrectionFactor );
+    default:
         break;
     }
+
+    PAD_SHAPE_CACHE::Instance().Store( key, padShapePos, outline );
+    aCornerBuffer.Append( outline );
 }
 
 /*
@@ -929,7 +1334,7 @@ bool D_PAD::BuildPadDrillShapePolygon( SHAPE_POLY_SET& aCornerBuffer,
  *      and are used in microwave applications and they *DO NOT* have a thermal relief that
  *      change the shape by creating stubs and destroy their properties.
  */
-void    CreateThermalReliefPadPolygon( SHAPE_POLY_SET& aCornerBuffer,
+static void buildThermalReliefPadPolygon( SHAPE_POLY_SET& aCornerBuffer,
                                        const D_PAD&          aPad,
                                        int             aThermalGap,
                                        int             aCopperThickness,
@@ -1390,6 +1795,42 @@ void    CreateThermalReliefPadPolygon( SHAPE_POLY_SET& aCornerBuffer,
     }
 }
 
+
+void    CreateThermalReliefPadPolygon( SHAPE_POLY_SET& aCornerBuffer,
+                                       const D_PAD&          aPad,
+                                       int             aThermalGap,
+                                       int             aCopperThickness,
+                                       int             aMinThicknessValue,
+                                       int             aCircleToSegmentsCount,
+                                       double          aCorrectionFactor,
+                                       double          aThermalRot )
+{
+    // Custom pads have no thermal relief
+    if( aPad.GetShape() == PAD_SHAPE_CUSTOM )
+        return;
+
+    PAD_SHAPE_CACHE::KEY key( PAD_SHAPE_CACHE::PAD_THERMAL_RELIEF, aPad,
+                              aCircleToSegmentsCount, aCorrectionFactor );
+    key.m_params[0] = aThermalGap;
+    key.m_params[1] = aCopperThickness;
+    key.m_params[2] = aMinThicknessValue;
+    key.m_rotation = aThermalRot;
+
+    wxPoint padShapePos = aPad.ShapePos();
+
+    if( PAD_SHAPE_CACHE::Instance().Append( key, padShapePos, aCornerBuffer ) )
+        return;
+
+    SHAPE_POLY_SET relief;
+
+    buildThermalReliefPadPolygon( relief, aPad, aThermalGap, aCopperThickness,
+                                  aMinThicknessValue, aCircleToSegmentsCount,
+                                  aCorrectionFactor, aThermalRot );
+
+    PAD_SHAPE_CACHE::Instance().Store( key, padShapePos, relief );
+    aCornerBuffer.Append( relief );
+}
+
 void ZONE_CONTAINER::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
                                                         int             aClearanceValue,
                                                         int             aCircleToSegmentsCount,
@@ -33,6 +33,7 @@
 #include <limits.h>
 #include <algorithm>
 #include <iterator>
+#include <unordered_set>
 
 #include <fctsys.h>
 #include <common.h>
@@ -59,6 +60,7 @@
 #include <class_pcb_target.h>
 #include <class_dimension.h>
 #include <connectivity/connectivity_data.h>
+#include <connectivity/connectivity_topology.h>
 
 
 /**
@@ -420,8 +422,45 @@ TRACKS BOARD::TracksInNetBetweenPoints( const wxPoint& aStartPos, const wxPoint&
 }
 
 
-void BOARD::chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
-                                 const LSET& aLayerSet, TRACKS* aList )
+/**
+ * Collects in aList up to aMaxCount tracks and vias ending at aPosition on aLayerSet, like
+ * successive calls to ::GetTrack().  The net index aTopology is used when not null,
+ * otherwise aTrackList is walked.
+ */
+static void findTracks( TRACK* aTrackList, const CN_NET_TOPOLOGY* aTopology,
+                        const wxPoint& aPosition, const LSET& aLayerSet, TRACKS& aList,
+                        size_t aMaxCount = SIZE_MAX )
+{
+    if( aTopology )
+    {
+        aTopology->FindTracks( aPosition, aLayerSet, aList, aMaxCount );
+        return;
+    }
+
+    TRACK* track = ::GetTrack( aTrackList, NULL, aPosition, aLayerSet );
+
+    while( track && aList.size() < aMaxCount )
+    {
+        aList.push_back( track );
+
+        if( aList.size() < aMaxCount )
+            track = ::GetTrack( track->Next(), NULL, aPosition, aLayerSet );
+    }
+}
+
+
+D_PAD* BOARD::findPad( const CN_NET_TOPOLOGY* aTopology, const wxPoint& aPosition,
+                       const LSET& aLayerSet )
+{
+    if( aTopology )
+        return aTopology->FindPad( aPosition, aLayerSet );
+
+    return GetPad( aPosition, aLayerSet );
+}
+
+
+void BOARD::chainMarkedSegments( TRACK* aTrackList, const CN_NET_TOPOLOGY* aTopology,
+                                 wxPoint aPosition, const LSET& aLayerSet, TRACKS* aList )
 {
     LSET    layer_set = aLayerSet;
 
@@ -447,7 +486,7 @@ void BOARD::chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
     for( ; ; )
     {
         if( !pad )
-            pad = GetPad( aPosition, layer_set );
+            pad = findPad( aTopology, aPosition, layer_set );
 
         if( pad )
             distanceToPadCenter = GetLineLength( aPosition, pad->GetCenter() );
@@ -459,7 +498,8 @@ void BOARD::chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
          * is found we do not know at this time the number of connected items
          * and we do not know if this via is on the track or finish the track
          */
-        TRACK* via = aTrackList->GetVia( NULL, aPosition, layer_set );
+        TRACK* via = aTopology ? aTopology->FindVia( aPosition, layer_set )
+                               : aTrackList->GetVia( NULL, aPosition, layer_set );
 
         if( via )
         {
@@ -474,32 +514,22 @@ void BOARD::chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
          *  if only 1 segment at aPosition: then this segment is "candidate"
          *  if > 1 segment:
          *      then end of "track" (because more than 2 segments are connected at aPosition)
+         * Already selected (BUSY) segments are not found.  At most 3 items are needed:
+         * the via just found and 2 segments.
          */
-        TRACK*  segment = aTrackList;
+        TRACKS connected;
 
-        while( ( segment = ::GetTrack( segment, NULL, aPosition, layer_set ) ) != NULL )
-        {
-            if( segment->GetState( BUSY ) ) // already found and selected: skip it
-            {
-                segment = segment->Next();
-                continue;
-            }
+        findTracks( aTrackList, aTopology, aPosition, layer_set, connected, 3 );
 
+        for( TRACK* segment : connected )
+        {
             if( segment == via )    // just previously found: skip it
-            {
-                segment = segment->Next();
                 continue;
-            }
 
             if( ++seg_count == 1 )  // if first connected item: then segment is candidate
-            {
                 candidate = segment;
-                segment = segment->Next();
-            }
             else        // More than 1 segment connected -> location is end of track
-            {
                 return;
-            }
         }
 
         if( candidate )      // A candidate is found: flag it and push it in list
@@ -522,7 +552,7 @@ void BOARD::chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
              */
             if( pad )
             {
-                if( GetPad( aPosition, layer_set ) != pad )
+                if( findPad( aTopology, aPosition, layer_set ) != pad )
                     return;
 
                 if( GetLineLength( aPosition, pad->GetCenter() ) > distanceToPadCenter )
@@ -1880,10 +1910,51 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
     if( aTrace == NULL )
         return NULL;
 
+    // The board tracks are found from the index of their net instead of walking the
+    // whole track list for each segment.  Other lists (e.g. a track being created) are
+    // still walked.
+    CN_NET_TOPOLOGY* topology = NULL;
+
+    if( aTrackList == m_Track.GetFirst() && aTrace->GetList() == &m_Track )
+    {
+        topology = m_connectivity->GetNetTopology( aTrace->GetNetCode() );
+
+        if( topology && !topology->Contains( aTrace ) )
+            topology = NULL;
+    }
+
+    if( topology && !aReorder )
+    {
+        const CN_NET_TOPOLOGY::TRACE_LENGTH* cached = topology->GetTraceLength( aTrace );
+
+        if( cached )
+        {
+            if( aCount )
+                *aCount = cached->m_count;
+
+            if( aTraceLength )
+                *aTraceLength = cached->m_length;
+
+            if( aPadToDieLength )
+                *aPadToDieLength = cached->m_padToDie;
+
+            return aTrace;
+        }
+    }
+
     // Ensure the flag BUSY of all tracks of the board is cleared
-    // because we use it to mark segments of the track
-    for( TRACK* track = aTrackList; track; track = track->Next() )
-        track->SetState( BUSY, false );
+    // because we use it to mark segments of the track.
+    // Without reordering, only the tracks seen by the walk need it.
+    if( topology && !aReorder )
+    {
+        for( TRACK* track : topology->Tracks() )
+            track->SetState( BUSY, false );
+    }
+    else
+    {
+        for( TRACK* track = aTrackList; track; track = track->Next() )
+            track->SetState( BUSY, false );
+    }
 
     // Set flags of the initial track segment
     aTrace->SetState( BUSY, true );
@@ -1900,21 +1971,11 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
      */
     if( aTrace->Type() == PCB_VIA_T )
     {
-        TRACK* segm1 = ::GetTrack( aTrackList, NULL, aTrace->GetStart(), layer_set );
-        TRACK* segm2 = NULL;
-        TRACK* segm3 = NULL;
+        TRACKS segments;
 
-        if( segm1 )
-        {
-            segm2 = ::GetTrack( segm1->Next(), NULL, aTrace->GetStart(), layer_set );
-        }
-
-        if( segm2 )
-        {
-            segm3 = ::GetTrack( segm2->Next(), NULL, aTrace->GetStart(), layer_set );
-        }
+        findTracks( aTrackList, topology, aTrace->GetStart(), layer_set, segments, 3 );
 
-        if( segm3 )
+        if( segments.size() > 2 )
         {
             // More than 2 segments are connected to this via.
             // The "track" is only this via.
@@ -1925,16 +1986,12 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
             return aTrace;
         }
 
-        if( segm1 ) // search for other segments connected to the initial segment start point
+        // search for other segments connected to the via, from each connected segment
+        for( TRACK* segment : segments )
         {
-            layer_set = segm1->GetLayerSet();
-            chainMarkedSegments( aTrackList, aTrace->GetStart(), layer_set, &trackList );
-        }
-
-        if( segm2 ) // search for other segments connected to the initial segment end point
-        {
-            layer_set = segm2->GetLayerSet();
-            chainMarkedSegments( aTrackList, aTrace->GetStart(), layer_set, &trackList );
+            layer_set = segment->GetLayerSet();
+            chainMarkedSegments( aTrackList, topology, aTrace->GetStart(), layer_set,
+                                 &trackList );
         }
     }
     else    // mark the chain using both ends of the initial segment
@@ -1942,8 +1999,8 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
         TRACKS  from_start;
         TRACKS  from_end;
 
-        chainMarkedSegments( aTrackList, aTrace->GetStart(), layer_set, &from_start );
-        chainMarkedSegments( aTrackList, aTrace->GetEnd(),   layer_set, &from_end );
+        chainMarkedSegments( aTrackList, topology, aTrace->GetStart(), layer_set, &from_start );
+        chainMarkedSegments( aTrackList, topology, aTrace->GetEnd(),   layer_set, &from_end );
 
         // combine into one trackList:
         trackList.insert( trackList.end(), from_start.begin(), from_start.end() );
@@ -1969,12 +2026,14 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
 
         layer_set = via->GetLayerSet();
 
-        TRACK* track = ::GetTrack( aTrackList, NULL, via->GetStart(), layer_set );
+        TRACKS connected;
+
+        findTracks( aTrackList, topology, via->GetStart(), layer_set, connected );
 
         // GetTrace does not consider tracks flagged BUSY.
         // So if no connected track found, this via is on the current track
         // only: keep it
-        if( track == NULL )
+        if( connected.empty() )
             continue;
 
         /* If a track is found, this via connects also other segments of
@@ -1989,9 +2048,9 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
          * if they are on the same layer, then the via is on the selected track;
          * if they are on different layers, the via is on a other track.
          */
-        LAYER_NUM layer = track->GetLayer();
+        LAYER_NUM layer = connected[0]->GetLayer();
 
-        while( ( track = ::GetTrack( track->Next(), NULL, via->GetStart(), layer_set ) ) != NULL )
+        for( TRACK* track : connected )
         {
             if( layer != track->GetLayer() )
             {
@@ -2003,28 +2062,16 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
         }
     }
 
-    /* Rearrange the track list in order to have flagged segments linked
-     * from firstTrack so the NbSegmBusy segments are consecutive segments
-     * in list, the first item in the full track list is firstTrack, and
-     * the NbSegmBusy-1 next items (NbSegmBusy when including firstTrack)
-     * are the flagged segments
-     */
-    int     busy_count = 0;
-    TRACK*  firstTrack;
+    // The flagged items, each one once (vias can be found from both sides)
+    TRACKS marked;
+    std::unordered_set<TRACK*> seen;
 
-    for( firstTrack = aTrackList; firstTrack; firstTrack = firstTrack->Next() )
+    for( TRACK* track : trackList )
     {
-        // Search for the first flagged BUSY segments
-        if( firstTrack->GetState( BUSY ) )
-        {
-            busy_count = 1;
-            break;
-        }
+        if( track->GetState( BUSY ) && seen.insert( track ).second )
+            marked.push_back( track );
     }
 
-    if( firstTrack == NULL )
-        return NULL;
-
     // First step: calculate the track length and find the pads (when exist)
     // at each end of the trace.
     double full_len = 0;
@@ -2038,14 +2085,11 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
     int dist_fromstart = INT_MAX;
     int dist_fromend = INT_MAX;
 
-    for( TRACK* track = firstTrack; track; track = track->Next() )
+    for( TRACK* track : marked )
     {
-        if( !track->GetState( BUSY ) )
-            continue;
-
         layer_set = track->GetLayerSet();
-        D_PAD * pad_on_start = GetPad( track->GetStart(), layer_set );
-        D_PAD * pad_on_end = GetPad( track->GetEnd(), layer_set );
+        D_PAD * pad_on_start = findPad( topology, track->GetStart(), layer_set );
+        D_PAD * pad_on_end = findPad( topology, track->GetEnd(), layer_set );
 
         // a segment fully inside a pad does not contribute to the track len
         // (another track end inside this pad will contribute to this lenght)
@@ -2142,8 +2186,30 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
         }
     }
 
+    int     busy_count = 0;
+    TRACK*  firstTrack = aTrace;
+
     if( aReorder )
     {
+        /* Rearrange the track list in order to have flagged segments linked
+         * from firstTrack so the NbSegmBusy segments are consecutive segments
+         * in list, the first item in the full track list is firstTrack, and
+         * the NbSegmBusy-1 next items (NbSegmBusy when including firstTrack)
+         * are the flagged segments
+         */
+        for( firstTrack = aTrackList; firstTrack; firstTrack = firstTrack->Next() )
+        {
+            // Search for the first flagged BUSY segments
+            if( firstTrack->GetState( BUSY ) )
+            {
+                busy_count = 1;
+                break;
+            }
+        }
+
+        if( firstTrack == NULL )
+            return NULL;
+
         DLIST<TRACK>* list = (DLIST<TRACK>*)firstTrack->GetList();
         wxASSERT( list );
 
@@ -2166,17 +2232,14 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
             }
         }
     }
-    else if( aTraceLength )
+    else
     {
-        busy_count = 0;
+        busy_count = marked.size();
 
-        for( TRACK* track = firstTrack; track; track = track->Next() )
+        if( aTraceLength )
         {
-            if( track->GetState( BUSY ) )
-            {
-                busy_count++;
+            for( TRACK* track : marked )
                 track->SetState( BUSY, false );
-            }
         }
     }
 
@@ -2201,6 +2264,19 @@ TRACK* BOARD::MarkTrace( TRACK* aTrackList, TRACK*  aTrace, int* aCount,
     if( aCount )
         *aCount = busy_count;
 
+    // Keep the length for the segments of the trace: starting from any of them gives the
+    // same trace.  Starting from a via can stop at the via, so only the initial one is kept.
+    if( topology )
+    {
+        CN_NET_TOPOLOGY::TRACE_LENGTH length = { (int) marked.size(), full_len, lenPadToDie };
+
+        for( TRACK* track : marked )
+        {
+            if( track == aTrace || track->Type() == PCB_TRACE_T )
+                topology->SetTraceLength( track, length );
+        }
+    }
+
     return firstTrack;
 }
 
@@ -64,6 +64,7 @@ class NETLIST;
 class REPORTER;
 class SHAPE_POLY_SET;
 class CONNECTIVITY_DATA;
+class CN_NET_TOPOLOGY;
 class COMPONENT;
 
 /**
@@ -206,12 +207,21 @@ private:
      * segment located at \a aPosition on aLayerMask.
      *  Vias are put in list but their flags BUSY is not set
      * @param aTrackList is the beginning of the track list (usually the board track list).
+     * @param aTopology is the index of the net of the trace, used instead of walking
+     *                  aTrackList when not NULL.
      * @param aPosition A wxPoint object containing the position of the starting search.
      * @param aLayerSet The allowed layers for segments to search.
      * @param aList The track list to fill with points of flagged segments.
      */
-    void chainMarkedSegments( TRACK* aTrackList, wxPoint aPosition,
-                              const LSET& aLayerSet, TRACKS* aList );
+    void chainMarkedSegments( TRACK* aTrackList, const CN_NET_TOPOLOGY* aTopology,
+                              wxPoint aPosition, const LSET& aLayerSet, TRACKS* aList );
+
+    /**
+     * Function findPad
+     * returns the pad at aPosition on aLayerSet, from aTopology when not NULL.
+     */
+    D_PAD* findPad( const CN_NET_TOPOLOGY* aTopology, const wxPoint& aPosition,
+                    const LSET& aLayerSet );
 
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
@@ -1276,7 +1286,13 @@ public:
      *                 set (the user is responsible of flag clearing). False
      *                 for no reorder : useful when we want just calculate the
      *                 track length in this case, flags are reset
-     * @return TRACK* - The first in the chain of interesting segments.
+     * @return TRACK* - The first in the chain of interesting segments when reordering,
+     *                  aTrace otherwise.
+     * <p>
+     * For the board track list, the connected segments are found from the index of the
+     * net kept by the connectivity (see CONNECTIVITY_DATA::GetNetTopology()) and the trace
+     * length is cached until the net changes.
+     * </p>
      */
     TRACK* MarkTrace( TRACK* aTrackList, TRACK* aTrace, int* aCount, double* aTraceLength,
                       double* aInPackageLength, bool aReorder );
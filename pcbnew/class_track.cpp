@@ -1095,8 +1095,15 @@ void TRACK::GetMsgPanelInfo( EDA_UNITS_T aUnits, std::vector< MSG_PANEL_ITEM >&
         // always the track list on board, but can be a "private" list
         TRACK* track_buffer_start = this;
 
-        while( track_buffer_start->Back() )
-            track_buffer_start = track_buffer_start->Back();
+        if( GetList() == &board->m_Track )
+        {
+            track_buffer_start = board->m_Track;
+        }
+        else
+        {
+            while( track_buffer_start->Back() )
+                track_buffer_start = track_buffer_start->Back();
+        }
 
         board->MarkTrace( track_buffer_start, this, NULL, &trackLen, &lenPadToDie, false );
         msg = MessageTextFromValue( aUnits, trackLen );
@@ -93,7 +93,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
-    m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_FilledPolysList = aZone.m_FilledPolysList;    // shares the polygons until modified
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_doNotAllowCopperPour = aZone.m_doNotAllowCopperPour;
@@ -130,8 +130,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     SetHatchStyle( aOther.GetHatchStyle() );
     SetHatchPitch( aOther.GetHatchPitch() );
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
-    m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_FilledPolysList = aOther.m_FilledPolysList;       // shares the polygons until modified
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
@@ -1285,6 +1284,7 @@ void ZONE_CONTAINER::SwapData( BOARD_ITEM* aImage )
 void ZONE_CONTAINER::CacheTriangulation()
 {
     m_FilledPolysList.CacheTriangulation();
+    m_FilledPolysList.CacheEdgeIndex();
 }
 
 
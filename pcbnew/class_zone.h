@@ -554,6 +554,7 @@ public:
 
     /** (re)create a list of triangles that "fill" the solid areas.
      * used for instance to draw these solid areas on opengl
+     * Also builds the edge index of the solid areas, used by hit tests and DRC.
      */
     void CacheTriangulation();
 
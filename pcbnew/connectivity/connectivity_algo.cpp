@@ -41,11 +41,15 @@ bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 {
     markItemNetAsDirty( aItem );
 
+    if( aItem->IsConnected() )
+        m_topology.Remove( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
+
     switch( aItem->Type() )
     {
     case PCB_MODULE_T:
         for( auto pad : static_cast<MODULE*>( aItem ) -> Pads() )
         {
+            m_topology.Remove( pad );
             m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( pad ) ].MarkItemsAsInvalid();
             m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( pad ) );
         }
@@ -597,6 +601,7 @@ void CN_CONNECTIVITY_ALGO::MarkNetAsDirty( int aNet )
     }
 
     m_dirtyNets[aNet] = true;
+    m_topology.Invalidate( aNet );
 }
 
 
@@ -728,6 +733,7 @@ void CN_CONNECTIVITY_ALGO::Clear()
     m_connClusters.clear();
     m_itemMap.clear();
     m_itemList.Clear();
+    m_topology.Clear();
 
 }
 
@@ -46,6 +46,7 @@
 #include <connectivity/connectivity_rtree.h>
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_items.h>
+#include <connectivity/connectivity_topology.h>
 
 class CN_CONNECTIVITY_ALGO_IMPL;
 class CN_RATSNEST_NODES;
@@ -150,6 +151,7 @@ private:
     CLUSTERS m_connClusters;
     CLUSTERS m_ratsnestClusters;
     std::vector<bool> m_dirtyNets;
+    CN_TOPOLOGY m_topology;
     PROGRESS_REPORTER* m_progressReporter = nullptr;
 
     void    searchConnections();
@@ -247,6 +249,15 @@ public:
 
     CN_LIST& ItemList() { return m_itemList; }
 
+    /**
+     * Returns the track/via/pad index of a net, rebuilt if the net changed since the last
+     * call.  The index stays valid until the next change to the connectivity.
+     */
+    CN_NET_TOPOLOGY* GetNetTopology( int aNet )
+    {
+        return m_topology.GetNet( aNet, m_itemList );
+    }
+
     void ForEachAnchor( const std::function<void( CN_ANCHOR& )>& aFunc );
     void ForEachItem( const std::function<void( CN_ITEM& )>& aFunc );
 
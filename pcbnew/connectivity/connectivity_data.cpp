@@ -635,6 +635,12 @@ RN_NET* CONNECTIVITY_DATA::GetRatsnestForNet( int aNet )
 }
 
 
+CN_NET_TOPOLOGY* CONNECTIVITY_DATA::GetNetTopology( int aNetCode )
+{
+    return m_connAlgo->GetNetTopology( aNetCode );
+}
+
+
 void CONNECTIVITY_DATA::MarkItemNetAsDirty( BOARD_ITEM *aItem )
 {
     if (aItem->Type() == PCB_MODULE_T)
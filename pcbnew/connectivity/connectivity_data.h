@@ -39,6 +39,7 @@
 
 class CN_CLUSTER;
 class CN_CONNECTIVITY_ALGO;
+class CN_NET_TOPOLOGY;
 class CN_EDGE;
 class BOARD;
 class BOARD_COMMIT;
@@ -230,6 +231,13 @@ public:
 
     void BlockRatsnestItems( const std::vector<BOARD_ITEM*>& aItems );
 
+    /**
+     * Function GetNetTopology()
+     * Returns the index of the tracks, vias and pads of net aNetCode, used to walk traces
+     * (see BOARD::MarkTrace()), or nullptr if aNetCode is not a valid net code.
+     */
+    CN_NET_TOPOLOGY* GetNetTopology( int aNetCode );
+
     std::shared_ptr<CN_CONNECTIVITY_ALGO> GetConnectivityAlgo() const
     {
         return m_connAlgo;
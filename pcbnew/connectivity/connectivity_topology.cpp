@@ -0,0 +1,199 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <connectivity/connectivity_topology.h>
+#include <connectivity/connectivity_items.h>
+
+#include <class_pad.h>
+#include <class_track.h>
+
+
+CN_NET_TOPOLOGY::ITEM_STATE::ITEM_STATE( const BOARD_CONNECTED_ITEM* aItem ) :
+    m_padToDie( 0 ),
+    m_netCode( aItem->GetNetCode() ),
+    m_layers( aItem->GetLayerSet() )
+{
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        m_start    = pad->GetPosition();
+        m_end      = wxPoint( pad->GetSize().x, pad->GetSize().y );
+        m_width    = KiROUND( pad->GetOrientation() );
+        m_padToDie = pad->GetPadToDieLength();
+    }
+    else
+    {
+        const TRACK* track = static_cast<const TRACK*>( aItem );
+
+        m_start = track->GetStart();
+        m_end   = track->GetEnd();
+        m_width = track->GetWidth();
+    }
+}
+
+
+bool CN_NET_TOPOLOGY::ITEM_STATE::operator==( const ITEM_STATE& aOther ) const
+{
+    return m_start == aOther.m_start && m_end == aOther.m_end && m_width == aOther.m_width
+           && m_padToDie == aOther.m_padToDie && m_netCode == aOther.m_netCode
+           && m_layers == aOther.m_layers;
+}
+
+
+void CN_NET_TOPOLOGY::Add( BOARD_CONNECTED_ITEM* aItem )
+{
+    if( m_states.count( aItem ) )
+        return;
+
+    m_states[aItem] = ITEM_STATE( aItem );
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+        m_pads.push_back( static_cast<D_PAD*>( aItem ) );
+        break;
+
+    case PCB_VIA_T:
+        m_vias.push_back( static_cast<VIA*>( aItem ) );
+        // fall through
+
+    case PCB_TRACE_T:
+    {
+        TRACK* track = static_cast<TRACK*>( aItem );
+
+        m_tracks.push_back( track );
+        m_ends[track->GetStart()].push_back( track );
+
+        if( track->GetEnd() != track->GetStart() )
+            m_ends[track->GetEnd()].push_back( track );
+
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+bool CN_NET_TOPOLOGY::IsUpToDate() const
+{
+    for( const auto& entry : m_states )
+    {
+        if( !( ITEM_STATE( entry.first ) == entry.second ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+void CN_NET_TOPOLOGY::FindTracks( const wxPoint& aPosition, const LSET& aLayers,
+                                  std::vector<TRACK*>& aList, size_t aMaxCount ) const
+{
+    auto it = m_ends.find( aPosition );
+
+    if( it == m_ends.end() )
+        return;
+
+    for( TRACK* track : it->second )
+    {
+        if( aList.size() >= aMaxCount )
+            break;
+
+        if( track->GetState( IS_DELETED | BUSY ) )
+            continue;
+
+        if( ( aLayers & track->GetLayerSet() ).any() )
+            aList.push_back( track );
+    }
+}
+
+
+VIA* CN_NET_TOPOLOGY::FindVia( const wxPoint& aPosition, const LSET& aLayers ) const
+{
+    for( VIA* via : m_vias )
+    {
+        if( via->HitTest( aPosition ) && !via->GetState( BUSY | IS_DELETED )
+                && ( aLayers & via->GetLayerSet() ).any() )
+            return via;
+    }
+
+    return nullptr;
+}
+
+
+D_PAD* CN_NET_TOPOLOGY::FindPad( const wxPoint& aPosition, LSET aLayers ) const
+{
+    if( !aLayers.any() )
+        aLayers = LSET::AllCuMask();
+
+    for( D_PAD* pad : m_pads )
+    {
+        if( ( aLayers & pad->GetLayerSet() ).any() && pad->HitTest( aPosition ) )
+            return pad;
+    }
+
+    return nullptr;
+}
+
+
+CN_NET_TOPOLOGY* CN_TOPOLOGY::GetNet( int aNetCode, CN_LIST& aItems )
+{
+    if( aNetCode < 0 )
+        return nullptr;
+
+    if( aNetCode >= (int) m_nets.size() )
+        m_nets.resize( aNetCode + 1 );
+
+    std::unique_ptr<CN_NET_TOPOLOGY>& net = m_nets[aNetCode];
+
+    if( net && net->IsUpToDate() )
+        return net.get();
+
+    net.reset( new CN_NET_TOPOLOGY( aNetCode ) );
+
+    for( CN_ITEM* item : aItems )
+    {
+        if( !item->Valid() || item->Net() != aNetCode )
+            continue;
+
+        BOARD_CONNECTED_ITEM* parent = item->Parent();
+
+        switch( parent->Type() )
+        {
+        case PCB_PAD_T:
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+            net->Add( parent );
+            m_itemNets[parent] = aNetCode;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return net.get();
+}
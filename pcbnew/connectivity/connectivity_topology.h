@@ -0,0 +1,207 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PCBNEW_CONNECTIVITY_CONNECTIVITY_TOPOLOGY_H_
+#define PCBNEW_CONNECTIVITY_CONNECTIVITY_TOPOLOGY_H_
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <wx/gdicmn.h>
+#include <layers_id_colors_and_visibility.h>
+
+class BOARD_CONNECTED_ITEM;
+class CN_LIST;
+class D_PAD;
+class TRACK;
+class VIA;
+
+
+/**
+ * Class CN_NET_TOPOLOGY
+ * indexes the tracks, vias and pads of one net by position, so the trace walks done by
+ * BOARD::MarkTrace() do not need to scan the whole board track list at each step.
+ *
+ * The index keeps a copy of the geometry of its items, so it can tell if one of them was
+ * changed without notifying the connectivity (see IsUpToDate()).  It also caches the trace
+ * lengths computed by BOARD::MarkTrace().
+ */
+class CN_NET_TOPOLOGY
+{
+public:
+    ///> Length of the trace containing a given segment, as computed by BOARD::MarkTrace()
+    struct TRACE_LENGTH
+    {
+        int    m_count;         ///< number of items in the trace
+        double m_length;        ///< routed length, including the parts inside the end pads
+        double m_padToDie;      ///< pad to die length of the end pads
+    };
+
+    CN_NET_TOPOLOGY( int aNetCode ) :
+        m_netCode( aNetCode )
+    {
+    }
+
+    int GetNetCode() const { return m_netCode; }
+
+    void Add( BOARD_CONNECTED_ITEM* aItem );
+
+    bool Contains( const BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        return m_states.count( aItem ) > 0;
+    }
+
+    /**
+     * Function IsUpToDate
+     * @return false if an item of the index has been moved, resized or assigned to another
+     * net since the index was built.
+     */
+    bool IsUpToDate() const;
+
+    /**
+     * Function FindTracks
+     * collects the tracks and vias ending at aPosition on one of aLayers, in the same way
+     * as ::GetTrack(): items flagged BUSY or IS_DELETED are skipped.
+     * @param aList receives at most aMaxCount items.
+     */
+    void FindTracks( const wxPoint& aPosition, const LSET& aLayers, std::vector<TRACK*>& aList,
+                     size_t aMaxCount = SIZE_MAX ) const;
+
+    /**
+     * Function FindVia
+     * @return the via hit at aPosition on one of aLayers, like TRACK::GetVia().
+     */
+    VIA* FindVia( const wxPoint& aPosition, const LSET& aLayers ) const;
+
+    /**
+     * Function FindPad
+     * @return the pad hit at aPosition on one of aLayers, like BOARD::GetPad().
+     */
+    D_PAD* FindPad( const wxPoint& aPosition, LSET aLayers ) const;
+
+    const std::vector<TRACK*>& Tracks() const { return m_tracks; }
+
+    const TRACE_LENGTH* GetTraceLength( const TRACK* aTrack ) const
+    {
+        auto it = m_lengths.find( aTrack );
+        return it == m_lengths.end() ? nullptr : &it->second;
+    }
+
+    void SetTraceLength( const TRACK* aTrack, const TRACE_LENGTH& aLength )
+    {
+        m_lengths[aTrack] = aLength;
+    }
+
+private:
+    ///> The part of an item used by the trace walks
+    struct ITEM_STATE
+    {
+        ITEM_STATE() {}
+        ITEM_STATE( const BOARD_CONNECTED_ITEM* aItem );
+
+        bool operator==( const ITEM_STATE& aOther ) const;
+
+        wxPoint m_start;
+        wxPoint m_end;          ///< size for pads
+        int     m_width;        ///< orientation for pads
+        int     m_padToDie;
+        int     m_netCode;
+        LSET    m_layers;
+    };
+
+    struct POINT_HASH
+    {
+        size_t operator()( const wxPoint& aPoint ) const
+        {
+            return std::hash<int>()( aPoint.x ) ^ ( std::hash<int>()( aPoint.y ) << 1 );
+        }
+    };
+
+    int m_netCode;
+
+    std::vector<TRACK*> m_tracks;
+    std::vector<VIA*>   m_vias;
+    std::vector<D_PAD*> m_pads;
+
+    ///> Tracks and vias by end point, in insertion order
+    std::unordered_map<wxPoint, std::vector<TRACK*>, POINT_HASH> m_ends;
+
+    std::unordered_map<const BOARD_CONNECTED_ITEM*, ITEM_STATE> m_states;
+
+    std::unordered_map<const TRACK*, TRACE_LENGTH> m_lengths;
+};
+
+
+/**
+ * Class CN_TOPOLOGY
+ * holds the CN_NET_TOPOLOGY indices of a board.  They are built on demand and dropped
+ * when the connectivity reports a change on their net.
+ */
+class CN_TOPOLOGY
+{
+public:
+    /**
+     * Function GetNet
+     * @return the index of net aNetCode, built from the valid items of aItems if needed,
+     * or nullptr for a negative net code.
+     */
+    CN_NET_TOPOLOGY* GetNet( int aNetCode, CN_LIST& aItems );
+
+    void Invalidate( int aNetCode )
+    {
+        if( aNetCode >= 0 && aNetCode < (int) m_nets.size() )
+            m_nets[aNetCode].reset();
+    }
+
+    /**
+     * Function Remove
+     * drops the index holding aItem, which can have been given another net code since
+     * the index was built.
+     */
+    void Remove( const BOARD_CONNECTED_ITEM* aItem )
+    {
+        auto it = m_itemNets.find( aItem );
+
+        if( it != m_itemNets.end() )
+        {
+            Invalidate( it->second );
+            m_itemNets.erase( it );
+        }
+    }
+
+    void Clear()
+    {
+        m_nets.clear();
+        m_itemNets.clear();
+    }
+
+private:
+    std::vector<std::unique_ptr<CN_NET_TOPOLOGY>> m_nets;
+
+    ///> Net of the index each item was added to
+    std::unordered_map<const BOARD_CONNECTED_ITEM*, int> m_itemNets;
+};
+
+#endif /* PCBNEW_CONNECTIVITY_CONNECTIVITY_TOPOLOGY_H_ */
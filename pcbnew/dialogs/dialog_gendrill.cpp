@@ -56,6 +56,7 @@
 #define DrillMapFileTypeKey     wxT( "DrillMapFileType" )
 #define DrillFileFormatKey      wxT( "DrillFileType" )
 #define OvalHolesRouteModeKey   wxT( "OvalHolesRouteMode" )
+#define OptimizeDrillPathKey    wxT( "DrillOptimizePath" )
 
 // list of allowed precision for EXCELLON files, for integer format:
 // Due to difference between inches and mm,
@@ -106,6 +107,7 @@ bool DIALOG_GENDRILL::m_Merge_PTH_NPTH  = false;    // Only for Excellon format
 int DIALOG_GENDRILL::m_mapFileType      = 1;
 int DIALOG_GENDRILL::m_drillFileType    = 0;
 bool DIALOG_GENDRILL::m_UseRouteModeForOvalHoles = true;    // Use G00 route mode to "drill" oval holes
+bool DIALOG_GENDRILL::m_OptimizeDrillPath = false;
 
 DIALOG_GENDRILL::~DIALOG_GENDRILL()
 {
@@ -123,6 +125,7 @@ void DIALOG_GENDRILL::initDialog()
     m_config->Read( DrillMapFileTypeKey, &m_mapFileType );
     m_config->Read( DrillFileFormatKey, &m_drillFileType );
     m_config->Read( OvalHolesRouteModeKey, &m_UseRouteModeForOvalHoles );
+    m_config->Read( OptimizeDrillPathKey, &m_OptimizeDrillPath );
 
     InitDisplayParams();
 }
@@ -146,6 +149,7 @@ void DIALOG_GENDRILL::InitDisplayParams()
     m_Check_Merge_PTH_NPTH->SetValue( m_Merge_PTH_NPTH );
     m_Choice_Drill_Map->SetSelection( m_mapFileType );
     m_radioBoxOvalHoleMode->SetSelection( m_UseRouteModeForOvalHoles ? 0 : 1 );
+    m_Check_Optimize_Path->SetValue( m_OptimizeDrillPath );
 
     m_platedPadsHoleCount    = 0;
     m_notplatedPadsHoleCount = 0;
@@ -255,6 +259,7 @@ void DIALOG_GENDRILL::UpdateConfig()
     m_config->Write( DrillMapFileTypeKey, m_mapFileType );
     m_config->Write( DrillFileFormatKey, m_drillFileType );
     m_config->Write( OvalHolesRouteModeKey, m_UseRouteModeForOvalHoles );
+    m_config->Write( OptimizeDrillPathKey, m_OptimizeDrillPath );
 }
 
 
@@ -352,6 +357,7 @@ void DIALOG_GENDRILL::UpdateDrillParams()
     m_Merge_PTH_NPTH = m_Check_Merge_PTH_NPTH->IsChecked();
     m_ZerosFormat = m_Choice_Zeros_Format->GetSelection();
     m_UseRouteModeForOvalHoles = m_radioBoxOvalHoleMode->GetSelection() == 0;
+    m_OptimizeDrillPath = m_Check_Optimize_Path->IsChecked();
 
     if( m_Choice_Drill_Offset->GetSelection() == 0 )
         m_FileDrillOffset = wxPoint( 0, 0 );
@@ -406,6 +412,7 @@ void DIALOG_GENDRILL::GenDrillAndMapFiles( bool aGenDrill, bool aGenMap )
                                   m_Precision.m_lhs, m_Precision.m_rhs );
         excellonWriter.SetOptions( m_Mirror, m_MinimalHeader, m_FileDrillOffset, m_Merge_PTH_NPTH );
         excellonWriter.SetRouteModeForOvalHoles( m_UseRouteModeForOvalHoles );
+        excellonWriter.SetOptimizePathOption( m_OptimizeDrillPath );
         excellonWriter.SetMapFileFormat( filefmt[choice] );
 
         excellonWriter.CreateDrillandMapFilesSet( outputDir.GetFullPath(),
@@ -419,6 +426,7 @@ void DIALOG_GENDRILL::GenDrillAndMapFiles( bool aGenDrill, bool aGenMap )
         // the integer part precision is always 4, and units always mm
         gerberWriter.SetFormat( m_plotOpts.GetGerberPrecision() );
         gerberWriter.SetOptions( m_FileDrillOffset );
+        gerberWriter.SetOptimizePathOption( m_OptimizeDrillPath );
         gerberWriter.SetMapFileFormat( filefmt[choice] );
 
         gerberWriter.CreateDrillandMapFilesSet( outputDir.GetFullPath(),
@@ -455,11 +463,13 @@ void DIALOG_GENDRILL::OnGenReportFile( wxCommandEvent& event )
     {
         EXCELLON_WRITER excellonWriter( m_board );
         excellonWriter.SetMergeOption( m_Merge_PTH_NPTH );
+        excellonWriter.SetOptimizePathOption( m_OptimizeDrillPath );
         success = excellonWriter.GenDrillReportFile( dlg.GetPath() );
     }
     else
     {
         GERBER_WRITER gerberWriter( m_board );
+        gerberWriter.SetOptimizePathOption( m_OptimizeDrillPath );
         success = gerberWriter.GenDrillReportFile( dlg.GetPath() );
     }
 
@@ -80,6 +80,11 @@ DIALOG_GENDRILL_BASE::DIALOG_GENDRILL_BASE( wxWindow* parent, wxWindowID id, con
 	m_rbGerberX2 = new wxRadioButton( sbSizer6->GetStaticBox(), wxID_ANY, _("Gerber X2 (experimental)"), wxDefaultPosition, wxDefaultSize, 0 );
 	sbSizer6->Add( m_rbGerberX2, 0, wxTOP|wxBOTTOM|wxRIGHT, 5 );
 
+	m_Check_Optimize_Path = new wxCheckBox( sbSizer6->GetStaticBox(), wxID_ANY, _("Optimize drill path"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_Check_Optimize_Path->SetToolTip( _("Reorder the holes of each tool to shorten the drill travel.\nThe travel distances are listed in the drill report.") );
+
+	sbSizer6->Add( m_Check_Optimize_Path, 0, wxBOTTOM|wxRIGHT, 5 );
+
 
 	bMiddleSizer->Add( sbSizer6, 1, wxEXPAND|wxALL, 5 );
 
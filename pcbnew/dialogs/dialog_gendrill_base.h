@@ -50,6 +50,7 @@ class DIALOG_GENDRILL_BASE : public DIALOG_SHIM
 		wxCheckBox* m_Check_Merge_PTH_NPTH;
 		wxRadioBox* m_radioBoxOvalHoleMode;
 		wxRadioButton* m_rbGerberX2;
+		wxCheckBox* m_Check_Optimize_Path;
 		wxRadioBox* m_Choice_Drill_Map;
 		wxRadioBox* m_Choice_Drill_Offset;
 		wxRadioBox* m_Choice_Unit;
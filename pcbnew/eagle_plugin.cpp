@@ -44,6 +44,10 @@ reporting.
 User can load the source XML file into firefox or other xml browser and follow
 our error message.
 
+The document is not loaded as a whole.  XML_STREAM_PARSER reads it as a stream and
+hands over one item (package, element, signal, graphic) at a time, which is converted
+and freed before the next one is read.  See loadAllSections().
+
 Load() TODO's
 
 *) verify zone fill clearances are correct
@@ -74,6 +78,7 @@ Load() TODO's
 #include <class_dimension.h>
 
 #include <eagle_plugin.h>
+#include <xml_stream_parser.h>
 
 using namespace std;
 
@@ -220,7 +225,6 @@ wxSize inline EAGLE_PLUGIN::kicad_fontz( const ECOORD& d ) const
 BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const PROPERTIES* aProperties )
 {
     LOCALE_IO       toggle;     // toggles on, then off, the C locale.
-    wxXmlNode*      doc;
 
     init( aProperties );
 
@@ -235,21 +239,15 @@ BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const
 
     try
     {
-        // Load the document
-        wxXmlDocument xmlDocument;
+        // The document is read as a stream, it is never loaded as a whole
         wxFileName fn = aFileName;
-
-        if( !xmlDocument.Load( fn.GetFullPath() ) )
-            THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ),
-                                              fn.GetFullPath() ) );
-
-        doc = xmlDocument.GetRoot();
+        XML_STREAM_PARSER parser( fn.GetFullPath() );
 
         m_min_trace    = INT_MAX;
         m_min_via      = INT_MAX;
         m_min_via_hole = INT_MAX;
 
-        loadAllSections( doc );
+        loadAllSections( parser );
 
         BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
 
@@ -332,53 +330,84 @@ void EAGLE_PLUGIN::clear_cu_map()
 }
 
 
-void EAGLE_PLUGIN::loadAllSections( wxXmlNode* aDoc )
+void EAGLE_PLUGIN::loadAllSections( XML_STREAM_PARSER& aParser )
 {
-    wxXmlNode* drawing       = MapChildren( aDoc )["drawing"];
-    NODE_MAP drawingChildren = MapChildren( drawing );
-
-    wxXmlNode* board         = drawingChildren["board"];
-    NODE_MAP boardChildren   = MapChildren( board );
-
-    m_xpath->push( "eagle.drawing" );
-
-    {
-        m_xpath->push( "board" );
-
-        wxXmlNode* designrules = boardChildren["designrules"];
-        loadDesignRules( designrules );
-
-        m_xpath->pop();
-    }
-
-    {
-        m_xpath->push( "layers" );
-
-        wxXmlNode* layers = drawingChildren["layers"];
-        loadLayerDefs( layers );
-
-        m_xpath->pop();
-    }
+    // The layers and the design rules are needed to convert the other items, but the rules
+    // come after the libraries in the file.  So read them in a first pass, they are small
+    // and the rest of the document is skipped without building any node.
+    aParser.Parse(
+            []( const wxString& aPath, const wxXmlNode& )
+            {
+                return aPath == "eagle.drawing.layers"
+                       || aPath == "eagle.drawing.board.designrules";
+            },
+            [this]( const wxString& aPath, wxXmlNode* aElement )
+            {
+                m_xpath->push( "eagle.drawing" );
 
-    {
-        m_xpath->push( "board" );
+                if( aPath == "eagle.drawing.layers" )
+                {
+                    m_xpath->push( "layers" );
+                    loadLayerDefs( aElement );
+                    m_xpath->pop();
+                }
+                else
+                {
+                    m_xpath->push( "board" );
+                    loadDesignRules( aElement );
+                    m_xpath->pop();
+                }
 
-        wxXmlNode* plain = boardChildren["plain"];
-        loadPlain( plain );
+                m_xpath->pop();
+            } );
 
-        wxXmlNode*  signals = boardChildren["signals"];
-        loadSignals( signals );
+    // Then convert the items one at a time, freeing each one before reading the next.
+    // The pads get their nets once all the signals are known.
+    std::vector<std::pair<wxString, MODULE*>> elements;
+    wxString libName;
+    int      netCode = 1;
 
-        wxXmlNode*  libs = boardChildren["libraries"];
-        loadLibraries( libs );
+    aParser.Parse(
+            [&]( const wxString& aPath, const wxXmlNode& aElement )
+            {
+                if( aPath == "eagle.drawing.board.libraries.library" )
+                    libName = aElement.GetAttribute( "name" );
+
+                return aPath.StartsWith( "eagle.drawing.board.plain." )
+                       || aPath == "eagle.drawing.board.libraries.library.packages.package"
+                       || aPath == "eagle.drawing.board.elements.element"
+                       || aPath == "eagle.drawing.board.signals.signal";
+            },
+            [&]( const wxString& aPath, wxXmlNode* aElement )
+            {
+                m_xpath->push( "eagle.drawing.board" );
 
-        wxXmlNode* elems = boardChildren["elements"];
-        loadElements( elems );
+                if( aPath == "eagle.drawing.board.libraries.library.packages.package" )
+                {
+                    m_xpath->push( "libraries.library", "name" );
+                    m_xpath->Value( libName.c_str() );
+                    loadPackage( aElement, &libName );
+                    m_xpath->pop();
+                }
+                else if( aPath == "eagle.drawing.board.elements.element" )
+                {
+                    elements.emplace_back( aElement->GetAttribute( "name" ),
+                                           loadElement( aElement ) );
+                }
+                else if( aPath == "eagle.drawing.board.signals.signal" )
+                {
+                    loadSignal( aElement, netCode );
+                }
+                else
+                {
+                    loadPlainGraphic( aElement );
+                }
 
-        m_xpath->pop();     // "board"
-    }
+                m_xpath->pop();
+            } );
 
-    m_xpath->pop();     // "eagle.drawing"
+    for( const std::pair<wxString, MODULE*>& element : elements )
+        setPadNets( element.second, element.first );
 }
 
 
@@ -467,412 +496,355 @@ void EAGLE_PLUGIN::loadLayerDefs( wxXmlNode* aLayers )
 }
 
 
-void EAGLE_PLUGIN::loadPlain( wxXmlNode* aGraphics )
+void EAGLE_PLUGIN::loadPlainGraphic( wxXmlNode* aGraphic )
 {
-    if( !aGraphics )
-        return;
-
     m_xpath->push( "plain" );
 
-    // Get the first graphic and iterate
-    wxXmlNode* gr = aGraphics->GetChildren();
+    // (polygon | wire | text | circle | rectangle | frame | hole)
+    wxString grName = aGraphic->GetName();
 
-    // (polygon | wire | text | circle | rectangle | frame | hole)*
-    while( gr )
+    if( grName == "wire" )
     {
-        wxString grName = gr->GetName();
+        m_xpath->push( "wire" );
+
+        EWIRE        w( aGraphic );
+        PCB_LAYER_ID layer = kicad_layer( w.layer );
+
+        wxPoint start( kicad_x( w.x1 ), kicad_y( w.y1 ) );
+        wxPoint end(   kicad_x( w.x2 ), kicad_y( w.y2 ) );
 
-        if( grName == "wire" )
+        if( layer != UNDEFINED_LAYER )
         {
-            m_xpath->push( "wire" );
+            DRAWSEGMENT* dseg = new DRAWSEGMENT( m_board );
+            int          width = w.width.ToPcbUnits();
 
-            EWIRE        w( gr );
-            PCB_LAYER_ID layer = kicad_layer( w.layer );
+            // KiCad cannot handle zero or negative line widths
+            if( width <= 0 )
+                width = m_board->GetDesignSettings().GetLineThickness( layer );
 
-            wxPoint start( kicad_x( w.x1 ), kicad_y( w.y1 ) );
-            wxPoint end(   kicad_x( w.x2 ), kicad_y( w.y2 ) );
+            m_board->Add( dseg, ADD_APPEND );
 
-            if( layer != UNDEFINED_LAYER )
+            if( !w.curve )
             {
-                DRAWSEGMENT* dseg = new DRAWSEGMENT( m_board );
-                int          width = w.width.ToPcbUnits();
-
-                // KiCad cannot handle zero or negative line widths
-                if( width <= 0 )
-                    width = m_board->GetDesignSettings().GetLineThickness( layer );
+                dseg->SetStart( start );
+                dseg->SetEnd( end );
+            }
+            else
+            {
+                wxPoint center = ConvertArcCenter( start, end, *w.curve );
 
-                m_board->Add( dseg, ADD_APPEND );
+                dseg->SetShape( S_ARC );
+                dseg->SetStart( center );
+                dseg->SetEnd( start );
+                dseg->SetAngle( *w.curve * -10.0 ); // KiCad rotates the other way
+            }
 
-                if( !w.curve )
-                {
-                    dseg->SetStart( start );
-                    dseg->SetEnd( end );
-                }
-                else
-                {
-                    wxPoint center = ConvertArcCenter( start, end, *w.curve );
+            dseg->SetTimeStamp( EagleTimeStamp( aGraphic ) );
+            dseg->SetLayer( layer );
+            dseg->SetWidth( width );
+        }
 
-                    dseg->SetShape( S_ARC );
-                    dseg->SetStart( center );
-                    dseg->SetEnd( start );
-                    dseg->SetAngle( *w.curve * -10.0 ); // KiCad rotates the other way
-                }
+        m_xpath->pop();
+    }
+    else if( grName == "text" )
+    {
+        m_xpath->push( "text" );
 
-                dseg->SetTimeStamp( EagleTimeStamp( gr ) );
-                dseg->SetLayer( layer );
-                dseg->SetWidth( width );
-            }
+        ETEXT        t( aGraphic );
+        PCB_LAYER_ID layer = kicad_layer( t.layer );
 
-            m_xpath->pop();
-        }
-        else if( grName == "text" )
+        if( layer != UNDEFINED_LAYER )
         {
-            m_xpath->push( "text" );
+            TEXTE_PCB* pcbtxt = new TEXTE_PCB( m_board );
+            m_board->Add( pcbtxt, ADD_APPEND );
 
-            ETEXT        t( gr );
-            PCB_LAYER_ID layer = kicad_layer( t.layer );
+            pcbtxt->SetLayer( layer );
+            pcbtxt->SetTimeStamp( EagleTimeStamp( aGraphic ) );
+            pcbtxt->SetText( FROM_UTF8( t.text.c_str() ) );
+            pcbtxt->SetTextPos( wxPoint( kicad_x( t.x ), kicad_y( t.y ) ) );
 
-            if( layer != UNDEFINED_LAYER )
-            {
-                TEXTE_PCB* pcbtxt = new TEXTE_PCB( m_board );
-                m_board->Add( pcbtxt, ADD_APPEND );
+            pcbtxt->SetTextSize( kicad_fontz( t.size ) );
 
-                pcbtxt->SetLayer( layer );
-                pcbtxt->SetTimeStamp( EagleTimeStamp( gr ) );
-                pcbtxt->SetText( FROM_UTF8( t.text.c_str() ) );
-                pcbtxt->SetTextPos( wxPoint( kicad_x( t.x ), kicad_y( t.y ) ) );
+            double ratio = t.ratio ? *t.ratio : 8;     // DTD says 8 is default
 
-                pcbtxt->SetTextSize( kicad_fontz( t.size ) );
+            pcbtxt->SetThickness( t.size.ToPcbUnits() * ratio / 100 );
 
-                double ratio = t.ratio ? *t.ratio : 8;     // DTD says 8 is default
+            int align = t.align ? *t.align : ETEXT::BOTTOM_LEFT;
 
-                pcbtxt->SetThickness( t.size.ToPcbUnits() * ratio / 100 );
+            if( t.rot )
+            {
+                int sign = t.rot->mirror ? -1 : 1;
+                pcbtxt->SetMirrored( t.rot->mirror );
 
-                int align = t.align ? *t.align : ETEXT::BOTTOM_LEFT;
+                double degrees = t.rot->degrees;
 
-                if( t.rot )
+                if( degrees == 90 || t.rot->spin )
+                    pcbtxt->SetTextAngle( sign * t.rot->degrees * 10 );
+                else if( degrees == 180 )
+                    align = ETEXT::TOP_RIGHT;
+                else if( degrees == 270 )
                 {
-                    int sign = t.rot->mirror ? -1 : 1;
-                    pcbtxt->SetMirrored( t.rot->mirror );
-
-                    double degrees = t.rot->degrees;
-
-                    if( degrees == 90 || t.rot->spin )
+                    pcbtxt->SetTextAngle( sign * 90 * 10 );
+                    align = ETEXT::TOP_RIGHT;
+                }
+                else // Ok so text is not at 90,180 or 270 so do some funny stuff to get placement right
+                {
+                    if( ( degrees > 0 ) &&  ( degrees < 90 ) )
                         pcbtxt->SetTextAngle( sign * t.rot->degrees * 10 );
-                    else if( degrees == 180 )
+                    else if( ( degrees > 90 ) && ( degrees < 180 ) )
+                    {
+                        pcbtxt->SetTextAngle( sign * ( t.rot->degrees + 180 ) * 10 );
                         align = ETEXT::TOP_RIGHT;
-                    else if( degrees == 270 )
+                    }
+                    else if( ( degrees > 180 ) && ( degrees < 270 ) )
                     {
-                        pcbtxt->SetTextAngle( sign * 90 * 10 );
+                        pcbtxt->SetTextAngle( sign * ( t.rot->degrees - 180 ) * 10 );
                         align = ETEXT::TOP_RIGHT;
                     }
-                    else // Ok so text is not at 90,180 or 270 so do some funny stuff to get placement right
+                    else if( ( degrees > 270 ) && ( degrees < 360 ) )
                     {
-                        if( ( degrees > 0 ) &&  ( degrees < 90 ) )
-                            pcbtxt->SetTextAngle( sign * t.rot->degrees * 10 );
-                        else if( ( degrees > 90 ) && ( degrees < 180 ) )
-                        {
-                            pcbtxt->SetTextAngle( sign * ( t.rot->degrees + 180 ) * 10 );
-                            align = ETEXT::TOP_RIGHT;
-                        }
-                        else if( ( degrees > 180 ) && ( degrees < 270 ) )
-                        {
-                            pcbtxt->SetTextAngle( sign * ( t.rot->degrees - 180 ) * 10 );
-                            align = ETEXT::TOP_RIGHT;
-                        }
-                        else if( ( degrees > 270 ) && ( degrees < 360 ) )
-                        {
-                            pcbtxt->SetTextAngle( sign * t.rot->degrees * 10 );
-                            align = ETEXT::BOTTOM_LEFT;
-                        }
+                        pcbtxt->SetTextAngle( sign * t.rot->degrees * 10 );
+                        align = ETEXT::BOTTOM_LEFT;
                     }
                 }
-
-                switch( align )
-                {
-                case ETEXT::CENTER:
-                    // this was the default in pcbtxt's constructor
-                    break;
-
-                case ETEXT::CENTER_LEFT:
-                    pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_LEFT );
-                    break;
-
-                case ETEXT::CENTER_RIGHT:
-                    pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
-                    break;
-
-                case ETEXT::TOP_CENTER:
-                    pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_TOP );
-                    break;
-
-                case ETEXT::TOP_LEFT:
-                    pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_LEFT );
-                    pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_TOP );
-                    break;
-
-                case ETEXT::TOP_RIGHT:
-                    pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
-                    pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_TOP );
-                    break;
-
-                case ETEXT::BOTTOM_CENTER:
-                    pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_BOTTOM );
-                    break;
-
-                case ETEXT::BOTTOM_LEFT:
-                    pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_LEFT );
-                    pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_BOTTOM );
-                    break;
-
-                case ETEXT::BOTTOM_RIGHT:
-                    pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
-                    pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_BOTTOM );
-                    break;
-                }
             }
-            m_xpath->pop();
-        }
-        else if( grName == "circle" )
-        {
-            m_xpath->push( "circle" );
-
-            ECIRCLE      c( gr );
-            PCB_LAYER_ID layer = kicad_layer( c.layer );
 
-            if( layer != UNDEFINED_LAYER )       // unsupported layer
+            switch( align )
             {
-                DRAWSEGMENT* dseg = new DRAWSEGMENT( m_board );
-                m_board->Add( dseg, ADD_APPEND );
-
-                int width = c.width.ToPcbUnits();
-                int radius = c.radius.ToPcbUnits();
+            case ETEXT::CENTER:
+                // this was the default in pcbtxt's constructor
+                break;
 
-                // with == 0 means filled circle
-                if( width <= 0 )
-                {
-                    width = radius;
-                    radius = radius / 2;
-                }
+            case ETEXT::CENTER_LEFT:
+                pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_LEFT );
+                break;
 
-                dseg->SetShape( S_CIRCLE );
-                dseg->SetTimeStamp( EagleTimeStamp( gr ) );
-                dseg->SetLayer( layer );
-                dseg->SetStart( wxPoint( kicad_x( c.x ), kicad_y( c.y ) ) );
-                dseg->SetEnd( wxPoint( kicad_x( c.x ) + radius, kicad_y( c.y ) ) );
-                dseg->SetWidth( width );
-            }
-            m_xpath->pop();
-        }
-        else if( grName == "rectangle" )
-        {
-            // This seems to be a simplified rectangular [copper] zone, cannot find any
-            // net related info on it from the DTD.
-            m_xpath->push( "rectangle" );
+            case ETEXT::CENTER_RIGHT:
+                pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
+                break;
 
-            ERECT        r( gr );
-            PCB_LAYER_ID layer = kicad_layer( r.layer );
+            case ETEXT::TOP_CENTER:
+                pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_TOP );
+                break;
 
-            if( IsCopperLayer( layer ) )
-            {
-                // use a "netcode = 0" type ZONE:
-                ZONE_CONTAINER* zone = new ZONE_CONTAINER( m_board );
-                m_board->Add( zone, ADD_APPEND );
+            case ETEXT::TOP_LEFT:
+                pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_LEFT );
+                pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_TOP );
+                break;
 
-                zone->SetTimeStamp( EagleTimeStamp( gr ) );
-                zone->SetLayer( layer );
-                zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
+            case ETEXT::TOP_RIGHT:
+                pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
+                pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_TOP );
+                break;
 
-                ZONE_CONTAINER::HATCH_STYLE outline_hatch = ZONE_CONTAINER::DIAGONAL_EDGE;
+            case ETEXT::BOTTOM_CENTER:
+                pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_BOTTOM );
+                break;
 
-                const int outlineIdx = -1;      // this is the id of the copper zone main outline
-                zone->AppendCorner( wxPoint( kicad_x( r.x1 ), kicad_y( r.y1 ) ), outlineIdx );
-                zone->AppendCorner( wxPoint( kicad_x( r.x2 ), kicad_y( r.y1 ) ), outlineIdx );
-                zone->AppendCorner( wxPoint( kicad_x( r.x2 ), kicad_y( r.y2 ) ), outlineIdx );
-                zone->AppendCorner( wxPoint( kicad_x( r.x1 ), kicad_y( r.y2 ) ), outlineIdx );
+            case ETEXT::BOTTOM_LEFT:
+                pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_LEFT );
+                pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_BOTTOM );
+                break;
 
-                if( r.rot )
-                {
-                    zone->Rotate( zone->GetPosition(), r.rot->degrees * 10 );
-                }
-                // this is not my fault:
-                zone->SetHatch( outline_hatch, zone->GetDefaultHatchPitch(), true );
+            case ETEXT::BOTTOM_RIGHT:
+                pcbtxt->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
+                pcbtxt->SetVertJustify( GR_TEXT_VJUSTIFY_BOTTOM );
+                break;
             }
-
-            m_xpath->pop();
         }
-        else if( grName == "hole" )
-        {
-            m_xpath->push( "hole" );
-
-            // Fabricate a MODULE with a single PAD_ATTRIB_HOLE_NOT_PLATED pad.
-            // Use m_hole_count to gen up a unique name.
-
-            MODULE* module = new MODULE( m_board );
-            m_board->Add( module, ADD_APPEND );
-            module->SetReference( wxString::Format( "@HOLE%d", m_hole_count++ ) );
-            module->Reference().SetVisible( false );
+        m_xpath->pop();
+    }
+    else if( grName == "circle" )
+    {
+        m_xpath->push( "circle" );
 
-            packageHole( module, gr, true );
+        ECIRCLE      c( aGraphic );
+        PCB_LAYER_ID layer = kicad_layer( c.layer );
 
-            m_xpath->pop();
-        }
-        else if( grName == "frame" )
-        {
-            // picture this
-        }
-        else if( grName == "polygon" )
+        if( layer != UNDEFINED_LAYER )       // unsupported layer
         {
-            m_xpath->push( "polygon" );
-            loadPolygon( gr );
-            m_xpath->pop();     // "polygon"
-        }
-        else if( grName == "dimension" )
-        {
-            EDIMENSION d( gr );
-            PCB_LAYER_ID layer = kicad_layer( d.layer );
-
-            if( layer != UNDEFINED_LAYER )
-            {
-                const BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
-                DIMENSION* dimension = new DIMENSION( m_board );
-                m_board->Add( dimension, ADD_APPEND );
-
-                if( d.dimensionType )
-                {
-                    // Eagle dimension graphic arms may have different lengths, but they look
-                    // incorrect in KiCad (the graphic is tilted). Make them even length in such case.
-                    if( *d.dimensionType == "horizontal" )
-                    {
-                        int newY = ( d.y1.ToPcbUnits() + d.y2.ToPcbUnits() ) / 2;
-                        d.y1 = ECOORD( newY, ECOORD::EAGLE_UNIT::EU_NM );
-                        d.y2 = ECOORD( newY, ECOORD::EAGLE_UNIT::EU_NM );
-                    }
-                    else if( *d.dimensionType == "vertical" )
-                    {
-                        int newX = ( d.x1.ToPcbUnits() + d.x2.ToPcbUnits() ) / 2;
-                        d.x1 = ECOORD( newX, ECOORD::EAGLE_UNIT::EU_NM );
-                        d.x2 = ECOORD( newX, ECOORD::EAGLE_UNIT::EU_NM );
-                    }
-                }
+            DRAWSEGMENT* dseg = new DRAWSEGMENT( m_board );
+            m_board->Add( dseg, ADD_APPEND );
 
-                dimension->SetLayer( layer );
-                // The origin and end are assumed to always be in this order from eagle
-                dimension->SetOrigin( wxPoint( kicad_x( d.x1 ), kicad_y( d.y1 ) ) );
-                dimension->SetEnd( wxPoint( kicad_x( d.x2 ), kicad_y( d.y2 ) ) );
-                dimension->Text().SetTextSize( designSettings.GetTextSize( layer ) );
-                dimension->Text().SetThickness( designSettings.GetTextThickness( layer ) );
-                dimension->SetWidth( designSettings.GetLineThickness( layer ) );
-                dimension->SetUnits( MILLIMETRES, false );
-
-                // check which axis the dimension runs in
-                // because the "height" of the dimension is perpendicular to that axis
-                // Note the check is just if two axes are close enough to each other
-                // Eagle appears to have some rounding errors
-                if( abs( ( d.x1 - d.x2 ).ToPcbUnits() ) < 50000 )   // 50000 nm = 0.05 mm
-                    dimension->SetHeight( kicad_x( d.x3 - d.x1 ) );
-                else
-                    dimension->SetHeight( kicad_y( d.y3 - d.y1 ) );
+            int width = c.width.ToPcbUnits();
+            int radius = c.radius.ToPcbUnits();
 
-                dimension->AdjustDimensionDetails();
+            // with == 0 means filled circle
+            if( width <= 0 )
+            {
+                width = radius;
+                radius = radius / 2;
             }
-        }
 
-        // Get next graphic
-        gr = gr->GetNext();
+            dseg->SetShape( S_CIRCLE );
+            dseg->SetTimeStamp( EagleTimeStamp( aGraphic ) );
+            dseg->SetLayer( layer );
+            dseg->SetStart( wxPoint( kicad_x( c.x ), kicad_y( c.y ) ) );
+            dseg->SetEnd( wxPoint( kicad_x( c.x ) + radius, kicad_y( c.y ) ) );
+            dseg->SetWidth( width );
+        }
+        m_xpath->pop();
     }
-    m_xpath->pop();
-}
+    else if( grName == "rectangle" )
+    {
+        // This seems to be a simplified rectangular [copper] zone, cannot find any
+        // net related info on it from the DTD.
+        m_xpath->push( "rectangle" );
 
+        ERECT        r( aGraphic );
+        PCB_LAYER_ID layer = kicad_layer( r.layer );
 
-void EAGLE_PLUGIN::loadLibrary( wxXmlNode* aLib, const wxString* aLibName )
-{
-    if( !aLib )
-        return;
-
-    // library will have <xmlattr> node, skip that and get the single packages node
-    wxXmlNode* packages = MapChildren( aLib )["packages"];
+        if( IsCopperLayer( layer ) )
+        {
+            // use a "netcode = 0" type ZONE:
+            ZONE_CONTAINER* zone = new ZONE_CONTAINER( m_board );
+            m_board->Add( zone, ADD_APPEND );
 
-    if( !packages )
-        return;
+            zone->SetTimeStamp( EagleTimeStamp( aGraphic ) );
+            zone->SetLayer( layer );
+            zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
 
-    m_xpath->push( "packages" );
+            ZONE_CONTAINER::HATCH_STYLE outline_hatch = ZONE_CONTAINER::DIAGONAL_EDGE;
 
-    // Create a MODULE for all the eagle packages, for use later via a copy constructor
-    // to instantiate needed MODULES in our BOARD.  Save the MODULE templates in
-    // a MODULE_MAP using a single lookup key consisting of libname+pkgname.
+            const int outlineIdx = -1;      // this is the id of the copper zone main outline
+            zone->AppendCorner( wxPoint( kicad_x( r.x1 ), kicad_y( r.y1 ) ), outlineIdx );
+            zone->AppendCorner( wxPoint( kicad_x( r.x2 ), kicad_y( r.y1 ) ), outlineIdx );
+            zone->AppendCorner( wxPoint( kicad_x( r.x2 ), kicad_y( r.y2 ) ), outlineIdx );
+            zone->AppendCorner( wxPoint( kicad_x( r.x1 ), kicad_y( r.y2 ) ), outlineIdx );
 
-    // Get the first package and iterate
-    wxXmlNode* package = packages->GetChildren();
+            if( r.rot )
+            {
+                zone->Rotate( zone->GetPosition(), r.rot->degrees * 10 );
+            }
+            // this is not my fault:
+            zone->SetHatch( outline_hatch, zone->GetDefaultHatchPitch(), true );
+        }
 
-    while( package )
+        m_xpath->pop();
+    }
+    else if( grName == "hole" )
     {
-        m_xpath->push( "package", "name" );
+        m_xpath->push( "hole" );
 
-        wxString pack_ref = package->GetAttribute( "name" );
-        ReplaceIllegalFileNameChars( pack_ref, '_' );
+        // Fabricate a MODULE with a single PAD_ATTRIB_HOLE_NOT_PLATED pad.
+        // Use m_hole_count to gen up a unique name.
 
-        m_xpath->Value( pack_ref.ToUTF8() );
+        MODULE* module = new MODULE( m_board );
+        m_board->Add( module, ADD_APPEND );
+        module->SetReference( wxString::Format( "@HOLE%d", m_hole_count++ ) );
+        module->Reference().SetVisible( false );
 
-        wxString key = aLibName ? makeKey( *aLibName, pack_ref ) : pack_ref;
+        packageHole( module, aGraphic, true );
 
-        MODULE* m = makeModule( package, pack_ref );
-
-        // add the templating MODULE to the MODULE template factory "m_templates"
-        std::pair<MODULE_ITER, bool> r = m_templates.insert( {key, m} );
+        m_xpath->pop();
+    }
+    else if( grName == "frame" )
+    {
+        // picture this
+    }
+    else if( grName == "polygon" )
+    {
+        m_xpath->push( "polygon" );
+        loadPolygon( aGraphic );
+        m_xpath->pop();     // "polygon"
+    }
+    else if( grName == "dimension" )
+    {
+        EDIMENSION d( aGraphic );
+        PCB_LAYER_ID layer = kicad_layer( d.layer );
 
-        if( !r.second
-            // && !( m_props && m_props->Value( "ignore_duplicates" ) )
-            )
+        if( layer != UNDEFINED_LAYER )
         {
-            wxString lib = aLibName ? *aLibName : m_lib_path;
-            wxString pkg = pack_ref;
-
-            wxString emsg = wxString::Format(
-                _( "<package> name: \"%s\" duplicated in eagle <library>: \"%s\"" ),
-                GetChars( pkg ),
-                GetChars( lib )
-                );
-            THROW_IO_ERROR( emsg );
-        }
+            const BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
+            DIMENSION* dimension = new DIMENSION( m_board );
+            m_board->Add( dimension, ADD_APPEND );
 
-        m_xpath->pop();
+            if( d.dimensionType )
+            {
+                // Eagle dimension graphic arms may have different lengths, but they look
+                // incorrect in KiCad (the graphic is tilted). Make them even length in such case.
+                if( *d.dimensionType == "horizontal" )
+                {
+                    int newY = ( d.y1.ToPcbUnits() + d.y2.ToPcbUnits() ) / 2;
+                    d.y1 = ECOORD( newY, ECOORD::EAGLE_UNIT::EU_NM );
+                    d.y2 = ECOORD( newY, ECOORD::EAGLE_UNIT::EU_NM );
+                }
+                else if( *d.dimensionType == "vertical" )
+                {
+                    int newX = ( d.x1.ToPcbUnits() + d.x2.ToPcbUnits() ) / 2;
+                    d.x1 = ECOORD( newX, ECOORD::EAGLE_UNIT::EU_NM );
+                    d.x2 = ECOORD( newX, ECOORD::EAGLE_UNIT::EU_NM );
+                }
+            }
 
-        package = package->GetNext();
+            dimension->SetLayer( layer );
+            // The origin and end are assumed to always be in this order from eagle
+            dimension->SetOrigin( wxPoint( kicad_x( d.x1 ), kicad_y( d.y1 ) ) );
+            dimension->SetEnd( wxPoint( kicad_x( d.x2 ), kicad_y( d.y2 ) ) );
+            dimension->Text().SetTextSize( designSettings.GetTextSize( layer ) );
+            dimension->Text().SetThickness( designSettings.GetTextThickness( layer ) );
+            dimension->SetWidth( designSettings.GetLineThickness( layer ) );
+            dimension->SetUnits( MILLIMETRES, false );
+
+            // check which axis the dimension runs in
+            // because the "height" of the dimension is perpendicular to that axis
+            // Note the check is just if two axes are close enough to each other
+            // Eagle appears to have some rounding errors
+            if( abs( ( d.x1 - d.x2 ).ToPcbUnits() ) < 50000 )   // 50000 nm = 0.05 mm
+                dimension->SetHeight( kicad_x( d.x3 - d.x1 ) );
+            else
+                dimension->SetHeight( kicad_y( d.y3 - d.y1 ) );
+
+            dimension->AdjustDimensionDetails();
+        }
     }
 
-    m_xpath->pop();     // "packages"
+    m_xpath->pop();
 }
 
 
-void EAGLE_PLUGIN::loadLibraries( wxXmlNode* aLibs )
+void EAGLE_PLUGIN::loadPackage( wxXmlNode* aPackage, const wxString* aLibName )
 {
-    if( !aLibs )
-        return;
+    // Create a MODULE for the eagle package, for use later via a copy constructor
+    // to instantiate needed MODULES in our BOARD.  Save the MODULE templates in
+    // a MODULE_MAP using a single lookup key consisting of libname+pkgname.
+    m_xpath->push( "packages.package", "name" );
+
+    wxString pack_ref = aPackage->GetAttribute( "name" );
+    ReplaceIllegalFileNameChars( pack_ref, '_' );
 
-    m_xpath->push( "libraries.library", "name" );
+    m_xpath->Value( pack_ref.ToUTF8() );
 
-    // Get the first library and iterate
-    wxXmlNode* library = aLibs->GetChildren();
+    wxString key = aLibName ? makeKey( *aLibName, pack_ref ) : pack_ref;
 
-    while( library )
+    MODULE* m = makeModule( aPackage, pack_ref );
+
+    // add the templating MODULE to the MODULE template factory "m_templates"
+    std::pair<MODULE_ITER, bool> r = m_templates.insert( {key, m} );
+
+    if( !r.second
+        // && !( m_props && m_props->Value( "ignore_duplicates" ) )
+        )
     {
-        const wxString& lib_name = library->GetAttribute( "name" );
+        wxString lib = aLibName ? *aLibName : m_lib_path;
+        wxString pkg = pack_ref;
+
+        delete m;
 
-        m_xpath->Value( lib_name.c_str() );
-        loadLibrary( library, &lib_name );
-        library = library->GetNext();
+        wxString emsg = wxString::Format(
+            _( "<package> name: \"%s\" duplicated in eagle <library>: \"%s\"" ),
+            GetChars( pkg ),
+            GetChars( lib )
+            );
+        THROW_IO_ERROR( emsg );
     }
 
     m_xpath->pop();
 }
 
 
-void EAGLE_PLUGIN::loadElements( wxXmlNode* aElements )
+MODULE* EAGLE_PLUGIN::loadElement( wxXmlNode* aElement )
 {
-    if( !aElements )
-        return;
-
     m_xpath->push( "elements.element", "name" );
 
     EATTR   name;
@@ -880,233 +852,222 @@ void EAGLE_PLUGIN::loadElements( wxXmlNode* aElements )
     bool refanceNamePresetInPackageLayout;
     bool valueNamePresetInPackageLayout;
 
-    // Get the first element and iterate
-    wxXmlNode* element = aElements->GetChildren();
-
-    while( element )
-    {
-        if( element->GetName() != "element" )
-        {
-            wxLogDebug( "expected: <element> read <%s>. Skip it", element->GetName() );
-            // Get next item
-            element = element->GetNext();
-            continue;
-        }
-
-        EELEMENT    e( element );
+    EELEMENT    e( aElement );
 
-        // use "NULL-ness" as an indication of presence of the attribute:
-        EATTR*      nameAttr  = 0;
-        EATTR*      valueAttr = 0;
+    // use "NULL-ness" as an indication of presence of the attribute:
+    EATTR*      nameAttr  = 0;
+    EATTR*      valueAttr = 0;
 
-        m_xpath->Value( e.name.c_str() );
+    m_xpath->Value( e.name.c_str() );
 
-        wxString pkg_key = makeKey( e.library, e.package );
+    wxString pkg_key = makeKey( e.library, e.package );
 
-        MODULE_CITER mi = m_templates.find( pkg_key );
+    MODULE_CITER mi = m_templates.find( pkg_key );
 
-        if( mi == m_templates.end() )
-        {
-            wxString emsg = wxString::Format( _( "No \"%s\" package in library \"%s\"" ),
-                                              GetChars( FROM_UTF8( e.package.c_str() ) ),
-                                              GetChars( FROM_UTF8( e.library.c_str() ) ) );
-            THROW_IO_ERROR( emsg );
-        }
+    if( mi == m_templates.end() )
+    {
+        wxString emsg = wxString::Format( _( "No \"%s\" package in library \"%s\"" ),
+                                          GetChars( FROM_UTF8( e.package.c_str() ) ),
+                                          GetChars( FROM_UTF8( e.library.c_str() ) ) );
+        THROW_IO_ERROR( emsg );
+    }
 
-        // copy constructor to clone the template
-        MODULE* m = new MODULE( *mi->second );
-        m_board->Add( m, ADD_APPEND );
+    // copy constructor to clone the template
+    MODULE* m = new MODULE( *mi->second );
+    m_board->Add( m, ADD_APPEND );
 
-        // update the nets within the pads of the clone
-        for( D_PAD* pad = m->PadsList();  pad;  pad = pad->Next() )
-        {
-            wxString pn_key = makeKey( e.name, pad->GetName() );
+    refanceNamePresetInPackageLayout = true;
+    valueNamePresetInPackageLayout = true;
+    m->SetPosition( wxPoint( kicad_x( e.x ), kicad_y( e.y ) ) );
 
-            NET_MAP_CITER ni = m_pads_to_nets.find( pn_key );
-            if( ni != m_pads_to_nets.end() )
-            {
-                const ENET* enet = &ni->second;
-                pad->SetNetCode( enet->netcode );
-            }
-        }
+    // Is >NAME field set in package layout ?
+    if( m->GetReference().size() == 0 )
+    {
+        m->Reference().SetVisible( false ); // No so no show
+        refanceNamePresetInPackageLayout = false;
+    }
 
-        refanceNamePresetInPackageLayout = true;
-        valueNamePresetInPackageLayout = true;
-        m->SetPosition( wxPoint( kicad_x( e.x ), kicad_y( e.y ) ) );
+    // Is >VALUE field set in package layout
+    if( m->GetValue().size() == 0 )
+    {
+        m->Value().SetVisible( false );     // No so no show
+        valueNamePresetInPackageLayout = false;
+    }
 
-        // Is >NAME field set in package layout ?
-        if( m->GetReference().size() == 0 )
-        {
-            m->Reference().SetVisible( false ); // No so no show
-            refanceNamePresetInPackageLayout = false;
-        }
+    m->SetReference( FROM_UTF8( e.name.c_str() ) );
+    m->SetValue( FROM_UTF8( e.value.c_str() ) );
 
-        // Is >VALUE field set in package layout
-        if( m->GetValue().size() == 0 )
-        {
-            m->Value().SetVisible( false );     // No so no show
-            valueNamePresetInPackageLayout = false;
-        }
+    if( !e.smashed )
+    { // Not smashed so show NAME & VALUE
+        if( valueNamePresetInPackageLayout )
+            m->Value().SetVisible( true );  // Only if place holder in package layout
 
-        m->SetReference( FROM_UTF8( e.name.c_str() ) );
-        m->SetValue( FROM_UTF8( e.value.c_str() ) );
+        if( refanceNamePresetInPackageLayout )
+            m->Reference().SetVisible( true );   // Only if place holder in package layout
+    }
+    else if( *e.smashed == true )
+    { // Smashed so set default to no show for NAME and VALUE
+        m->Value().SetVisible( false );
+        m->Reference().SetVisible( false );
 
-        if( !e.smashed )
-        { // Not smashed so show NAME & VALUE
-            if( valueNamePresetInPackageLayout )
-                m->Value().SetVisible( true );  // Only if place holder in package layout
+        // initialize these to default values in case the <attribute> elements are not present.
+        m_xpath->push( "attribute", "name" );
 
-            if( refanceNamePresetInPackageLayout )
-                m->Reference().SetVisible( true );   // Only if place holder in package layout
-        }
-        else if( *e.smashed == true )
-        { // Smashed so set default to no show for NAME and VALUE
-            m->Value().SetVisible( false );
-            m->Reference().SetVisible( false );
+        // VALUE and NAME can have something like our text "effects" overrides
+        // in SWEET and new schematic.  Eagle calls these XML elements "attribute".
+        // There can be one for NAME and/or VALUE both.  Features present in the
+        // EATTR override the ones established in the package only if they are
+        // present here (except for rot, which if not present means angle zero).
+        // So the logic is a bit different than in packageText() and in plain text.
 
-            // initialize these to default values in case the <attribute> elements are not present.
-            m_xpath->push( "attribute", "name" );
+        // Get the first attribute and iterate
+        wxXmlNode* attribute = aElement->GetChildren();
 
-            // VALUE and NAME can have something like our text "effects" overrides
-            // in SWEET and new schematic.  Eagle calls these XML elements "attribute".
-            // There can be one for NAME and/or VALUE both.  Features present in the
-            // EATTR override the ones established in the package only if they are
-            // present here (except for rot, which if not present means angle zero).
-            // So the logic is a bit different than in packageText() and in plain text.
+        while( attribute )
+        {
+            if( attribute->GetName() != "attribute" )
+            {
+                wxLogDebug( "expected: <attribute> read <%s>. Skip it", attribute->GetName() );
+                attribute = attribute->GetNext();
+                continue;
+            }
 
-            // Get the first attribute and iterate
-            wxXmlNode* attribute = element->GetChildren();
+            EATTR   a( attribute );
 
-            while( attribute )
+            if( a.name == "NAME" )
             {
-                if( attribute->GetName() != "attribute" )
-                {
-                    wxLogDebug( "expected: <attribute> read <%s>. Skip it", attribute->GetName() );
-                    attribute = attribute->GetNext();
-                    continue;
-                }
-
-                EATTR   a( attribute );
+                name = a;
+                nameAttr = &name;
 
-                if( a.name == "NAME" )
+                // do we have a display attribute ?
+                if( a.display  )
                 {
-                    name = a;
-                    nameAttr = &name;
-
-                    // do we have a display attribute ?
-                    if( a.display  )
+                    // Yes!
+                    switch( *a.display )
                     {
-                        // Yes!
-                        switch( *a.display )
-                        {
-                        case EATTR::VALUE :
+                    case EATTR::VALUE :
+                    {
+                        wxString reference = e.name;
+
+                        // EAGLE allows references to be single digits.  This breaks KiCad netlisting, which requires
+                        // parts to have non-digit + digit annotation.  If the reference begins with a number,
+                        // we prepend 'UNK' (unknown) for the symbol designator
+                        if( reference.find_first_not_of( "0123456789" ) == wxString::npos )
+                            reference.Prepend( "UNK" );
+
+                        nameAttr->name = reference;
+                        m->SetReference( reference );
+                        if( refanceNamePresetInPackageLayout )
+                            m->Reference().SetVisible( true );
+                        break;
+                    }
+                    case EATTR::NAME :
+                        if( refanceNamePresetInPackageLayout )
                         {
-                            wxString reference = e.name;
-
-                            // EAGLE allows references to be single digits.  This breaks KiCad netlisting, which requires
-                            // parts to have non-digit + digit annotation.  If the reference begins with a number,
-                            // we prepend 'UNK' (unknown) for the symbol designator
-                            if( reference.find_first_not_of( "0123456789" ) == wxString::npos )
-                                reference.Prepend( "UNK" );
-
-                            nameAttr->name = reference;
-                            m->SetReference( reference );
-                            if( refanceNamePresetInPackageLayout )
-                                m->Reference().SetVisible( true );
-                            break;
-                        }
-                        case EATTR::NAME :
-                            if( refanceNamePresetInPackageLayout )
-                            {
-                                m->SetReference( "NAME" );
-                                m->Reference().SetVisible( true );
-                            }
-                            break;
-
-                        case EATTR::BOTH :
-                            if( refanceNamePresetInPackageLayout )
-                                m->Reference().SetVisible( true );
-                            nameAttr->name =  nameAttr->name + " = " + e.name;
-                            m->SetReference( "NAME = " + e.name );
-                            break;
-
-                        case EATTR::Off :
-                            m->Reference().SetVisible( false );
-                            break;
-
-                        default:
-                            nameAttr->name =  e.name;
-                            if( refanceNamePresetInPackageLayout )
-                                m->Reference().SetVisible( true );
+                            m->SetReference( "NAME" );
+                            m->Reference().SetVisible( true );
                         }
+                        break;
+
+                    case EATTR::BOTH :
+                        if( refanceNamePresetInPackageLayout )
+                            m->Reference().SetVisible( true );
+                        nameAttr->name =  nameAttr->name + " = " + e.name;
+                        m->SetReference( "NAME = " + e.name );
+                        break;
+
+                    case EATTR::Off :
+                        m->Reference().SetVisible( false );
+                        break;
+
+                    default:
+                        nameAttr->name =  e.name;
+                        if( refanceNamePresetInPackageLayout )
+                            m->Reference().SetVisible( true );
                     }
-                    else
-                        // No display, so default is visible, and show value of NAME
-                        m->Reference().SetVisible( true );
                 }
-                else if( a.name == "VALUE" )
-                {
-                    value = a;
-                    valueAttr = &value;
+                else
+                    // No display, so default is visible, and show value of NAME
+                    m->Reference().SetVisible( true );
+            }
+            else if( a.name == "VALUE" )
+            {
+                value = a;
+                valueAttr = &value;
 
-                    if( a.display  )
+                if( a.display  )
+                {
+                    // Yes!
+                    switch( *a.display )
                     {
-                        // Yes!
-                        switch( *a.display )
-                        {
-                        case EATTR::VALUE :
-                            valueAttr->value = opt_wxString( e.value );
-                            m->SetValue( e.value );
-                            if( valueNamePresetInPackageLayout )
-                                m->Value().SetVisible( true );
-                            break;
-
-                        case EATTR::NAME :
-                            if( valueNamePresetInPackageLayout )
-                                m->Value().SetVisible( true );
-                            m->SetValue( "VALUE" );
-                            break;
-
-                        case EATTR::BOTH :
-                            if( valueNamePresetInPackageLayout )
-                                m->Value().SetVisible( true );
-                            valueAttr->value = opt_wxString( "VALUE = " + e.value );
-                            m->SetValue( "VALUE = " + e.value );
-                            break;
-
-                        case EATTR::Off :
-                            m->Value().SetVisible( false );
-                            break;
-
-                        default:
-                            valueAttr->value = opt_wxString( e.value );
-                            if( valueNamePresetInPackageLayout )
-                                m->Value().SetVisible( true );
-                        }
+                    case EATTR::VALUE :
+                        valueAttr->value = opt_wxString( e.value );
+                        m->SetValue( e.value );
+                        if( valueNamePresetInPackageLayout )
+                            m->Value().SetVisible( true );
+                        break;
+
+                    case EATTR::NAME :
+                        if( valueNamePresetInPackageLayout )
+                            m->Value().SetVisible( true );
+                        m->SetValue( "VALUE" );
+                        break;
+
+                    case EATTR::BOTH :
+                        if( valueNamePresetInPackageLayout )
+                            m->Value().SetVisible( true );
+                        valueAttr->value = opt_wxString( "VALUE = " + e.value );
+                        m->SetValue( "VALUE = " + e.value );
+                        break;
+
+                    case EATTR::Off :
+                        m->Value().SetVisible( false );
+                        break;
+
+                    default:
+                        valueAttr->value = opt_wxString( e.value );
+                        if( valueNamePresetInPackageLayout )
+                            m->Value().SetVisible( true );
                     }
-                    else
-                        // No display, so default is visible, and show value of NAME
-                        m->Value().SetVisible( true );
-
                 }
+                else
+                    // No display, so default is visible, and show value of NAME
+                    m->Value().SetVisible( true );
 
-                attribute = attribute->GetNext();
             }
 
-            m_xpath->pop();     // "attribute"
+            attribute = attribute->GetNext();
         }
 
-        orientModuleAndText( m, e, nameAttr, valueAttr );
+        m_xpath->pop();     // "attribute"
+    }
 
-        // Set the local coordinates for the footprint text items
-        m->Reference().SetLocalCoord();
-        m->Value().SetLocalCoord();
+    orientModuleAndText( m, e, nameAttr, valueAttr );
 
-        // Get next element
-        element = element->GetNext();
-    }
+    // Set the local coordinates for the footprint text items
+    m->Reference().SetLocalCoord();
+    m->Value().SetLocalCoord();
 
     m_xpath->pop();     // "elements.element"
+
+    return m;
+}
+
+
+void EAGLE_PLUGIN::setPadNets( MODULE* aModule, const wxString& aElementName )
+{
+    // update the nets within the pads of the clone
+    for( D_PAD* pad = aModule->PadsList();  pad;  pad = pad->Next() )
+    {
+        wxString pn_key = makeKey( aElementName, pad->GetName() );
+
+        NET_MAP_CITER ni = m_pads_to_nets.find( pn_key );
+        if( ni != m_pads_to_nets.end() )
+        {
+            const ENET* enet = &ni->second;
+            pad->SetNetCode( enet->netcode );
+        }
+    }
 }
 
 
@@ -2005,240 +1966,227 @@ void EAGLE_PLUGIN::deleteTemplates()
 }
 
 
-void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals )
+void EAGLE_PLUGIN::loadSignal( wxXmlNode* aSignal, int& aNetCode )
 {
     ZONES zones;      // per net
 
     m_xpath->push( "signals.signal", "name" );
 
-    int netCode = 1;
-
-    // Get the first signal and iterate
-    wxXmlNode* net = aSignals->GetChildren();
+    bool    sawPad = false;
 
-    while( net )
-    {
-        bool    sawPad = false;
-
-        zones.clear();
+    const wxString& netName = escapeName( aSignal->GetAttribute( "name" ) );
+    m_board->Add( new NETINFO_ITEM( m_board, netName, aNetCode ) );
 
-        const wxString& netName = escapeName( net->GetAttribute( "name" ) );
-        m_board->Add( new NETINFO_ITEM( m_board, netName, netCode ) );
+    m_xpath->Value( netName.c_str() );
 
-        m_xpath->Value( netName.c_str() );
+    // Get the first net item and iterate
+    wxXmlNode* netItem = aSignal->GetChildren();
 
-        // Get the first net item and iterate
-        wxXmlNode* netItem = net->GetChildren();
+    // (contactref | polygon | wire | via)*
+    while( netItem )
+    {
+        const wxString& itemName = netItem->GetName();
 
-        // (contactref | polygon | wire | via)*
-        while( netItem )
+        if( itemName == "wire" )
         {
-            const wxString& itemName = netItem->GetName();
-
-            if( itemName == "wire" )
-            {
-                m_xpath->push( "wire" );
+            m_xpath->push( "wire" );
 
-                EWIRE        w( netItem );
-                PCB_LAYER_ID layer = kicad_layer( w.layer );
+            EWIRE        w( netItem );
+            PCB_LAYER_ID layer = kicad_layer( w.layer );
 
-                if( IsCopperLayer( layer ) )
+            if( IsCopperLayer( layer ) )
+            {
+                wxPoint start( kicad_x( w.x1 ), kicad_y( w.y1 ) );
+                double angle = 0.0;
+                double end_angle = 0.0;
+                double radius = 0.0;
+                double delta_angle = 0.0;
+                wxPoint center;
+
+                int width = w.width.ToPcbUnits();
+                if( width < m_min_trace )
+                    m_min_trace = width;
+
+                if( w.curve )
                 {
-                    wxPoint start( kicad_x( w.x1 ), kicad_y( w.y1 ) );
-                    double angle = 0.0;
-                    double end_angle = 0.0;
-                    double radius = 0.0;
-                    double delta_angle = 0.0;
-                    wxPoint center;
-
-                    int width = w.width.ToPcbUnits();
-                    if( width < m_min_trace )
-                        m_min_trace = width;
-
-                    if( w.curve )
-                    {
-                        center = ConvertArcCenter(
-                                wxPoint( kicad_x( w.x1 ), kicad_y( w.y1 ) ),
-                                wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ),
-                                *w.curve );
-
-                        angle = DEG2RAD( *w.curve );
-
-                        end_angle = atan2( kicad_y( w.y2 ) - center.y,
-                                           kicad_x( w.x2 ) - center.x );
-
-                        radius = sqrt( pow( center.x - kicad_x( w.x1 ), 2 ) +
-                                       pow( center.y - kicad_y( w.y1 ), 2 ) );
-
-                        // If we are curving, we need at least 2 segments otherwise
-                        // delta_angle == angle
-                        int segments = std::max( 2, GetArcToSegmentCount( KiROUND( radius ),
-                                ARC_HIGH_DEF, *w.curve ) - 1 );
-                        delta_angle = angle / segments;
-                    }
+                    center = ConvertArcCenter(
+                            wxPoint( kicad_x( w.x1 ), kicad_y( w.y1 ) ),
+                            wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ),
+                            *w.curve );
 
-                    while( fabs( angle ) > fabs( delta_angle ) )
-                    {
-                        wxASSERT( radius > 0.0 );
-                        wxPoint end( KiROUND( radius * cos( end_angle + angle ) + center.x ),
-                                     KiROUND( radius * sin( end_angle + angle ) + center.y ) );
+                    angle = DEG2RAD( *w.curve );
 
-                        TRACK*  t = new TRACK( m_board );
+                    end_angle = atan2( kicad_y( w.y2 ) - center.y,
+                                       kicad_x( w.x2 ) - center.x );
 
-                        t->SetTimeStamp( EagleTimeStamp( netItem ) + int( RAD2DEG( angle ) ) );
-                        t->SetPosition( start );
-                        t->SetEnd( end );
-                        t->SetWidth( width );
-                        t->SetLayer( layer );
-                        t->SetNetCode( netCode );
+                    radius = sqrt( pow( center.x - kicad_x( w.x1 ), 2 ) +
+                                   pow( center.y - kicad_y( w.y1 ), 2 ) );
 
-                        m_board->m_Track.PushBack( t );
+                    // If we are curving, we need at least 2 segments otherwise
+                    // delta_angle == angle
+                    int segments = std::max( 2, GetArcToSegmentCount( KiROUND( radius ),
+                            ARC_HIGH_DEF, *w.curve ) - 1 );
+                    delta_angle = angle / segments;
+                }
 
-                        start = end;
-                        angle -= delta_angle;
-                    }
+                while( fabs( angle ) > fabs( delta_angle ) )
+                {
+                    wxASSERT( radius > 0.0 );
+                    wxPoint end( KiROUND( radius * cos( end_angle + angle ) + center.x ),
+                                 KiROUND( radius * sin( end_angle + angle ) + center.y ) );
 
                     TRACK*  t = new TRACK( m_board );
 
-                    t->SetTimeStamp( EagleTimeStamp( netItem ) );
+                    t->SetTimeStamp( EagleTimeStamp( netItem ) + int( RAD2DEG( angle ) ) );
                     t->SetPosition( start );
-                    t->SetEnd( wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ) );
+                    t->SetEnd( end );
                     t->SetWidth( width );
                     t->SetLayer( layer );
-                    t->SetNetCode( netCode );
+                    t->SetNetCode( aNetCode );
 
                     m_board->m_Track.PushBack( t );
-                }
-                else
-                {
-                    // put non copper wires where the sun don't shine.
+
+                    start = end;
+                    angle -= delta_angle;
                 }
 
-                m_xpath->pop();
-            }
+                TRACK*  t = new TRACK( m_board );
 
-            else if( itemName == "via" )
+                t->SetTimeStamp( EagleTimeStamp( netItem ) );
+                t->SetPosition( start );
+                t->SetEnd( wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ) );
+                t->SetWidth( width );
+                t->SetLayer( layer );
+                t->SetNetCode( aNetCode );
+
+                m_board->m_Track.PushBack( t );
+            }
+            else
             {
-                m_xpath->push( "via" );
-                EVIA    v( netItem );
+                // put non copper wires where the sun don't shine.
+            }
 
-                PCB_LAYER_ID  layer_front_most = kicad_layer( v.layer_front_most );
-                PCB_LAYER_ID  layer_back_most  = kicad_layer( v.layer_back_most );
+            m_xpath->pop();
+        }
 
-                if( IsCopperLayer( layer_front_most ) &&
-                    IsCopperLayer( layer_back_most ) )
-                {
-                    int  kidiam;
-                    int  drillz = v.drill.ToPcbUnits();
-                    VIA* via = new VIA( m_board );
-                    m_board->m_Track.PushBack( via );
+        else if( itemName == "via" )
+        {
+            m_xpath->push( "via" );
+            EVIA    v( netItem );
 
-                    via->SetLayerPair( layer_front_most, layer_back_most );
+            PCB_LAYER_ID  layer_front_most = kicad_layer( v.layer_front_most );
+            PCB_LAYER_ID  layer_back_most  = kicad_layer( v.layer_back_most );
 
-                    if( v.diam )
-                    {
-                        kidiam = v.diam->ToPcbUnits();
-                        via->SetWidth( kidiam );
-                    }
-                    else
-                    {
-                        double annulus = drillz * m_rules->rvViaOuter;  // eagle "restring"
-                        annulus = eagleClamp( m_rules->rlMinViaOuter, annulus,
-                                              m_rules->rlMaxViaOuter );
-                        kidiam = KiROUND( drillz + 2 * annulus );
-                        via->SetWidth( kidiam );
-                    }
+            if( IsCopperLayer( layer_front_most ) &&
+                IsCopperLayer( layer_back_most ) )
+            {
+                int  kidiam;
+                int  drillz = v.drill.ToPcbUnits();
+                VIA* via = new VIA( m_board );
+                m_board->m_Track.PushBack( via );
 
-                    via->SetDrill( drillz );
+                via->SetLayerPair( layer_front_most, layer_back_most );
 
-                    // make sure the via diameter respects the restring rules
+                if( v.diam )
+                {
+                    kidiam = v.diam->ToPcbUnits();
+                    via->SetWidth( kidiam );
+                }
+                else
+                {
+                    double annulus = drillz * m_rules->rvViaOuter;  // eagle "restring"
+                    annulus = eagleClamp( m_rules->rlMinViaOuter, annulus,
+                                          m_rules->rlMaxViaOuter );
+                    kidiam = KiROUND( drillz + 2 * annulus );
+                    via->SetWidth( kidiam );
+                }
 
-                    if( !v.diam || via->GetWidth() <= via->GetDrill() )
-                    {
-                        double annulus = eagleClamp( m_rules->rlMinViaOuter,
-                                (double)( via->GetWidth() / 2 - via->GetDrill() ),
-                                m_rules->rlMaxViaOuter );
-                        via->SetWidth( drillz + 2 * annulus );
-                    }
+                via->SetDrill( drillz );
 
-                    if( kidiam < m_min_via )
-                        m_min_via = kidiam;
+                // make sure the via diameter respects the restring rules
 
-                    if( drillz < m_min_via_hole )
-                        m_min_via_hole = drillz;
+                if( !v.diam || via->GetWidth() <= via->GetDrill() )
+                {
+                    double annulus = eagleClamp( m_rules->rlMinViaOuter,
+                            (double)( via->GetWidth() / 2 - via->GetDrill() ),
+                            m_rules->rlMaxViaOuter );
+                    via->SetWidth( drillz + 2 * annulus );
+                }
 
-                    if( layer_front_most == F_Cu && layer_back_most == B_Cu )
-                        via->SetViaType( VIA_THROUGH );
-                    else if( layer_front_most == F_Cu || layer_back_most == B_Cu )
-                        via->SetViaType( VIA_MICROVIA );
-                    else
-                        via->SetViaType( VIA_BLIND_BURIED );
+                if( kidiam < m_min_via )
+                    m_min_via = kidiam;
 
-                    via->SetTimeStamp( EagleTimeStamp( netItem ) );
+                if( drillz < m_min_via_hole )
+                    m_min_via_hole = drillz;
 
-                    wxPoint pos( kicad_x( v.x ), kicad_y( v.y ) );
+                if( layer_front_most == F_Cu && layer_back_most == B_Cu )
+                    via->SetViaType( VIA_THROUGH );
+                else if( layer_front_most == F_Cu || layer_back_most == B_Cu )
+                    via->SetViaType( VIA_MICROVIA );
+                else
+                    via->SetViaType( VIA_BLIND_BURIED );
 
-                    via->SetPosition( pos  );
-                    via->SetEnd( pos );
+                via->SetTimeStamp( EagleTimeStamp( netItem ) );
 
-                    via->SetNetCode( netCode );
-                }
+                wxPoint pos( kicad_x( v.x ), kicad_y( v.y ) );
 
-                m_xpath->pop();
+                via->SetPosition( pos  );
+                via->SetEnd( pos );
+
+                via->SetNetCode( aNetCode );
             }
 
-            else if( itemName == "contactref" )
-            {
-                m_xpath->push( "contactref" );
-                // <contactref element="RN1" pad="7"/>
+            m_xpath->pop();
+        }
 
-                const wxString& reference = netItem->GetAttribute( "element" );
-                const wxString& pad       = netItem->GetAttribute( "pad" );
-                wxString key = makeKey( reference, pad ) ;
+        else if( itemName == "contactref" )
+        {
+            m_xpath->push( "contactref" );
+            // <contactref element="RN1" pad="7"/>
 
-                // D(printf( "adding refname:'%s' pad:'%s' netcode:%d netname:'%s'\n", reference.c_str(), pad.c_str(), netCode, netName.c_str() );)
+            const wxString& reference = netItem->GetAttribute( "element" );
+            const wxString& pad       = netItem->GetAttribute( "pad" );
+            wxString key = makeKey( reference, pad ) ;
 
-                m_pads_to_nets[ key ] = ENET( netCode, netName );
+            // D(printf( "adding refname:'%s' pad:'%s' netcode:%d netname:'%s'\n", reference.c_str(), pad.c_str(), aNetCode, netName.c_str() );)
 
-                m_xpath->pop();
+            m_pads_to_nets[ key ] = ENET( aNetCode, netName );
 
-                sawPad = true;
-            }
+            m_xpath->pop();
 
-            else if( itemName == "polygon" )
-            {
-                m_xpath->push( "polygon" );
-                auto* zone = loadPolygon( netItem );
+            sawPad = true;
+        }
 
-                if( zone )
-                {
-                    zones.push_back( zone );
+        else if( itemName == "polygon" )
+        {
+            m_xpath->push( "polygon" );
+            auto* zone = loadPolygon( netItem );
 
-                    if( !zone->GetIsKeepout() )
-                        zone->SetNetCode( netCode );
-                }
+            if( zone )
+            {
+                zones.push_back( zone );
 
-                m_xpath->pop();     // "polygon"
+                if( !zone->GetIsKeepout() )
+                    zone->SetNetCode( aNetCode );
             }
 
-            netItem = netItem->GetNext();
+            m_xpath->pop();     // "polygon"
         }
 
-        if( zones.size() && !sawPad )
-        {
-            // KiCad does not support an unconnected zone with its own non-zero netcode,
-            // but only when assigned netcode = 0 w/o a name...
-            for( ZONES::iterator it = zones.begin();  it != zones.end();  ++it )
-                (*it)->SetNetCode( NETINFO_LIST::UNCONNECTED );
+        netItem = netItem->GetNext();
+    }
 
-            // therefore omit this signal/net.
-        }
-        else
-            netCode++;
+    if( zones.size() && !sawPad )
+    {
+        // KiCad does not support an unconnected zone with its own non-zero netcode,
+        // but only when assigned netcode = 0 w/o a name...
+        for( ZONES::iterator it = zones.begin();  it != zones.end();  ++it )
+            (*it)->SetNetCode( NETINFO_LIST::UNCONNECTED );
 
-        // Get next signal
-        net = net->GetNext();
+        // therefore omit this signal/net.
     }
+    else
+        aNetCode++;
 
     m_xpath->pop();     // "signals.signal"
 }
@@ -2378,7 +2326,6 @@ void EAGLE_PLUGIN::cacheLib( const wxString& aLibPath )
 
         if( aLibPath != m_lib_path || load )
         {
-            wxXmlNode*  doc;
             LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
             deleteTemplates();
@@ -2393,31 +2340,34 @@ void EAGLE_PLUGIN::cacheLib( const wxString& aLibPath )
             // and is not necessarily utf8.
             string filename = (const char*) aLibPath.char_str( wxConvFile );
 
-            // Load the document
-            wxXmlDocument xmlDocument;
+            // Read the document as a stream, the layers come before the library
             wxFileName fn( filename );
-
-            if( !xmlDocument.Load( fn.GetFullPath() ) )
-                THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ),
-                                                  fn.GetFullPath() ) );
-
-            doc = xmlDocument.GetRoot();
-
-            wxXmlNode* drawing       = MapChildren( doc )["drawing"];
-            NODE_MAP drawingChildren = MapChildren( drawing );
+            XML_STREAM_PARSER parser( fn.GetFullPath() );
 
             // clear the cu map and then rebuild it.
             clear_cu_map();
 
-            m_xpath->push( "eagle.drawing.layers" );
-            wxXmlNode* layers  = drawingChildren["layers"];
-            loadLayerDefs( layers );
-            m_xpath->pop();
-
-            m_xpath->push( "eagle.drawing.library" );
-            wxXmlNode* library = drawingChildren["library"];
-            loadLibrary( library, NULL );
-            m_xpath->pop();
+            parser.Parse(
+                    []( const wxString& aPath, const wxXmlNode& )
+                    {
+                        return aPath == "eagle.drawing.layers"
+                               || aPath == "eagle.drawing.library.packages.package";
+                    },
+                    [this]( const wxString& aPath, wxXmlNode* aElement )
+                    {
+                        if( aPath == "eagle.drawing.layers" )
+                        {
+                            m_xpath->push( "eagle.drawing.layers" );
+                            loadLayerDefs( aElement );
+                            m_xpath->pop();
+                        }
+                        else
+                        {
+                            m_xpath->push( "eagle.drawing.library" );
+                            loadPackage( aElement, NULL );
+                            m_xpath->pop();
+                        }
+                    } );
 
             m_mod_time = modtime;
         }
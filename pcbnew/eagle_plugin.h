@@ -34,6 +34,7 @@
 
 class D_PAD;
 class TEXTE_MODULE;
+class XML_STREAM_PARSER;
 
 typedef std::map<wxString, MODULE*>  MODULE_MAP;
 typedef std::vector<ZONE_CONTAINER*> ZONES;
@@ -219,27 +220,48 @@ private:
 
     // all these loadXXX() throw IO_ERROR or ptree_error exceptions:
 
-    void loadAllSections( wxXmlNode* aDocument );
+    /**
+     * Function loadAllSections
+     * converts the board document.  The document is streamed: the items are converted one
+     * at a time as they are read, so the document is never held in memory as a whole.
+     */
+    void loadAllSections( XML_STREAM_PARSER& aParser );
     void loadDesignRules( wxXmlNode* aDesignRules );
     void loadLayerDefs( wxXmlNode* aLayers );
-    void loadPlain( wxXmlNode* aPlain );
-    void loadSignals( wxXmlNode* aSignals );
+
+    /// Loads one of the (polygon | wire | text | circle | rectangle | frame | hole) items
+    /// found in the "plain" element.
+    void loadPlainGraphic( wxXmlNode* aGraphic );
 
     /**
-     * Function loadLibrary
-     * loads the Eagle "library" XML element, which can occur either under
-     * a "libraries" element (if a *.brd file) or under a "drawing" element if a
-     * *.lbr file.
-     * @param aLib is the portion of the loaded XML document tree that is the "library"
-     *   element.
+     * Function loadSignal
+     * loads an Eagle "signal" element: its net, tracks, vias and zones.  The pads connected
+     * to it are recorded in m_pads_to_nets.
+     * @param aNetCode is the net code to give to the signal, incremented if it was used.
+     */
+    void loadSignal( wxXmlNode* aSignal, int& aNetCode );
+
+    /**
+     * Function loadPackage
+     * loads an Eagle "package" element into a MODULE template, stored in m_templates.  The
+     * packages are found in the "library" elements, either under a "libraries" element
+     * (if a *.brd file) or under the "drawing" element if a *.lbr file.
+     * @param aPackage is the "package" element.
      * @param aLibName is a pointer to the library name or NULL.  If NULL this means
      *   we are loading a *.lbr not a *.brd file and the key used in m_templates is to exclude
      *   the library name.
      */
-    void loadLibrary( wxXmlNode* aLib, const wxString* aLibName );
+    void loadPackage( wxXmlNode* aPackage, const wxString* aLibName );
+
+    /**
+     * Function loadElement
+     * adds the MODULE of an Eagle "element" to the board, from its package template.
+     * The nets of the pads are set afterwards by setPadNets().
+     */
+    MODULE* loadElement( wxXmlNode* aElement );
 
-    void loadLibraries( wxXmlNode* aLibs );
-    void loadElements( wxXmlNode* aElements );
+    /// Sets the nets of the pads of an element, from m_pads_to_nets.
+    void setPadNets( MODULE* aModule, const wxString& aElementName );
 
     /** Loads a copper or keepout polygon and adds it to the board.
      *
@@ -0,0 +1,535 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drill_path_optimizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace
+{
+
+// Number of nearest neighbours of a hole tried by the 2-opt and Or-opt moves
+const int NEIGHBOUR_COUNT = 8;
+
+// Longest chain of holes moved by an Or-opt move
+const int MAX_OR_OPT_LENGTH = 3;
+
+// Smallest gain (in internal units) of an accepted move, to stop on rounding noise
+const double MIN_GAIN = 0.5;
+
+
+/**
+ * The open path is handled as a closed tour including a dummy point, at a null distance from
+ * all holes: the holes next to the dummy point are the ends of the path. This allows the
+ * usual 2-opt moves to reverse the shortest side of the tour.
+ */
+class PATH_OPTIMIZER
+{
+public:
+    PATH_OPTIMIZER( const std::vector<wxPoint>& aPoints,
+                    std::chrono::steady_clock::time_point aDeadline ) :
+        m_points( aPoints ),
+        m_count( aPoints.size() ),
+        m_dummy( aPoints.size() ),
+        m_deadline( aDeadline ),
+        m_cellSize( 1.0 ),
+        m_cols( 1 ),
+        m_rows( 1 )
+    {
+    }
+
+    std::vector<int> Run()
+    {
+        buildGrid();
+        buildNeighbours();
+        buildInitialTour();
+
+        bool improved = true;
+
+        while( improved && !timeout() )
+        {
+            improved = false;
+
+            for( int node = 0; node < m_count; ++node )
+            {
+                if( ( node % 256 ) == 0 && timeout() )
+                    break;
+
+                if( twoOpt( node ) )
+                    improved = true;
+
+                if( orOpt( node ) )
+                    improved = true;
+            }
+        }
+
+        std::vector<int> order;
+        int size  = m_tour.size();
+        int start = m_pos[m_dummy];
+
+        order.reserve( m_count );
+
+        for( int ii = 1; ii < size; ++ii )
+            order.push_back( m_tour[( start + ii ) % size] );
+
+        return order;
+    }
+
+private:
+    bool timeout() const
+    {
+        return std::chrono::steady_clock::now() > m_deadline;
+    }
+
+    double dist( int a, int b ) const
+    {
+        if( a == m_dummy || b == m_dummy )
+            return 0.0;
+
+        return std::hypot( double( m_points[a].x - m_points[b].x ),
+                           double( m_points[a].y - m_points[b].y ) );
+    }
+
+    int succ( int aNode ) const
+    {
+        return m_tour[( m_pos[aNode] + 1 ) % m_tour.size()];
+    }
+
+    int pred( int aNode ) const
+    {
+        return m_tour[( m_pos[aNode] + m_tour.size() - 1 ) % m_tour.size()];
+    }
+
+    int cellIndex( const wxPoint& aPoint ) const
+    {
+        int col = std::min( int( ( aPoint.x - m_origin.x ) / m_cellSize ), m_cols - 1 );
+        int row = std::min( int( ( aPoint.y - m_origin.y ) / m_cellSize ), m_rows - 1 );
+
+        return row * m_cols + col;
+    }
+
+    /**
+     * Calls aFunc for the cells at the Chebyshev distance aRing of the cell aCell.
+     * The points of these cells are at least at ( aRing - 1 ) * m_cellSize from the points
+     * of aCell.
+     */
+    template <typename FUNC>
+    void forRing( int aCell, int aRing, FUNC aFunc ) const
+    {
+        int col = aCell % m_cols;
+        int row = aCell / m_cols;
+
+        for( int y = row - aRing; y <= row + aRing; ++y )
+        {
+            if( y < 0 || y >= m_rows )
+                continue;
+
+            int step = ( y == row - aRing || y == row + aRing ) ? 1 : 2 * aRing;
+
+            for( int x = col - aRing; x <= col + aRing; x += step )
+            {
+                if( x >= 0 && x < m_cols )
+                    aFunc( y * m_cols + x );
+            }
+        }
+    }
+
+    void buildGrid()
+    {
+        wxPoint lo = m_points[0];
+        wxPoint hi = m_points[0];
+
+        for( const wxPoint& pt : m_points )
+        {
+            lo.x = std::min( lo.x, pt.x );
+            lo.y = std::min( lo.y, pt.y );
+            hi.x = std::max( hi.x, pt.x );
+            hi.y = std::max( hi.y, pt.y );
+        }
+
+        // About 2 holes per cell, and no more cells than holes along one axis
+        double w = double( hi.x ) - lo.x;
+        double h = double( hi.y ) - lo.y;
+
+        m_cellSize = std::max( { std::sqrt( w * h * 2.0 / m_count ), std::max( w, h ) / m_count,
+                                 1.0 } );
+        m_origin = lo;
+        m_cols = int( w / m_cellSize ) + 1;
+        m_rows = int( h / m_cellSize ) + 1;
+        m_cells.assign( m_cols * m_rows, std::vector<int>() );
+
+        for( int ii = 0; ii < m_count; ++ii )
+            m_cells[cellIndex( m_points[ii] )].push_back( ii );
+    }
+
+    void buildNeighbours()
+    {
+        int count = std::min( NEIGHBOUR_COUNT, m_count - 1 );
+        int maxRing = std::max( m_cols, m_rows );
+        std::vector<std::pair<double, int>> candidates;
+
+        m_neighbours.assign( m_count * NEIGHBOUR_COUNT, -1 );
+
+        for( int ii = 0; ii < m_count; ++ii )
+        {
+            int cell = cellIndex( m_points[ii] );
+
+            candidates.clear();
+
+            for( int ring = 0; ring <= maxRing; ++ring )
+            {
+                forRing( cell, ring, [&]( int aCell )
+                {
+                    for( int jj : m_cells[aCell] )
+                    {
+                        if( jj != ii )
+                            candidates.emplace_back( dist( ii, jj ), jj );
+                    }
+                } );
+
+                if( (int) candidates.size() >= count )
+                {
+                    std::nth_element( candidates.begin(), candidates.begin() + count - 1,
+                                      candidates.end() );
+
+                    if( candidates[count - 1].first <= ring * m_cellSize )
+                        break;
+                }
+            }
+
+            std::partial_sort( candidates.begin(), candidates.begin() + count, candidates.end() );
+
+            for( int kk = 0; kk < count; ++kk )
+                m_neighbours[ii * NEIGHBOUR_COUNT + kk] = candidates[kk].second;
+        }
+    }
+
+    ///> Nearest neighbour tour, starting from the first hole
+    void buildInitialTour()
+    {
+        std::vector<std::vector<int>> cells = m_cells;
+        std::vector<bool> visited( m_count, false );
+        int maxRing = std::max( m_cols, m_rows );
+        int current = 0;
+
+        auto visit = [&]( int aNode )
+        {
+            std::vector<int>& cell = cells[cellIndex( m_points[aNode] )];
+
+            cell.erase( std::find( cell.begin(), cell.end(), aNode ) );
+            visited[aNode] = true;
+            m_tour.push_back( aNode );
+        };
+
+        m_tour.clear();
+        m_tour.reserve( m_count + 1 );
+        visit( current );
+
+        while( (int) m_tour.size() < m_count && !timeout() )
+        {
+            int    cell = cellIndex( m_points[current] );
+            int    best = -1;
+            double bestDist = std::numeric_limits<double>::max();
+
+            for( int ring = 0; ring <= maxRing; ++ring )
+            {
+                forRing( cell, ring, [&]( int aCell )
+                {
+                    for( int node : cells[aCell] )
+                    {
+                        double d = dist( current, node );
+
+                        if( d < bestDist )
+                        {
+                            bestDist = d;
+                            best = node;
+                        }
+                    }
+                } );
+
+                if( best >= 0 && bestDist <= ring * m_cellSize )
+                    break;
+            }
+
+            visit( best );
+            current = best;
+        }
+
+        // Out of time: keep the initial order for the remaining holes
+        for( int ii = 0; ii < m_count; ++ii )
+        {
+            if( !visited[ii] )
+                m_tour.push_back( ii );
+        }
+
+        m_tour.push_back( m_dummy );
+        m_pos.resize( m_tour.size() );
+
+        for( size_t ii = 0; ii < m_tour.size(); ++ii )
+            m_pos[m_tour[ii]] = ii;
+    }
+
+    ///> Reverses the part of the tour from position aFirst to aLast (cyclic)
+    void reverse( int aFirst, int aLast )
+    {
+        int size = m_tour.size();
+        int len = ( aLast - aFirst + size ) % size + 1;
+
+        // Reversing the other side gives the same tour
+        if( 2 * len > size )
+        {
+            int first = ( aLast + 1 ) % size;
+            aLast = ( aFirst + size - 1 ) % size;
+            aFirst = first;
+            len = size - len;
+        }
+
+        for( int ii = 0; ii < len / 2; ++ii )
+        {
+            int a = ( aFirst + ii ) % size;
+            int b = ( aLast - ii + size ) % size;
+
+            std::swap( m_tour[a], m_tour[b] );
+            m_pos[m_tour[a]] = a;
+            m_pos[m_tour[b]] = b;
+        }
+    }
+
+    /**
+     * Tries to replace the edges ( aNode, b ) and ( c, d ) by ( aNode, c ) and ( b, d ), where
+     * c is a neighbour of aNode and b follows (or precedes) aNode.
+     */
+    bool twoOpt( int aNode )
+    {
+        for( int forward = 0; forward < 2; ++forward )
+        {
+            int    b = forward ? succ( aNode ) : pred( aNode );
+            double dab = dist( aNode, b );
+
+            for( int kk = 0; kk < NEIGHBOUR_COUNT; ++kk )
+            {
+                int c = m_neighbours[aNode * NEIGHBOUR_COUNT + kk];
+
+                if( c < 0 )
+                    break;
+
+                double dac = dist( aNode, c );
+
+                if( dab - dac <= MIN_GAIN )
+                    break;
+
+                int d = forward ? succ( c ) : pred( c );
+
+                if( c == b || d == aNode )
+                    continue;
+
+                if( dab - dac + dist( c, d ) - dist( b, d ) > MIN_GAIN )
+                {
+                    if( forward )
+                        reverse( m_pos[b], m_pos[c] );
+                    else
+                        reverse( m_pos[c], m_pos[b] );
+
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Tries to move the chain of up to MAX_OR_OPT_LENGTH holes starting at aNode next to a
+     * neighbour of one of its ends, in either direction.
+     */
+    bool orOpt( int aNode )
+    {
+        int size = m_tour.size();
+
+        for( int len = 1; len <= MAX_OR_OPT_LENGTH && len + 3 <= size; ++len )
+        {
+            int first = m_pos[aNode];
+            int last = first + len - 1;
+
+            // Chains wrapping around the end of m_tour are not moved
+            if( last >= size )
+                break;
+
+            int    s = aNode;
+            int    e = m_tour[last];
+            int    p = pred( s );
+            int    q = succ( e );
+            double removeGain = dist( p, s ) + dist( e, q ) - dist( p, q );
+
+            if( removeGain <= MIN_GAIN )
+                continue;
+
+            auto inChain = [&]( int aOther )
+            {
+                return m_pos[aOther] >= first && m_pos[aOther] <= last;
+            };
+
+            for( int end = 0; end < 2; ++end )
+            {
+                int x = end == 0 ? s : e;
+
+                if( x == m_dummy )
+                    continue;
+
+                for( int kk = 0; kk < NEIGHBOUR_COUNT; ++kk )
+                {
+                    int c = m_neighbours[x * NEIGHBOUR_COUNT + kk];
+
+                    if( c < 0 || dist( x, c ) >= removeGain )
+                        break;
+
+                    if( inChain( c ) )
+                        continue;
+
+                    // Insert between c and its successor, or between its predecessor and c
+                    for( int side = 0; side < 2; ++side )
+                    {
+                        int c1 = side == 0 ? c : pred( c );
+                        int c2 = side == 0 ? succ( c ) : c;
+
+                        if( inChain( c1 ) || inChain( c2 ) )
+                            continue;
+
+                        double base = dist( c1, c2 );
+                        double keep = dist( c1, s ) + dist( e, c2 ) - base;
+                        double flip = dist( c1, e ) + dist( s, c2 ) - base;
+
+                        if( removeGain - std::min( keep, flip ) > MIN_GAIN )
+                        {
+                            moveChain( first, len, c1, flip < keep );
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    ///> Moves the aLen holes at aFirst after the node aAfter, reversed if aReverse is true
+    void moveChain( int aFirst, int aLen, int aAfter, bool aReverse )
+    {
+        int last = aFirst + aLen - 1;
+        int afterPos = m_pos[aAfter];
+        int lo, hi, chain;
+
+        if( afterPos > last )
+        {
+            std::rotate( m_tour.begin() + aFirst, m_tour.begin() + last + 1,
+                         m_tour.begin() + afterPos + 1 );
+            lo = aFirst;
+            hi = afterPos;
+            chain = afterPos - aLen + 1;
+        }
+        else
+        {
+            std::rotate( m_tour.begin() + afterPos + 1, m_tour.begin() + aFirst,
+                         m_tour.begin() + last + 1 );
+            lo = afterPos + 1;
+            hi = last;
+            chain = afterPos + 1;
+        }
+
+        if( aReverse )
+            std::reverse( m_tour.begin() + chain, m_tour.begin() + chain + aLen );
+
+        for( int ii = lo; ii <= hi; ++ii )
+            m_pos[m_tour[ii]] = ii;
+    }
+
+    const std::vector<wxPoint>&           m_points;
+    int                                   m_count;
+    int                                   m_dummy;
+    std::chrono::steady_clock::time_point m_deadline;
+
+    // Spatial grid used to find the nearest holes
+    wxPoint                       m_origin;
+    double                        m_cellSize;
+    int                           m_cols;
+    int                           m_rows;
+    std::vector<std::vector<int>> m_cells;
+
+    std::vector<int> m_neighbours;  ///< NEIGHBOUR_COUNT nearest holes of each hole, or -1
+    std::vector<int> m_tour;        ///< holes and dummy point, in visit order
+    std::vector<int> m_pos;         ///< position in m_tour of each hole and the dummy point
+};
+
+}
+
+
+double DrillPathLength( const std::vector<wxPoint>& aPoints, const std::vector<int>& aOrder )
+{
+    double length = 0.0;
+    size_t count = aOrder.empty() ? aPoints.size() : aOrder.size();
+
+    for( size_t ii = 1; ii < count; ++ii )
+    {
+        const wxPoint& a = aPoints[aOrder.empty() ? ii - 1 : aOrder[ii - 1]];
+        const wxPoint& b = aPoints[aOrder.empty() ? ii : aOrder[ii]];
+
+        length += std::hypot( double( a.x - b.x ), double( a.y - b.y ) );
+    }
+
+    return length;
+}
+
+
+std::vector<int> OptimizeDrillPath( const std::vector<wxPoint>& aPoints,
+                                    std::chrono::steady_clock::time_point aDeadline )
+{
+    std::vector<int> order( aPoints.size() );
+
+    for( size_t ii = 0; ii < order.size(); ++ii )
+        order[ii] = ii;
+
+    if( aPoints.size() < 3 )
+        return order;
+
+    PATH_OPTIMIZER   optimizer( aPoints, aDeadline );
+    std::vector<int> path = optimizer.Run();
+
+    // Start from the end nearest to the first hole, like the initial path
+    const wxPoint& start = aPoints[0];
+
+    if( std::hypot( double( aPoints[path.back()].x - start.x ),
+                    double( aPoints[path.back()].y - start.y ) )
+        < std::hypot( double( aPoints[path.front()].x - start.x ),
+                      double( aPoints[path.front()].y - start.y ) ) )
+    {
+        std::reverse( path.begin(), path.end() );
+    }
+
+    if( DrillPathLength( aPoints, path ) < DrillPathLength( aPoints, order ) )
+        return path;
+
+    return order;
+}
@@ -0,0 +1,56 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file drill_path_optimizer.h
+ * @brief shortening of the path of a drill tool visiting a set of holes.
+ */
+
+#ifndef DRILL_PATH_OPTIMIZER_H
+#define DRILL_PATH_OPTIMIZER_H
+
+#include <chrono>
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+/**
+ * Function DrillPathLength
+ * @return the length of the path visiting aPoints in the order given by aOrder
+ * (indexes in aPoints), or in the aPoints order if aOrder is empty.
+ */
+double DrillPathLength( const std::vector<wxPoint>& aPoints,
+                        const std::vector<int>& aOrder = std::vector<int>() );
+
+/**
+ * Function OptimizeDrillPath
+ * Finds a short open path visiting all aPoints: the path built by the nearest neighbour
+ * heuristic is improved by 2-opt and Or-opt moves until no move shortens it, or until
+ * aDeadline.
+ * The path is never longer than the path visiting aPoints in their order.
+ * @return the indexes in aPoints, in visit order.
+ */
+std::vector<int> OptimizeDrillPath( const std::vector<wxPoint>& aPoints,
+                                    std::chrono::steady_clock::time_point aDeadline );
+
+#endif      // DRILL_PATH_OPTIMIZER_H
@@ -24,10 +24,16 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <wx/dir.h>
 
@@ -61,15 +67,7 @@
 // offset for plating
 #define  PLATE_OFFSET 0.005
 
-static S3D_CACHE* cache;
-static bool USE_INLINES;            // true to use legacy inline{} behavior
-static bool USE_DEFS;               // true to reuse component definitions
-static bool USE_RELPATH;            // true to use relative paths in VRML inline{}
-static double WORLD_SCALE = 1.0;    // scaling from 0.1 in to desired VRML unit
-static double BOARD_SCALE;          // scaling from mm to desired VRML world scale
 static const int PRECISION = 6;     // legacy precision factor (now set to 6)
-static wxString SUBDIR_3D;          // legacy 3D subdirectory
-static wxString PROJ_DIR;           // project directory
 
 struct VRML_COLOR
 {
@@ -138,9 +136,22 @@ enum VRML_COLOR_INDEX
     VRML_COLOR_LAST
 };
 
-static VRML_COLOR colors[VRML_COLOR_LAST];
-static SGNODE* sgmaterial[VRML_COLOR_LAST] = { NULL };
+// a 3D model used by the footprints, loaded once and shared by all its instances
+struct VRML_MODEL_ENTRY
+{
+    SGNODE*     m_node;         // the loaded model, or NULL if it is not usable
+    wxString    m_url;          // inline mode: url of the model in the 3D subdirectory
+    wxString    m_defName;      // inline mode: name of the Inline node of the model
+    bool        m_defined;      // inline mode: true once the Inline node has been written
+
+    VRML_MODEL_ENTRY() : m_node( NULL ), m_defined( false ) {}
+};
 
+
+/**
+ * MODEL_VRML
+ * holds the whole state of a VRML export, so several boards can be exported at once.
+ */
 class MODEL_VRML
 {
 private:
@@ -149,7 +160,18 @@ private:
     int         m_iMaxSeg;                  // max. sides to a small circle
     double      m_arcMinLen, m_arcMaxLen;   // min and max lengths of an arc chord
 
+    VRML_COLOR  m_colors[VRML_COLOR_LAST];
+    SGNODE*     m_sgmaterial[VRML_COLOR_LAST];
+
 public:
+    S3D_CACHE*  m_cache;
+    bool        m_useInlines;       // true to use legacy inline{} behavior
+    bool        m_useDefs;          // true to reuse component definitions
+    bool        m_useRelPath;       // true to use relative paths in VRML inline{}
+    double      m_worldScale;       // scaling from 0.1 in to desired VRML unit
+    double      m_boardScale;       // scaling from mm to desired VRML world scale
+    wxString    m_subdir3D;         // legacy 3D subdirectory
+
     IFSG_TRANSFORM m_OutputPCB;
     VRML_LAYER  m_holes;
     VRML_LAYER  m_board;
@@ -161,8 +183,14 @@ public:
     VRML_LAYER  m_bot_tin;
     VRML_LAYER  m_plated_holes;
 
+    // copies of m_holes for the layers tesselated at the same time as m_board
+    std::vector< std::unique_ptr<VRML_LAYER> > m_layerHoles;
+
     std::list< SGNODE* > m_components;
 
+    // the 3D models of the footprints, by file name
+    std::map< wxString, VRML_MODEL_ENTRY > m_models;
+
     bool m_plainPCB;
 
     double m_minLineWidth;    // minimum width of a VRML line segment
@@ -185,17 +213,27 @@ public:
         // this default only makes sense if the output is in mm
         m_brd_thickness = 1.6;
 
+        for( int j = 0; j < VRML_COLOR_LAST; ++j )
+            m_sgmaterial[j] = NULL;
+
+        m_cache = NULL;
+        m_useInlines = false;
+        m_useDefs = true;
+        m_useRelPath = false;
+        m_worldScale = 1.0;
+        m_boardScale = MM_PER_IU;
+
         // pcb green
-        colors[ VRML_COLOR_PCB ]    = VRML_COLOR( .07, .3, .12, .01, .03, .01,
+        m_colors[ VRML_COLOR_PCB ]    = VRML_COLOR( .07, .3, .12, .01, .03, .01,
                                                   0, 0, 0, 0.8, 0, 0.02 );
         // track green
-        colors[ VRML_COLOR_TRACK ]  = VRML_COLOR( .08, .5, .1, .01, .05, .01,
+        m_colors[ VRML_COLOR_TRACK ]  = VRML_COLOR( .08, .5, .1, .01, .05, .01,
                                                   0, 0, 0, 0.8, 0, 0.02 );
         // silkscreen white
-        colors[ VRML_COLOR_SILK ]   = VRML_COLOR( .9, .9, .9, .1, .1, .1,
+        m_colors[ VRML_COLOR_SILK ]   = VRML_COLOR( .9, .9, .9, .1, .1, .1,
                                                   0, 0, 0, 0.9, 0, 0.02 );
         // pad silver
-        colors[ VRML_COLOR_TIN ]    = VRML_COLOR( .749, .756, .761, .749, .756, .761,
+        m_colors[ VRML_COLOR_TIN ]    = VRML_COLOR( .749, .756, .761, .749, .756, .761,
                                                   0, 0, 0, 0.8, 0, 0.8 );
 
         m_plainPCB = false;
@@ -210,10 +248,10 @@ public:
         // destroy any unassociated material appearances
         for( int j = 0; j < VRML_COLOR_LAST; ++j )
         {
-            if( sgmaterial[j] && NULL == S3D::GetSGNodeParent( sgmaterial[j] ) )
-                S3D::DestroyNode( sgmaterial[j] );
+            if( m_sgmaterial[j] && NULL == S3D::GetSGNodeParent( m_sgmaterial[j] ) )
+                S3D::DestroyNode( m_sgmaterial[j] );
 
-            sgmaterial[j] = NULL;
+            m_sgmaterial[j] = NULL;
         }
 
         if( !m_components.empty() )
@@ -233,9 +271,11 @@ public:
 
     VRML_COLOR& GetColor( VRML_COLOR_INDEX aIndex )
     {
-        return colors[aIndex];
+        return m_colors[aIndex];
     }
 
+    SGNODE* GetSGColor( VRML_COLOR_INDEX aIndex );
+
     void SetOffset( double aXoff, double aYoff )
     {
         m_tx = aXoff;
@@ -272,7 +312,7 @@ public:
             throw( std::runtime_error( "WorldScale out of range (valid range is 0.001 to 10.0)" ) );
 
         m_OutputPCB.SetScale( aWorldScale * 2.54 );
-        WORLD_SCALE = aWorldScale * 2.54;
+        m_worldScale = aWorldScale * 2.54;
 
         return true;
     }
@@ -280,10 +320,6 @@ public:
 };
 
 
-// static var. for dealing with text
-static MODEL_VRML* model_vrml;
-
-
 // select the VRML layer object to draw on; return true if
 // a layer has been selected.
 static bool GetLayer( MODEL_VRML& aModel, LAYER_NUM layer, VRML_LAYER** vlayer )
@@ -313,10 +349,10 @@ static bool GetLayer( MODEL_VRML& aModel, LAYER_NUM layer, VRML_LAYER** vlayer )
     return true;
 }
 
-static void create_vrml_shell( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
+static void create_vrml_shell( MODEL_VRML& aModel, VRML_COLOR_INDEX colorID,
     VRML_LAYER* layer, double top_z, double bottom_z );
 
-static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
+static void create_vrml_plane( MODEL_VRML& aModel, VRML_COLOR_INDEX colorID,
     VRML_LAYER* layer, double aHeight, bool aTopPlane );
 
 static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
@@ -419,36 +455,108 @@ static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
 }
 
 
+// tesselate the board and all layers; the layers are independent, so they
+// are tesselated by worker threads
+static void tesselate_layers( MODEL_VRML& aModel )
+{
+    struct TESSELATE_JOB
+    {
+        VRML_LAYER* m_layer;
+        VRML_LAYER* m_holes;
+        bool        m_holesOnly;
+    };
+
+    std::vector<TESSELATE_JOB> jobs;
+
+    jobs.push_back( { &aModel.m_board, &aModel.m_holes, false } );
+
+    if( !aModel.m_plainPCB )
+    {
+        VRML_LAYER* layers[] = { &aModel.m_top_copper, &aModel.m_top_tin,
+                                 &aModel.m_bot_copper, &aModel.m_bot_tin,
+                                 &aModel.m_top_silk, &aModel.m_bot_silk };
+
+        // The tesselation renumbers the vertices of the holes layer: each
+        // layer needs its own copy of the board holes
+        for( VRML_LAYER* layer : layers )
+        {
+            aModel.m_layerHoles.emplace_back( new VRML_LAYER );
+            VRML_LAYER* holes = aModel.m_layerHoles.back().get();
+
+            if( !holes->AppendContours( aModel.m_holes ) )
+                throw( std::runtime_error( holes->GetError() ) );
+
+            jobs.push_back( { layer, holes, false } );
+        }
+
+        jobs.push_back( { &aModel.m_plated_holes, NULL, true } );
+    }
+
+    std::atomic<size_t> nextItem( 0 );
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   jobs.size() );
+
+    auto tesselate_lambda = [&]() -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextItem++; i < jobs.size(); i = nextItem++ )
+        {
+            // empty layers do not tesselate, and are written without any shape
+            jobs[i].m_layer->Tesselate( jobs[i].m_holes, jobs[i].m_holesOnly );
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        tesselate_lambda();
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, tesselate_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+}
+
+
 static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     const char* aFileName, OSTREAM* aOutputFile )
 {
+    tesselate_layers( aModel );
+
+    // offset of the art layers from the copper layers
+    double artOffset = Millimeter2iu( ART_OFFSET / 2.0 ) * aModel.m_boardScale;
+
     // VRML_LAYER board;
-    aModel.m_board.Tesselate( &aModel.m_holes );
-    double brdz = aModel.m_brd_thickness / 2.0
-                  - ( Millimeter2iu( ART_OFFSET / 2.0 ) ) * BOARD_SCALE;
+    double brdz = aModel.m_brd_thickness / 2.0 - artOffset;
 
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_PCB ),
                             &aModel.m_board, false, false, brdz, -brdz );
     }
     else
     {
-        create_vrml_shell( aModel.m_OutputPCB, VRML_COLOR_PCB, &aModel.m_board, brdz, -brdz );
+        create_vrml_shell( aModel, VRML_COLOR_PCB, &aModel.m_board, brdz, -brdz );
     }
 
     if( aModel.m_plainPCB )
     {
-        if( !USE_INLINES )
-            S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), USE_DEFS, true );
+        if( !aModel.m_useInlines )
+            S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), aModel.m_useDefs,
+                            true );
 
         return;
     }
 
     // VRML_LAYER m_top_copper;
-    aModel.m_top_copper.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
                            &aModel.m_top_copper, true, true,
@@ -456,31 +564,27 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
     else
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TRACK, &aModel.m_top_copper,
+        create_vrml_plane( aModel, VRML_COLOR_TRACK, &aModel.m_top_copper,
                            aModel.GetLayerZ( F_Cu ), true );
     }
 
     // VRML_LAYER m_top_tin;
-    aModel.m_top_tin.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
                             &aModel.m_top_tin, true, true,
-                            aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
+                            aModel.GetLayerZ( F_Cu ) + artOffset,
                             0 );
     }
     else
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_top_tin,
-                           aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
+        create_vrml_plane( aModel, VRML_COLOR_TIN, &aModel.m_top_tin,
+                           aModel.GetLayerZ( F_Cu ) + artOffset,
                            true );
     }
 
     // VRML_LAYER m_bot_copper;
-    aModel.m_bot_copper.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TRACK ),
                             &aModel.m_bot_copper, true, false,
@@ -488,74 +592,66 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb,
     }
     else
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TRACK, &aModel.m_bot_copper,
+        create_vrml_plane( aModel, VRML_COLOR_TRACK, &aModel.m_bot_copper,
                            aModel.GetLayerZ( B_Cu ), false );
     }
 
     // VRML_LAYER m_bot_tin;
-    aModel.m_bot_tin.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
                             &aModel.m_bot_tin, true, false,
                             aModel.GetLayerZ( B_Cu )
-                            - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
+                            - artOffset,
                             0 );
     }
     else
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_bot_tin,
-                           aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
+        create_vrml_plane( aModel, VRML_COLOR_TIN, &aModel.m_bot_tin,
+                           aModel.GetLayerZ( B_Cu ) - artOffset,
                            false );
     }
 
     // VRML_LAYER PTH;
-    aModel.m_plated_holes.Tesselate( NULL, true );
-
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_TIN ),
                             &aModel.m_plated_holes, false, false,
-                            aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                            aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE );
+                            aModel.GetLayerZ( F_Cu ) + artOffset,
+                            aModel.GetLayerZ( B_Cu ) - artOffset );
     }
     else
     {
-        create_vrml_shell( aModel.m_OutputPCB, VRML_COLOR_TIN, &aModel.m_plated_holes,
-                           aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE,
-                           aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE );
+        create_vrml_shell( aModel, VRML_COLOR_TIN, &aModel.m_plated_holes,
+                           aModel.GetLayerZ( F_Cu ) + artOffset,
+                           aModel.GetLayerZ( B_Cu ) - artOffset );
     }
 
     // VRML_LAYER m_top_silk;
-    aModel.m_top_silk.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_top_silk,
                             true, true, aModel.GetLayerZ( F_SilkS ), 0 );
     }
     else
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_SILK, &aModel.m_top_silk,
+        create_vrml_plane( aModel, VRML_COLOR_SILK, &aModel.m_top_silk,
                            aModel.GetLayerZ( F_SilkS ), true );
     }
 
     // VRML_LAYER m_bot_silk;
-    aModel.m_bot_silk.Tesselate( &aModel.m_holes );
-
-    if( USE_INLINES )
+    if( aModel.m_useInlines )
     {
         write_triangle_bag( *aOutputFile, aModel.GetColor( VRML_COLOR_SILK ), &aModel.m_bot_silk,
                             true, false, aModel.GetLayerZ( B_SilkS ), 0 );
     }
     else
     {
-        create_vrml_plane( aModel.m_OutputPCB, VRML_COLOR_SILK, &aModel.m_bot_silk,
+        create_vrml_plane( aModel, VRML_COLOR_SILK, &aModel.m_bot_silk,
                            aModel.GetLayerZ( B_SilkS ), false );
     }
 
-    if( !USE_INLINES )
+    if( !aModel.m_useInlines )
         S3D::WriteVRML( aFileName, true, aModel.m_OutputPCB.GetRawPtr(), true, true );
 }
 
@@ -565,7 +661,7 @@ static void compute_layer_Zs( MODEL_VRML& aModel, BOARD* pcb )
     int copper_layers = pcb->GetCopperLayerCount();
 
     // We call it 'layer' thickness, but it's the whole board thickness!
-    aModel.m_brd_thickness = pcb->GetDesignSettings().GetBoardThickness() * BOARD_SCALE;
+    aModel.m_brd_thickness = pcb->GetDesignSettings().GetBoardThickness() * aModel.m_boardScale;
     double half_thickness = aModel.m_brd_thickness / 2;
 
     // Compute each layer's Z value, more or less like the 3d view
@@ -581,7 +677,7 @@ static void compute_layer_Zs( MODEL_VRML& aModel, BOARD* pcb )
 
     /* To avoid rounding interference, we apply an epsilon to each
      * successive layer */
-    double epsilon_z = Millimeter2iu( ART_OFFSET ) * BOARD_SCALE;
+    double epsilon_z = Millimeter2iu( ART_OFFSET ) * aModel.m_boardScale;
     aModel.SetLayerZ( B_Paste, -half_thickness - epsilon_z * 4 );
     aModel.SetLayerZ( B_Adhes, -half_thickness - epsilon_z * 3 );
     aModel.SetLayerZ( B_SilkS, -half_thickness - epsilon_z * 2 );
@@ -703,8 +799,8 @@ static void export_vrml_polygon( MODEL_VRML& aModel, LAYER_NUM layer,
 
         for( int j = 0; j < outline.PointCount(); j++ )
         {
-            if( !vlayer->AddVertex( seg, outline.CPoint( j ).x * BOARD_SCALE,
-                                     -outline.CPoint( j ).y * BOARD_SCALE ) )
+            if( !vlayer->AddVertex( seg, outline.CPoint( j ).x * aModel.m_boardScale,
+                                     -outline.CPoint( j ).y * aModel.m_boardScale ) )
                 throw( std::runtime_error( vlayer->GetError() ) );
         }
 
@@ -716,11 +812,11 @@ static void export_vrml_polygon( MODEL_VRML& aModel, LAYER_NUM layer,
 static void export_vrml_drawsegment( MODEL_VRML& aModel, DRAWSEGMENT* drawseg )
 {
     LAYER_NUM layer = drawseg->GetLayer();
-    double  w   = drawseg->GetWidth() * BOARD_SCALE;
-    double  x   = drawseg->GetStart().x * BOARD_SCALE;
-    double  y   = drawseg->GetStart().y * BOARD_SCALE;
-    double  xf  = drawseg->GetEnd().x * BOARD_SCALE;
-    double  yf  = drawseg->GetEnd().y * BOARD_SCALE;
+    double  w   = drawseg->GetWidth() * aModel.m_boardScale;
+    double  x   = drawseg->GetStart().x * aModel.m_boardScale;
+    double  y   = drawseg->GetStart().y * aModel.m_boardScale;
+    double  xf  = drawseg->GetEnd().x * aModel.m_boardScale;
+    double  yf  = drawseg->GetEnd().y * aModel.m_boardScale;
     double  r   = sqrt( pow( x - xf, 2 ) + pow( y - yf, 2 ) );
 
     // Items on the edge layer are handled elsewhere; just return
@@ -731,10 +827,10 @@ static void export_vrml_drawsegment( MODEL_VRML& aModel, DRAWSEGMENT* drawseg )
     {
     case S_ARC:
         export_vrml_arc( aModel, layer,
-                         (double) drawseg->GetCenter().x * BOARD_SCALE,
-                         (double) drawseg->GetCenter().y * BOARD_SCALE,
-                         (double) drawseg->GetArcStart().x * BOARD_SCALE,
-                         (double) drawseg->GetArcStart().y * BOARD_SCALE,
+                         (double) drawseg->GetCenter().x * aModel.m_boardScale,
+                         (double) drawseg->GetCenter().y * aModel.m_boardScale,
+                         (double) drawseg->GetArcStart().x * aModel.m_boardScale,
+                         (double) drawseg->GetArcStart().y * aModel.m_boardScale,
                          w, drawseg->GetAngle() / 10 );
         break;
 
@@ -756,24 +852,25 @@ static void export_vrml_drawsegment( MODEL_VRML& aModel, DRAWSEGMENT* drawseg )
 }
 
 
-/* C++ doesn't have closures and neither continuation forms... this is
- * for coupling the vrml_text_callback with the common parameters */
+/* C++ doesn't have closures and neither continuation forms... the model
+ * is passed as callback data, and holds the layer and width of the text */
 static void vrml_text_callback( int x0, int y0, int xf, int yf, void* aData )
 {
-    LAYER_NUM m_text_layer = model_vrml->m_text_layer;
-    int m_text_width = model_vrml->m_text_width;
-
-    export_vrml_line( *model_vrml, m_text_layer,
-                      x0 * BOARD_SCALE, y0 * BOARD_SCALE,
-                      xf * BOARD_SCALE, yf * BOARD_SCALE,
-                      m_text_width * BOARD_SCALE );
+    MODEL_VRML* model = static_cast<MODEL_VRML*>( aData );
+    LAYER_NUM m_text_layer = model->m_text_layer;
+    int m_text_width = model->m_text_width;
+
+    export_vrml_line( *model, m_text_layer,
+                      x0 * model->m_boardScale, y0 * model->m_boardScale,
+                      xf * model->m_boardScale, yf * model->m_boardScale,
+                      m_text_width * model->m_boardScale );
 }
 
 
 static void export_vrml_pcbtext( MODEL_VRML& aModel, TEXTE_PCB* text )
 {
-    model_vrml->m_text_layer    = text->GetLayer();
-    model_vrml->m_text_width    = text->GetThickness();
+    aModel.m_text_layer    = text->GetLayer();
+    aModel.m_text_width    = text->GetThickness();
 
     wxSize size = text->GetTextSize();
 
@@ -798,7 +895,7 @@ static void export_vrml_pcbtext( MODEL_VRML& aModel, TEXTE_PCB* text )
                              text->GetHorizJustify(), text->GetVertJustify(),
                              text->GetThickness(), text->IsItalic(),
                              true,
-                             vrml_text_callback );
+                             vrml_text_callback, &aModel );
         }
     }
     else
@@ -808,7 +905,7 @@ static void export_vrml_pcbtext( MODEL_VRML& aModel, TEXTE_PCB* text )
                          text->GetHorizJustify(), text->GetVertJustify(),
                          text->GetThickness(), text->IsItalic(),
                          true,
-                         vrml_text_callback );
+                         vrml_text_callback, &aModel );
     }
 }
 
@@ -863,8 +960,8 @@ static void export_vrml_board( MODEL_VRML& aModel, BOARD* aPcb )
 
         for( int j = 0; j < outline.PointCount(); j++ )
         {
-            aModel.m_board.AddVertex( seg, (double)outline.CPoint(j).x * BOARD_SCALE,
-                                        -((double)outline.CPoint(j).y * BOARD_SCALE ) );
+            aModel.m_board.AddVertex( seg, (double)outline.CPoint(j).x * aModel.m_boardScale,
+                                        -((double)outline.CPoint(j).y * aModel.m_boardScale ) );
 
         }
 
@@ -888,8 +985,8 @@ static void export_vrml_board( MODEL_VRML& aModel, BOARD* aPcb )
 
             for( int j = 0; j < hole.PointCount(); j++ )
             {
-                aModel.m_holes.AddVertex( seg, (double)hole.CPoint(j).x * BOARD_SCALE,
-                                          -((double)hole.CPoint(j).y * BOARD_SCALE ) );
+                aModel.m_holes.AddVertex( seg, (double)hole.CPoint(j).x * aModel.m_boardScale,
+                                          -((double)hole.CPoint(j).y * aModel.m_boardScale ) );
 
             }
 
@@ -949,10 +1046,10 @@ static void export_vrml_via( MODEL_VRML& aModel, BOARD* aPcb, const VIA* aVia )
     double      x, y, r, hole;
     PCB_LAYER_ID    top_layer, bottom_layer;
 
-    hole = aVia->GetDrillValue() * BOARD_SCALE / 2.0;
-    r   = aVia->GetWidth() * BOARD_SCALE / 2.0;
-    x   = aVia->GetStart().x * BOARD_SCALE;
-    y   = aVia->GetStart().y * BOARD_SCALE;
+    hole = aVia->GetDrillValue() * aModel.m_boardScale / 2.0;
+    r   = aVia->GetWidth() * aModel.m_boardScale / 2.0;
+    x   = aVia->GetStart().x * aModel.m_boardScale;
+    y   = aVia->GetStart().y * aModel.m_boardScale;
     aVia->LayerPair( &top_layer, &bottom_layer );
 
     // do not render a buried via
@@ -975,11 +1072,11 @@ static void export_vrml_tracks( MODEL_VRML& aModel, BOARD* pcb )
         else if( ( track->GetLayer() == B_Cu || track->GetLayer() == F_Cu )
                    && !aModel.m_plainPCB )
             export_vrml_line( aModel, track->GetLayer(),
-                              track->GetStart().x * BOARD_SCALE,
-                              track->GetStart().y * BOARD_SCALE,
-                              track->GetEnd().x * BOARD_SCALE,
-                              track->GetEnd().y * BOARD_SCALE,
-                              track->GetWidth() * BOARD_SCALE );
+                              track->GetStart().x * aModel.m_boardScale,
+                              track->GetStart().y * aModel.m_boardScale,
+                              track->GetEnd().x * aModel.m_boardScale,
+                              track->GetEnd().y * aModel.m_boardScale,
+                              track->GetWidth() * aModel.m_boardScale );
     }
 }
 
@@ -1015,8 +1112,8 @@ static void export_vrml_zones( MODEL_VRML& aModel, BOARD* aPcb )
 
             for( int j = 0; j < outline.PointCount(); j++ )
             {
-                if( !vl->AddVertex( seg, (double)outline.CPoint( j ).x * BOARD_SCALE,
-                                         -((double)outline.CPoint( j ).y * BOARD_SCALE ) ) )
+                if( !vl->AddVertex( seg, (double)outline.CPoint( j ).x * aModel.m_boardScale,
+                                         -((double)outline.CPoint( j ).y * aModel.m_boardScale ) ) )
                     throw( std::runtime_error( vl->GetError() ) );
 
             }
@@ -1027,7 +1124,7 @@ static void export_vrml_zones( MODEL_VRML& aModel, BOARD* aPcb )
 }
 
 
-static void export_vrml_text_module( TEXTE_MODULE* module )
+static void export_vrml_text_module( MODEL_VRML& aModel, TEXTE_MODULE* module )
 {
     if( module->IsVisible() )
     {
@@ -1036,15 +1133,15 @@ static void export_vrml_text_module( TEXTE_MODULE* module )
         if( module->IsMirrored() )
             size.x = -size.x;  // Text is mirrored
 
-        model_vrml->m_text_layer    = module->GetLayer();
-        model_vrml->m_text_width    = module->GetThickness();
+        aModel.m_text_layer    = module->GetLayer();
+        aModel.m_text_width    = module->GetThickness();
 
         DrawGraphicText( NULL, NULL, module->GetTextPos(), BLACK,
                          module->GetShownText(), module->GetDrawRotation(), size,
                          module->GetHorizJustify(), module->GetVertJustify(),
                          module->GetThickness(), module->IsItalic(),
                          true,
-                         vrml_text_callback );
+                         vrml_text_callback, &aModel );
     }
 }
 
@@ -1053,11 +1150,11 @@ static void export_vrml_edge_module( MODEL_VRML& aModel, EDGE_MODULE* aOutline,
                                      MODULE* aModule )
 {
     LAYER_NUM layer = aOutline->GetLayer();
-    double  x   = aOutline->GetStart().x * BOARD_SCALE;
-    double  y   = aOutline->GetStart().y * BOARD_SCALE;
-    double  xf  = aOutline->GetEnd().x * BOARD_SCALE;
-    double  yf  = aOutline->GetEnd().y * BOARD_SCALE;
-    double  w   = aOutline->GetWidth() * BOARD_SCALE;
+    double  x   = aOutline->GetStart().x * aModel.m_boardScale;
+    double  y   = aOutline->GetStart().y * aModel.m_boardScale;
+    double  xf  = aOutline->GetEnd().x * aModel.m_boardScale;
+    double  yf  = aOutline->GetEnd().y * aModel.m_boardScale;
+    double  w   = aOutline->GetWidth() * aModel.m_boardScale;
 
     switch( aOutline->GetShape() )
     {
@@ -1088,15 +1185,15 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
 {
     // The (maybe offset) pad position
     wxPoint pad_pos = aPad->ShapePos();
-    double  pad_x   = pad_pos.x * BOARD_SCALE;
-    double  pad_y   = pad_pos.y * BOARD_SCALE;
+    double  pad_x   = pad_pos.x * aModel.m_boardScale;
+    double  pad_y   = pad_pos.y * aModel.m_boardScale;
     wxSize  pad_delta = aPad->GetDelta();
 
-    double  pad_dx  = pad_delta.x * BOARD_SCALE / 2.0;
-    double  pad_dy  = pad_delta.y * BOARD_SCALE / 2.0;
+    double  pad_dx  = pad_delta.x * aModel.m_boardScale / 2.0;
+    double  pad_dy  = pad_delta.y * aModel.m_boardScale / 2.0;
 
-    double  pad_w   = aPad->GetSize().x * BOARD_SCALE / 2.0;
-    double  pad_h   = aPad->GetSize().y * BOARD_SCALE / 2.0;
+    double  pad_w   = aPad->GetSize().x * aModel.m_boardScale / 2.0;
+    double  pad_h   = aPad->GetSize().y * aModel.m_boardScale / 2.0;
 
     switch( aPad->GetShape() )
     {
@@ -1127,8 +1224,8 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
         SHAPE_LINE_CHAIN poly( polySet.Outline( 0 ) );
 
         for( int ii = 0; ii < poly.PointCount(); ++ii )
-            cornerList.push_back( wxRealPoint( poly.Point( ii ).x * BOARD_SCALE,
-                                               -poly.Point( ii ).y * BOARD_SCALE ) );
+            cornerList.push_back( wxRealPoint( poly.Point( ii ).x * aModel.m_boardScale,
+                                               -poly.Point( ii ).y * aModel.m_boardScale ) );
 
         // Close polygon
         cornerList.push_back( cornerList[0] );
@@ -1151,8 +1248,8 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
             cornerList.clear();
 
             for( int ii = 0; ii < poly.PointCount(); ++ii )
-                cornerList.push_back( wxRealPoint( poly.Point( ii ).x * BOARD_SCALE,
-                                                   -poly.Point( ii ).y * BOARD_SCALE ) );
+                cornerList.push_back( wxRealPoint( poly.Point( ii ).x * aModel.m_boardScale,
+                                                   -poly.Point( ii ).y * aModel.m_boardScale ) );
 
             // Close polygon
             cornerList.push_back( cornerList[0] );
@@ -1219,11 +1316,11 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
 
 static void export_vrml_pad( MODEL_VRML& aModel, BOARD* aPcb, D_PAD* aPad )
 {
-    double  hole_drill_w    = (double) aPad->GetDrillSize().x * BOARD_SCALE / 2.0;
-    double  hole_drill_h    = (double) aPad->GetDrillSize().y * BOARD_SCALE / 2.0;
+    double  hole_drill_w    = (double) aPad->GetDrillSize().x * aModel.m_boardScale / 2.0;
+    double  hole_drill_h    = (double) aPad->GetDrillSize().y * aModel.m_boardScale / 2.0;
     double  hole_drill      = std::min( hole_drill_w, hole_drill_h );
-    double  hole_x          = aPad->GetPosition().x * BOARD_SCALE;
-    double  hole_y          = aPad->GetPosition().y * BOARD_SCALE;
+    double  hole_x          = aPad->GetPosition().x * aModel.m_boardScale;
+    double  hole_y          = aPad->GetPosition().y * aModel.m_boardScale;
 
     // Export the hole on the edge layer
     if( hole_drill > 0 )
@@ -1344,10 +1441,10 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
     {
         // Reference and value
         if( aModule->Reference().IsVisible() )
-            export_vrml_text_module( &aModule->Reference() );
+            export_vrml_text_module( aModel, &aModule->Reference() );
 
         if( aModule->Value().IsVisible() )
-            export_vrml_text_module( &aModule->Value() );
+            export_vrml_text_module( aModel, &aModule->Value() );
 
         // Export module edges
         for( EDA_ITEM* item = aModule->GraphicalItemsList(); item; item = item->Next() )
@@ -1355,7 +1452,7 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             switch( item->Type() )
             {
                 case PCB_MODULE_TEXT_T:
-                    export_vrml_text_module( static_cast<TEXTE_MODULE*>( item ) );
+                    export_vrml_text_module( aModel, static_cast<TEXTE_MODULE*>( item ) );
                     break;
 
                 case PCB_MODULE_EDGE_T:
@@ -1379,17 +1476,15 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
     auto sM = aModule->Models().begin();
     auto eM = aModule->Models().end();
 
-    wxFileName subdir( SUBDIR_3D, "" );
-
-    while( sM != eM )
+    for( ; sM != eM; ++sM )
     {
-        SGNODE* mod3d = (SGNODE*) cache->Load( sM->m_Filename );
+        auto it = aModel.m_models.find( sM->m_Filename );
 
-        if( NULL == mod3d )
-        {
-            ++sM;
+        if( it == aModel.m_models.end() || NULL == it->second.m_node )
             continue;
-        }
+
+        VRML_MODEL_ENTRY& entry = it->second;
+        SGNODE* mod3d = entry.m_node;
 
         /* Calculate 3D shape rotation:
          * this is the rotation parameters, with an additional 180 deg rotation
@@ -1437,50 +1532,12 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
         RotatePoint( &offsetx, &offsety, aModule->GetOrientation() );
 
         SGPOINT trans;
-        trans.x = ( offsetx + aModule->GetPosition().x ) * BOARD_SCALE + aModel.m_tx;
-        trans.y = -(offsety + aModule->GetPosition().y) * BOARD_SCALE - aModel.m_ty;
-        trans.z = (offsetz * BOARD_SCALE ) + aModel.GetLayerZ( aModule->GetLayer() );
+        trans.x = ( offsetx + aModule->GetPosition().x ) * aModel.m_boardScale + aModel.m_tx;
+        trans.y = -(offsety + aModule->GetPosition().y) * aModel.m_boardScale - aModel.m_ty;
+        trans.z = (offsetz * aModel.m_boardScale ) + aModel.GetLayerZ( aModule->GetLayer() );
 
-        if( USE_INLINES )
+        if( aModel.m_useInlines )
         {
-            wxFileName srcFile = cache->GetResolver()->ResolvePath( sM->m_Filename );
-            wxFileName dstFile;
-            dstFile.SetPath( SUBDIR_3D );
-            dstFile.SetName( srcFile.GetName() );
-            dstFile.SetExt( "wrl"  );
-
-            // copy the file if necessary
-            wxDateTime srcModTime = srcFile.GetModificationTime();
-            wxDateTime destModTime = srcModTime;
-
-            destModTime.SetToCurrent();
-
-            if( dstFile.FileExists() )
-                destModTime = dstFile.GetModificationTime();
-
-            if( srcModTime != destModTime )
-            {
-                wxLogDebug( "Copying 3D model %s to %s.",
-                            GetChars( srcFile.GetFullPath() ),
-                            GetChars( dstFile.GetFullPath() ) );
-
-                wxString fileExt = srcFile.GetExt();
-                fileExt.LowerCase();
-
-                // copy VRML models and use the scenegraph library to
-                // translate other model types
-                if( fileExt == "wrl" )
-                {
-                    if( !wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() ) )
-                        continue;
-                }
-                else
-                {
-                    if( !S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d, USE_DEFS, true ) )
-                        continue;
-                }
-            }
-
             (*aOutputFile) << "Transform {\n";
 
             // only write a rotation if it is >= 0.1 deg
@@ -1500,20 +1557,19 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             (*aOutputFile) << sM->m_Scale.y << " ";
             (*aOutputFile) << sM->m_Scale.z << "\n";
 
-            (*aOutputFile) << "  children [\n    Inline {\n      url \"";
-
-            if( USE_RELPATH )
+            // the first instance defines the Inline node, the next ones reuse it
+            if( entry.m_defined )
             {
-                wxFileName tmp = dstFile;
-                tmp.SetExt( "" );
-                tmp.SetName( "" );
-                tmp.RemoveLastDir();
-                dstFile.MakeRelativeTo( tmp.GetPath() );
+                (*aOutputFile) << "  children [ USE " << TO_UTF8( entry.m_defName ) << " ]\n";
+            }
+            else
+            {
+                (*aOutputFile) << "  children [\n    DEF " << TO_UTF8( entry.m_defName );
+                (*aOutputFile) << " Inline {\n      url \"";
+                (*aOutputFile) << TO_UTF8( entry.m_url ) << "\"\n    } ]\n";
+                entry.m_defined = true;
             }
 
-            wxString fn = dstFile.GetFullPath();
-            fn.Replace( "\\", "/" );
-            (*aOutputFile) << TO_UTF8( fn ) << "\"\n    } ]\n";
             (*aOutputFile) << "  }\n";
         }
         else
@@ -1538,8 +1594,82 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             }
 
         }
+    }
+}
+
 
-        ++sM;
+// load the 3D models of all footprints once; in inline mode, each model is also
+// copied (or translated to VRML) once in the 3D subdirectory, and given the
+// name its instances use to reference it
+static void export_vrml_models( MODEL_VRML& aModel, BOARD* aPcb )
+{
+    for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
+    {
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( aModel.m_models.count( model.m_Filename ) )
+                continue;
+
+            VRML_MODEL_ENTRY& entry = aModel.m_models[model.m_Filename];
+            entry.m_node = (SGNODE*) aModel.m_cache->Load( model.m_Filename );
+
+            if( NULL == entry.m_node || !aModel.m_useInlines )
+                continue;
+
+            wxFileName srcFile = aModel.m_cache->GetResolver()->ResolvePath( model.m_Filename );
+            wxFileName dstFile;
+            dstFile.SetPath( aModel.m_subdir3D );
+            dstFile.SetName( srcFile.GetName() );
+            dstFile.SetExt( "wrl"  );
+
+            // copy the file if necessary
+            wxDateTime srcModTime = srcFile.GetModificationTime();
+            wxDateTime destModTime = srcModTime;
+
+            destModTime.SetToCurrent();
+
+            if( dstFile.FileExists() )
+                destModTime = dstFile.GetModificationTime();
+
+            if( srcModTime != destModTime )
+            {
+                wxLogDebug( "Copying 3D model %s to %s.",
+                            GetChars( srcFile.GetFullPath() ),
+                            GetChars( dstFile.GetFullPath() ) );
+
+                wxString fileExt = srcFile.GetExt();
+                fileExt.LowerCase();
+
+                // copy VRML models and use the scenegraph library to
+                // translate other model types
+                bool copied;
+
+                if( fileExt == "wrl" )
+                    copied = wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() );
+                else
+                    copied = S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, entry.m_node,
+                                             aModel.m_useDefs, true );
+
+                if( !copied )
+                {
+                    entry.m_node = NULL;
+                    continue;
+                }
+            }
+
+            if( aModel.m_useRelPath )
+            {
+                wxFileName tmp = dstFile;
+                tmp.SetExt( "" );
+                tmp.SetName( "" );
+                tmp.RemoveLastDir();
+                dstFile.MakeRelativeTo( tmp.GetPath() );
+            }
+
+            entry.m_url = dstFile.GetFullPath();
+            entry.m_url.Replace( "\\", "/" );
+            entry.m_defName.Printf( "MODEL_%u", (unsigned) aModel.m_models.size() );
+        }
     }
 }
 
@@ -1551,26 +1681,23 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
 {
     BOARD*          pcb = GetBoard();
     bool            ok  = true;
+    MODEL_VRML      model3d;
 
-    USE_INLINES = aExport3DFiles;
-    USE_DEFS = true;
-    USE_RELPATH = aUseRelativePaths;
-
-    cache = Prj().Get3DCacheManager();
-    PROJ_DIR = Prj().GetProjectPath();
-    SUBDIR_3D = a3D_Subdir;
-    MODEL_VRML model3d;
-    model_vrml = &model3d;
+    model3d.m_useInlines = aExport3DFiles;
+    model3d.m_useDefs = true;
+    model3d.m_useRelPath = aUseRelativePaths;
+    model3d.m_cache = Prj().Get3DCacheManager();
+    model3d.m_subdir3D = a3D_Subdir;
     model3d.SetScale( aMMtoWRMLunit );
 
-    if( USE_INLINES )
+    if( model3d.m_useInlines )
     {
-        BOARD_SCALE = MM_PER_IU / 2.54;
+        model3d.m_boardScale = MM_PER_IU / 2.54;
         model3d.SetOffset( -aXRef / 2.54, aYRef / 2.54 );
     }
     else
     {
-        BOARD_SCALE = MM_PER_IU;
+        model3d.m_boardScale = MM_PER_IU;
         model3d.SetOffset( -aXRef, aYRef );
     }
 
@@ -1597,10 +1724,10 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
         if( !aUsePlainPCB )
             export_vrml_zones( model3d, pcb);
 
-        if( USE_INLINES )
+        if( model3d.m_useInlines )
         {
             // check if the 3D Subdir exists - create if not
-            wxFileName subdir( SUBDIR_3D, "" );
+            wxFileName subdir( model3d.m_subdir3D, "" );
 
             if( ! subdir.DirExists() )
             {
@@ -1628,12 +1755,14 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
             output_file << "}\n";
             output_file << "Transform {\n";
             output_file << "  scale " << std::setprecision( PRECISION );
-            output_file << WORLD_SCALE << " ";
-            output_file << WORLD_SCALE << " ";
-            output_file << WORLD_SCALE << "\n";
+            output_file << model3d.m_worldScale << " ";
+            output_file << model3d.m_worldScale << " ";
+            output_file << model3d.m_worldScale << "\n";
             output_file << "  children [\n";
 
-            // Export footprints
+            // Load and copy the 3D models once, then export footprints
+            export_vrml_models( model3d, pcb );
+
             for( MODULE* module = pcb->m_Modules; module != 0; module = module->Next() )
                 export_vrml_module( model3d, pcb, module, &output_file );
 
@@ -1647,7 +1776,9 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
         }
         else
         {
-            // Export footprints
+            // Load the 3D models once, then export footprints
+            export_vrml_models( model3d, pcb );
+
             for( MODULE* module = pcb->m_Modules; module != 0; module = module->Next() )
                 export_vrml_module( model3d, pcb, module, NULL );
 
@@ -1668,18 +1799,18 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
 }
 
 
-static SGNODE* getSGColor( VRML_COLOR_INDEX colorIdx )
+SGNODE* MODEL_VRML::GetSGColor( VRML_COLOR_INDEX colorIdx )
 {
     if( colorIdx == -1 )
         colorIdx = VRML_COLOR_PCB;
     else if( colorIdx == VRML_COLOR_LAST )
         return NULL;
 
-    if( sgmaterial[colorIdx] )
-        return sgmaterial[colorIdx];
+    if( m_sgmaterial[colorIdx] )
+        return m_sgmaterial[colorIdx];
 
     IFSG_APPEARANCE vcolor( (SGNODE*) NULL );
-    VRML_COLOR* cp = &colors[colorIdx];
+    VRML_COLOR* cp = &m_colors[colorIdx];
 
     vcolor.SetSpecular( cp->spec_red, cp->spec_grn, cp->spec_blu );
     vcolor.SetDiffuse( cp->diffuse_red, cp->diffuse_grn, cp->diffuse_blu );
@@ -1689,13 +1820,13 @@ static SGNODE* getSGColor( VRML_COLOR_INDEX colorIdx )
     vcolor.SetAmbient( cp->ambient, cp->ambient, cp->ambient );
     vcolor.SetTransparency( cp->transp );
 
-    sgmaterial[colorIdx] = vcolor.GetRawPtr();
+    m_sgmaterial[colorIdx] = vcolor.GetRawPtr();
 
-    return sgmaterial[colorIdx];
+    return m_sgmaterial[colorIdx];
 }
 
 
-static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
+static void create_vrml_plane( MODEL_VRML& aModel, VRML_COLOR_INDEX colorID,
     VRML_LAYER* layer, double top_z, bool aTopPlane )
 {
     std::vector< double > vertices;
@@ -1737,7 +1868,7 @@ static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX color
         vlist.push_back( SGPOINT( vertices[j], vertices[j+1], vertices[j+2] ) );
 
     // create the intermediate scenegraph
-    IFSG_TRANSFORM tx0( PcbOutput.GetRawPtr() );    // tx0 = Transform for this outline
+    IFSG_TRANSFORM tx0( aModel.m_OutputPCB.GetRawPtr() );    // tx0 = Transform for this outline
     IFSG_SHAPE shape( tx0 );            // shape will hold (a) all vertices and (b) a local list of normals
     IFSG_FACESET face( shape );         // this face shall represent the top and bottom planes
     IFSG_COORDS cp( face );             // coordinates for all faces
@@ -1759,7 +1890,7 @@ static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX color
     }
 
     // assign a color from the palette
-    SGNODE* modelColor = getSGColor( colorID );
+    SGNODE* modelColor = aModel.GetSGColor( colorID );
 
     if( NULL != modelColor )
     {
@@ -1773,7 +1904,7 @@ static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX color
 }
 
 
-static void create_vrml_shell( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
+static void create_vrml_shell( MODEL_VRML& aModel, VRML_COLOR_INDEX colorID,
     VRML_LAYER* layer, double top_z, double bottom_z )
 {
     std::vector< double > vertices;
@@ -1824,7 +1955,7 @@ static void create_vrml_shell( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX color
         vlist.push_back( SGPOINT( vertices[j], vertices[j+1], vertices[j+2] ) );
 
     // create the intermediate scenegraph
-    IFSG_TRANSFORM tx0( PcbOutput.GetRawPtr() );    // tx0 = Transform for this outline
+    IFSG_TRANSFORM tx0( aModel.m_OutputPCB.GetRawPtr() );    // tx0 = Transform for this outline
     IFSG_SHAPE shape( tx0 );            // shape will hold (a) all vertices and (b) a local list of normals
     IFSG_FACESET face( shape );         // this face shall represent the top and bottom planes
     IFSG_COORDS cp( face );             // coordinates for all faces
@@ -1845,7 +1976,7 @@ static void create_vrml_shell( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX color
         norms.AddNormal( 0.0, 0.0, -1.0 );
 
     // assign a color from the palette
-    SGNODE* modelColor = getSGColor( colorID );
+    SGNODE* modelColor = aModel.GetSGColor( colorID );
 
     if( NULL != modelColor )
     {
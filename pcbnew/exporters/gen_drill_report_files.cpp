@@ -335,6 +335,8 @@ bool GENDRILL_WRITER_BASE::GenDrillReportFile( const wxString& aFullFileName )
      * 1 - through holes
      * 2 - for partial holes only: by layer starting and ending pair
      * 3 - Non Plated through holes
+     * When the drill path optimization is enabled, the hole lists are optimized like in
+     * the drill files, to give the drill travel before and after the optimization.
      */
 
     bool buildNPTHlist = false;     // First pass: build PTH list only
@@ -344,7 +346,7 @@ bool GENDRILL_WRITER_BASE::GenDrillReportFile( const wxString& aFullFileName )
     {
         DRILL_LAYER_PAIR  pair = hole_sets[pair_ndx];
 
-        buildHolesList( pair, buildNPTHlist );
+        buildHolesList( pair, buildNPTHlist, m_optimizePath );
 
         if( pair == DRILL_LAYER_PAIR( F_Cu, B_Cu ) )
         {
@@ -380,7 +382,7 @@ bool GENDRILL_WRITER_BASE::GenDrillReportFile( const wxString& aFullFileName )
     if( !m_merge_PTH_NPTH )
         buildNPTHlist = true;
 
-    buildHolesList( DRILL_LAYER_PAIR( F_Cu, B_Cu ), buildNPTHlist );
+    buildHolesList( DRILL_LAYER_PAIR( F_Cu, B_Cu ), buildNPTHlist, m_optimizePath );
 
     // nothing wrong with an empty NPTH file in report.
     if( m_merge_PTH_NPTH )
@@ -426,6 +428,8 @@ bool GENDRILL_WRITER_BASE::plotDrillMarks( PLOTTER* aPlotter )
 unsigned GENDRILL_WRITER_BASE::printToolSummary( OUTPUTFORMATTER& out, bool aSummaryNPTH ) const
 {
     unsigned totalHoleCount = 0;
+    double   pathLength = 0.0;
+    double   optimizedPathLength = 0.0;
 
     for( unsigned ii = 0; ii < m_toolListBuffer.size(); ii++ )
     {
@@ -458,9 +462,27 @@ unsigned GENDRILL_WRITER_BASE::printToolSummary( OUTPUTFORMATTER& out, bool aSum
                      tool.m_TotalCount, tool.m_OvalCount );
 
         totalHoleCount += tool.m_TotalCount;
+        pathLength += tool.m_PathLength;
+        optimizedPathLength += tool.m_OptimizedPathLength;
     }
 
     out.Print( 0, "\n" );
 
+    // Travel of the drill between holes of the same tool
+    if( totalHoleCount )
+    {
+        if( m_optimizePath )
+        {
+            out.Print( 0, "    Drill travel before path optimization %.1fmm\n",
+                       pathLength / IU_PER_MM );
+            out.Print( 0, "    Drill travel after path optimization %.1fmm\n",
+                       optimizedPathLength / IU_PER_MM );
+        }
+        else
+        {
+            out.Print( 0, "    Drill travel %.1fmm\n", pathLength / IU_PER_MM );
+        }
+    }
+
     return totalHoleCount;
 }
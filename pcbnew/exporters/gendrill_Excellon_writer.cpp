@@ -96,7 +96,7 @@ void EXCELLON_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
         // For separate drill files, the last layer pair is the NPTH drill file.
         bool doing_npth = m_merge_PTH_NPTH ? false : ( it == hole_sets.end() - 1 );
 
-        buildHolesList( pair, doing_npth );
+        buildHolesList( pair, doing_npth, m_optimizePath );
 
         // The file is created if it has holes, or if it is the non plated drill file
         // to be sure the NPTH file is up to date in separate files mode.
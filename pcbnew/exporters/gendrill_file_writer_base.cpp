@@ -30,6 +30,15 @@
 #include <reporter.h>
 
 #include <gendrill_file_writer_base.h>
+#include <drill_path_optimizer.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+
+// Time allowed to optimize the drill path of all the tools of a hole list, in ms
+static const int DRILL_PATH_OPTIMIZATION_TIME = 2000;
 
 
 /* Helper function for sorting hole list.
@@ -70,7 +79,7 @@ static bool CmpHoleSorting( const HOLE_INFO& a, const HOLE_INFO& b )
 
 
 void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
-                                           bool aGenerateNPTH_list )
+                                           bool aGenerateNPTH_list, bool aOptimizePath )
 {
     HOLE_INFO new_hole;
 
@@ -186,6 +195,62 @@ void GENDRILL_WRITER_BASE::buildHolesList( DRILL_LAYER_PAIR aLayerPair,
         if( m_holeListBuffer[ii].m_Hole_Shape )
             m_toolListBuffer.back().m_OvalCount++;
     }
+
+    // Holes of a tool are consecutive in m_holeListBuffer
+    std::vector<size_t> toolStart( m_toolListBuffer.size() + 1, m_holeListBuffer.size() );
+
+    for( unsigned ii = m_holeListBuffer.size(); ii > 0; ii-- )
+        toolStart[ m_holeListBuffer[ii - 1].m_Tool_Reference - 1 ] = ii - 1;
+
+    // Optimize the tool paths in parallel, one tool at a time per thread
+    auto deadline = std::chrono::steady_clock::now()
+                    + std::chrono::milliseconds( DRILL_PATH_OPTIMIZATION_TIME );
+    std::atomic<size_t> nextTool( 0 );
+
+    auto path_lambda = [&]() -> size_t
+    {
+        for( size_t tool = nextTool++; tool < m_toolListBuffer.size(); tool = nextTool++ )
+        {
+            auto first = m_holeListBuffer.begin() + toolStart[tool];
+            auto last = m_holeListBuffer.begin() + toolStart[tool + 1];
+            std::vector<wxPoint> positions;
+
+            for( auto it = first; it != last; ++it )
+                positions.push_back( it->m_Hole_Pos );
+
+            DRILL_TOOL& drillTool = m_toolListBuffer[tool];
+            drillTool.m_PathLength = DrillPathLength( positions );
+
+            if( !aOptimizePath )
+                continue;
+
+            std::vector<int> order = OptimizeDrillPath( positions, deadline );
+            std::vector<HOLE_INFO> holes( first, last );
+
+            for( size_t ii = 0; ii < order.size(); ii++ )
+                *( first + ii ) = holes[ order[ii] ];
+
+            drillTool.m_OptimizedPathLength = DrillPathLength( positions, order );
+        }
+
+        return 1;
+    };
+
+    size_t parallelThreadCount = aOptimizePath ?
+            std::min<size_t>( std::thread::hardware_concurrency(), m_toolListBuffer.size() ) : 1;
+
+    if( parallelThreadCount <= 1 )
+        path_lambda();
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, path_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
 }
 
 
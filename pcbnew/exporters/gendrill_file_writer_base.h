@@ -42,6 +42,8 @@ public:
     int m_TotalCount;       // how many times it is used (round and oblong)
     int m_OvalCount;        // oblong count
     bool m_Hole_NotPlated;  // Is the hole plated or not plated
+    double m_PathLength;    // travel between the holes, in hole list order
+    double m_OptimizedPathLength;   // travel after the path optimization, 0 if not optimized
 
 public:
     DRILL_TOOL( int aDiameter, bool a_NotPlated )
@@ -50,6 +52,8 @@ public:
         m_OvalCount      = 0;
         m_Diameter       = aDiameter;
         m_Hole_NotPlated = a_NotPlated;
+        m_PathLength     = 0.0;
+        m_OptimizedPathLength = 0.0;
     }
 };
 
@@ -143,6 +147,8 @@ protected:
                                                         // Excellon/Gerber units (i.e inches or mm)
     wxPoint                  m_offset;                  // Drill offset coordinates
     bool                     m_merge_PTH_NPTH;          // True to generate only one drill file
+    bool                     m_optimizePath;            // True to reorder the holes of each tool
+                                                        // to shorten the drill travel
     std::vector<HOLE_INFO>   m_holeListBuffer;          // Buffer containing holes
     std::vector<DRILL_TOOL>  m_toolListBuffer;          // Buffer containing tools
 
@@ -160,6 +166,7 @@ protected:
         m_mapFileFmt = PLOT_FORMAT_PDF;
         m_pageInfo = NULL;
         m_merge_PTH_NPTH = false;
+        m_optimizePath = false;
         m_zeroFormat = DECIMAL_FORMAT;
     }
 
@@ -175,6 +182,14 @@ public:
      */
     void SetMergeOption( bool aMerge ) { m_merge_PTH_NPTH = aMerge; }
 
+    /**
+     * set the option to optimize the order of the holes of each tool
+     * @param aOptimize = true to shorten the drill travel (the drill report gives the
+     * travel before the optimization)
+     * = false to drill the holes in the order of the hole list sort
+     */
+    void SetOptimizePathOption( bool aOptimize ) { m_optimizePath = aOptimize; }
+
     /**
      * Return the plot offset (usually the position
      * of the auxiliary axis
@@ -287,9 +302,12 @@ protected:
      * @param aGenerateNPTH_list :
      *       true to create NPTH only list (with no plated holes)
      *       false to created plated holes list (with no NPTH )
+     * @param aOptimizePath = true to reorder the holes of each tool to shorten the drill
+     *       travel (only useful for drill files and the drill report, as it takes time
+     *       on large boards)
      */
     void buildHolesList( DRILL_LAYER_PAIR aLayerPair,
-                         bool aGenerateNPTH_list );
+                         bool aGenerateNPTH_list, bool aOptimizePath = false );
 
     int  getHolesCount() const { return m_holeListBuffer.size(); }
 
@@ -308,7 +326,8 @@ protected:
 
     /**
      * Function printToolSummary
-     * prints m_toolListBuffer[] tools to aOut and returns total hole count.
+     * prints m_toolListBuffer[] tools and their drill travel to aOut and returns total
+     * hole count.
      * @param aOut = the current OUTPUTFORMATTER to print summary
      * @param aSummaryNPTH = true to print summary for NPTH, false for PTH
      */
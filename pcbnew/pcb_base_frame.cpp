@@ -76,6 +76,19 @@ static const wxChar DisplayModuleTextEntry[] = wxT( "DiModTx" );
 static const wxChar FastGrid1Entry[] = wxT( "FastGrid1" );
 static const wxChar FastGrid2Entry[] = wxT( "FastGrid2" );
 
+/**
+ * Integer to set the memory budget of each of the undo and redo lists, in MB.  If zero, the
+ * memory used by the undo and redo lists is unlimited.
+ *
+ * Present as:
+ *
+ * - PcbFrameDevelMaxUndoMemory (file: pcbnew)
+ * - ModEditFrameDevelMaxUndoMemory (file: pcbnew)
+ *
+ * \ingroup develconfig
+ */
+static const wxChar MaxUndoMemoryEntry[] = wxT( "DevelMaxUndoMemory" );
+
 
 BEGIN_EVENT_TABLE( PCB_BASE_FRAME, EDA_DRAW_FRAME )
     EVT_MENU_RANGE( ID_POPUP_PCB_ITEM_SELECTION_START, ID_POPUP_PCB_ITEM_SELECTION_END,
@@ -116,6 +129,8 @@ PCB_BASE_FRAME::PCB_BASE_FRAME( KIWAY* aKiway, wxWindow* aParent, FRAME_T aFrame
     m_FastGrid1           = 0;
     m_FastGrid2           = 0;
 
+    m_UndoMemoryMax       = DEFAULT_MAX_UNDO_MEMORY_MB;
+
     m_zoomLevelCoeff      = 11.0 * IU_PER_MILS;  // Adjusted to roughly displays zoom level = 1
                                         // when the screen shows a 1:1 image
                                         // obviously depends on the monitor,
@@ -995,6 +1010,9 @@ void PCB_BASE_FRAME::LoadSettings( wxConfigBase* aCfg )
     m_FastGrid2 = itmp;
 
     aCfg->Read( baseCfgName + DisplayModuleTextEntry, &m_DisplayOptions.m_DisplayModTextFill, true );
+
+    aCfg->Read( baseCfgName + MaxUndoMemoryEntry, &itmp, ( long )DEFAULT_MAX_UNDO_MEMORY_MB );
+    m_UndoMemoryMax = itmp > 0 ? itmp : 0;
 }
 
 
@@ -1014,6 +1032,7 @@ void PCB_BASE_FRAME::SaveSettings( wxConfigBase* aCfg )
     aCfg->Write( baseCfgName + DisplayModuleTextEntry, m_DisplayOptions.m_DisplayModTextFill );
     aCfg->Write( baseCfgName + FastGrid1Entry, ( long )m_FastGrid1 );
     aCfg->Write( baseCfgName + FastGrid2Entry, ( long )m_FastGrid2 );
+    aCfg->Write( baseCfgName + MaxUndoMemoryEntry, ( long )m_UndoMemoryMax );
 }
 
 
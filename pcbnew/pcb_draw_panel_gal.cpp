@@ -45,6 +45,9 @@
 #include <thread>
 using namespace std::placeholders;
 
+/// Minimal size (in pixels) of an item drawn on the technical layers
+static const double MIN_DETAIL_SCREEN_SIZE = 2.0;
+
 const LAYER_NUM GAL_LAYER_ORDER[] =
 {
     LAYER_GP_OVERLAY,
@@ -463,6 +466,17 @@ void PCB_DRAW_PANEL_GAL::setDefaultLayerDeps()
             m_view->SetLayerDisplayOnly( layer );
     }
 
+    // Texts and graphic details that are too small to be recognized are skipped on
+    // technical layers when the board is zoomed out. Copper, mask, paste and board edge
+    // layers are always drawn in full, so no pad, track or outline disappears.
+    LSET detailLayers( 10, F_SilkS, B_SilkS, F_Fab, B_Fab, F_CrtYd, B_CrtYd,
+                       Dwgs_User, Cmts_User, Eco1_User, Eco2_User );
+
+    for( PCB_LAYER_ID layer : detailLayers.Seq() )
+        m_view->SetLayerMinScreenSize( layer, MIN_DETAIL_SCREEN_SIZE );
+
+    m_view->SetLayerMinScreenSize( LAYER_MOD_TEXT_INVISIBLE, MIN_DETAIL_SCREEN_SIZE );
+
     m_view->SetLayerTarget( LAYER_ANCHOR, KIGFX::TARGET_NONCACHED );
     m_view->SetLayerDisplayOnly( LAYER_ANCHOR );
 
@@ -346,6 +346,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
     SetScreen( new PCB_SCREEN( GetPageSettings().GetSizeIU() ) );
     GetScreen()->SetMaxUndoItems( m_UndoRedoCountMax );
+    GetScreen()->SetMaxUndoMemory( size_t( m_UndoMemoryMax ) * 1024 * 1024 );
 
     // PCB drawings start in the upper left corner.
     GetScreen()->m_Center = false;
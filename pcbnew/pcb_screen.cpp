@@ -24,11 +24,21 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <unordered_set>
+
 #include <fctsys.h>
 #include <common.h>
 #include <macros.h>
 #include <trigo.h>
 #include <pcb_screen.h>
+#include <undo_redo_container.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_edge_mod.h>
+#include <class_pcb_text.h>
+#include <class_track.h>
+#include <class_dimension.h>
+#include <class_zone.h>
 #include <eda_text.h>                // FILLED
 #include <base_units.h>
 
@@ -173,6 +183,8 @@ PCB_SCREEN::PCB_SCREEN( const wxSize& aPageSizeIU ) :
     m_Route_Layer_TOP    = F_Cu;     // default layers pair for vias (bottom to top)
     m_Route_Layer_BOTTOM = B_Cu;
 
+    m_undoMemoryMax = 0;
+
     SetZoom( DEFAULT_ZOOM );             // a default value for zoom
 
     InitDataPoints( aPageSizeIU );
@@ -189,3 +201,177 @@ int PCB_SCREEN::MilsToIuScalar()
 {
     return static_cast<int>( IU_PER_MILS );
 }
+
+
+/**
+ * Function estimateMemoryUsage
+ * @return an estimate of the memory used by a board item stored in the undo list, in bytes.
+ */
+static size_t estimateMemoryUsage( const EDA_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_ZONE_AREA_T:
+    {
+        auto zone = static_cast<const ZONE_CONTAINER*>( aItem );
+
+        return sizeof( ZONE_CONTAINER ) + zone->Outline()->GetMemoryUsage()
+               + zone->GetFilledPolysList().GetMemoryUsage()
+               + zone->FillSegments().capacity() * sizeof( SEG )
+               + zone->GetHatchLines().capacity() * sizeof( SEG );
+    }
+
+    case PCB_MODULE_T:
+    {
+        auto module = static_cast<const MODULE*>( aItem );
+        size_t usage = sizeof( MODULE );
+
+        for( const D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+            usage += estimateMemoryUsage( pad );
+
+        for( const BOARD_ITEM* item = module->GraphicalItemsList(); item; item = item->Next() )
+            usage += estimateMemoryUsage( item );
+
+        return usage;
+    }
+
+    case PCB_PAD_T:
+    {
+        auto pad = static_cast<const D_PAD*>( aItem );
+
+        return sizeof( D_PAD ) + pad->GetCustomShapeAsPolygon().GetMemoryUsage()
+               + pad->GetPrimitives().capacity() * sizeof( PAD_CS_PRIMITIVE );
+    }
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        auto segment = static_cast<const DRAWSEGMENT*>( aItem );
+
+        size_t usage = aItem->Type() == PCB_LINE_T ? sizeof( DRAWSEGMENT ) : sizeof( EDGE_MODULE );
+
+        return usage + segment->GetPolyShape().GetMemoryUsage()
+               + segment->GetBezierPoints().capacity() * sizeof( wxPoint );
+    }
+
+    case PCB_TRACE_T:
+        return sizeof( TRACK );
+
+    case PCB_VIA_T:
+        return sizeof( VIA );
+
+    case PCB_TEXT_T:
+        return sizeof( TEXTE_PCB );
+
+    case PCB_MODULE_TEXT_T:
+        return sizeof( TEXTE_MODULE );
+
+    case PCB_DIMENSION_T:
+        return sizeof( DIMENSION );
+
+    default:
+        return sizeof( BOARD_ITEM );
+    }
+}
+
+
+/**
+ * Function estimateMemoryUsage
+ * @return an estimate of the memory used by the item copies owned by a command, in bytes.
+ * An item picked several times (e.g. as the link of a picker and the item of another one)
+ * is only counted once.
+ */
+static size_t estimateMemoryUsage( const PICKED_ITEMS_LIST& aCommand )
+{
+    size_t usage = sizeof( PICKED_ITEMS_LIST ) + aCommand.GetCount() * sizeof( ITEM_PICKER );
+    std::unordered_set<const EDA_ITEM*> counted;
+
+    auto countItem = [&]( const EDA_ITEM* aItem )
+    {
+        if( aItem && counted.insert( aItem ).second )
+            usage += estimateMemoryUsage( aItem );
+    };
+
+    for( unsigned ii = 0; ii < aCommand.GetCount(); ii++ )
+    {
+        // Same ownership rules as PICKED_ITEMS_LIST::ClearListAndDeleteItems()
+        countItem( aCommand.GetPickedItemLink( ii ) );
+
+        if( aCommand.GetPickedItemStatus( ii ) == UR_DELETED
+                || ( aCommand.GetPickerFlags( ii ) & UR_TRANSIENT ) )
+            countItem( aCommand.GetPickedItem( ii ) );
+    }
+
+    return usage;
+}
+
+
+void PCB_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aItem )
+{
+    size_t usage = estimateMemoryUsage( *aItem );
+
+    m_undoMemory.m_CommandsUsage.push_back( usage );
+    m_undoMemory.m_Total += usage;
+
+    BASE_SCREEN::PushCommandToUndoList( aItem );
+    trimUndoORRedoList( m_UndoList );
+}
+
+
+void PCB_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aItem )
+{
+    size_t usage = estimateMemoryUsage( *aItem );
+
+    m_redoMemory.m_CommandsUsage.push_back( usage );
+    m_redoMemory.m_Total += usage;
+
+    BASE_SCREEN::PushCommandToRedoList( aItem );
+    trimUndoORRedoList( m_RedoList );
+}
+
+
+PICKED_ITEMS_LIST* PCB_SCREEN::PopCommandFromUndoList()
+{
+    PICKED_ITEMS_LIST* command = BASE_SCREEN::PopCommandFromUndoList();
+
+    if( command && !m_undoMemory.m_CommandsUsage.empty() )
+    {
+        m_undoMemory.m_Total -= m_undoMemory.m_CommandsUsage.back();
+        m_undoMemory.m_CommandsUsage.pop_back();
+    }
+
+    return command;
+}
+
+
+PICKED_ITEMS_LIST* PCB_SCREEN::PopCommandFromRedoList()
+{
+    PICKED_ITEMS_LIST* command = BASE_SCREEN::PopCommandFromRedoList();
+
+    if( command && !m_redoMemory.m_CommandsUsage.empty() )
+    {
+        m_redoMemory.m_Total -= m_redoMemory.m_CommandsUsage.back();
+        m_redoMemory.m_CommandsUsage.pop_back();
+    }
+
+    return command;
+}
+
+
+void PCB_SCREEN::trimUndoORRedoList( UNDO_REDO_CONTAINER& aList )
+{
+    if( m_undoMemoryMax == 0 )
+        return;
+
+    UNDO_MEMORY& memory = undoMemory( aList );
+
+    // Commands are deleted from the oldest one, but the last one pushed is always kept
+    int extraitems = 0;
+    size_t total = memory.m_Total;
+
+    while( total > m_undoMemoryMax && extraitems + 1 < (int) memory.m_CommandsUsage.size() )
+        total -= memory.m_CommandsUsage[extraitems++];
+
+    if( extraitems > 0 )
+        ClearUndoORRedoList( aList, extraitems );
+}
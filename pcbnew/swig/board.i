@@ -167,5 +167,67 @@ HANDLE_EXCEPTIONS(BOARD::TracksInNetBetweenPoints)
         # netclassmap = deepcopy(netclassmap)
         netclassmap['Default'] = self.GetNetClasses().GetDefault()
         return netclassmap
+
+    def _BulkArray(self, buffer, columns):
+        """
+        Return buffer as rows of columns 32 bit integers.  With Python 3 this is a
+        memoryview on the buffer, with Python 2 the bytearray itself; in both cases
+        numpy.frombuffer(array, numpy.int32).reshape(-1, columns) wraps it without a copy.
+        """
+        if not hasattr(memoryview, "cast") or len(buffer) == 0:
+            return buffer
+        return memoryview(buffer).cast('i', [len(buffer) // (4 * columns), columns])
+
+    def GetTracksArray(self):
+        """
+        Return the track segments (vias excluded) as an array of BULK_TRACK_COLUMN_COUNT
+        integers per segment, see the BULK_TRACK_* column indices.
+        """
+        return self._BulkArray(BulkGetTracks(self), BULK_TRACK_COLUMN_COUNT)
+
+    def GetViasArray(self):
+        """
+        Return the vias as an array of BULK_VIA_COLUMN_COUNT integers per via.
+        """
+        return self._BulkArray(BulkGetVias(self), BULK_VIA_COLUMN_COUNT)
+
+    def GetPadsArray(self):
+        """
+        Return the pads of all the footprints as an array of BULK_PAD_COLUMN_COUNT integers
+        per pad.
+        """
+        return self._BulkArray(BulkGetPads(self), BULK_PAD_COLUMN_COUNT)
+
+    def GetZoneFillsArray(self):
+        """
+        Return the vertices of all the zone fills as an array of
+        BULK_ZONE_FILL_COLUMN_COUNT integers per vertex.
+        """
+        return self._BulkArray(BulkGetZoneFills(self), BULK_ZONE_FILL_COLUMN_COUNT)
+
+    def SetTracksArray(self, array):
+        """
+        Set the start, end and width of the track segments from an array laid out as
+        returned by GetTracksArray().
+        """
+        BulkSetTracks(self, array)
+
+    def SetViasArray(self, array):
+        """
+        Set the position, width and drill of the vias from an array laid out as returned
+        by GetViasArray().
+        """
+        BulkSetVias(self, array)
+
+    def SetPadsArray(self, array):
+        """
+        Set the position of the pads from an array laid out as returned by GetPadsArray().
+        """
+        BulkSetPads(self, array)
     %}
 }
+
+%include pcbnew_bulk_access.h
+%{
+#include <pcbnew_bulk_access.h>
+%}
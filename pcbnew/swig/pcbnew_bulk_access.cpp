@@ -0,0 +1,394 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcbnew_bulk_access.cpp
+ * @brief Bulk access to the board items for Python scripts
+ */
+
+#include <Python.h>
+#undef HAVE_CLOCK_GETTIME  // macro is defined in Python.h and causes redefine warning
+
+#include <cstdint>
+#include <cstring>
+
+#include <pcbnew_bulk_access.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+
+/**
+ * Creates a bytearray for aRows rows of aColumns integers.
+ * @return the bytearray, or NULL (with a Python exception set) if out of memory.
+ */
+static PyObject* newArray( size_t aRows, int aColumns, int32_t** aData )
+{
+    PyObject* array = PyByteArray_FromStringAndSize( NULL,
+                                                     aRows * aColumns * sizeof( int32_t ) );
+
+    if( array )
+        *aData = reinterpret_cast<int32_t*>( PyByteArray_AS_STRING( array ) );
+
+    return array;
+}
+
+
+/**
+ * @return true if the items of aView are 32 bit signed integers in the native byte order,
+ * or untyped bytes (such as the bytearrays returned by the getters).
+ */
+static bool isInt32Buffer( const Py_buffer& aView )
+{
+    const uint16_t one = 1;
+    const char     nativeOrder = *reinterpret_cast<const char*>( &one ) ? '<' : '>';
+    const char*    format = aView.format ? aView.format : "B";
+
+    if( aView.itemsize == 1 && strcmp( format, "B" ) == 0 )
+        return true;
+
+    if( *format == '@' || *format == '=' || *format == nativeOrder )
+        format++;
+
+    return aView.itemsize == sizeof( int32_t )
+           && ( strcmp( format, "i" ) == 0 || strcmp( format, "l" ) == 0 );
+}
+
+
+/**
+ * Class BULK_INPUT
+ * gives access to the rows of a Python buffer passed to a bulk setter.
+ */
+class BULK_INPUT
+{
+public:
+    BULK_INPUT() :
+        m_valid( false )
+    {
+    }
+
+    ~BULK_INPUT()
+    {
+        if( m_valid )
+            PyBuffer_Release( &m_view );
+    }
+
+    /**
+     * Gets the contents of aObject, which must have aRows rows of aColumns 32 bit integers.
+     * @return false (with a Python exception set) if it does not.
+     */
+    bool Open( PyObject* aObject, size_t aRows, int aColumns )
+    {
+        if( PyObject_GetBuffer( aObject, &m_view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT ) != 0 )
+            return false;
+
+        m_valid = true;
+        m_columns = aColumns;
+
+        // Other items of the same total size (e.g. int64 or float arrays) would be misread
+        if( !isInt32Buffer( m_view ) )
+        {
+            PyErr_Format( PyExc_TypeError,
+                          "buffer holds items of format '%s' and size %zd, "
+                          "32 bit integers were expected",
+                          m_view.format ? m_view.format : "B", m_view.itemsize );
+            return false;
+        }
+
+        size_t expected = aRows * aColumns * sizeof( int32_t );
+
+        if( (size_t) m_view.len != expected )
+        {
+            PyErr_Format( PyExc_ValueError,
+                          "buffer holds %zd bytes, %zu rows of %d 32 bit integers were expected",
+                          m_view.len, aRows, aColumns );
+            return false;
+        }
+
+        return true;
+    }
+
+    /// Copies the row aRow in aData, the buffer may not be aligned.
+    void Row( size_t aRow, int32_t* aData ) const
+    {
+        memcpy( aData, static_cast<const char*>( m_view.buf ) + aRow * m_columns * sizeof( int32_t ),
+                m_columns * sizeof( int32_t ) );
+    }
+
+private:
+    Py_buffer m_view;
+    bool      m_valid;
+    int       m_columns;
+};
+
+
+static size_t countTracks( const BOARD* aBoard, KICAD_T aType )
+{
+    size_t count = 0;
+
+    for( const TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() == aType )
+            count++;
+    }
+
+    return count;
+}
+
+
+static size_t countPads( const BOARD* aBoard )
+{
+    size_t count = 0;
+
+    for( const MODULE* module = aBoard->m_Modules; module; module = module->Next() )
+        count += module->PadsList().GetCount();
+
+    return count;
+}
+
+
+PyObject* BulkGetTracks( const BOARD* aBoard )
+{
+    int32_t*  row;
+    PyObject* array = newArray( countTracks( aBoard, PCB_TRACE_T ), BULK_TRACK_COLUMN_COUNT,
+                                &row );
+
+    if( !array )
+        return NULL;
+
+    for( const TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() != PCB_TRACE_T )
+            continue;
+
+        row[BULK_TRACK_START_X] = track->GetStart().x;
+        row[BULK_TRACK_START_Y] = track->GetStart().y;
+        row[BULK_TRACK_END_X]   = track->GetEnd().x;
+        row[BULK_TRACK_END_Y]   = track->GetEnd().y;
+        row[BULK_TRACK_WIDTH]   = track->GetWidth();
+        row[BULK_TRACK_LAYER]   = track->GetLayer();
+        row[BULK_TRACK_NET]     = track->GetNetCode();
+
+        row += BULK_TRACK_COLUMN_COUNT;
+    }
+
+    return array;
+}
+
+
+PyObject* BulkGetVias( const BOARD* aBoard )
+{
+    int32_t*  row;
+    PyObject* array = newArray( countTracks( aBoard, PCB_VIA_T ), BULK_VIA_COLUMN_COUNT, &row );
+
+    if( !array )
+        return NULL;
+
+    for( const TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() != PCB_VIA_T )
+            continue;
+
+        const VIA*   via = static_cast<const VIA*>( track );
+        PCB_LAYER_ID top, bottom;
+
+        via->LayerPair( &top, &bottom );
+
+        row[BULK_VIA_X]            = via->GetStart().x;
+        row[BULK_VIA_Y]            = via->GetStart().y;
+        row[BULK_VIA_WIDTH]        = via->GetWidth();
+        row[BULK_VIA_DRILL]        = via->GetDrillValue();
+        row[BULK_VIA_TOP_LAYER]    = top;
+        row[BULK_VIA_BOTTOM_LAYER] = bottom;
+        row[BULK_VIA_NET]          = via->GetNetCode();
+        row[BULK_VIA_TYPE]         = via->GetViaType();
+
+        row += BULK_VIA_COLUMN_COUNT;
+    }
+
+    return array;
+}
+
+
+PyObject* BulkGetPads( const BOARD* aBoard )
+{
+    int32_t*  row;
+    PyObject* array = newArray( countPads( aBoard ), BULK_PAD_COLUMN_COUNT, &row );
+
+    if( !array )
+        return NULL;
+
+    for( const MODULE* module = aBoard->m_Modules; module; module = module->Next() )
+    {
+        for( const D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+        {
+            row[BULK_PAD_X]           = pad->GetPosition().x;
+            row[BULK_PAD_Y]           = pad->GetPosition().y;
+            row[BULK_PAD_SIZE_X]      = pad->GetSize().x;
+            row[BULK_PAD_SIZE_Y]      = pad->GetSize().y;
+            row[BULK_PAD_ORIENTATION] = KiROUND( pad->GetOrientation() );
+            row[BULK_PAD_SHAPE]       = pad->GetShape();
+            row[BULK_PAD_ATTRIBUTE]   = pad->GetAttribute();
+            row[BULK_PAD_DRILL_X]     = pad->GetDrillSize().x;
+            row[BULK_PAD_DRILL_Y]     = pad->GetDrillSize().y;
+            row[BULK_PAD_NET]         = pad->GetNetCode();
+
+            row += BULK_PAD_COLUMN_COUNT;
+        }
+    }
+
+    return array;
+}
+
+
+PyObject* BulkGetZoneFills( const BOARD* aBoard )
+{
+    size_t count = 0;
+
+    for( int ii = 0; ii < aBoard->GetAreaCount(); ii++ )
+        count += aBoard->GetArea( ii )->GetFilledPolysList().TotalVertices();
+
+    int32_t*  row;
+    PyObject* array = newArray( count, BULK_ZONE_FILL_COLUMN_COUNT, &row );
+
+    if( !array )
+        return NULL;
+
+    for( int ii = 0; ii < aBoard->GetAreaCount(); ii++ )
+    {
+        const SHAPE_POLY_SET& fill = aBoard->GetArea( ii )->GetFilledPolysList();
+
+        for( int polygon = 0; polygon < fill.OutlineCount(); polygon++ )
+        {
+            const SHAPE_POLY_SET::POLYGON& contours = fill.CPolygon( polygon );
+
+            for( size_t contour = 0; contour < contours.size(); contour++ )
+            {
+                const SHAPE_LINE_CHAIN& chain = contours[contour];
+
+                for( int jj = 0; jj < chain.PointCount(); jj++ )
+                {
+                    const VECTOR2I& pt = chain.CPoint( jj );
+
+                    row[BULK_ZONE_FILL_ZONE]    = ii;
+                    row[BULK_ZONE_FILL_POLYGON] = polygon;
+                    row[BULK_ZONE_FILL_CONTOUR] = contour;
+                    row[BULK_ZONE_FILL_X]       = pt.x;
+                    row[BULK_ZONE_FILL_Y]       = pt.y;
+
+                    row += BULK_ZONE_FILL_COLUMN_COUNT;
+                }
+            }
+        }
+    }
+
+    return array;
+}
+
+
+PyObject* BulkSetTracks( BOARD* aBoard, PyObject* aBuffer )
+{
+    BULK_INPUT input;
+
+    if( !input.Open( aBuffer, countTracks( aBoard, PCB_TRACE_T ), BULK_TRACK_COLUMN_COUNT ) )
+        return NULL;
+
+    int32_t row[BULK_TRACK_COLUMN_COUNT];
+    size_t  ii = 0;
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() != PCB_TRACE_T )
+            continue;
+
+        input.Row( ii++, row );
+
+        track->SetStart( wxPoint( row[BULK_TRACK_START_X], row[BULK_TRACK_START_Y] ) );
+        track->SetEnd( wxPoint( row[BULK_TRACK_END_X], row[BULK_TRACK_END_Y] ) );
+        track->SetWidth( row[BULK_TRACK_WIDTH] );
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+PyObject* BulkSetVias( BOARD* aBoard, PyObject* aBuffer )
+{
+    BULK_INPUT input;
+
+    if( !input.Open( aBuffer, countTracks( aBoard, PCB_VIA_T ), BULK_VIA_COLUMN_COUNT ) )
+        return NULL;
+
+    int32_t row[BULK_VIA_COLUMN_COUNT];
+    size_t  ii = 0;
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() != PCB_VIA_T )
+            continue;
+
+        VIA* via = static_cast<VIA*>( track );
+
+        input.Row( ii++, row );
+
+        via->SetPosition( wxPoint( row[BULK_VIA_X], row[BULK_VIA_Y] ) );
+        via->SetWidth( row[BULK_VIA_WIDTH] );
+
+        // Keep the net class default drill when it is not changed
+        if( row[BULK_VIA_DRILL] != via->GetDrillValue() )
+            via->SetDrill( row[BULK_VIA_DRILL] );
+    }
+
+    Py_RETURN_NONE;
+}
+
+
+PyObject* BulkSetPads( BOARD* aBoard, PyObject* aBuffer )
+{
+    BULK_INPUT input;
+
+    if( !input.Open( aBuffer, countPads( aBoard ), BULK_PAD_COLUMN_COUNT ) )
+        return NULL;
+
+    int32_t row[BULK_PAD_COLUMN_COUNT];
+    size_t  ii = 0;
+
+    for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->PadsList(); pad; pad = pad->Next() )
+        {
+            input.Row( ii++, row );
+
+            pad->SetPosition( wxPoint( row[BULK_PAD_X], row[BULK_PAD_Y] ) );
+
+            // The position relative to the footprint is the one saved in files
+            pad->SetLocalCoord();
+        }
+
+        module->CalculateBoundingBox();
+    }
+
+    Py_RETURN_NONE;
+}
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcbnew_bulk_access.h
+ * @brief Bulk access to the board items for Python scripts
+ *
+ * Instead of one Python call (and one wrapper object) per item and per property, these
+ * functions copy the properties of all the tracks, vias, pads or zone fill vertices of a
+ * board in one pass into a Python bytearray.  Each item is a row of 32 bit integers, the
+ * columns are listed below.  Scripts can wrap the buffer without copying it, e.g. with
+ * numpy.frombuffer( buffer, dtype=numpy.int32 ).reshape( -1, column_count ).
+ *
+ * The setters take any object supporting the buffer protocol, with the same layout and
+ * the same number of rows, in the same order as returned by the getters.  Its items must be
+ * 32 bit integers (e.g. a numpy.int32 array) or untyped bytes; other item types raise a
+ * TypeError.
+ */
+
+#ifndef PCBNEW_BULK_ACCESS_H
+#define PCBNEW_BULK_ACCESS_H
+
+#include <Python.h>
+
+class BOARD;
+
+
+///> Columns of the track segment arrays (vias excluded)
+enum BULK_TRACK_COLUMNS
+{
+    BULK_TRACK_START_X = 0,
+    BULK_TRACK_START_Y,
+    BULK_TRACK_END_X,
+    BULK_TRACK_END_Y,
+    BULK_TRACK_WIDTH,
+    BULK_TRACK_LAYER,
+    BULK_TRACK_NET,
+    BULK_TRACK_COLUMN_COUNT
+};
+
+///> Columns of the via arrays
+enum BULK_VIA_COLUMNS
+{
+    BULK_VIA_X = 0,
+    BULK_VIA_Y,
+    BULK_VIA_WIDTH,
+    BULK_VIA_DRILL,
+    BULK_VIA_TOP_LAYER,
+    BULK_VIA_BOTTOM_LAYER,
+    BULK_VIA_NET,
+    BULK_VIA_TYPE,
+    BULK_VIA_COLUMN_COUNT
+};
+
+///> Columns of the pad arrays
+enum BULK_PAD_COLUMNS
+{
+    BULK_PAD_X = 0,
+    BULK_PAD_Y,
+    BULK_PAD_SIZE_X,
+    BULK_PAD_SIZE_Y,
+    BULK_PAD_ORIENTATION,       ///< in 0.1 degrees
+    BULK_PAD_SHAPE,
+    BULK_PAD_ATTRIBUTE,
+    BULK_PAD_DRILL_X,
+    BULK_PAD_DRILL_Y,
+    BULK_PAD_NET,
+    BULK_PAD_COLUMN_COUNT
+};
+
+///> Columns of the zone fill vertex arrays
+enum BULK_ZONE_FILL_COLUMNS
+{
+    BULK_ZONE_FILL_ZONE = 0,    ///< index of the zone, see BOARD::GetArea()
+    BULK_ZONE_FILL_POLYGON,     ///< index of the polygon in the zone fill
+    BULK_ZONE_FILL_CONTOUR,     ///< 0 for the outline, 1.. for the holes
+    BULK_ZONE_FILL_X,
+    BULK_ZONE_FILL_Y,
+    BULK_ZONE_FILL_COLUMN_COUNT
+};
+
+
+/// @return a bytearray holding the track segments of aBoard, see BULK_TRACK_COLUMNS.
+PyObject* BulkGetTracks( const BOARD* aBoard );
+
+/// @return a bytearray holding the vias of aBoard, see BULK_VIA_COLUMNS.
+PyObject* BulkGetVias( const BOARD* aBoard );
+
+/// @return a bytearray holding the pads of all the footprints of aBoard, see BULK_PAD_COLUMNS.
+PyObject* BulkGetPads( const BOARD* aBoard );
+
+/// @return a bytearray holding the vertices of the zone fills, see BULK_ZONE_FILL_COLUMNS.
+PyObject* BulkGetZoneFills( const BOARD* aBoard );
+
+/**
+ * Sets the start, end and width of the track segments of aBoard from aBuffer, laid out as
+ * returned by BulkGetTracks().  The other columns are ignored.
+ * @return None, or NULL with a Python exception set if aBuffer does not match the tracks.
+ */
+PyObject* BulkSetTracks( BOARD* aBoard, PyObject* aBuffer );
+
+/**
+ * Sets the position, width and drill of the vias of aBoard from aBuffer, laid out as
+ * returned by BulkGetVias().  The other columns are ignored.
+ */
+PyObject* BulkSetVias( BOARD* aBoard, PyObject* aBuffer );
+
+/**
+ * Sets the position of the pads of aBoard from aBuffer, laid out as returned by
+ * BulkGetPads().  The other columns are ignored.
+ */
+PyObject* BulkSetPads( BOARD* aBoard, PyObject* aBuffer );
+
+#endif  // PCBNEW_BULK_ACCESS_H
@@ -601,6 +601,8 @@ void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount
     if( aItemCount > 0 )
         icnt = aItemCount;
 
+    UNDO_MEMORY& memory = undoMemory( aList );
+
     for( unsigned ii = 0; ii < icnt; ii++ )
     {
         if( aList.m_CommandsList.size() == 0 )
@@ -609,6 +611,12 @@ void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount
         PICKED_ITEMS_LIST* curr_cmd = aList.m_CommandsList[0];
         aList.m_CommandsList.erase( aList.m_CommandsList.begin() );
 
+        if( !memory.m_CommandsUsage.empty() )
+        {
+            memory.m_Total -= memory.m_CommandsUsage.front();
+            memory.m_CommandsUsage.pop_front();
+        }
+
         curr_cmd->ClearListAndDeleteItems();
         delete curr_cmd;    // Delete command
     }
@@ -0,0 +1,191 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <cmath>
+#include <future>
+#include <random>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+/**
+ * Boolean operations on large operands are split across threads.  These tests check the
+ * result region against the source polygons, point by point, away from the edges (where
+ * the rounding of intersection points may differ from a single pass).
+ */
+BOOST_AUTO_TEST_SUITE( SPSBoolean )
+
+/**
+ * Builds many overlapping polygons (regular octagons with random centres and radii),
+ * enough to go through the multithreaded path.
+ */
+static std::vector<SHAPE_LINE_CHAIN> buildOctagons( int aCount, int aSeed )
+{
+    std::vector<SHAPE_LINE_CHAIN> octagons;
+    std::mt19937 rng( aSeed );
+    std::uniform_int_distribution<int> posDist( 0, 100000 );
+    std::uniform_int_distribution<int> radiusDist( 500, 5000 );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        const VECTOR2I centre( posDist( rng ), posDist( rng ) );
+        const int radius = radiusDist( rng );
+        SHAPE_LINE_CHAIN octagon;
+
+        for( int j = 0; j < 8; j++ )
+        {
+            double angle = M_PI / 4 * j;
+
+            octagon.Append( centre.x + std::lround( radius * std::cos( angle ) ),
+                            centre.y + std::lround( radius * std::sin( angle ) ) );
+        }
+
+        octagon.SetClosed( true );
+        octagons.push_back( octagon );
+    }
+
+    return octagons;
+}
+
+
+/**
+ * Returns 1 if aP is inside one of the chains, 0 if it is outside all of them, and -1 if
+ * it is too close to an edge to be checked.
+ */
+static int insideAny( const std::vector<SHAPE_LINE_CHAIN>& aChains, const VECTOR2I& aP )
+{
+    int inside = 0;
+
+    for( const SHAPE_LINE_CHAIN& chain : aChains )
+    {
+        if( chain.Distance( aP, true ) <= 2 )
+            return -1;
+
+        if( chain.PointInside( aP ) )
+            inside = 1;
+    }
+
+    return inside;
+}
+
+
+BOOST_AUTO_TEST_CASE( UnionOfManyPolygons )
+{
+    std::vector<SHAPE_LINE_CHAIN> octagons = buildOctagons( 600, 1 );
+    SHAPE_POLY_SET a, b;
+
+    for( size_t i = 0; i < octagons.size(); i++ )
+        ( i % 2 ? a : b ).AddOutline( octagons[i] );
+
+    a.BooleanAdd( b, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    BOOST_CHECK( !a.IsSelfIntersecting() );
+
+    for( int x = 0; x <= 100000; x += 997 )
+    {
+        for( int y = 0; y <= 100000; y += 991 )
+        {
+            const VECTOR2I p( x, y );
+            int expected = insideAny( octagons, p );
+
+            if( expected >= 0 )
+                BOOST_CHECK_EQUAL( a.Contains( p ), expected == 1 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( SubtractManyPolygons )
+{
+    std::vector<SHAPE_LINE_CHAIN> octagons = buildOctagons( 400, 2 );
+    SHAPE_LINE_CHAIN square;
+    SHAPE_POLY_SET area, holes;
+
+    square.Append( 10000, 10000 );
+    square.Append( 90000, 10000 );
+    square.Append( 90000, 90000 );
+    square.Append( 10000, 90000 );
+    square.SetClosed( true );
+    area.AddOutline( square );
+
+    for( const SHAPE_LINE_CHAIN& octagon : octagons )
+        holes.AddOutline( octagon );
+
+    area.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+
+    for( int x = 0; x <= 100000; x += 997 )
+    {
+        for( int y = 0; y <= 100000; y += 991 )
+        {
+            const VECTOR2I p( x, y );
+            int inHole = insideAny( octagons, p );
+
+            if( inHole < 0 || square.Distance( p, true ) <= 2 )
+                continue;
+
+            BOOST_CHECK_EQUAL( area.Contains( p ), square.PointInside( p ) && inHole == 0 );
+        }
+    }
+}
+
+/**
+ * Unions run concurrently share the worker threads, so they may run on fewer threads than
+ * a union run alone; the result must not depend on it.
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentUnions )
+{
+    std::vector<SHAPE_LINE_CHAIN> octagons = buildOctagons( 600, 3 );
+    SHAPE_POLY_SET source;
+
+    for( const SHAPE_LINE_CHAIN& octagon : octagons )
+        source.AddOutline( octagon );
+
+    auto unite = [&source]() -> SHAPE_POLY_SET
+    {
+        SHAPE_POLY_SET result;
+
+        result.BooleanAdd( source, SHAPE_POLY_SET::PM_FAST );
+        return result;
+    };
+
+    const SHAPE_POLY_SET expected = unite();
+    std::vector<std::future<SHAPE_POLY_SET>> results;
+
+    for( int i = 0; i < 4; i++ )
+        results.push_back( std::async( std::launch::async, unite ) );
+
+    for( std::future<SHAPE_POLY_SET>& future : results )
+    {
+        const SHAPE_POLY_SET result = future.get();
+
+        BOOST_REQUIRE_EQUAL( result.TotalVertices(), expected.TotalVertices() );
+
+        for( auto it = result.CIterateWithHoles(), ref = expected.CIterateWithHoles(); it;
+                it++, ref++ )
+            BOOST_CHECK( *it == *ref );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
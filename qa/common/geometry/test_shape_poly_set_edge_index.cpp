@@ -0,0 +1,176 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <cmath>
+#include <random>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include "fixtures_geometry.h"
+
+/**
+ * Builds a set of wavy, non-convex outlines, each one with a few holes, so that the edge
+ * index has a meaningful number of edges spread over many cells.
+ */
+static SHAPE_POLY_SET buildWavyPolySet()
+{
+    SHAPE_POLY_SET polySet;
+
+    for( int p = 0; p < 3; p++ )
+    {
+        const VECTOR2I centre( p * 25000, ( p % 2 ) * 7000 );
+        SHAPE_LINE_CHAIN outline;
+
+        for( int i = 0; i < 720; i++ )
+        {
+            double angle = 2.0 * M_PI * i / 720;
+            double radius = 10000 + 1500 * std::sin( angle * 17 ) + 300 * std::cos( angle * 91 );
+
+            outline.Append( centre.x + std::lround( radius * std::cos( angle ) ),
+                            centre.y + std::lround( radius * std::sin( angle ) ) );
+        }
+
+        outline.SetClosed( true );
+        polySet.AddOutline( outline );
+
+        for( int h = 0; h < 4; h++ )
+        {
+            const VECTOR2I holeCentre = centre + VECTOR2I( ( h % 2 ) ? 4000 : -4000,
+                                                            ( h / 2 ) ? 4000 : -4000 );
+            SHAPE_LINE_CHAIN hole;
+
+            for( int i = 0; i < 60; i++ )
+            {
+                double angle = 2.0 * M_PI * i / 60;
+                double radius = 1500 + 400 * std::sin( angle * 5 );
+
+                hole.Append( holeCentre.x + std::lround( radius * std::cos( angle ) ),
+                             holeCentre.y + std::lround( radius * std::sin( angle ) ) );
+            }
+
+            hole.SetClosed( true );
+            polySet.AddHole( hole, p );
+        }
+    }
+
+    return polySet;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SPSEdgeIndex )
+
+/**
+ * The indexed queries must give the same results as the linear scans on the common fixture,
+ * which has points on edges, corners and re-entrant hole angles.
+ */
+BOOST_AUTO_TEST_CASE( HoleyPolySet )
+{
+    KI_TEST::CommonTestData common;
+    SHAPE_POLY_SET indexed( common.holeyPolySet );
+
+    indexed.CacheEdgeIndex();
+    BOOST_CHECK( indexed.IsEdgeIndexUpToDate() );
+    BOOST_CHECK( !common.holeyPolySet.IsEdgeIndexUpToDate() );
+
+    for( int x = -5; x <= 105; x++ )
+    {
+        for( int y = -5; y <= 105; y++ )
+        {
+            const VECTOR2I p( x, y );
+
+            BOOST_CHECK_EQUAL( indexed.Contains( p ), common.holeyPolySet.Contains( p ) );
+            BOOST_CHECK_EQUAL( indexed.Contains( p, 0, true ),
+                               common.holeyPolySet.Contains( p, 0, true ) );
+            BOOST_CHECK_EQUAL( indexed.Distance( p ), common.holeyPolySet.Distance( p ) );
+        }
+    }
+}
+
+/**
+ * Compares the indexed and linear versions of all the accelerated queries on a larger set.
+ */
+BOOST_AUTO_TEST_CASE( MatchesLinearScan )
+{
+    SHAPE_POLY_SET linear = buildWavyPolySet();
+    SHAPE_POLY_SET indexed( linear );
+
+    indexed.CacheEdgeIndex();
+
+    std::mt19937 rng( 42 );
+    std::uniform_int_distribution<int> xDist( -15000, 65000 );
+    std::uniform_int_distribution<int> yDist( -15000, 22000 );
+    std::uniform_int_distribution<int> lenDist( -3000, 3000 );
+
+    for( int i = 0; i < 2000; i++ )
+    {
+        const VECTOR2I p( xDist( rng ), yDist( rng ) );
+        const SEG seg( p, p + VECTOR2I( lenDist( rng ), lenDist( rng ) ) );
+
+        BOOST_CHECK_EQUAL( indexed.Contains( p ), linear.Contains( p ) );
+        BOOST_CHECK_EQUAL( indexed.Contains( p, 1 ), linear.Contains( p, 1 ) );
+        BOOST_CHECK_EQUAL( indexed.Contains( p, -1, true ), linear.Contains( p, -1, true ) );
+        BOOST_CHECK_EQUAL( indexed.Distance( p ), linear.Distance( p ) );
+        BOOST_CHECK_EQUAL( indexed.DistanceToPolygon( p, 2 ), linear.DistanceToPolygon( p, 2 ) );
+        BOOST_CHECK_EQUAL( indexed.Distance( seg, 200 ), linear.Distance( seg, 200 ) );
+        BOOST_CHECK_EQUAL( indexed.DistanceToPolygon( seg, 0 ),
+                           linear.DistanceToPolygon( seg, 0 ) );
+        BOOST_CHECK_EQUAL( indexed.Collide( seg, 0 ), linear.Collide( seg, 0 ) );
+    }
+
+    // Points lying exactly on the outline and hole vertices
+    for( auto it = linear.CIterateWithHoles(); it; it++ )
+    {
+        BOOST_CHECK_EQUAL( indexed.Contains( *it ), linear.Contains( *it ) );
+        BOOST_CHECK_EQUAL( indexed.Distance( *it ), linear.Distance( *it ) );
+    }
+}
+
+/**
+ * Modifying the set must drop the index, and copies must keep it.
+ */
+BOOST_AUTO_TEST_CASE( Invalidation )
+{
+    SHAPE_POLY_SET polySet = buildWavyPolySet();
+
+    polySet.CacheEdgeIndex();
+
+    SHAPE_POLY_SET copy( polySet );
+    BOOST_CHECK( copy.IsEdgeIndexUpToDate() );
+
+    polySet.Move( VECTOR2I( 100000, 0 ) );
+    BOOST_CHECK( !polySet.IsEdgeIndexUpToDate() );
+    BOOST_CHECK( polySet.Contains( VECTOR2I( 100000, 0 ) ) );
+    BOOST_CHECK( !polySet.Contains( VECTOR2I( 0, 0 ) ) );
+
+    polySet.CacheEdgeIndex();
+    polySet.Outline( 0 ).Append( VECTOR2I( 90000, -20000 ) );
+    BOOST_CHECK( !polySet.IsEdgeIndexUpToDate() );
+
+    // The copy still answers for the original position
+    BOOST_CHECK( copy.Contains( VECTOR2I( 0, 0 ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
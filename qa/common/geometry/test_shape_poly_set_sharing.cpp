@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include "fixtures_geometry.h"
+
+/**
+ * Copies of a SHAPE_POLY_SET share their polygons until one of them is modified.  These
+ * tests check that the copies still behave as independent values.
+ */
+BOOST_AUTO_TEST_SUITE( SPSSharing )
+
+/**
+ * Returns true if both sets have the same vertices, in the same order.
+ */
+static bool sameVertices( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.TotalVertices() != aB.TotalVertices() )
+        return false;
+
+    auto itA = aA.CIterateWithHoles();
+    auto itB = aB.CIterateWithHoles();
+
+    for( ; itA && itB; itA++, itB++ )
+    {
+        if( *itA != *itB )
+            return false;
+    }
+
+    return true;
+}
+
+
+BOOST_AUTO_TEST_CASE( ModifyCopy )
+{
+    KI_TEST::CommonTestData common;
+    const SHAPE_POLY_SET original( common.holeyPolySet );
+    SHAPE_POLY_SET copy( original );
+
+    BOOST_CHECK( sameVertices( copy, original ) );
+
+    copy.Move( VECTOR2I( 10, 10 ) );
+    BOOST_CHECK( !sameVertices( copy, original ) );
+    BOOST_CHECK( sameVertices( original, common.holeyPolySet ) );
+
+    SHAPE_POLY_SET assigned;
+    assigned = original;
+    assigned.Vertex( 0 ) = VECTOR2I( -100, -100 );
+
+    BOOST_CHECK_EQUAL( assigned.CVertex( 0 ), VECTOR2I( -100, -100 ) );
+    BOOST_CHECK( sameVertices( original, common.holeyPolySet ) );
+
+    for( auto it = copy.IterateWithHoles(); it; it++ )
+        *it = VECTOR2I( 0, 0 );
+
+    BOOST_CHECK( sameVertices( original, common.holeyPolySet ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( ModifyOriginal )
+{
+    KI_TEST::CommonTestData common;
+    SHAPE_POLY_SET original( common.holeyPolySet );
+    const SHAPE_POLY_SET copy( original );
+
+    original.RemoveAllContours();
+    BOOST_CHECK_EQUAL( original.OutlineCount(), 0 );
+    BOOST_CHECK( sameVertices( copy, common.holeyPolySet ) );
+
+    original = copy;
+    original.DeletePolygon( 0 );
+    original.Append( copy );
+    original.Outline( 0 ).Append( VECTOR2I( 200, 200 ) );
+
+    BOOST_CHECK_EQUAL( copy.COutline( 0 ).PointCount(),
+                       common.holeyPolySet.COutline( 0 ).PointCount() );
+}
+
+/**
+ * The memory used by a shared set is divided between its copies.
+ */
+BOOST_AUTO_TEST_CASE( MemoryUsage )
+{
+    KI_TEST::CommonTestData common;
+    SHAPE_POLY_SET original( common.holeyPolySet );
+
+    // Stop sharing with the fixture
+    original.Move( VECTOR2I( 1, 1 ) );
+
+    const size_t unshared = original.GetMemoryUsage();
+
+    BOOST_CHECK_GT( unshared, 0 );
+    BOOST_CHECK_EQUAL( common.emptyPolySet.GetMemoryUsage(), 0 );
+
+    {
+        SHAPE_POLY_SET copy( original );
+
+        BOOST_CHECK_EQUAL( original.GetMemoryUsage(), unshared / 2 );
+        BOOST_CHECK_EQUAL( copy.GetMemoryUsage(), unshared / 2 );
+
+        copy.Move( VECTOR2I( 1, 1 ) );
+        BOOST_CHECK_EQUAL( original.GetMemoryUsage(), unshared );
+    }
+
+    BOOST_CHECK_EQUAL( original.GetMemoryUsage(), unshared );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
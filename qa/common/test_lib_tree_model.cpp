@@ -0,0 +1,286 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the library tree search: the scores given through the search index must
+ * be the scores given by running the matchers on every node of the tree.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <lib_tree_model.h>
+
+#include <eda_pattern_match.h>
+#include <lib_tree_item.h>
+
+#include <wx/tokenzr.h>
+
+
+/**
+ * A library item with fixed fields
+ */
+class TEST_LIB_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_LIB_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aDesc,
+                        const wxString& aKeywords ) :
+            m_libId( aLib, aName ),
+            m_name( aName ),
+            m_desc( aDesc ),
+            m_keywords( aKeywords )
+    {
+    }
+
+    LIB_ID GetLibId() const override { return m_libId; }
+
+    const wxString& GetName() const override { return m_name; }
+
+    wxString GetLibNickname() const override { return m_libId.GetLibNickname(); }
+
+    const wxString& GetDescription() override { return m_desc; }
+
+    wxString GetSearchText() override { return m_keywords + wxT( " " ) + m_desc; }
+
+private:
+    LIB_ID   m_libId;
+    wxString m_name;
+    wxString m_desc;
+    wxString m_keywords;
+};
+
+
+struct LIB_TREE_MODEL_FIXTURE
+{
+    LIB_TREE_MODEL_FIXTURE()
+    {
+        addItem( "Device", "R", "Resistor", "R res resistor" );
+        addItem( "Device", "R_Small", "Resistor, small symbol", "R res resistor" );
+        addItem( "Device", "C", "Unpolarized capacitor", "cap capacitor" );
+        addItem( "Device", "C_Small", "Unpolarized capacitor, small symbol", "cap capacitor" );
+        addItem( "Device", "LED", "Light emitting diode", "LED diode" );
+        addItem( "Device", "LED_Small", "Light emitting diode, small symbol", "LED diode" );
+        addItem( "Connector", "Conn_01x02", "Generic connector, single row, 01x02", "connector" );
+        addItem( "Connector", "Conn_02x02", "Generic connector, double row, 02x02", "connector" );
+        addItem( "Connector", "USB_B", "USB Type B connector", "connector USB" );
+        addItem( "Diode", "1N4148", "100V 0.15A standard switching", "switching" );
+        addItem( "Diode", "LED_Diode", "Diode shaped like a LED", "diode" );
+
+        buildTree( m_reference );
+        buildTree( m_indexed );
+    }
+
+    void addItem( const char* aLib, const char* aName, const char* aDesc, const char* aKeywords )
+    {
+        m_items.emplace_back( new TEST_LIB_TREE_ITEM( aLib, aName, aDesc, aKeywords ) );
+    }
+
+    void buildTree( LIB_TREE_NODE_ROOT& aRoot )
+    {
+        LIB_TREE_NODE_LIB* lib = nullptr;
+
+        for( auto& item : m_items )
+        {
+            if( !lib || lib->Name != item->GetLibNickname() )
+                lib = &aRoot.AddLib( item->GetLibNickname(), wxEmptyString );
+
+            lib->AddItem( item.get() );
+        }
+
+        // A library without items is matched on its name
+        aRoot.AddLib( "Connector_Empty", wxEmptyString );
+
+        aRoot.AssignIntrinsicRanks();
+    }
+
+    /**
+     * Scores the reference tree by running the matchers on every node, and the indexed
+     * tree through its search index, as LIB_TREE_MODEL_ADAPTER::UpdateSearchString() does.
+     */
+    void search( const wxString& aSearch )
+    {
+        m_reference.ResetScore();
+        m_indexed.ResetScore();
+
+        wxStringTokenizer tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            const wxString term = tokenizer.GetNextToken().Lower();
+            EDA_COMBINED_MATCHER matcher( term );
+
+            m_reference.UpdateScore( matcher );
+            m_indexed.UpdateScore( term );
+        }
+
+        m_reference.SortNodes();
+        m_indexed.SortNodes();
+    }
+
+    /**
+     * Checks that both trees have the same nodes, in the same order, with the same scores.
+     */
+    void checkSameResults( const LIB_TREE_NODE& aReference, const LIB_TREE_NODE& aIndexed )
+    {
+        BOOST_CHECK_EQUAL( aReference.Name, aIndexed.Name );
+        BOOST_CHECK_EQUAL( aReference.Score, aIndexed.Score );
+        BOOST_REQUIRE_EQUAL( aReference.Children.size(), aIndexed.Children.size() );
+
+        for( size_t i = 0; i < aReference.Children.size(); ++i )
+            checkSameResults( *aReference.Children[i], *aIndexed.Children[i] );
+    }
+
+    /**
+     * @return the score of the given item in the indexed tree.
+     */
+    int indexedScore( const wxString& aLib, const wxString& aName )
+    {
+        for( auto& lib : m_indexed.Children )
+        {
+            for( auto& node : lib->Children )
+            {
+                if( lib->Name == aLib && node->Name == aName )
+                    return node->Score;
+            }
+        }
+
+        BOOST_FAIL( "item not found" );
+        return 0;
+    }
+
+    std::vector<std::unique_ptr<TEST_LIB_TREE_ITEM>> m_items;
+    LIB_TREE_NODE_ROOT m_reference;
+    LIB_TREE_NODE_ROOT m_indexed;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTreeModel, LIB_TREE_MODEL_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( ExactMatch )
+{
+    search( "led" );
+    checkSameResults( m_reference, m_indexed );
+
+    BOOST_CHECK_GT( indexedScore( "Device", "LED" ), 1000 );
+
+    // The exact match comes first
+    BOOST_CHECK_EQUAL( m_indexed.Children[0]->Name, "Device" );
+    BOOST_CHECK_EQUAL( m_indexed.Children[0]->Children[0]->Name, "LED" );
+}
+
+
+BOOST_AUTO_TEST_CASE( PrefixMatch )
+{
+    search( "conn" );
+    checkSameResults( m_reference, m_indexed );
+
+    BOOST_CHECK_GT( indexedScore( "Connector", "Conn_01x02" ), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( SubstringMatch )
+{
+    search( "small" );
+    checkSameResults( m_reference, m_indexed );
+
+    search( "capacitor" );
+    checkSameResults( m_reference, m_indexed );
+
+    BOOST_CHECK_GT( indexedScore( "Device", "C_Small" ), 0 );
+    BOOST_CHECK_EQUAL( indexedScore( "Device", "R" ), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( LibraryNameMatch )
+{
+    search( "diod" );
+    checkSameResults( m_reference, m_indexed );
+
+    // Matched by its library name only
+    BOOST_CHECK_GT( indexedScore( "Diode", "1N4148" ), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( NoMatch )
+{
+    search( "xyzzy" );
+    checkSameResults( m_reference, m_indexed );
+
+    BOOST_CHECK_EQUAL( indexedScore( "Device", "LED" ), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( SeveralTerms )
+{
+    search( "conn 02x02" );
+    checkSameResults( m_reference, m_indexed );
+
+    search( "small led" );
+    checkSameResults( m_reference, m_indexed );
+}
+
+
+BOOST_AUTO_TEST_CASE( UnindexedTerms )
+{
+    // Short terms and pattern syntax go through the matchers on every node
+    search( "r" );
+    checkSameResults( m_reference, m_indexed );
+
+    search( "c*small" );
+    checkSameResults( m_reference, m_indexed );
+
+    search( "conn_0?x02" );
+    checkSameResults( m_reference, m_indexed );
+}
+
+
+BOOST_AUTO_TEST_CASE( IndexUpdate )
+{
+    search( "usb" );
+    checkSameResults( m_reference, m_indexed );
+
+    // Nodes added after the index was built are found
+    addItem( "Connector", "USB_C", "USB Type C connector", "connector USB" );
+
+    for( LIB_TREE_NODE_ROOT* root : { &m_reference, &m_indexed } )
+    {
+        for( auto& lib : root->Children )
+        {
+            if( lib->Name == "Connector" )
+            {
+                static_cast<LIB_TREE_NODE_LIB*>( lib.get() )->AddItem( m_items.back().get() );
+                lib->AssignIntrinsicRanks();
+            }
+        }
+    }
+
+    search( "usb" );
+    checkSameResults( m_reference, m_indexed );
+
+    BOOST_CHECK_GT( indexedScore( "Connector", "USB_C" ), 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,211 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for XML_STREAM_PARSER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+// Code under test
+#include <ki_exception.h>
+#include <xml_stream_parser.h>
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( XmlStreamParser )
+
+
+/**
+ * Writes the given document to a temporary file, removed on destruction.
+ */
+struct TEMP_XML_FILE
+{
+    TEMP_XML_FILE( const std::string& aContents )
+    {
+        m_name = wxFileName::CreateTempFileName( "qa_xml" );
+
+        wxFFile file( m_name, "wb" );
+        file.Write( aContents.data(), aContents.size() );
+    }
+
+    ~TEMP_XML_FILE()
+    {
+        wxRemoveFile( m_name );
+    }
+
+    wxString m_name;
+};
+
+
+static const std::string doc =
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<!DOCTYPE eagle SYSTEM \"eagle.dtd\" [ <!ENTITY x \"y\"> ]>\n"
+        "<eagle version=\"9.1\">\n"
+        "  <drawing>\n"
+        "    <!-- a <comment> -->\n"
+        "    <layers>\n"
+        "      <layer number=\"1\" name=\"Top\"/>\n"
+        "      <layer number=\"16\" name=\"Bottom\"/>\n"
+        "    </layers>\n"
+        "    <board>\n"
+        "      <plain>\n"
+        "        <text x=\"1\" y='2'>A &amp; B &#x3A9;</text>\n"
+        "        <text x=\"3\" y=\"4\"><![CDATA[<raw>]]></text>\n"
+        "      </plain>\n"
+        "    </board>\n"
+        "  </drawing>\n"
+        "</eagle>\n";
+
+
+BOOST_AUTO_TEST_CASE( StartEvents )
+{
+    TEMP_XML_FILE file( doc );
+    XML_STREAM_PARSER parser( file.m_name );
+    std::vector<wxString> paths;
+    wxString version;
+
+    parser.Parse(
+            [&]( const wxString& aPath, const wxXmlNode& aElement ) {
+                paths.push_back( aPath );
+
+                if( aPath == "eagle" )
+                    version = aElement.GetAttribute( "version" );
+
+                return false;
+            },
+            []( const wxString&, wxXmlNode* ) {
+                BOOST_FAIL( "Nothing was captured" );
+            } );
+
+    const std::vector<wxString> expected = {
+        "eagle",
+        "eagle.drawing",
+        "eagle.drawing.layers",
+        "eagle.drawing.layers.layer",
+        "eagle.drawing.layers.layer",
+        "eagle.drawing.board",
+        "eagle.drawing.board.plain",
+        "eagle.drawing.board.plain.text",
+        "eagle.drawing.board.plain.text",
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( paths.begin(), paths.end(), expected.begin(), expected.end() );
+    BOOST_CHECK_EQUAL( version, "9.1" );
+}
+
+
+BOOST_AUTO_TEST_CASE( CapturedElements )
+{
+    TEMP_XML_FILE file( doc );
+    XML_STREAM_PARSER parser( file.m_name );
+    std::vector<wxString> contents;
+    int layerCount = 0;
+
+    // Parse twice, to check the parser starts again from the beginning
+    for( int pass = 0; pass < 2; ++pass )
+    {
+        contents.clear();
+        layerCount = 0;
+
+        parser.Parse(
+                []( const wxString& aPath, const wxXmlNode& ) {
+                    return aPath == "eagle.drawing.layers"
+                           || aPath == "eagle.drawing.board.plain.text";
+                },
+                [&]( const wxString& aPath, wxXmlNode* aElement ) {
+                    if( aPath == "eagle.drawing.layers" )
+                    {
+                        for( wxXmlNode* layer = aElement->GetChildren(); layer;
+                                layer = layer->GetNext() )
+                        {
+                            BOOST_CHECK_EQUAL( layer->GetName(), "layer" );
+                            layerCount++;
+                        }
+
+                        BOOST_CHECK_EQUAL( aElement->GetChildren()->GetAttribute( "name" ),
+                                           "Top" );
+                    }
+                    else
+                    {
+                        contents.push_back( aElement->GetNodeContent() );
+                    }
+                } );
+
+        BOOST_CHECK_EQUAL( layerCount, 2 );
+        BOOST_REQUIRE_EQUAL( contents.size(), 2 );
+        BOOST_CHECK( contents[0] == wxString::FromUTF8( "A & B \xCE\xA9" ) );
+        BOOST_CHECK_EQUAL( contents[1], "<raw>" );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( Latin1 )
+{
+    TEMP_XML_FILE file( "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>"
+                        "<lib name=\"caf\xE9\"/>" );
+    XML_STREAM_PARSER parser( file.m_name );
+    wxString name;
+
+    parser.Parse(
+            [&]( const wxString&, const wxXmlNode& aElement ) {
+                name = aElement.GetAttribute( "name" );
+                return false;
+            },
+            []( const wxString&, wxXmlNode* ) {} );
+
+    BOOST_CHECK( name == wxString::FromUTF8( "caf\xC3\xA9" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( MalformedDocuments )
+{
+    const std::vector<std::string> cases = {
+        "<a><b></a>",
+        "<a>",
+        "<a b=c/>",
+        "<a b=\"c/>",
+        "<a><!-- unterminated </a>",
+    };
+
+    for( const std::string& c : cases )
+    {
+        BOOST_TEST_CONTEXT( c )
+        {
+            TEMP_XML_FILE file( c );
+            XML_STREAM_PARSER parser( file.m_name );
+
+            BOOST_CHECK_THROW( parser.Parse(
+                                       []( const wxString&, const wxXmlNode& ) { return true; },
+                                       []( const wxString&, wxXmlNode* ) {} ),
+                               PARSE_ERROR );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the parsing functions of SIM_SWEEP
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <sim/sim_sweep.h>
+#include <sim/spice_value.h>
+
+
+BOOST_AUTO_TEST_SUITE( SimSweep )
+
+
+BOOST_AUTO_TEST_CASE( Lists )
+{
+    std::vector<SIM_SWEEP_POINT> points;
+    wxString error;
+
+    BOOST_REQUIRE( SIM_SWEEP::ParseSpec( "R1=1k,2k\n* comment\n\nrload = 10, 20, 30", points,
+                                         error ) );
+    BOOST_REQUIRE_EQUAL( points.size(), 6 );
+
+    // The first list is the outer loop
+    BOOST_CHECK( points[0].at( "R1" ) == "1k" );
+    BOOST_CHECK( points[0].at( "rload" ) == "10" );
+    BOOST_CHECK( points[2].at( "rload" ) == "30" );
+    BOOST_CHECK( points[3].at( "R1" ) == "2k" );
+    BOOST_CHECK( points[3].at( "rload" ) == "10" );
+
+    BOOST_CHECK( SIM_SWEEP::FormatPoint( points[5] ) == "R1=2k, rload=30" );
+}
+
+
+BOOST_AUTO_TEST_CASE( Tolerances )
+{
+    std::vector<SIM_SWEEP_POINT> points, again;
+    wxString error;
+
+    BOOST_REQUIRE( SIM_SWEEP::ParseSpec( "C1=10n+-10%; RUNS=50; SEED=3; R1=1k,2k", points,
+                                         error ) );
+    BOOST_REQUIRE_EQUAL( points.size(), 100 );
+
+    for( const SIM_SWEEP_POINT& point : points )
+    {
+        double value = SPICE_VALUE( point.at( "C1" ) ).ToDouble();
+
+        BOOST_CHECK_GE( value, 9e-9 * 0.999 );
+        BOOST_CHECK_LE( value, 11e-9 * 1.001 );
+    }
+
+    // The seed gives the same values
+    BOOST_REQUIRE( SIM_SWEEP::ParseSpec( "C1=10n+-10%; RUNS=50; SEED=3; R1=1k,2k", again,
+                                         error ) );
+    BOOST_CHECK( points == again );
+}
+
+
+BOOST_AUTO_TEST_CASE( Errors )
+{
+    std::vector<SIM_SWEEP_POINT> points;
+    wxString error;
+
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "R1", points, error ) );
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "R1=", points, error ) );
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "R(1)=1k", points, error ) );
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "RUNS=0", points, error ) );
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "C1=abc+-10%", points, error ) );
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "C1=10n+-10", points, error ) );
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "R1=1,2,3,4,5,6,7,8,9,10; RUNS=100000", points, error ) );
+
+    // 4 * 2^62 runs would wrap around to 0
+    BOOST_CHECK( !SIM_SWEEP::ParseSpec( "R1=1,2,3,4; RUNS=4611686018427387904", points, error ) );
+    BOOST_CHECK( !error.IsEmpty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( Output )
+{
+    SIM_SWEEP::RESULT result;
+
+    // Real scale
+    BOOST_REQUIRE( SIM_SWEEP::ParseOutput( " time v(1) v(2)\n"
+                                           " 0.0e+00 1.0 2.0\n"
+                                           " 1.0e-03 3.0 4.0\n", 2, result ) );
+    BOOST_REQUIRE_EQUAL( result.m_x.size(), 2 );
+    BOOST_CHECK_EQUAL( result.m_x[1], 1e-3 );
+    BOOST_CHECK_EQUAL( result.m_signals[0][1], 3.0 );
+    BOOST_CHECK_EQUAL( result.m_signals[1][0], 2.0 );
+
+    // Complex scale (AC analysis)
+    BOOST_REQUIRE( SIM_SWEEP::ParseOutput( " frequency mag(v(1))\n"
+                                           " 1.0e+03 0.0 0.5\n", 1, result ) );
+    BOOST_CHECK_EQUAL( result.m_x[0], 1e3 );
+    BOOST_CHECK_EQUAL( result.m_signals[0][0], 0.5 );
+
+    // Wrong number of columns
+    BOOST_CHECK( !SIM_SWEEP::ParseOutput( " time v(1)\n 0.0 1.0 2.0 3.0\n", 1, result ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
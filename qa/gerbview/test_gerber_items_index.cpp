@@ -0,0 +1,160 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the index of the gerber items: the items must be found anywhere
+ * GERBER_DRAW_ITEM::HitTest() finds them.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <gerber_file_image.h>
+
+#include <convert_to_biu.h>
+#include <dcode.h>
+#include <gerber_draw_item.h>
+
+
+struct GERBER_ITEMS_INDEX_FIXTURE
+{
+    GERBER_ITEMS_INDEX_FIXTURE() :
+            m_image( 0 )
+    {
+    }
+
+    /**
+     * Adds to the image an item drawn with the D code aDCode, of aShape and aSize
+     */
+    GERBER_DRAW_ITEM* addItem( int aDCode, APERTURE_T aShape, const wxSize& aSize )
+    {
+        D_CODE* dcode = m_image.GetDCODEOrCreate( aDCode );
+        dcode->m_Shape = aShape;
+        dcode->m_Size = aSize;
+
+        GERBER_DRAW_ITEM* item = new GERBER_DRAW_ITEM( &m_image );
+        item->m_DCode = aDCode;
+        item->m_Size = aSize;
+        m_image.m_Drawings.Append( item );
+
+        return item;
+    }
+
+    /**
+     * @return the items found by the image at aPos, given in gerber file coordinates
+     */
+    std::vector<GERBER_DRAW_ITEM*> hitTest( const GERBER_DRAW_ITEM* aItem, const wxPoint& aPos )
+    {
+        std::vector<GERBER_DRAW_ITEM*> found;
+
+        m_image.HitTestItems( aItem->GetABPosition( aPos ),
+                              [&]( GERBER_DRAW_ITEM* aFound ) -> bool
+                              {
+                                  found.push_back( aFound );
+                                  return true;
+                              } );
+
+        return found;
+    }
+
+    GERBER_FILE_IMAGE m_image;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( GerberItemsIndex, GERBER_ITEMS_INDEX_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( RectApertureSegment )
+{
+    // The polygon of the segment is created only when it is drawn
+    GERBER_DRAW_ITEM* item = addItem( 10, APT_RECT,
+                                      wxSize( Millimeter2iu( 0.5 ), Millimeter2iu( 0.3 ) ) );
+    item->m_Shape = GBR_SEGMENT;
+    item->m_Start = wxPoint( 0, 0 );
+    item->m_End = wxPoint( Millimeter2iu( 20 ), Millimeter2iu( 10 ) );
+
+    m_image.BuildItemsIndex();
+
+    const wxPoint middle = ( item->m_Start + item->m_End ) / 2;
+
+    BOOST_CHECK( item->HitTest( item->GetABPosition( middle ) ) );
+    BOOST_CHECK_EQUAL( hitTest( item, middle ).size(), 1 );
+    BOOST_CHECK_EQUAL( hitTest( item, item->m_End ).size(), 1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( RotatedLayer )
+{
+    // A rotation which is not a multiple of 90 degrees turns the item box
+    m_image.m_LocalRotation = 45;
+
+    GERBER_DRAW_ITEM* item = addItem( 10, APT_CIRCLE,
+                                      wxSize( Millimeter2iu( 0.2 ), Millimeter2iu( 0.2 ) ) );
+    item->m_Shape = GBR_SEGMENT;
+    item->m_Start = wxPoint( 0, Millimeter2iu( 10 ) );
+    item->m_End = wxPoint( Millimeter2iu( 10 ), 0 );
+
+    m_image.BuildItemsIndex();
+
+    const wxPoint quarter = item->m_Start + ( item->m_End - item->m_Start ) / 4;
+
+    BOOST_CHECK( item->HitTest( item->GetABPosition( quarter ) ) );
+    BOOST_CHECK_EQUAL( hitTest( item, quarter ).size(), 1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( CirclePenWidth )
+{
+    GERBER_DRAW_ITEM* item = addItem( 10, APT_CIRCLE,
+                                      wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+    item->m_Shape = GBR_CIRCLE;
+    item->m_Start = wxPoint( 0, 0 );
+    item->m_End = wxPoint( Millimeter2iu( 5 ), 0 );
+
+    m_image.BuildItemsIndex();
+
+    // Outside of the circle, but on its outline drawn with the pen width
+    const wxPoint outline( Millimeter2iu( 5.4 ), 0 );
+
+    BOOST_CHECK( item->HitTest( item->GetABPosition( outline ) ) );
+    BOOST_CHECK_EQUAL( hitTest( item, outline ).size(), 1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( Miss )
+{
+    GERBER_DRAW_ITEM* item = addItem( 10, APT_RECT,
+                                      wxSize( Millimeter2iu( 0.5 ), Millimeter2iu( 0.3 ) ) );
+    item->m_Shape = GBR_SEGMENT;
+    item->m_Start = wxPoint( 0, 0 );
+    item->m_End = wxPoint( Millimeter2iu( 20 ), 0 );
+
+    m_image.BuildItemsIndex();
+
+    BOOST_CHECK_EQUAL( hitTest( item, wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 5 ) ) ).size(),
+                       0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for GERBER_LINE_READER: the lines must be the ones fgets() would read,
+ * whatever the size of the chunks of the file.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <gerber_line_reader.h>
+
+#include <cstdio>
+#include <string>
+
+
+struct GERBER_LINE_READER_FIXTURE
+{
+    GERBER_LINE_READER_FIXTURE() :
+            m_file( tmpfile() )
+    {
+    }
+
+    ~GERBER_LINE_READER_FIXTURE()
+    {
+        if( m_file )
+            fclose( m_file );
+    }
+
+    void write( const std::string& aText )
+    {
+        fwrite( aText.data(), 1, aText.size(), m_file );
+        rewind( m_file );
+    }
+
+    /**
+     * @return the lines read by a reader of aMaxLineLength and aChunkSize
+     */
+    std::vector<std::string> readLines( unsigned aMaxLineLength, size_t aChunkSize )
+    {
+        GERBER_LINE_READER       reader( m_file, wxT( "test.gbr" ), aMaxLineLength, aChunkSize );
+        std::vector<std::string> lines;
+
+        while( reader.ReadLine() )
+            lines.push_back( std::string( reader.Line(), reader.Length() ) );
+
+        return lines;
+    }
+
+    FILE* m_file;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( GerberLineReader, GERBER_LINE_READER_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( LinesAcrossChunks )
+{
+    BOOST_REQUIRE( m_file );
+    write( "G04 comment*\nX100Y200D01*\n%FSLAX24Y24*%\n" );
+
+    const std::vector<std::string> expected = { "G04 comment*\n", "X100Y200D01*\n",
+                                                "%FSLAX24Y24*%\n" };
+
+    // Chunks smaller than a line, and larger than the file
+    for( size_t chunkSize : { 1, 5, 13, 1024 } )
+    {
+        rewind( m_file );
+        BOOST_CHECK( readLines( GERBER_BUFZ, chunkSize ) == expected );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( LastLineWithoutEnd )
+{
+    BOOST_REQUIRE( m_file );
+    write( "G01*\nM02*" );
+
+    const std::vector<std::string> expected = { "G01*\n", "M02*" };
+
+    BOOST_CHECK( readLines( GERBER_BUFZ, 3 ) == expected );
+}
+
+
+BOOST_AUTO_TEST_CASE( LongLineSplit )
+{
+    BOOST_REQUIRE( m_file );
+    write( "X1Y2D03*X3Y4D03*\nM02*\n" );
+
+    // Like fgets(), a line longer than the max length is read in several pieces
+    const std::vector<std::string> expected = { "X1Y2D03*", "X3Y4D03*", "\n", "M02*\n" };
+
+    BOOST_CHECK( readLines( 8, 5 ) == expected );
+}
+
+
+BOOST_AUTO_TEST_CASE( EmptyFile )
+{
+    BOOST_REQUIRE( m_file );
+    BOOST_CHECK( readLines( GERBER_BUFZ, 16 ).empty() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the primitives store of the gerber images: the primitives must be
+ * given back as the items they were added from.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <gerber_file_image.h>
+#include <gerber_primitives.h>
+
+#include <convert_to_biu.h>
+#include <dcode.h>
+#include <gerber_draw_item.h>
+
+
+struct GERBER_PRIMITIVES_FIXTURE
+{
+    GERBER_PRIMITIVES_FIXTURE() :
+            m_image( 0 )
+    {
+        D_CODE* dcode = m_image.GetDCODEOrCreate( 10 );
+        dcode->m_Shape = APT_CIRCLE;
+        dcode->m_Size = wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) );
+    }
+
+    /**
+     * @return a flash of the D code 10 at aPos
+     */
+    GERBER_DRAW_ITEM makeFlash( const wxPoint& aPos )
+    {
+        GERBER_DRAW_ITEM flash( &m_image );
+
+        flash.m_Shape = GBR_SPOT_CIRCLE;
+        flash.m_Flashed = true;
+        flash.m_DCode = 10;
+        flash.m_Size = wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) );
+        flash.m_Start = flash.m_End = aPos;
+
+        return flash;
+    }
+
+    GERBER_FILE_IMAGE m_image;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( GerberPrimitives, GERBER_PRIMITIVES_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( LoadArc )
+{
+    GERBER_DRAW_ITEM arc( &m_image );
+    arc.m_Shape = GBR_ARC;
+    arc.m_DCode = 10;
+    arc.m_Size = wxSize( Millimeter2iu( 0.2 ), Millimeter2iu( 0.2 ) );
+    arc.m_Start = wxPoint( Millimeter2iu( 5 ), 0 );
+    arc.m_End = wxPoint( 0, Millimeter2iu( 5 ) );
+    arc.m_ArcCentre = wxPoint( 0, 0 );
+
+    m_image.AddPrimitive( makeFlash( wxPoint( Millimeter2iu( 1 ), Millimeter2iu( 2 ) ) ) );
+    m_image.AddPrimitive( arc );
+
+    const GERBER_PRIMITIVES& primitives = m_image.GetPrimitives();
+    GERBER_DRAW_ITEM         item( NULL );
+
+    BOOST_REQUIRE_EQUAL( primitives.GetCount(), 2 );
+
+    primitives.Load( 0, item );
+    BOOST_CHECK_EQUAL( item.m_Shape, GBR_SPOT_CIRCLE );
+    BOOST_CHECK( item.m_Flashed );
+    BOOST_CHECK_EQUAL( item.m_DCode, 10 );
+    BOOST_CHECK( item.m_Start == wxPoint( Millimeter2iu( 1 ), Millimeter2iu( 2 ) ) );
+    BOOST_CHECK( item.m_ArcCentre == wxPoint( 0, 0 ) );
+
+    primitives.Load( 1, item );
+    BOOST_CHECK_EQUAL( item.m_Shape, GBR_ARC );
+    BOOST_CHECK( !item.m_Flashed );
+    BOOST_CHECK( item.m_Start == arc.m_Start );
+    BOOST_CHECK( item.m_End == arc.m_End );
+    BOOST_CHECK( item.m_Size == arc.m_Size );
+    BOOST_CHECK( item.m_ArcCentre == arc.m_ArcCentre );
+    BOOST_CHECK( item.GetBoundingBox().GetOrigin() == arc.GetBoundingBox().GetOrigin() );
+    BOOST_CHECK( item.GetBoundingBox().GetSize() == arc.GetBoundingBox().GetSize() );
+}
+
+
+BOOST_AUTO_TEST_CASE( StepAndRepeat )
+{
+    m_image.GetLayerParams().m_XRepeatCount = 3;
+    m_image.GetLayerParams().m_StepForRepeat.x = 10;
+    m_image.GetLayerParams().m_StepForRepeatMetric = true;
+
+    m_image.AddPrimitive( makeFlash( wxPoint( 0, 0 ) ) );
+
+    const GERBER_PRIMITIVES& primitives = m_image.GetPrimitives();
+    GERBER_DRAW_ITEM         item( NULL );
+
+    BOOST_REQUIRE_EQUAL( primitives.GetCount(), 3 );
+
+    primitives.Load( 2, item );
+    BOOST_CHECK( item.m_Start == wxPoint( Millimeter2iu( 20 ), 0 ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( HitTestGivesKeptItems )
+{
+    m_image.AddPrimitive( makeFlash( wxPoint( 0, 0 ) ) );
+    m_image.AddPrimitive( makeFlash( wxPoint( Millimeter2iu( 10 ), 0 ) ) );
+    m_image.BuildItemsIndex();
+
+    BOOST_CHECK_EQUAL( m_image.GetPrimitiveBlocks().size(), 1 );
+
+    GERBER_DRAW_ITEM* found = nullptr;
+    wxPoint           pos = m_image.GetPrimitiveItem( 1 )->GetABPosition( wxPoint(
+                                    Millimeter2iu( 10 ), 0 ) );
+
+    m_image.HitTestItems( pos, [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                               {
+                                   found = aItem;
+                                   return false;
+                               } );
+
+    // The item is the one kept for the primitive, not a temporary one
+    BOOST_CHECK_EQUAL( found, m_image.GetPrimitiveItem( 1 ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( MoveUpdatesKeptItems )
+{
+    m_image.AddPrimitive( makeFlash( wxPoint( 0, 0 ) ) );
+    m_image.BuildItemsIndex();
+
+    GERBER_DRAW_ITEM* item = m_image.GetPrimitiveItem( 0 );
+    wxPoint           before = item->GetABPosition( item->m_Start );
+    EDA_RECT          area( before, wxSize( 0, 0 ) );
+    const wxPoint     move( Millimeter2iu( 5 ), Millimeter2iu( 5 ) );
+
+    area.Inflate( Millimeter2iu( 1 ) );
+
+    BOOST_CHECK( m_image.MoveItems( area, move ) );
+    BOOST_CHECK( item->GetABPosition( item->m_Start ) == before + move );
+
+    // The moved primitive is found at its new position
+    int count = 0;
+
+    m_image.HitTestItems( before + move, [&]( GERBER_DRAW_ITEM* aItem ) -> bool
+                                         {
+                                             count++;
+                                             return true;
+                                         } );
+
+    BOOST_CHECK_EQUAL( count, 1 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
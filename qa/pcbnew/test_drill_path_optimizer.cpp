@@ -0,0 +1,135 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the drill path optimization
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <exporters/drill_path_optimizer.h>
+
+#include <algorithm>
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( DrillPathOptimizer )
+
+
+static std::chrono::steady_clock::time_point deadline()
+{
+    return std::chrono::steady_clock::now() + std::chrono::seconds( 10 );
+}
+
+
+static bool isPermutation( std::vector<int> aOrder, size_t aCount )
+{
+    std::sort( aOrder.begin(), aOrder.end() );
+
+    for( size_t ii = 0; ii < aOrder.size(); ++ii )
+    {
+        if( aOrder[ii] != (int) ii )
+            return false;
+    }
+
+    return aOrder.size() == aCount;
+}
+
+
+BOOST_AUTO_TEST_CASE( Small )
+{
+    std::vector<wxPoint> points;
+
+    BOOST_CHECK( OptimizeDrillPath( points, deadline() ).empty() );
+
+    points.emplace_back( 0, 0 );
+    points.emplace_back( 1000, 0 );
+    BOOST_CHECK( OptimizeDrillPath( points, deadline() ) == std::vector<int>( { 0, 1 } ) );
+
+    // Holes on a line, visited out of order
+    points = { { 0, 0 }, { 3000, 0 }, { 1000, 0 }, { 2000, 0 } };
+    std::vector<int> order = OptimizeDrillPath( points, deadline() );
+
+    BOOST_CHECK( order == std::vector<int>( { 0, 2, 3, 1 } ) );
+    BOOST_CHECK_EQUAL( DrillPathLength( points ), 6000.0 );
+    BOOST_CHECK_EQUAL( DrillPathLength( points, order ), 3000.0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( Grid )
+{
+    // A 30x30 grid of holes, in random order
+    std::vector<wxPoint> points;
+
+    for( int x = 0; x < 30; ++x )
+    {
+        for( int y = 0; y < 30; ++y )
+            points.emplace_back( x * 1000, ( x % 2 ) ? y * 1000 : 29000 - y * 1000 );
+    }
+
+    std::shuffle( points.begin(), points.end(), std::mt19937( 1 ) );
+
+    std::vector<int> order = OptimizeDrillPath( points, deadline() );
+
+    BOOST_CHECK( isPermutation( order, points.size() ) );
+
+    // The shortest path is 899 steps of 1000
+    BOOST_CHECK_LT( DrillPathLength( points, order ), 899000 * 1.1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( Random )
+{
+    std::mt19937 rng( 42 );
+    std::uniform_int_distribution<int> coord( 0, 100000000 );
+    std::vector<wxPoint> points;
+
+    for( int ii = 0; ii < 5000; ++ii )
+        points.emplace_back( coord( rng ), coord( rng ) );
+
+    // Duplicated holes are allowed
+    points.push_back( points[10] );
+
+    std::vector<int> order = OptimizeDrillPath( points, deadline() );
+
+    BOOST_CHECK( isPermutation( order, points.size() ) );
+    BOOST_CHECK_LT( DrillPathLength( points, order ), DrillPathLength( points ) / 10 );
+}
+
+
+BOOST_AUTO_TEST_CASE( Deadline )
+{
+    std::vector<wxPoint> points;
+
+    for( int ii = 0; ii < 1000; ++ii )
+        points.emplace_back( ( ii * 7919 ) % 1000 * 1000, ii );
+
+    // Out of time: the path is still valid, and not longer than the initial one
+    std::vector<int> order = OptimizeDrillPath( points, std::chrono::steady_clock::now() );
+
+    BOOST_CHECK( isPermutation( order, points.size() ) );
+    BOOST_CHECK_LE( DrillPathLength( points, order ), DrillPathLength( points ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
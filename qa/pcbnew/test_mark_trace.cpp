@@ -0,0 +1,143 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for BOARD::MarkTrace() and the net topology index it uses
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <set>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connectivity/connectivity_data.h>
+
+
+BOOST_AUTO_TEST_SUITE( MarkTrace )
+
+
+/**
+ * A board with a chain of 3 segments, and a branch of 2 segments from the end of the chain.
+ */
+struct MARK_TRACE_FIXTURE
+{
+    MARK_TRACE_FIXTURE()
+    {
+        m_chain.push_back( addTrack( wxPoint( 0, 0 ), wxPoint( 1000, 0 ) ) );
+        m_chain.push_back( addTrack( wxPoint( 1000, 0 ), wxPoint( 2000, 0 ) ) );
+        m_chain.push_back( addTrack( wxPoint( 2000, 0 ), wxPoint( 3000, 0 ) ) );
+        m_branch.push_back( addTrack( wxPoint( 3000, 0 ), wxPoint( 3000, 1000 ) ) );
+        m_branch.push_back( addTrack( wxPoint( 3000, 0 ), wxPoint( 3000, -1000 ) ) );
+    }
+
+    TRACK* addTrack( const wxPoint& aStart, const wxPoint& aEnd )
+    {
+        TRACK* track = new TRACK( &m_board );
+
+        track->SetStart( aStart );
+        track->SetEnd( aEnd );
+        track->SetLayer( F_Cu );
+        m_board.Add( track );
+
+        return track;
+    }
+
+    double traceLength( TRACK* aTrack, int* aCount = nullptr )
+    {
+        double length = 0;
+        double padToDie = 0;
+
+        m_board.MarkTrace( m_board.m_Track, aTrack, aCount, &length, &padToDie, false );
+
+        return length;
+    }
+
+    BOARD               m_board;
+    std::vector<TRACK*> m_chain;
+    std::vector<TRACK*> m_branch;
+};
+
+
+BOOST_FIXTURE_TEST_CASE( ChainLength, MARK_TRACE_FIXTURE )
+{
+    int count = 0;
+
+    BOOST_CHECK_EQUAL( traceLength( m_chain[1], &count ), 3000.0 );
+    BOOST_CHECK_EQUAL( count, 3 );
+
+    // Cached value, from another segment of the chain
+    BOOST_CHECK_EQUAL( traceLength( m_chain[0], &count ), 3000.0 );
+    BOOST_CHECK_EQUAL( count, 3 );
+
+    // The junction ends the branch segments
+    BOOST_CHECK_EQUAL( traceLength( m_branch[0], &count ), 1000.0 );
+    BOOST_CHECK_EQUAL( count, 1 );
+
+    // No flag is left set
+    for( TRACK* track = m_board.m_Track; track; track = track->Next() )
+        BOOST_CHECK( !track->GetState( BUSY ) );
+}
+
+
+BOOST_FIXTURE_TEST_CASE( Reorder, MARK_TRACE_FIXTURE )
+{
+    int    count = 0;
+    TRACK* first = m_board.MarkTrace( m_board.m_Track, m_chain[2], &count, nullptr, nullptr,
+                                      true );
+
+    BOOST_CHECK_EQUAL( count, 3 );
+
+    std::set<TRACK*> marked;
+
+    for( int i = 0; i < count; ++i, first = first->Next() )
+        marked.insert( first );
+
+    BOOST_CHECK( marked == std::set<TRACK*>( m_chain.begin(), m_chain.end() ) );
+}
+
+
+BOOST_FIXTURE_TEST_CASE( Updates, MARK_TRACE_FIXTURE )
+{
+    BOOST_CHECK_EQUAL( traceLength( m_chain[0] ), 3000.0 );
+
+    // Change notified to the connectivity
+    m_chain[2]->SetEnd( wxPoint( 4000, 0 ) );
+    m_board.GetConnectivity()->Update( m_chain[2] );
+
+    BOOST_CHECK_EQUAL( traceLength( m_chain[0] ), 4000.0 );
+
+    // Change not notified: the stale index must not be used
+    m_chain[0]->SetStart( wxPoint( -1000, 0 ) );
+
+    BOOST_CHECK_EQUAL( traceLength( m_chain[1] ), 5000.0 );
+
+    // Removed segment
+    m_board.Remove( m_chain[1] );
+    delete m_chain[1];
+
+    BOOST_CHECK_EQUAL( traceLength( m_chain[0] ), 2000.0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
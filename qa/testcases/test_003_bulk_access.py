@@ -0,0 +1,58 @@
+import unittest
+import struct
+
+from pcbnew import *
+
+
+class TestBulkAccess(unittest.TestCase):
+
+    def setUp(self):
+        self.pcb = LoadBoard("data/complex_hierarchy.kicad_pcb")
+
+    def rows(self, array, columns):
+        data = bytes(array)
+        count = len(data) // (4 * columns)
+        values = struct.unpack('=%di' % (count * columns), data)
+        return [values[i * columns:(i + 1) * columns] for i in range(count)]
+
+    def test_tracks(self):
+        segments = [t for t in self.pcb.GetTracks() if t.Type() == PCB_TRACE_T]
+        rows = self.rows(self.pcb.GetTracksArray(), BULK_TRACK_COLUMN_COUNT)
+
+        self.assertEqual(len(rows), len(segments))
+
+        for row, track in zip(rows, segments):
+            self.assertEqual(row[BULK_TRACK_START_X], track.GetStart().x)
+            self.assertEqual(row[BULK_TRACK_END_Y], track.GetEnd().y)
+            self.assertEqual(row[BULK_TRACK_WIDTH], track.GetWidth())
+            self.assertEqual(row[BULK_TRACK_NET], track.GetNetCode())
+
+    def test_pads(self):
+        pads = [p for m in self.pcb.GetModules() for p in m.Pads()]
+        rows = self.rows(self.pcb.GetPadsArray(), BULK_PAD_COLUMN_COUNT)
+
+        self.assertEqual(len(rows), len(pads))
+
+        for row, pad in zip(rows, pads):
+            self.assertEqual(row[BULK_PAD_X], pad.GetPosition().x)
+            self.assertEqual(row[BULK_PAD_SIZE_Y], pad.GetSize().y)
+            self.assertEqual(row[BULK_PAD_NET], pad.GetNetCode())
+
+    def test_set_tracks(self):
+        array = bytearray(self.pcb.GetTracksArray())
+        count = len(array) // (4 * BULK_TRACK_COLUMN_COUNT)
+        self.assertGreater(count, 0)
+
+        struct.pack_into('=i', array, 4 * BULK_TRACK_WIDTH, 12345)
+        self.pcb.SetTracksArray(array)
+
+        track = [t for t in self.pcb.GetTracks() if t.Type() == PCB_TRACE_T][0]
+        self.assertEqual(track.GetWidth(), 12345)
+
+    def test_set_wrong_size(self):
+        with self.assertRaises(ValueError):
+            self.pcb.SetTracksArray(bytearray(4))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -595,6 +595,46 @@ bool VRML_LAYER::AddPolygon( const std::vector< wxRealPoint >& aPolySet, double
 }
 
 
+// adds a copy of the contours of another layer; the contours of a layer
+// hold positions in its vertex list, which are shifted by our vertex count
+bool VRML_LAYER::AppendContours( const VRML_LAYER& aLayer )
+{
+    if( fix )
+    {
+        error = "AppendContours(): no more vertices may be added (Tesselate was previously executed)";
+        return false;
+    }
+
+    int start = idx;
+
+    for( const VERTEX_3D* src : aLayer.vertices )
+    {
+        VERTEX_3D* vertex = new VERTEX_3D;
+        vertex->x   = src->x;
+        vertex->y   = src->y;
+        vertex->i   = idx++;
+        vertex->o   = -1;
+        vertex->pth = src->pth;
+
+        vertices.push_back( vertex );
+    }
+
+    for( size_t i = 0; i < aLayer.contours.size(); ++i )
+    {
+        std::list<int>* contour = new std::list<int>;
+
+        for( int vidx : *aLayer.contours[i] )
+            contour->push_back( vidx + start );
+
+        contours.push_back( contour );
+        areas.push_back( aLayer.areas[i] );
+        pth.push_back( aLayer.pth[i] );
+    }
+
+    return true;
+}
+
+
 // adds an arc to the given center, start point, pen width, and angle (degrees).
 bool VRML_LAYER::AppendArc( double aCenterX, double aCenterY, double aRadius,
                             double aStartAngle, double aAngle, int aContourID )
@@ -324,6 +324,18 @@ public:
     bool AddPolygon( const std::vector< wxRealPoint >& aPolySet,
                                  double aCenterX, double aCenterY, double aAngle );
 
+    /**
+     * Function AppendContours
+     * adds a copy of all contours of another layer to this layer.
+     * Since the tesselation of a layer renumbers the vertices of its holes layer,
+     * layers tesselated concurrently must each use their own copy of the holes.
+     *
+     * @param aLayer is the layer holding the contours to copy
+     *
+     * @return bool: true if the operation succeeded
+     */
+    bool AppendContours( const VRML_LAYER& aLayer );
+
     /**
      * Function Tesselate
      * creates a list of outline vertices as well as the
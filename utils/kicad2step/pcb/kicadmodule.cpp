@@ -383,3 +383,17 @@ bool KICADMODULE::ComposePCB( class PCBMODEL* aPCB, S3D_RESOLVER* resolver,
 
     return hasdata;
 }
+
+
+void KICADMODULE::GetModelFiles( S3D_RESOLVER* resolver, std::vector< std::string >& aFileNames,
+    bool aComposeVirtual )
+{
+    if( m_virtual && !aComposeVirtual )
+        return;
+
+    for( auto i : m_models )
+    {
+        aFileNames.emplace_back( resolver->ResolvePath(
+            wxString::FromUTF8Unchecked( i->m_modelname.c_str() ) ).ToUTF8() );
+    }
+}
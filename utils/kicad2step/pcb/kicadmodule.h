@@ -75,6 +75,10 @@ public:
 
     bool ComposePCB( class PCBMODEL* aPCB, S3D_RESOLVER* resolver,
         DOUBLET aOrigin, bool aComposeVirtual = true );
+
+    // append the resolved names of the model files which ComposePCB() would add
+    void GetModelFiles( S3D_RESOLVER* resolver, std::vector< std::string >& aFileNames,
+        bool aComposeVirtual = true );
 };
 
 #endif  // KICADMODULE_H
@@ -501,6 +501,13 @@ bool KICADPCB::ComposePCB( bool aComposeVirtual )
         m_pcb->AddOutlineSegment( &lcurve );
     }
 
+    std::vector< std::string > modelFiles;
+
+    for( auto i : m_modules )
+        i->GetModelFiles( &m_resolver, modelFiles, aComposeVirtual );
+
+    m_pcb->LoadModels( modelFiles );
+
     for( auto i : m_modules )
         i->ComposePCB( m_pcb, &m_resolver, origin, aComposeVirtual );
 
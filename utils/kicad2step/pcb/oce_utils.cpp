@@ -22,12 +22,27 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdio>
+#include <future>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <wx/filename.h>
 #include <wx/log.h>
+#include <wx/stdpaths.h>
+#include <wx/utils.h>
+
+#include <boost/version.hpp>
+
+#if BOOST_VERSION >= 106800
+#include <boost/uuid/detail/sha1.hpp>
+#else
+#include <boost/uuid/sha1.hpp>
+#endif
 
 #include "oce_utils.h"
 #include "kicadpad.h"
@@ -42,8 +57,10 @@
 #include <Quantity_Color.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
+#include <STEPControl_Controller.hxx>
 #include <APIHeaderSection_MakeHeader.hxx>
 #include <Standard_Version.hxx>
+#include <Standard.hxx>
 #include <TCollection_ExtendedString.hxx>
 #include <TDataStd_Name.hxx>
 #include <TDF_LabelSequence.hxx>
@@ -67,6 +84,7 @@
 #include <TopoDS_Face.hxx>
 #include <TopoDS_Compound.hxx>
 #include <TopoDS_Builder.hxx>
+#include <TopTools_ListOfShape.hxx>
 
 #include <Standard_Failure.hxx>
 
@@ -75,6 +93,10 @@
 #include <gp_Dir.hxx>
 #include <gp_Pnt.hxx>
 
+#if OCC_VERSION_HEX >= 0x070200
+#include <BinXCAFDrivers.hxx>
+#endif
+
 static constexpr double USER_PREC = 1e-4;
 static constexpr double USER_ANGLE_PREC = 1e-6;
 // minimum PCB thickness in mm (2 microns assumes a very thin polyimide film)
@@ -215,9 +237,132 @@ FormatType fileType( const char* aFileName )
 }
 
 
+// initialize the translators and set the options shared by readIGES() and readSTEP()
+static bool initReaders()
+{
+    IGESControl_Controller::Init();
+    STEPControl_Controller::Init();
+
+    // Enable user-defined shape precision
+    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
+        return false;
+
+    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
+    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
+        return false;
+
+    return true;
+}
+
+
+// return the existing MCAD equivalents of a .wrl file, in order of preference
+static std::vector< std::string > getMCADAlternates( const std::string& aFileName )
+{
+    wxFileName wrlName( aFileName );
+
+    wxString basePath = wrlName.GetPath();
+    wxString baseName = wrlName.GetName();
+
+    // List of alternate files to look for
+    // Given in order of preference
+    static const char* const alts[] =
+    {
+        // Step files
+        "stp", "step", "STP", "STEP", "Stp", "Step",
+        // IGES files
+        "iges", "IGES", "igs", "IGS"
+        //TODO - Other alternative formats?
+    };
+
+    std::vector< std::string > files;
+
+    for( auto alt : alts )
+    {
+        wxFileName altFile( basePath, baseName + "." + alt );
+
+        if( altFile.IsOk() && altFile.FileExists() )
+            files.push_back( altFile.GetFullPath().ToStdString() );
+    }
+
+    return files;
+}
+
+
+#if OCC_VERSION_HEX >= 0x070200
+// return the directory holding translated models, or an empty string if there is none:
+// 1. OSX: ~/Library/Caches/kicad/3d/
+// 2. Linux: ${XDG_CACHE_HOME}/kicad/3d ~/.cache/kicad/3d/
+// 3. MSWin: AppData\Local\kicad\3d
+static std::string getCacheDir()
+{
+    wxString cacheDir;
+
+#if defined(_WIN32)
+    wxStandardPaths::Get().UseAppInfo( wxStandardPaths::AppInfo_None );
+    cacheDir = wxStandardPaths::Get().GetUserLocalDataDir();
+    cacheDir.append( "\\kicad\\3d" );
+#elif defined(__APPLE__)
+    cacheDir = wxGetHomeDir() + "/Library/Caches/kicad/3d";
+#else   // assume Linux
+    if( !wxGetEnv( "XDG_CACHE_HOME", &cacheDir ) || cacheDir.empty() )
+        cacheDir = wxGetHomeDir() + "/.cache";
+
+    cacheDir.append( "/kicad/3d" );
+#endif
+
+    wxFileName cfgdir( cacheDir, "" );
+
+    if( !cfgdir.DirExists() && !cfgdir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return std::string();
+
+    return std::string( cfgdir.GetPathWithSep().ToUTF8() );
+}
+#endif
+
+
+// return the SHA1 of a model file as a hex string, or an empty string on failure
+static std::string getSHA1( const std::string& aFileName )
+{
+#ifdef _WIN32
+    FILE* fp = _wfopen( wxString::FromUTF8Unchecked( aFileName.c_str() ).wc_str(), L"rb" );
+#else
+    FILE* fp = fopen( aFileName.c_str(), "rb" );
+#endif
+
+    if( NULL == fp )
+        return std::string();
+
+    boost::uuids::detail::sha1 dblock;
+    unsigned char block[4096];
+    size_t bsize = 0;
+
+    while( ( bsize = fread( &block, 1, 4096, fp ) ) > 0 )
+        dblock.process_bytes( block, bsize );
+
+    fclose( fp );
+
+    // the translated shapes depend on the conversion precision
+    dblock.process_bytes( &USER_PREC, sizeof( USER_PREC ) );
+
+    unsigned int digest[5];
+    dblock.get_digest( digest );
+
+    char sha1[41];
+
+    for( int i = 0; i < 5; ++i )
+        snprintf( sha1 + i * 8, 9, "%08x", digest[i] );
+
+    return std::string( sha1 );
+}
+
+
 PCBMODEL::PCBMODEL()
 {
     m_app = XCAFApp_Application::GetApplication();
+#if OCC_VERSION_HEX >= 0x070200
+    // register the format of the translated model cache
+    BinXCAFDrivers::DefineFormat( m_app );
+#endif
     m_app->NewDocument( "MDTV-XCAF", m_doc );
     m_assy = XCAFDoc_DocumentTool::ShapeTool ( m_doc->Main() );
     m_assy_label = m_assy->NewShape();
@@ -576,6 +721,173 @@ bool PCBMODEL::AddPadHole( KICADPAD* aPad )
 }
 
 
+// read the given model files into m_models, using the translated model cache when possible
+void PCBMODEL::LoadModels( const std::vector< std::string >& aFileNames )
+{
+    struct MODEL_JOB
+    {
+        std::string                 m_fileName;
+        std::string                 m_cacheName;    // translated model file, if any
+        Handle( TDocStd_Document )  m_doc;
+        bool                        m_cached;       // set true if m_cacheName exists
+        bool                        m_ok;           // set true if m_doc holds the model
+    };
+
+    std::vector< MODEL_JOB > jobs;
+    std::set< std::string > names;
+
+    for( const auto& fileName : aFileNames )
+    {
+        std::string name = fileName;
+        wxFileName lfile( wxString::FromUTF8Unchecked( name.c_str() ) );
+
+        if( !lfile.FileExists() )
+            continue;
+
+        // .wrl files are replaced with their preferred MCAD equivalent
+        if( lfile.GetExt().Lower() == "wrl" )
+        {
+            std::vector< std::string > alts = getMCADAlternates( name );
+
+            if( alts.empty() )
+                continue;
+
+            name = alts.front();
+        }
+
+        if( m_models.count( name ) || !names.insert( name ).second )
+            continue;
+
+        MODEL_JOB job;
+        job.m_fileName = name;
+        job.m_cached = false;
+        job.m_ok = false;
+        m_app->NewDocument( "MDTV-XCAF", job.m_doc );
+        jobs.push_back( job );
+    }
+
+    if( jobs.empty() || !initReaders() )
+        return;
+
+#if OCC_VERSION_HEX < 0x070000
+    Standard::SetReentrant( Standard_True );
+#endif
+
+#if OCC_VERSION_HEX >= 0x070200
+    std::string cacheDir = getCacheDir();
+#else
+    // the BinXCAF format of the cache is not registered (see the constructor)
+    std::string cacheDir;
+#endif
+
+    // each worker reads its models into their own document; the documents are merged
+    // into the assembly afterwards since the XCAF application is not thread safe
+    std::atomic<size_t> nextItem( 0 );
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   jobs.size() );
+
+    auto read_lambda = [&] () -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextItem++; i < jobs.size(); i = nextItem++ )
+        {
+            MODEL_JOB& job = jobs[i];
+            FormatType modelFmt = fileType( job.m_fileName.c_str() );
+
+            if( !cacheDir.empty() && ( FMT_IGES == modelFmt || FMT_STEP == modelFmt ) )
+            {
+                std::string sha1 = getSHA1( job.m_fileName );
+
+                if( !sha1.empty() )
+                {
+                    job.m_cacheName = cacheDir + sha1 + ".xbf";
+                    job.m_cached = wxFileName::FileExists(
+                            wxString::FromUTF8Unchecked( job.m_cacheName.c_str() ) );
+                }
+            }
+
+            if( job.m_cached )
+                continue;
+
+            if( FMT_IGES == modelFmt )
+                job.m_ok = readIGES( job.m_doc, job.m_fileName.c_str() );
+            else if( FMT_STEP == modelFmt )
+                job.m_ok = readSTEP( job.m_doc, job.m_fileName.c_str() );
+
+            num++;
+        }
+
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        read_lambda();
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, read_lambda );
+
+        // Finalize the reads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    for( auto& job : jobs )
+    {
+        if( job.m_cached )
+        {
+            Handle( TDocStd_Document ) doc;
+            TCollection_ExtendedString cacheName( job.m_cacheName.c_str(), Standard_True );
+
+            if( m_app->Open( cacheName, doc ) == PCDM_RS_OK )
+            {
+                job.m_doc->Close();
+                job.m_doc = doc;
+                job.m_ok = true;
+            }
+            else
+            {
+                // the cached model is unreadable; translate the model again
+                FormatType modelFmt = fileType( job.m_fileName.c_str() );
+                job.m_cached = false;
+
+                if( FMT_IGES == modelFmt )
+                    job.m_ok = readIGES( job.m_doc, job.m_fileName.c_str() );
+                else if( FMT_STEP == modelFmt )
+                    job.m_ok = readSTEP( job.m_doc, job.m_fileName.c_str() );
+            }
+        }
+
+        // models which could not be read are left to getModelLabel() to report
+        if( !job.m_ok )
+            continue;
+
+        if( !job.m_cached && !job.m_cacheName.empty() )
+        {
+            TCollection_ExtendedString cacheName( job.m_cacheName.c_str(), Standard_True );
+            job.m_doc->ChangeStorageFormat( "BinXCAF" );
+
+            if( m_app->SaveAs( job.m_doc, cacheName ) != PCDM_SS_OK )
+            {
+                std::ostringstream ostr;
+#ifdef __WXDEBUG__
+                ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+#endif /* __WXDEBUG */
+                ostr << "  * could not cache model data to file '" << job.m_cacheName << "'\n";
+                wxLogMessage( "%s", ostr.str().c_str() );
+            }
+        }
+
+        TDF_Label label;
+        addModel( job.m_fileName, job.m_doc, label );
+        job.m_doc->Close();
+    }
+}
+
+
 // add a component at the given position and orientation
 bool PCBMODEL::AddComponent( const std::string& aFileName, const std::string& aRefDes,
     bool aBottom, DOUBLET aPosition, double aRotation,
@@ -805,8 +1117,46 @@ bool PCBMODEL::CreatePCB()
     }
 
     // subtract cutouts (if any)
-    for( auto i : m_cutouts )
-        board = BRepAlgoAPI_Cut( board, i );
+    if( !m_cutouts.empty() )
+    {
+#if OCC_VERSION_HEX >= 0x060900
+        // subtracting the cutouts one at a time intersects the board with every
+        // cutout again for each cut; a single cut with all the tools is much faster
+        TopTools_ListOfShape arguments;
+        TopTools_ListOfShape tools;
+
+        arguments.Append( board );
+
+        for( auto& i : m_cutouts )
+            tools.Append( i );
+
+        BRepAlgoAPI_Cut cut;
+        cut.SetArguments( arguments );
+        cut.SetTools( tools );
+        cut.SetRunParallel( Standard_True );
+        cut.Build();
+
+        if( cut.IsDone() )
+        {
+            board = cut.Shape();
+        }
+        else
+        {
+            std::ostringstream ostr;
+#ifdef __WXDEBUG__
+            ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+#endif /* __WXDEBUG */
+            ostr << "  * could not subtract cutouts at once; subtracting them one by one\n";
+            wxLogMessage( "%s", ostr.str().c_str() );
+
+            for( auto& i : m_cutouts )
+                board = BRepAlgoAPI_Cut( board, i );
+        }
+#else
+        for( auto& i : m_cutouts )
+            board = BRepAlgoAPI_Cut( board, i );
+#endif
+    }
 
     // push the board to the data structure
     m_pcb_label = m_assy->AddComponent( m_assy_label, board );
@@ -925,6 +1275,9 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TDF_Label& aLabel )
 
     FormatType modelFmt = fileType( aFileName.c_str() );
 
+    if( ( FMT_IGES == modelFmt || FMT_STEP == modelFmt ) && !initReaders() )
+        return false;
+
     switch( modelFmt )
     {
         case FMT_IGES:
@@ -965,47 +1318,10 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TDF_Label& aLabel )
              * for THAT file will be associated with the .wrl file
              *
              */
+            for( auto altFileName : getMCADAlternates( aFileName ) )
             {
-                wxFileName wrlName( aFileName );
-
-                wxString basePath = wrlName.GetPath();
-                wxString baseName = wrlName.GetName();
-
-                // List of alternate files to look for
-                // Given in order of preference
-                // (Break if match is found)
-                wxArrayString alts;
-
-                // Step files
-                alts.Add( "stp" );
-                alts.Add( "step" );
-                alts.Add( "STP" );
-                alts.Add( "STEP" );
-                alts.Add( "Stp" );
-                alts.Add( "Step" );
-
-                // IGES files
-                alts.Add( "iges" );
-                alts.Add( "IGES" );
-                alts.Add( "igs" );
-                alts.Add( "IGS" );
-
-                //TODO - Other alternative formats?
-
-                for( auto alt : alts )
-                {
-                    wxFileName altFile( basePath, baseName + "." + alt );
-
-                    if( altFile.IsOk() && altFile.FileExists() )
-                    {
-                        std::string altFileName = altFile.GetFullPath().ToStdString();
-
-                        if( getModelLabel( altFileName, aLabel ) )
-                        {
-                            return true;
-                        }
-                    }
-                }
+                if( getModelLabel( altFileName, aLabel ) )
+                    return true;
             }
 
             break;
@@ -1016,7 +1332,14 @@ bool PCBMODEL::getModelLabel( const std::string aFileName, TDF_Label& aLabel )
             return false;
     }
 
-    aLabel = transferModel( doc, m_doc );
+    return addModel( aFileName, doc, aLabel );
+}
+
+
+bool PCBMODEL::addModel( const std::string& aFileName, Handle( TDocStd_Document )& aDoc,
+    TDF_Label& aLabel )
+{
+    aLabel = transferModel( aDoc, m_doc );
 
     if( aLabel.IsNull() )
     {
@@ -1100,22 +1423,13 @@ bool PCBMODEL::getModelLocation( bool aBottom, DOUBLET aPosition, double aRotati
 
 bool PCBMODEL::readIGES( Handle( TDocStd_Document )& doc, const char* fname )
 {
-    IGESControl_Controller::Init();
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
-    // set other translation options
+    // set translation options (the precision is set by initReaders())
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use IGES label names
     reader.SetLayerMode(false); // ignore LAYER data
@@ -1145,15 +1459,7 @@ bool PCBMODEL::readSTEP( Handle(TDocStd_Document)& doc, const char* fname )
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
-    // set other translation options
+    // set translation options (the precision is set by initReaders())
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
     reader.SetLayerMode(false); // ignore LAYER data
@@ -101,6 +101,10 @@ class PCBMODEL
 
     bool getModelLabel( const std::string aFileName, TDF_Label& aLabel );
 
+    // transfer the model read from aFileName into the assembly and register its label
+    bool addModel( const std::string& aFileName, Handle( TDocStd_Document )& aDoc,
+        TDF_Label& aLabel );
+
     bool getModelLocation( bool aBottom, DOUBLET aPosition, double aRotation,
         TRIPLET aOffset, TRIPLET aOrientation, TopLoc_Location& aLocation );
 
@@ -120,6 +124,10 @@ public:
     // add a pad hole or slot (must be in final position)
     bool AddPadHole( KICADPAD* aPad );
 
+    // read the given model files ahead of AddComponent(); models which are not in the
+    // translated model cache are read concurrently and the results are cached
+    void LoadModels( const std::vector< std::string >& aFileNames );
+
     // add a component at the given position and orientation
     bool AddComponent( const std::string& aFileName, const std::string& aRefDes,
         bool aBottom, DOUBLET aPosition, double aRotation,